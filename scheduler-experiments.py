@@ -0,0 +1,42 @@
+import subprocess
+
+
+# Compares the LTE MAC schedulers on the DASH X2 handover scenario:
+# stall ratio of the players and downlink throughput of the cells.
+
+schedulers = ['RrFfMacScheduler', 'PfFfMacScheduler', 'VideoAwareFfMacScheduler']
+
+
+def main():
+
+    rep = 5             # Number of simulations repetitions
+    users = 10          # UEs attached to the first eNodeB
+    simTime = 60        # Simulation duration (seconds)
+
+    print("Initializing ...")
+
+    results = {}
+    for scheduler in schedulers:
+        results[scheduler] = []
+        for seed in range(1, rep + 1):
+            out = subprocess.check_output('./waf --run \'dash-lena-x2-handover --numberOfUes=%d --simTime=%ds --seed=%d --scheduler=ns3::%s\'' %
+                                          (users, simTime, seed, scheduler), shell=True, universal_newlines=True)
+            for line in out.splitlines():
+                if line.startswith('scheduler '):
+                    fields = line.split()
+                    results[scheduler].append((float(fields[5]), float(fields[7])))
+
+    print("%-26s %12s %22s" % ('scheduler', 'stall ratio', 'cell throughput (Mbps)'))
+    for scheduler in schedulers:
+        runs = results[scheduler]
+        if not runs:
+            continue
+        stall = sum(r[0] for r in runs) / len(runs)
+        thr = sum(r[1] for r in runs) / len(runs)
+        print("%-26s %12.4f %22.2f" % (scheduler, stall, thr))
+
+    print("Done.")
+
+
+if __name__ == '__main__':
+    main()
@@ -123,6 +123,7 @@ int main(int argc, char *argv[])
     unsigned numberOfAps = 0;
     int stopTime = 30;
     int seed = 0;
+    bool scenarioCache = false;
 
 
     CommandLine cmd;
@@ -133,6 +134,7 @@ int main(int argc, char *argv[])
     cmd.AddValue("HASLogic", "Adaptation Logic to Use.", hasAlgorithm);
     cmd.AddValue("seed", "Seed experiment.", seed);
     cmd.AddValue("Client", "Number of clients per AP.", n_clients);
+    cmd.AddValue("ScenarioCache", "Load the topology files through a binary cache (<file>.cache), rebuilt when a file changes.", scenarioCache);
 
     cmd.Parse(argc, argv);
 
@@ -140,7 +142,8 @@ int main(int argc, char *argv[])
     Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(1600));
     Config::SetDefault("ns3::TcpSocket::DelAckCount", UintegerValue(0));
 
-    ReadTopology("content/scenario/backhaul_link", "content/scenario/backhaul_nodes", network);
+    bool loaded = ReadTopology("content/scenario/backhaul_link", "content/scenario/backhaul_nodes", network, scenarioCache);
+    NS_ABORT_MSG_IF(!loaded, "Cannot load the topology from content/scenario");
 
     NS_LOG_INFO("Create Nodes");
 
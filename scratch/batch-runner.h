@@ -0,0 +1,364 @@
+#ifndef BATCH_RUNNER_HH_
+#define BATCH_RUNNER_HH_
+
+#include "ns3/system-path.h"
+#include "ns3/dashplayer-tracer.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <functional>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+
+using namespace std;
+
+// One point of the parameter grid. A batch run expands the cartesian product
+// of seeds x HASLogic x clients per AP x controller algorithm x TCP variant
+// into these.
+struct ScenarioParams
+{
+    string hasAlgorithm;
+    string controller;
+    unsigned clients;
+    int seed;
+    int stopTime;
+    bool batch;         // true when running as a forked worker of a batch
+    bool distributed;   // true when the topology is split over MPI ranks
+    unsigned threads;   // partitions of the multi-threaded simulator, 0 or 1 for none
+    bool threadsSequential;     // simulate the partitions of threads with the default simulator (CheckThreads)
+    string accessNetwork;       // "wifi" (802.11g per AP) or "link" (shared-capacity AccessLinkChannel)
+    string accessCapacity;      // aggregate capacity of an AP cell
+    string accessDelay;         // access delay of an AP cell
+    string accessStationRate;   // per-client rate cap, empty for none
+    double accessLoss;          // packet loss rate on the access link
+    string qoeModel;            // "basic" or "p1203", see DASHPlayerTracer::SetQoEModel
+    bool segmentTrace;          // write the per-segment topology.csv
+    string tcpVariant;          // congestion control of the TCP sockets, e.g. "ns3::TcpCubic"
+    string eventLog;            // DashEventLog components to record, empty for none
+    string animation;           // NetAnim output: "packets", "sampled" (link utilization) or "off"
+    double animInterval;        // link sampling interval of the sampled animation (s)
+    bool animBinary;            // write the packets and the samples to topology.netanim.bin
+    double animStart;           // start of the animation window (s)
+    double animStop;            // end of the animation window (s), 0 for the end of the run
+    bool live;                  // stream the videos live, the servers publish dynamic MPDs
+    double liveLatency;         // target latency of the players behind the live point (s)
+    bool scenarioCache;         // load the topology files through their binary cache
+    bool multiSource;           // download the segments in byte ranges from several servers
+    unsigned multiSourceMaxServers; // servers of a multi-source download
+    unsigned cacheEdges;        // level-3 edges replaced by a cache server pulling from the cloud server
+};
+
+// Per-run results, written by every worker to <run dir>/summary and read back
+// by the parent to build the aggregated table.
+struct RunSummary
+{
+    unsigned users;
+    double bitrate;         // mean experienced bitrate (bit/s)
+    double stalls;          // mean number of stalls per user
+    double startupDelay;    // mean start-up delay (ms)
+    double backhaulBytes;   // bytes sent on the point-to-point backhaul
+    double segmentDownload; // mean download time of a media segment (ms)
+    double liveLatency;     // mean latency of the live segments when played (s)
+    double hitRatio;        // share of the segment requests served from the edge caches
+};
+
+vector<string> BatchSplitList(const string& s)
+{
+    vector<string> values;
+    stringstream ss(s);
+    string item;
+
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) {
+            values.push_back(item);
+        }
+    }
+    return values;
+}
+
+// Seeds accept both "0,1,2" and "0-29".
+vector<int> BatchParseSeeds(const string& s)
+{
+    vector<int> seeds;
+    for (auto& item : BatchSplitList(s)) {
+        size_t dash = item.find('-', 1);
+        if (dash != string::npos) {
+            int first = atoi(item.substr(0, dash).c_str());
+            int last  = atoi(item.substr(dash + 1).c_str());
+            for (int i = first; i <= last; i++) {
+                seeds.push_back(i);
+            }
+        } else {
+            seeds.push_back(atoi(item.c_str()));
+        }
+    }
+    return seeds;
+}
+
+string RunDirName(const ScenarioParams& p)
+{
+    string dir = "../btree-" + p.hasAlgorithm + "-" + to_string(p.clients) + "-" + to_string(p.seed);
+    if (p.threadsSequential) {
+        dir += "-sequential";
+    }
+    if (p.batch) {
+        dir += "-" + p.controller;
+        if (p.tcpVariant != "ns3::TcpNewReno") {
+            dir += "-" + p.tcpVariant.substr(p.tcpVariant.rfind(':') + 1);
+        }
+    }
+    return dir;
+}
+
+// Reduce the online QoE of all the users of one run to the per-run summary.
+RunSummary SummarizeQoE(const DASHPlayerTracer::QoE& qoe, double backhaulBytes, double segmentDownload, double liveLatency,
+                        double hitRatio)
+{
+    RunSummary summary = {qoe.users, qoe.meanBitrate, 0.0, qoe.startupDelay, backhaulBytes, segmentDownload, liveLatency, hitRatio};
+    if (qoe.users > 0) {
+        summary.stalls = (double) qoe.stalls / qoe.users;
+    }
+    return summary;
+}
+
+void WriteRunSummary(const string& file, const RunSummary& s)
+{
+    ofstream out(file.c_str(), ios::out);
+    out.precision(17);
+    out << s.users << " " << s.bitrate << " " << s.stalls << " " << s.startupDelay << " " << s.backhaulBytes << " " << s.segmentDownload << " " << s.liveLatency << " " << s.hitRatio << endl;
+    out.close();
+}
+
+bool ReadRunSummary(const string& file, RunSummary& s)
+{
+    ifstream in(file.c_str());
+    return (bool) (in >> s.users >> s.bitrate >> s.stalls >> s.startupDelay >> s.backhaulBytes >> s.segmentDownload >> s.liveLatency >> s.hitRatio);
+}
+
+// Two-sided 95% Student-t quantile for n-1 degrees of freedom.
+double BatchTQuantile(unsigned n)
+{
+    static const double t95[] = {0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+                                 2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093,
+                                 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045};
+    unsigned df = n - 1;
+    return df < 30 ? t95[df] : 1.96;
+}
+
+void BatchMeanCI(const vector<double>& v, double& mean, double& ci)
+{
+    mean = 0.0;
+    ci   = 0.0;
+    if (v.empty()) {
+        return;
+    }
+    for (auto& x : v) {
+        mean += x;
+    }
+    mean /= v.size();
+
+    if (v.size() < 2) {
+        return;
+    }
+    double var = 0.0;
+    for (auto& x : v) {
+        var += (x - mean) * (x - mean);
+    }
+    var /= (v.size() - 1);
+    ci = BatchTQuantile(v.size()) * sqrt(var / v.size());
+}
+
+// Runs every point of the grid in its own forked process, keeping at most
+// `workers` simulations alive at a time. Forking gives every run a private
+// copy of the simulator singletons and of the scratch globals (rng, zipf
+// tables), so runs never share state. The aggregated table is written to
+// summaryFile once all workers have exited. When fork fails the run is
+// started again once a worker exits, or after a growing delay when none is
+// running; the runs which could never be started are listed and counted as
+// failed.
+int RunBatch(vector<ScenarioParams>& grid, unsigned workers, const string& summaryFile,
+             function<int(const ScenarioParams&)> runScenario)
+{
+    if (workers == 0) {
+        long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = ncpu > 0 ? ncpu : 1;
+    }
+
+    const unsigned maxForkRetries = 5;
+
+    map<pid_t, size_t> running;
+    map<size_t, int> status;
+    size_t next = 0;
+    unsigned forkRetries = 0;
+
+    fprintf(stderr, "Batch: %zu runs on %u workers\n", grid.size(), workers);
+
+    while (next < grid.size() || !running.empty()) {
+        while (next < grid.size() && running.size() < workers) {
+            fflush(stdout);
+            fflush(stderr);
+
+            pid_t pid = fork();
+            if (pid == 0) {
+                _exit(runScenario(grid[next]));
+            } else if (pid < 0) {
+                perror("fork");
+                break;
+            }
+            running[pid] = next++;
+            forkRetries = 0;
+        }
+
+        if (running.empty()) {
+            // fork failed and no worker will free resources: wait and retry
+            if (forkRetries == maxForkRetries) {
+                break;
+            }
+            forkRetries++;
+            fprintf(stderr, "Batch: cannot start run %s, retrying in %u s\n", RunDirName(grid[next]).c_str(), 1u << forkRetries);
+            sleep(1u << forkRetries);
+            continue;
+        }
+
+        int wstatus;
+        pid_t pid = waitpid(-1, &wstatus, 0);
+        if (pid < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("waitpid");
+            for (auto& worker : running) {
+                status[worker.second] = -1;
+            }
+            break;
+        }
+
+        auto it = running.find(pid);
+        if (it != running.end()) {
+            status[it->second] = WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : -1;
+            fprintf(stderr, "Batch: run %s finished (status %d)\n", RunDirName(grid[it->second]).c_str(), status[it->second]);
+            running.erase(it);
+        }
+    }
+
+    if (next < grid.size()) {
+        fprintf(stderr, "Batch: %zu runs not launched:\n", grid.size() - next);
+        for (; next < grid.size(); next++) {
+            status[next] = -1;
+            fprintf(stderr, "  %s\n", RunDirName(grid[next]).c_str());
+        }
+    }
+
+    // group runs which only differ by seed
+    map<string, vector<RunSummary>> groups;
+    map<string, const ScenarioParams*> groupParams;
+    int failed = 0;
+
+    for (size_t i = 0; i < grid.size(); i++) {
+        RunSummary s;
+        if (status[i] != 0 || !ReadRunSummary(RunDirName(grid[i]) + "/summary", s)) {
+            failed++;
+            continue;
+        }
+        string key = grid[i].hasAlgorithm + " " + to_string(grid[i].clients) + " " + grid[i].controller + " " + grid[i].tcpVariant;
+        groups[key].push_back(s);
+        groupParams[key] = &grid[i];
+    }
+
+    ofstream out(summaryFile.c_str(), ios::out);
+    out << "HASLogic Clients Controller TcpVariant Runs "
+        << "Bitrate BitrateCI Stalls StallsCI StartupDelay StartupDelayCI BackhaulBytes BackhaulBytesCI "
+        << "SegmentDownload SegmentDownloadCI LiveLatency LiveLatencyCI HitRatio HitRatioCI" << endl;
+
+    for (auto& group : groups) {
+        vector<double> bitrate, stalls, startup, backhaul, download, latency, hits;
+        for (auto& s : group.second) {
+            bitrate.push_back(s.bitrate);
+            stalls.push_back(s.stalls);
+            startup.push_back(s.startupDelay);
+            backhaul.push_back(s.backhaulBytes);
+            download.push_back(s.segmentDownload);
+            latency.push_back(s.liveLatency);
+            hits.push_back(s.hitRatio);
+        }
+
+        const ScenarioParams* p = groupParams[group.first];
+        out << p->hasAlgorithm << " " << p->clients << " " << p->controller << " " << p->tcpVariant << " " << group.second.size();
+
+        double mean, ci;
+        for (auto v : {&bitrate, &stalls, &startup, &backhaul, &download, &latency, &hits}) {
+            BatchMeanCI(*v, mean, ci);
+            out << " " << mean << " " << ci;
+        }
+        out << endl;
+    }
+    out.close();
+
+    fprintf(stderr, "Batch: %zu runs, %d failed, summary in %s\n", grid.size(), failed, summaryFile.c_str());
+    return failed == 0 ? 0 : 1;
+}
+
+// Runs the partitions of params.threads once with the default sequential
+// simulator and once with the multi-threaded one, each in a forked process,
+// and compares the two run summaries field by field. Both runs use the same
+// partitions, hence the same monitors and controller messages: a difference
+// can only come from the parallel simulation.
+int CheckThreads(const ScenarioParams& params, function<int(const ScenarioParams&)> runScenario)
+{
+    vector<ScenarioParams> runs(2, params);
+    runs[0].threadsSequential = true;
+    runs[1].threadsSequential = false;
+
+    RunSummary summaries[2];
+    for (size_t i = 0; i < runs.size(); i++) {
+        fflush(stdout);
+        fflush(stderr);
+        pid_t pid = fork();
+        if (pid == 0) {
+            _exit(runScenario(runs[i]));
+        }
+
+        int wstatus = 0;
+        if (pid < 0 || waitpid(pid, &wstatus, 0) != pid || !WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != 0
+            || !ReadRunSummary(RunDirName(runs[i]) + "/summary", summaries[i])) {
+            fprintf(stderr, "CheckThreads: run %s failed\n", RunDirName(runs[i]).c_str());
+            return 1;
+        }
+    }
+
+    const RunSummary& a = summaries[0];
+    const RunSummary& b = summaries[1];
+    vector<pair<string, pair<double, double>>> fields = {
+        {"users",           {a.users, b.users}},
+        {"bitrate",         {a.bitrate, b.bitrate}},
+        {"stalls",          {a.stalls, b.stalls}},
+        {"startupDelay",    {a.startupDelay, b.startupDelay}},
+        {"backhaulBytes",   {a.backhaulBytes, b.backhaulBytes}},
+        {"segmentDownload", {a.segmentDownload, b.segmentDownload}},
+        {"liveLatency",     {a.liveLatency, b.liveLatency}},
+        {"hitRatio",        {a.hitRatio, b.hitRatio}},
+    };
+
+    int differences = 0;
+    for (auto& field : fields) {
+        bool same = field.second.first == field.second.second;
+        differences += same ? 0 : 1;
+        fprintf(stderr, "CheckThreads: %-15s %.17g %.17g%s\n", field.first.c_str(),
+                field.second.first, field.second.second, same ? "" : "  DIFFERENT");
+    }
+    fprintf(stderr, "CheckThreads: %u threads, %s\n", params.threads,
+            differences == 0 ? "same summary as the sequential run" : "summaries differ");
+    return differences == 0 ? 0 : 1;
+}
+
+#endif // BATCH_RUNNER_HH_
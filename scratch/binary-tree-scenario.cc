@@ -3,10 +3,12 @@
 #include "ns3/network-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/wifi-module.h"
+#include "ns3/access-link-module.h"
 #include "ns3/mobility-module.h"
 #include "ns3/csma-module.h"
 #include "ns3/internet-module.h"
 #include "ns3/dashplayer-tracer.h"
+#include "ns3/dash-event-log.h"
 #include "ns3/node-throughput-tracer.h"
 #include "ns3/ipv4-static-routing-helper.h"
 #include "ns3/ipv4-list-routing-helper.h"
@@ -16,6 +18,7 @@
 
 #include "ns3/uinteger.h"
 #include "ns3/netanim-module.h"
+#include "ns3/mpi-interface.h"
 
 #include <map>
 #include <fstream>
@@ -25,6 +28,8 @@
 
 #include "utils.h"
 #include "videos.h"
+#include "batch-runner.h"
+#include "partition.h"
 
 #include "ns3/hash.h"
 
@@ -44,68 +49,173 @@ static string Ipv4AddressToString (Ipv4Address ad)
 	return oss.str ();
 }
 
-int main (int argc, char *argv[])
+// Download time of the media segments, to compare the TCP variants. The
+// players also report the download of the MPD, which is left out.
+struct SegmentDownloadStats
+{
+    unsigned segments;
+    double totalMs;
+};
+
+static void SegmentDownloadFinished (SegmentDownloadStats* stats, Ptr<Application> app, string file, double speed, long milliSeconds)
+{
+    if (file.find(".mpd") != string::npos) {
+        return;
+    }
+    stats->segments++;
+    stats->totalMs += milliSeconds;
+}
+
+// Latency of the live segments behind the live point when they start to play.
+struct LiveLatencyStats
+{
+    unsigned segments;
+    double totalLatency;
+};
+
+static void LiveSegmentPlayed (LiveLatencyStats* stats, unsigned segmentNumber, double latency)
+{
+    stats->segments++;
+    stats->totalLatency += latency;
+}
+
+struct CacheLookupStats
+{
+    uint64_t lookups;
+    uint64_t hits;
+};
+
+static void CacheLookup (CacheLookupStats* stats, string filename, bool hit)
+{
+    stats->lookups++;
+    stats->hits += hit ? 1 : 0;
+}
+
+// Shows the redirects of the controller on the edge servers of the animation.
+static void AnimateRedirect (AnimationInterface* anim, NodeContainer* nodes, string group, int content, unsigned fromNode, unsigned toNode)
+{
+    anim->UpdateNodeDescription(nodes->Get(toNode), "edge " + to_string(toNode) + " <- " + group + " (" + to_string(content) + ")");
+    anim->UpdateNodeColor(nodes->Get(toNode), 0, 255, 0);
+}
+
+static int RunScenario (const ScenarioParams& params)
 {
     map<pair<string, int>, string> serverTableList;
     NetworkTopology network;
-    unsigned n_clients = 1;
+    unsigned n_clients = params.clients;
     unsigned n_ap      = 0;
     int dst_server     = 7;
-    int seed           = 0;
-    int stopTime       = 30;
+    int seed           = params.seed;
+    int stopTime       = params.stopTime;
 
-    string scenarioFiles             = GetCurrentWorkingDir() + "/../content/scenario";
-    string requestsFile              = "requests";
-    string DashTraceFile             = "report.csv";
-    string ServerThroughputTraceFile = "server_throughput.csv";
-    string RepresentationType        = "netflix";
-    string hasAlgorithm              = "hybrid";
-
-    CommandLine cmd;
-
-    //default parameters
-    cmd.AddValue("DashTraceFile", "Filename of the DASH traces", DashTraceFile);
-    cmd.AddValue("RepresentationType", "Input representation type name", RepresentationType);
-    cmd.AddValue("stopTime", "The time when the clients will stop requesting segments", stopTime);
-    cmd.AddValue("HASLogic", "Adaptation Logic to Use.", hasAlgorithm);
-    cmd.AddValue("seed", "Seed experiment.", seed);
-    cmd.AddValue("Client", "Number of clients per AP.", n_clients);
-    cmd.Parse(argc, argv);
+    string scenarioFiles = GetCurrentWorkingDir() + "/../content/scenario";
+    string hasAlgorithm  = params.hasAlgorithm;
 
-    Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(1600));
+    // segments fit the MTU of the backbone and access links: no IP fragmentation
+    const uint16_t linkMtu = 1500;
+    Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(linkMtu - 20 - 32)); // IPv4 and TCP (timestamps) headers
     Config::SetDefault("ns3::TcpSocket::DelAckCount", UintegerValue(0));
-    string dir                  = CreateDir("../btree-" + hasAlgorithm + "-" + to_string(n_clients) + "-" + to_string(seed));
+
+    TypeId tcpVariant;
+    if (!TypeId::LookupByNameFailSafe(params.tcpVariant, &tcpVariant)) {
+        NS_FATAL_ERROR("Unknown TCP variant " << params.tcpVariant);
+    }
+    Config::SetDefault("ns3::TcpL4Protocol::SocketType", TypeIdValue(tcpVariant));
+    string dir                  = CreateDir(RunDirName(params));
     string filePath             = dir + "/Troughput_" + to_string(seed) + "_";
     string AdaptationLogicToUse = "dash::player::" + has_algorithm(hasAlgorithm);
-     
 
+    // batch workers run concurrently, so they must not share the connection file
+    string usersConnectionFile = params.batch ? dir + "/UsersConnection" : "UsersConnection";
+    Config::SetDefault("ns3::HttpClientDashApplication::UsersConnectionFile", StringValue(usersConnectionFile));
+
+
+    // The threads are set up here rather than in main, so that the workers of
+    // a batch run multi-threaded as well.
+    bool threaded = params.threads > 1 && !params.threadsSequential;
+    if (threaded) {
+        GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::MultithreadedSimulatorImpl"));
+        MpiInterface::Enable(0, 0);
+    }
 
-    ReadTopology(scenarioFiles + "/btree_l3_link", scenarioFiles + "/btree_l3_nodes", network);
+    bool loaded = ReadTopology(scenarioFiles + "/btree_l3_link", scenarioFiles + "/btree_l3_nodes", network, params.scenarioCache);
+    NS_ABORT_MSG_IF(!loaded, "Cannot load the topology from " << scenarioFiles);
 
 
+    // In distributed mode every rank builds the whole topology, but only
+    // simulates (installs applications on) the nodes of its own subtrees.
+    // With threads, the subtrees are split the same way over the partitions of
+    // the multi-threaded simulator and every node is simulated by this process.
+    vector<uint32_t> partition(network.getNodes().size(), 0);
+    vector<double> nodeLoad;
+    for (auto& node : network.getNodes()) {
+        nodeLoad.push_back(node->getType() == "ap" ? 1 + n_clients : 1);
+    }
+    if (params.threads > 1) {
+        partition = PartitionBySubtree(network, dst_server, params.threads, nodeLoad);
+    }
+#ifdef NS3_MPI
+    if (params.distributed) {
+        uint32_t systemId = MpiInterface::GetSystemId();
+
+        partition = PartitionBySubtree(network, dst_server, MpiInterface::GetSize(), nodeLoad);
+        dir += "/rank-" + to_string(systemId);
+        CreateDir(dir);
+        filePath = dir + "/Troughput_" + to_string(seed) + "_";
+
+        usersConnectionFile = dir + "/UsersConnection";
+        Config::SetDefault("ns3::HttpClientDashApplication::UsersConnectionFile", StringValue(usersConnectionFile));
+    }
+#endif
+    auto isLocal = [&](Ptr<Node> node) { return MpiInterface::IsLocal(node->GetSystemId()); };
+    // the controller reaches the nodes of the other partitions by messages only
+    bool parallel = params.distributed || params.threads > 1;
+
     NS_LOG_INFO("Create Nodes");
     NodeContainer nodes;    // Declare nodes objects
     NodeContainer clients;
-    nodes.Create(network.getNodes().size());
+    for (unsigned i = 0; i < network.getNodes().size(); i++) {
+        nodes.Create(1, partition[i]);
+    }
 
-    Ptr<Monitoring> monitor = CreateObject<Monitoring>();
-    monitor->setStepsTime(2);
-    monitor->setToRedirect(true);
-    monitor->setPathFile(filePath);
-    monitor->setNodes(&nodes);
+    // With threads, every partition monitors the links of its own nodes in its
+    // own directory, as every MPI rank does, and only the partition of the
+    // controller redirects: the monitors need no locking.
+    unsigned nMonitors = params.threads > 1 ? params.threads : 1;
+    vector<Ptr<Monitoring>> monitors;
+    for (unsigned p = 0; p < nMonitors; p++) {
+        Ptr<Monitoring> monitor = CreateObject<Monitoring>();
+        monitor->setStepsTime(2);
+        monitor->setNodes(&nodes);
+        if (nMonitors > 1) {
+            string partitionDir = dir + "/partition-" + to_string(p);
+            CreateDir(partitionDir);
+            monitor->setToRedirect(partition[dst_server] == p);
+            monitor->setPathFile(partitionDir + "/Troughput_" + to_string(seed) + "_");
+        } else {
+            monitor->setToRedirect(isLocal(nodes.Get(dst_server)));
+            monitor->setPathFile(filePath);
+        }
+        monitors.push_back(monitor);
+    }
+    auto monitorOf = [&](unsigned node) { return monitors[nMonitors > 1 ? partition[node] : 0]; };
 
     Ptr<BigTable> bigtable = CreateObject<BigTable>();
     bigtable->setClientContainers(&clients);
     bigtable->setServerTable(&serverTableList);
 
     Ptr<ControllerMain> ctrlapp = CreateObject<ControllerMain>();
-    nodes.Get(dst_server)->AddApplication(ctrlapp);
-    ctrlapp->Setup(Ipv4Address::GetAny(), 1317, "QoSGreedy");
+    if (isLocal(nodes.Get(dst_server))) {
+        nodes.Get(dst_server)->AddApplication(ctrlapp);
+    }
+    ctrlapp->Setup(Ipv4Address::GetAny(), 1317, params.controller);
     ctrlapp->setNodeContainers(&nodes);
     ctrlapp->SetStartTime(Seconds(0.0));
     ctrlapp->SetStopTime(Seconds(stopTime));
 
-    monitor->setController(ctrlapp);
+    for (auto& monitor : monitors) {
+        monitor->setController(ctrlapp);
+    }
     ctrlapp->setBigTable(bigtable);
     ctrlapp->setServerTable(&serverTableList);
 
@@ -130,6 +240,7 @@ int main (int argc, char *argv[])
     Ipv4AddressHelper address;
     address.SetBase("10.0.0.0", "255.255.255.0");
     PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("Mtu", UintegerValue(linkMtu));
 
     for (unsigned i = 0; i < network.getLinks().size(); i += 1) {
         int srcnode = network.getLinks().at(i)->getSrcId();
@@ -138,6 +249,9 @@ int main (int argc, char *argv[])
         double datarate = network.getLinks().at(i)->getRate();
 
         p2p.SetDeviceAttribute("DataRate", DataRateValue( datarate )); // Mbit/s
+        // in every mode, so that sequential and parallel runs simulate the same
+        // network; the parallel simulators take their lookahead from these delays
+        p2p.SetChannelAttribute("Delay", TimeValue(MilliSeconds(network.getLinks().at(i)->getDelay())));
 
         // And then install devices and channels connecting our topology
         NetDeviceContainer deviceContainer;
@@ -159,9 +273,12 @@ int main (int argc, char *argv[])
 
         string stripv4 = Ipv4AddressToString(srcipv4->GetAddress(same_bcst, 0).GetBroadcast());
 
-        monitor->setLinkMap(stripv4, 0);
-        monitor->setLinkCapacityMap(stripv4, srcnode, dstnode, datarate/1000000);
-        monitor->CreateFile(stripv4, srcnode, dstnode);
+        // both ends send on the link, so the monitors of both watch it
+        for (auto& monitor : {monitorOf(srcnode), monitorOf(dstnode)}) {
+            monitor->setLinkMap(stripv4, 0);
+            monitor->setLinkCapacityMap(stripv4, srcnode, dstnode, datarate/1000000);
+            monitor->CreateFile(stripv4, srcnode, dstnode);
+        }
 	}
 
     //Store IP adresses
@@ -206,7 +323,7 @@ int main (int argc, char *argv[])
         int apId = ap.first;
             NodeContainer &apContainer = ap.second;
 
-            Ptr<Node> node_client = CreateObject<Node> ();
+            Ptr<Node> node_client = CreateObject<Node> (partition[apId]);
             pair<int, Ptr<Node>> ap_client{apId, node_client};
 
             clients.Add(node_client);
@@ -216,7 +333,8 @@ int main (int argc, char *argv[])
         }
     }
 
-    int seedValue = time(0);
+    // ranks must draw the same clients, so distributed runs never seed from the clock
+    int seedValue = (params.batch || params.distributed) ? seed + 1 : time(0);
     RngSeedManager::SetSeed(seedValue);
     srand(seedValue);
     rng.seed(seedValue);
@@ -267,9 +385,21 @@ int main (int argc, char *argv[])
     mobility.Install(nodes.Get(7));
 
 
+    // the APs and the clients never move and the default log distance loss is
+    // deterministic: evaluate it once per pair
+    Config::SetDefault("ns3::YansWifiChannel::PropagationCache", BooleanValue(true));
     YansWifiChannelHelper channel = YansWifiChannelHelper::Default();
     YansWifiPhyHelper 	  phy     = YansWifiPhyHelper::Default();
 
+    // abstract access cells: one shared-capacity channel per AP instead of the 802.11 stack
+    AccessLinkHelper accessLink;
+    accessLink.SetChannelAttribute("DataRate", StringValue(params.accessCapacity));
+    accessLink.SetChannelAttribute("Delay", StringValue(params.accessDelay));
+    accessLink.SetDeviceAttribute("Mtu", UintegerValue(linkMtu));
+    if (!params.accessStationRate.empty()) {
+        accessLink.SetDeviceAttribute("DataRate", StringValue(params.accessStationRate));
+    }
+
     for (auto& ap : map_aps) {
         int ap_i = ap.first;
         NodeContainer& node_clients = ap.second;
@@ -278,22 +408,39 @@ int main (int argc, char *argv[])
 
         internet.Install(node_clients);
 
-        WifiHelper wifi;
-        WifiMacHelper mac;
-        phy.SetChannel(channel.Create());
+        NetDeviceContainer ap_dev, sta_dev;
+        if (params.accessNetwork == "link") {
+            NetDeviceContainer devs = accessLink.Install(node, node_clients);
+            ap_dev.Add(devs.Get(0));
+            for (uint32_t d = 1; d < devs.GetN(); d++) {
+                sta_dev.Add(devs.Get(d));
+            }
+            if (params.accessLoss > 0) {
+                for (uint32_t d = 0; d < devs.GetN(); d++) {
+                    Ptr<RateErrorModel> em = CreateObject<RateErrorModel>();
+                    em->SetUnit(RateErrorModel::ERROR_UNIT_PACKET);
+                    em->SetRate(params.accessLoss);
+                    devs.Get(d)->SetAttribute("ReceiveErrorModel", PointerValue(em));
+                }
+            }
+        } else {
+            WifiHelper wifi;
+            WifiMacHelper mac;
+            phy.SetChannel(channel.Create());
 
-        ostringstream ss;
-        ss << "ns-3-ssid-" << ++n_ap;
-        Ssid ssid = Ssid(ss.str());
+            ostringstream ss;
+            ss << "ns-3-ssid-" << ++n_ap;
+            Ssid ssid = Ssid(ss.str());
 
-        wifi.SetRemoteStationManager("ns3::AarfWifiManager");
-        wifi.SetStandard (WIFI_PHY_STANDARD_80211g);
+            wifi.SetRemoteStationManager("ns3::AarfWifiManager");
+            wifi.SetStandard (WIFI_PHY_STANDARD_80211g);
 
-        mac.SetType("ns3::ApWifiMac", "Ssid", SsidValue (ssid));
-        NetDeviceContainer ap_dev =  wifi.Install(phy, mac, node);
+            mac.SetType("ns3::ApWifiMac", "Ssid", SsidValue (ssid));
+            ap_dev = wifi.Install(phy, mac, node);
 
-        mac.SetType("ns3::StaWifiMac", "Ssid", SsidValue (ssid), "ActiveProbing", BooleanValue (false));
-        NetDeviceContainer sta_dev = wifi.Install(phy, mac, node_clients);
+            mac.SetType("ns3::StaWifiMac", "Ssid", SsidValue (ssid), "ActiveProbing", BooleanValue (false));
+            sta_dev = wifi.Install(phy, mac, node_clients);
+        }
 
         address.Assign(ap_dev);
         address.Assign(sta_dev);
@@ -311,20 +458,46 @@ int main (int argc, char *argv[])
 
     DASHServerHelper serverCache(Ipv4Address::GetAny (), 80, strIpv4Server,
         "/content/mpds/", representationStrings, "/content/segments/");
+    serverCache.SetAttribute("Live", BooleanValue(params.live));
 
-    ApplicationContainer serverApps = serverCache.Install(cloudServer);
-    serverApps.Start (Seconds(0.0));
-    serverApps.Stop (Seconds(stopTime));
+    if (isLocal(cloudServer)) {
+        ApplicationContainer serverApps = serverCache.Install(cloudServer);
+        serverApps.Start (Seconds(0.0));
+        serverApps.Stop (Seconds(stopTime));
+    }
 
+    // one stats per cache, each one only updated by the partition of its cache
+    vector<CacheLookupStats> cacheLookups(params.cacheEdges, CacheLookupStats{0, 0});
     for (size_t i = 3; i < nodes.GetN(); i++) {
         representationStrings = GetCurrentWorkingDir() + "/../content/representations/netflix_vid1.csv";
 
         Ptr<Node> edgeServer = nodes.Get(i);
+
+        if (partition[i] != partition[dst_server]) {
+            ctrlapp->setEdgeCapacity(i, 3);
+        }
+        if (!isLocal(edgeServer)) {
+            continue;
+        }
         string strIpv4Edge = Ipv4AddressToString(edgeServer->GetObject<Ipv4>()->GetAddress(1,0).GetLocal());
 
+        if (i < 3 + params.cacheEdges) {
+            // a pull-through cache: the misses and the MPDs come from the cloud server,
+            // the content placements of the controller are ignored
+            DASHCacheServerHelper cacheServer(Ipv4Address::GetAny (), 80, strIpv4Edge, strIpv4Server,
+                "/content/mpds/", representationStrings, "/content/segments/");
+            ApplicationContainer serverApps = cacheServer.Install(edgeServer);
+            serverApps.Get(0)->TraceConnectWithoutContext("CacheLookup", MakeBoundCallback(&CacheLookup, &cacheLookups[i - 3]));
+            serverApps.Start (Seconds(0.0));
+            serverApps.Stop (Seconds(stopTime));
+            continue;
+        }
+
         EdgeDashServerHelper edgeServerCache(Ipv4Address::GetAny (), 80, strIpv4Edge,
             "/content/mpds/", representationStrings, "/content/segments/");
         edgeServerCache.SetAttribute("Capacity", UintegerValue(3));
+        edgeServerCache.SetAttribute("Live", BooleanValue(params.live));
+        edgeServerCache.SetAttribute("ControlPort", UintegerValue(parallel ? 1318 : 0));
 
         ApplicationContainer serverApps = edgeServerCache.Install(edgeServer);
         serverApps.Start (Seconds(0.0));
@@ -335,12 +508,21 @@ int main (int argc, char *argv[])
         representationStrings = GetCurrentWorkingDir() + "/../content/representations/netflix_vid1.csv";
 
         Ptr<Node> edgeServer = nodes.Get(i);
+
+        if (partition[i] != partition[dst_server]) {
+            ctrlapp->setEdgeCapacity(i, 6);
+        }
+        if (!isLocal(edgeServer)) {
+            continue;
+        }
         string strIpv4Edge = Ipv4AddressToString(edgeServer->GetObject<Ipv4>()->GetAddress(1,0).GetLocal());
 
         EdgeDashServerHelper edgeServerCache(Ipv4Address::GetAny (), 80, strIpv4Edge,
                                 "/content/mpds/", representationStrings, "/content/segments/");
 
         edgeServerCache.SetAttribute("Capacity", UintegerValue(6));
+        edgeServerCache.SetAttribute("Live", BooleanValue(params.live));
+        edgeServerCache.SetAttribute("ControlPort", UintegerValue(parallel ? 1318 : 0));
         ApplicationContainer serverApps = edgeServerCache.Install(edgeServer);
         serverApps.Start (Seconds(0.0));
         serverApps.Stop (Seconds(stopTime));
@@ -349,11 +531,20 @@ int main (int argc, char *argv[])
     for (size_t i = 0; i < 1; i++) {
         representationStrings = GetCurrentWorkingDir() + "/../content/representations/netflix_vid1.csv";
         Ptr<Node> edgeServer  = nodes.Get(i);
+
+        if (partition[i] != partition[dst_server]) {
+            ctrlapp->setEdgeCapacity(i, 9);
+        }
+        if (!isLocal(edgeServer)) {
+            continue;
+        }
         string strIpv4Edge    = Ipv4AddressToString(edgeServer->GetObject<Ipv4>()->GetAddress(1,0).GetLocal());
 
         EdgeDashServerHelper edgeServerCache(Ipv4Address::GetAny (), 80, strIpv4Edge,
                                 "/content/mpds/", representationStrings, "/content/segments/");
         edgeServerCache.SetAttribute("Capacity", UintegerValue(9));
+        edgeServerCache.SetAttribute("Live", BooleanValue(params.live));
+        edgeServerCache.SetAttribute("ControlPort", UintegerValue(parallel ? 1318 : 0));
 
         ApplicationContainer serverApps = edgeServerCache.Install(edgeServer);
         serverApps.Start(Seconds(0.0));
@@ -366,8 +557,12 @@ int main (int argc, char *argv[])
 
     Ipv4GlobalRoutingHelper::PopulateRoutingTables();
 
+    // while running, the controller must not touch the nodes of other threads
+    ctrlapp->CacheNodes();
+    bigtable->CacheClients();
+
     ofstream fileMobility;
-    fileMobility.open("UsersConnection", ios::out);
+    fileMobility.open(usersConnectionFile.c_str(), ios::out);
 
     ofstream fileUserArrive;
     fileUserArrive.open(dir + string("/UserConnectionStatus"), ios::out);
@@ -397,29 +592,45 @@ int main (int argc, char *argv[])
         player.SetAttribute("ScreenWidth", UintegerValue(screenWidth));
         player.SetAttribute("ScreenHeight", UintegerValue(screenHeight));
         player.SetAttribute("UserId", UintegerValue(final_client));
+        DASHPlayerTracer::SetUserGroup(final_client, "ap" + to_string(apId));
         player.SetAttribute("AllowDownscale", BooleanValue(true));
         player.SetAttribute("AllowUpscale", BooleanValue(true));
         player.SetAttribute("MaxBufferedSeconds", StringValue("60"));
         player.SetAttribute("ContentId", UintegerValue(content));
-
-        ApplicationContainer clientApps;
-        clientApps = player.Install(clientNode);
-        clientApps.Start(Seconds(start));
-        clientApps.Stop(Seconds(stopTime));
+        player.SetAttribute("LiveTargetLatency", DoubleValue(params.liveLatency));
+        player.SetAttribute("MultiSource", BooleanValue(params.multiSource));
+        player.SetAttribute("MultiSourceMaxServers", UintegerValue(params.multiSourceMaxServers));
+        if (parallel) {
+            // the controller may live in another partition, redirects come as messages
+            player.SetAttribute("ControllerAddress", AddressValue(Ipv4Address(strIpv4Server.c_str())));
+        }
 
         string strIpv4Lcl = Ipv4AddressToString(clientNode->GetObject<Ipv4>()->GetAddress(1,0).GetLocal());
         string strIpv4Bst = Ipv4AddressToString(clientNode->GetObject<Ipv4>()->GetAddress(1,0).GetBroadcast());
 
-
-        Ptr<Application> app = clientNode->GetApplication(0);
-        app->GetObject<HttpClientDashApplication>()->setServerTableList(&serverTableList);
         serverTableList[{strIpv4Bst, content}] = strIpv4Server;
 
+        if (isLocal(clientNode)) {
+            ApplicationContainer clientApps;
+            clientApps = player.Install(clientNode);
+            clientApps.Start(Seconds(start));
+            clientApps.Stop(Seconds(stopTime));
+
+            if (!parallel) {
+                Ptr<Application> app = clientNode->GetApplication(0);
+                app->GetObject<HttpClientDashApplication>()->setServerTableList(&serverTableList);
+            }
+        }
+
 
         fileUserArrive << clientNode->GetId() << " " << final_client << " " << apId << " " << strIpv4Lcl << " " << strIpv4Server << " " << content << endl;
         fileMobility   << clientNode->GetId() << " " << final_client << " " << apId << " " << strIpv4Lcl << " " << strIpv4Server << endl;
 
-        Simulator::Schedule(Seconds(start), &BigTable::AddUserInGroup, bigtable, apId, dst_server, content, userId);
+        if (isLocal(nodes.Get(dst_server))) {
+            // in the partition of the controller, which owns the table
+            Simulator::ScheduleWithContext(nodes.Get(dst_server)->GetId(), Seconds(start),
+                &BigTable::AddUserInGroup, bigtable, apId, dst_server, content, userId);
+        }
     }
     std::cout << '\n';
 
@@ -429,34 +640,257 @@ int main (int argc, char *argv[])
     fileUserArrive.flush();
     fileUserArrive.close();
 
-    Config::Connect("/NodeList/0/DeviceList/*/$ns3::PointToPointNetDevice/MacTx",
-                  MakeCallback (&Monitoring::RateCallback, monitor));
-    Config::Connect("/NodeList/1/DeviceList/*/$ns3::PointToPointNetDevice/MacTx",
-                  MakeCallback (&Monitoring::RateCallback, monitor));
-    Config::Connect("/NodeList/2/DeviceList/*/$ns3::PointToPointNetDevice/MacTx",
-                  MakeCallback (&Monitoring::RateCallback, monitor));
-    Config::Connect("/NodeList/3/DeviceList/*/$ns3::PointToPointNetDevice/MacTx",
-                  MakeCallback (&Monitoring::RateCallback, monitor));
-    Config::Connect("/NodeList/4/DeviceList/*/$ns3::PointToPointNetDevice/MacTx",
-                  MakeCallback (&Monitoring::RateCallback, monitor));
-    Config::Connect("/NodeList/5/DeviceList/*/$ns3::PointToPointNetDevice/MacTx",
-                  MakeCallback (&Monitoring::RateCallback, monitor));
-    Config::Connect("/NodeList/6/DeviceList/*/$ns3::PointToPointNetDevice/MacTx",
-                  MakeCallback (&Monitoring::RateCallback, monitor));
-    Config::Connect("/NodeList/7/DeviceList/*/$ns3::PointToPointNetDevice/MacTx",
-                  MakeCallback (&Monitoring::RateCallback, monitor));
-    Simulator::Schedule(Seconds(0), &Monitoring::BandwidthEstimator, monitor);
-
-
-    AnimationInterface anim(dir + string("/topology.netanim"));
+    for (unsigned i = 0; i < 8; i++) {
+        Config::Connect("/NodeList/" + to_string(i) + "/DeviceList/*/$ns3::PointToPointNetDevice/MacTx",
+                      MakeCallback (&Monitoring::RateCallback, monitorOf(i)));
+    }
+    if (nMonitors > 1) {
+        // every monitor samples in the thread of its partition
+        for (unsigned p = 0; p < nMonitors; p++) {
+            auto node = find(partition.begin(), partition.end(), p);
+            if (node != partition.end()) {
+                Simulator::ScheduleWithContext(nodes.Get(node - partition.begin())->GetId(), Seconds(0),
+                    &Monitoring::BandwidthEstimator, monitors[p]);
+            }
+        }
+    } else {
+        Simulator::Schedule(Seconds(0), &Monitoring::BandwidthEstimator, monitors[0]);
+    }
 
+    // one counter per partition, only updated by the thread of the partition
+    vector<SegmentDownloadStats> downloads(nMonitors, SegmentDownloadStats{0, 0.0});
+    for (auto& client : m_clients) {
+        int apId = client.second.first;
+        Config::ConnectWithoutContext("/NodeList/" + to_string(client.second.second->GetId())
+                      + "/ApplicationList/*/$ns3::HttpClientDashApplication/FileDownloadFinished",
+                      MakeBoundCallback(&SegmentDownloadFinished, &downloads[nMonitors > 1 ? partition[apId] : 0]));
+    }
+    vector<LiveLatencyStats> latencies(nMonitors, LiveLatencyStats{0, 0.0});
+    if (params.live) {
+        for (auto& client : m_clients) {
+            int apId = client.second.first;
+            Config::ConnectWithoutContext("/NodeList/" + to_string(client.second.second->GetId())
+                          + "/ApplicationList/*/$ns3::HttpClientDashApplication::MultimediaConsumer/LiveLatency",
+                          MakeBoundCallback(&LiveSegmentPlayed, &latencies[nMonitors > 1 ? partition[apId] : 0]));
+        }
+    }
+
+
+    // Tracing every packet makes NetAnim files of large runs huge, the sampled
+    // mode only writes the utilization of the links and the redirects.
+    AnimationInterface *anim = 0;
+    if (!parallel && params.animation != "off") {
+        anim = new AnimationInterface(dir + string("/topology.netanim"));
+        anim->SetStartTime(Seconds(params.animStart));
+        if (params.animStop > 0) {
+            anim->SetStopTime(Seconds(params.animStop));
+        }
+        if (params.animation == "sampled") {
+            anim->EnableLinkSampling(Seconds(params.animInterval));
+        } else if (params.animation != "packets") {
+            NS_FATAL_ERROR("Unknown Animation " << params.animation << ", use packets, sampled or off");
+        }
+        anim->EnableBinaryOutput(params.animBinary);
+        ctrlapp->TraceConnectWithoutContext("Redirect", MakeBoundCallback(&AnimateRedirect, anim, &nodes));
+    }
+
+    DASHPlayerTracer::SetQoEModel(params.qoeModel);
+    DASHPlayerTracer::SetSegmentTrace(params.segmentTrace);
+    DASHPlayerTracer::SetSummaryFile(dir + string("/qoe"));
     DASHPlayerTracer::InstallAll(dir + string("/topology.csv"));
 
+    if (!params.eventLog.empty()) {
+        DashEventLog::Clear();
+        DashEventLog::EnableFromString(params.eventLog);
+    }
+
     Simulator::Stop(Seconds(stopTime));
     Simulator::Run();
+    if (!params.eventLog.empty()) {
+        DashEventLog::Dump(dir + string("/events"));
+    }
     Simulator::Destroy();
+    if (threaded) {
+        MpiInterface::Disable();
+    }
+
+    SegmentDownloadStats total = {0, 0.0};
+    for (auto& d : downloads) {
+        total.segments += d.segments;
+        total.totalMs  += d.totalMs;
+    }
+    LiveLatencyStats live = {0, 0.0};
+    for (auto& l : latencies) {
+        live.segments     += l.segments;
+        live.totalLatency += l.totalLatency;
+    }
+    CacheLookupStats cache = {0, 0};
+    for (auto& c : cacheLookups) {
+        cache.lookups += c.lookups;
+        cache.hits    += c.hits;
+    }
+    uint64_t backhaulBytes = 0;
+    for (auto& monitor : monitors) {
+        backhaulBytes += monitor->getTotalBytes();
+    }
+
+    DASHPlayerTracer::QoE qoe = DASHPlayerTracer::QoE();
+    DASHPlayerTracer::GetGroupQoE("all", qoe);
+    double segmentDownload = total.segments > 0 ? total.totalMs / total.segments : 0.0;
+    double liveLatency = live.segments > 0 ? live.totalLatency / live.segments : 0.0;
+    double hitRatio = cache.lookups > 0 ? (double) cache.hits / cache.lookups : 0.0;
+    WriteRunSummary(dir + "/summary", SummarizeQoE(qoe, backhaulBytes, segmentDownload, liveLatency, hitRatio));
 
     DASHPlayerTracer::Destroy();
 
+    delete anim;
+
     return 0;
 }
+
+int main (int argc, char *argv[])
+{
+    ScenarioParams params;
+    params.hasAlgorithm = "hybrid";
+    params.controller   = "QoSGreedy";
+    params.clients      = 1;
+    params.seed         = 0;
+    params.stopTime     = 30;
+    params.batch        = false;
+    params.distributed  = false;
+    params.threads      = 0;
+    params.threadsSequential = false;
+    params.accessNetwork     = "wifi";
+    params.accessCapacity    = "54Mbps";
+    params.accessDelay       = "2ms";
+    params.accessStationRate = "";
+    params.accessLoss        = 0;
+    params.qoeModel          = "basic";
+    params.segmentTrace      = true;
+    params.tcpVariant        = "ns3::TcpNewReno";
+    params.eventLog          = "";
+    params.animation         = "packets";
+    params.animInterval      = 1;
+    params.animBinary        = false;
+    params.animStart         = 0;
+    params.animStop          = 0;
+    params.live              = false;
+    params.liveLatency       = 10;
+    params.scenarioCache     = false;
+    params.multiSource       = false;
+    params.multiSourceMaxServers = 2;
+    params.cacheEdges        = 1;
+
+    string DashTraceFile      = "report.csv";
+    string RepresentationType = "netflix";
+
+    string batchSeeds       = "";
+    string batchHASLogic    = "";
+    string batchClients     = "";
+    string batchControllers = "";
+    string batchTcpVariants = "";
+    string batchSummary     = "../btree-batch-summary.txt";
+    unsigned workers        = 0;
+    bool checkThreads       = false;
+
+    CommandLine cmd;
+
+    //default parameters
+    cmd.AddValue("DashTraceFile", "Filename of the DASH traces", DashTraceFile);
+    cmd.AddValue("RepresentationType", "Input representation type name", RepresentationType);
+    cmd.AddValue("stopTime", "The time when the clients will stop requesting segments", params.stopTime);
+    cmd.AddValue("HASLogic", "Adaptation Logic to Use.", params.hasAlgorithm);
+    cmd.AddValue("seed", "Seed experiment.", params.seed);
+    cmd.AddValue("Client", "Number of clients per AP.", params.clients);
+    cmd.AddValue("Controller", "Controller optimization algorithm (QoSGreedy, ILPSolution).", params.controller);
+    cmd.AddValue("AccessNetwork", "Access network of the APs (wifi, link).", params.accessNetwork);
+    cmd.AddValue("AccessCapacity", "Aggregate capacity of an AP cell (AccessNetwork=link).", params.accessCapacity);
+    cmd.AddValue("AccessDelay", "Access delay of an AP cell (AccessNetwork=link).", params.accessDelay);
+    cmd.AddValue("AccessStationRate", "Rate cap of every client, empty for none (AccessNetwork=link).", params.accessStationRate);
+    cmd.AddValue("AccessLoss", "Packet loss rate of the access link (AccessNetwork=link).", params.accessLoss);
+    cmd.AddValue("QoEModel", "QoE model of the online metrics (basic, p1203).", params.qoeModel);
+    cmd.AddValue("SegmentTrace", "Write the per-segment player trace (topology.csv).", params.segmentTrace);
+    cmd.AddValue("Distributed", "Split the topology by subtree over the MPI ranks (requires --enable-mpi).", params.distributed);
+    cmd.AddValue("Threads", "Split the topology by subtree over this many threads (only the monitor of the controller's partition redirects).", params.threads);
+    cmd.AddValue("CheckThreads", "Run the Threads partitions on the sequential and on the multi-threaded simulator and compare the summaries.", checkThreads);
+    cmd.AddValue("TcpVariant", "Congestion control of the TCP sockets (ns3::TcpNewReno, ns3::TcpCubic, ns3::TcpBbr, ...).", params.tcpVariant);
+    cmd.AddValue("EventLog", "DashEventLog components written to events, e.g. HttpClientDashApplication=10:HttpServerFakeClientSocket.", params.eventLog);
+    cmd.AddValue("Animation", "NetAnim output (packets, sampled link utilization, off).", params.animation);
+    cmd.AddValue("AnimInterval", "Link sampling interval of Animation=sampled (s).", params.animInterval);
+    cmd.AddValue("AnimBinary", "Write the packets and link samples to topology.netanim.bin (see utils/netanim-bin2xml.py).", params.animBinary);
+    cmd.AddValue("AnimStart", "Start of the animation window (s).", params.animStart);
+    cmd.AddValue("AnimStop", "End of the animation window (s), 0 for the end of the run.", params.animStop);
+    cmd.AddValue("Live", "Stream the videos live, from dynamic MPDs whose segments are produced as the simulation advances.", params.live);
+    cmd.AddValue("LiveLatency", "Target latency of the players behind the live point (s).", params.liveLatency);
+    cmd.AddValue("ScenarioCache", "Load the topology files through a binary cache (<file>.cache), rebuilt when a file changes.", params.scenarioCache);
+    cmd.AddValue("MultiSource", "Download the segments in byte ranges from the edge, the origin and the MPD BaseURLs in parallel.", params.multiSource);
+    cmd.AddValue("MultiSourceMaxServers", "Maximum number of servers of a MultiSource download.", params.multiSourceMaxServers);
+    cmd.AddValue("CacheEdges", "Number of level-3 edges served by a cache server pulling from the cloud server instead of an edge server.", params.cacheEdges);
+
+    //batch parameters
+    cmd.AddValue("BatchSeeds", "Run a batch over these seeds (e.g. 0-29 or 1,4,7).", batchSeeds);
+    cmd.AddValue("BatchHASLogic", "Comma separated adaptation logics of the batch (default: HASLogic).", batchHASLogic);
+    cmd.AddValue("BatchClients", "Comma separated clients per AP of the batch (default: Client).", batchClients);
+    cmd.AddValue("BatchControllers", "Comma separated controller algorithms of the batch (default: Controller).", batchControllers);
+    cmd.AddValue("BatchTcpVariants", "Comma separated TCP variants of the batch (default: TcpVariant).", batchTcpVariants);
+    cmd.AddValue("BatchSummary", "File receiving the aggregated batch table.", batchSummary);
+    cmd.AddValue("Workers", "Maximum number of concurrent simulations (0 = number of cores).", workers);
+    cmd.Parse(argc, argv);
+
+    if (params.distributed && params.threads > 1) {
+        NS_FATAL_ERROR("Distributed and Threads cannot be combined");
+    }
+
+    if (checkThreads) {
+        if (params.threads < 2 || params.distributed || !batchSeeds.empty()) {
+            NS_FATAL_ERROR("CheckThreads needs Threads > 1, without Distributed or a batch");
+        }
+        params.batch = true;
+        return CheckThreads(params, RunScenario);
+    }
+
+    if (params.distributed) {
+#ifdef NS3_MPI
+        GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DistributedSimulatorImpl"));
+        MpiInterface::Enable(&argc, &argv);
+
+        int ret = RunScenario(params);
+
+        MpiInterface::Disable();
+        return ret;
+#else
+        NS_FATAL_ERROR("Distributed mode needs ns-3 configured with --enable-mpi");
+#endif
+    }
+
+    if (batchSeeds.empty()) {
+        return RunScenario(params);
+    }
+
+    vector<string> hasList  = batchHASLogic.empty() ? vector<string>{params.hasAlgorithm} : BatchSplitList(batchHASLogic);
+    vector<string> ctrlList = batchControllers.empty() ? vector<string>{params.controller} : BatchSplitList(batchControllers);
+    vector<string> clientList = batchClients.empty() ? vector<string>{to_string(params.clients)} : BatchSplitList(batchClients);
+    vector<string> tcpList  = batchTcpVariants.empty() ? vector<string>{params.tcpVariant} : BatchSplitList(batchTcpVariants);
+
+    vector<ScenarioParams> grid;
+    for (auto& has : hasList) {
+        for (auto& clients : clientList) {
+            for (auto& ctrl : ctrlList) {
+                for (auto& tcp : tcpList) {
+                    for (auto& seed : BatchParseSeeds(batchSeeds)) {
+                        ScenarioParams p = params;
+                        p.hasAlgorithm = has;
+                        p.clients      = atoi(clients.c_str());
+                        p.controller   = ctrl;
+                        p.tcpVariant   = tcp;
+                        p.seed         = seed;
+                        p.batch        = true;
+                        grid.push_back(p);
+                    }
+                }
+            }
+        }
+    }
+
+    return RunBatch(grid, workers, batchSummary, RunScenario);
+}
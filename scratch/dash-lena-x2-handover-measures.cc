@@ -163,6 +163,9 @@ main (int argc, char *argv[])
   Config::SetDefault ("ns3::UdpClient::Interval", TimeValue (MilliSeconds (10)));
   Config::SetDefault ("ns3::UdpClient::MaxPackets", UintegerValue (1000000));
   Config::SetDefault ("ns3::LteHelper::UseIdealRrc", BooleanValue (true));
+  // the eNBs do not move and the Friis path loss is deterministic: only
+  // the moving UEs need the path loss computed for every transmission
+  Config::SetDefault ("ns3::MultiModelSpectrumChannel::PropagationCache", BooleanValue (true));
 
   // Command line arguments
   CommandLine cmd;
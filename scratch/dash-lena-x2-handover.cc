@@ -124,6 +124,30 @@ ReceivePacket (Ptr<const Packet> packet, const Address &)
   getchar();
 }
 
+// stall ratio and cell throughput, to compare the MAC schedulers
+std::map<unsigned, Time> g_playStart;
+int64_t g_stallMs = 0;
+uint64_t g_cellBytes = 0;
+
+void
+NotifyPlayerSegment (Ptr<Application> app, unsigned userId, unsigned segmentNr, std::string repId,
+                     unsigned bitrate, unsigned freezeTime, unsigned bufferLevel, std::string host)
+{
+  if (g_playStart.find (userId) == g_playStart.end ())
+    {
+      // the freeze time of the first segment is the start-up delay
+      g_playStart[userId] = Simulator::Now ();
+      return;
+    }
+  g_stallMs += freezeTime;
+}
+
+void
+NotifyCellRx (Ptr<Packet> packet)
+{
+  g_cellBytes += packet->GetSize ();
+}
+
 static string Ipv4AddressToString (Ipv4Address ad)
 {
 	ostringstream oss;
@@ -162,6 +186,9 @@ main (int argc, char *argv[])
   double distance = 100.0;
   bool disableDl = false;
   bool disableUl = false;
+  bool mec = false;
+  std::string scheduler = "ns3::RrFfMacScheduler";
+  uint32_t seed = 1;
 
   // change some default attributes so that they are reasonable for
   // this scenario, but do this before processing command line
@@ -169,6 +196,9 @@ main (int argc, char *argv[])
   Config::SetDefault ("ns3::UdpClient::Interval", TimeValue (MilliSeconds (10)));
   Config::SetDefault ("ns3::UdpClient::MaxPackets", UintegerValue (1000000));
   Config::SetDefault ("ns3::LteHelper::UseIdealRrc", BooleanValue (false));
+  // the eNBs do not move and the Friis path loss is deterministic: only
+  // the moving UEs need the path loss computed for every transmission
+  Config::SetDefault ("ns3::MultiModelSpectrumChannel::PropagationCache", BooleanValue (true));
 
   // Command line arguments
   CommandLine cmd;
@@ -177,13 +207,18 @@ main (int argc, char *argv[])
   cmd.AddValue ("simTime", "Total duration of the simulation", simTime);
   cmd.AddValue ("disableDl", "Disable downlink data flows", disableDl);
   cmd.AddValue ("disableUl", "Disable uplink data flows", disableUl);
+  cmd.AddValue ("mec", "Serve the DASH clients from a MEC node at each eNodeB, through a local breakout", mec);
+  cmd.AddValue ("scheduler", "MAC scheduler of the eNodeBs (e.g. ns3::PfFfMacScheduler, ns3::VideoAwareFfMacScheduler)", scheduler);
+  cmd.AddValue ("seed", "Run number of the random number generators", seed);
   cmd.Parse (argc, argv);
 
+  RngSeedManager::SetRun (seed);
+
 
   Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
   Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper> ();
   lteHelper->SetEpcHelper (epcHelper);
-  lteHelper->SetSchedulerType ("ns3::RrFfMacScheduler");
+  lteHelper->SetSchedulerType (scheduler);
   lteHelper->SetHandoverAlgorithmType ("ns3::NoOpHandoverAlgorithm"); // disable automatic handover
 
   Ptr<Node> pgw = epcHelper->GetPgwNode ();
@@ -263,6 +298,36 @@ main (int argc, char *argv[])
   "/content/mpds/", representationStrings, "/content/segments/");
 
   ApplicationContainer serverApps = edgeServerCache.Install(remoteHost);
+
+  // MEC nodes at the eNodeBs: their segments do not cross the S1-U backhaul.
+  // Each UE is served by the MEC node of its cell, and the controller moves
+  // it to the MEC node of the target cell when it is handed over
+  NodeContainer mecNodes;
+  Ptr<ControllerMain> controller;
+  if (mec)
+    {
+      mecNodes.Create (numberOfEnbs);
+      internet.Install (mecNodes);
+      std::vector<std::string> mecAddress;
+      for (uint16_t i = 0; i < numberOfEnbs; i++)
+        {
+          mecAddress.push_back (Ipv4AddressToString (epcHelper->AddMecNode (enbNodes.Get (i), mecNodes.Get (i))));
+
+          EdgeDashServerHelper mecServer(Ipv4Address::GetAny (), dashPort, mecAddress[i],
+          "/content/mpds/", representationStrings, "/content/segments/");
+          serverApps.Add (mecServer.Install (mecNodes.Get (i)));
+        }
+      // the UEs are attached to the first eNodeB
+      strIpv4Server = mecAddress[0];
+
+      controller = CreateObject<ControllerMain> ();
+      remoteHost->AddApplication (controller);
+      controller->Setup (Ipv4Address::GetAny (), 1317, "");
+      controller->setNodeContainers (&mecNodes);
+      controller->setServerTable (&serverTableList);
+      controller->CacheNodes ();
+    }
+
   serverApps.Start (Seconds(0.01));
   serverApps.Stop (Seconds(simTime));
 
@@ -296,7 +361,6 @@ main (int argc, char *argv[])
 
           ApplicationContainer clientApp = player.Install(ue);
 
-          std::string strIpv4Lcl = Ipv4AddressToString(ue->GetObject<Ipv4>()->GetAddress(1,0).GetLocal());
           std::string strIpv4Bst = Ipv4AddressToString(ue->GetObject<Ipv4>()->GetAddress(1,0).GetBroadcast());
 
           Ptr<Application> app = ue->GetApplication(0);
@@ -325,6 +389,13 @@ main (int argc, char *argv[])
     }
 
 
+  // the video-aware scheduler gets the buffer levels of the players
+  if (scheduler == "ns3::VideoAwareFfMacScheduler")
+    {
+      Ptr<VideoAwareSchedulerHelper> videoAwareHelper = CreateObject<VideoAwareSchedulerHelper> ();
+      videoAwareHelper->Install (ueLteDevs, enbLteDevs);
+    }
+
   // Add X2 interface
   lteHelper->AddX2Interface (enbNodes);
 
@@ -358,6 +429,23 @@ main (int argc, char *argv[])
   Config::Connect ("/NodeList/*/DeviceList/*/LteUeRrc/HandoverEndOk",
                    MakeCallback (&NotifyHandoverEndOkUe));
 
+  if (mec)
+    {
+      DashHandoverHelper handoverHelper (controller);
+      for (uint16_t i = 0; i < numberOfEnbs; i++)
+        {
+          handoverHelper.SetCellEdge (enbLteDevs.Get (i)->GetObject<LteEnbNetDevice> ()->GetCellId (), i);
+        }
+      handoverHelper.Install (ueLteDevs);
+    }
+
+  Config::ConnectWithoutContext ("/NodeList/*/ApplicationList/*/$ns3::HttpClientDashApplication::MultimediaConsumer/PlayerTracer",
+                                 MakeCallback (&NotifyPlayerSegment));
+  Config::ConnectWithoutContext ("/NodeList/*/ApplicationList/*/$ns3::EpcEnbApplication/RxFromS1u",
+                                 MakeCallback (&NotifyCellRx));
+  Config::ConnectWithoutContext ("/NodeList/*/ApplicationList/*/$ns3::EpcEnbApplication/RxFromMec",
+                                 MakeCallback (&NotifyCellRx));
+
   //Trace sink for the packet sink of UE
   // std::ostringstream oss;
   // oss << "/NodeList/" << ueNodes.Get (0)->GetId () << "/ApplicationList/0/$ns3::PacketSink/Rx";
@@ -369,6 +457,18 @@ main (int argc, char *argv[])
   Simulator::Stop (simTime + MilliSeconds (20));
   Simulator::Run ();
 
+  Time playTime;
+  for (std::map<unsigned, Time>::iterator it = g_playStart.begin (); it != g_playStart.end (); ++it)
+    {
+      playTime += simTime - it->second;
+    }
+  double stallRatio = playTime.IsStrictlyPositive () ? (g_stallMs / 1000.0) / playTime.GetSeconds () : 0.0;
+  std::cout << "scheduler " << scheduler
+            << " seed " << seed
+            << " stallRatio " << stallRatio
+            << " cellThroughputMbps " << g_cellBytes * 8.0 / simTime.GetSeconds () / 1e6
+            << std::endl;
+
   // GtkConfigStore config;
   // config.ConfigureAttributes ();
 
@@ -0,0 +1,181 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/point-to-point-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DashTraceReplay");
+
+// stall ratio and bitrate of the players
+std::map<unsigned, Time> g_playStart;
+int64_t g_stallMs = 0;
+uint64_t g_bitrateSum = 0;
+uint32_t g_segments = 0;
+
+void
+NotifyPlayerSegment (Ptr<Application> app, unsigned userId, unsigned segmentNr, std::string repId,
+                     unsigned bitrate, unsigned freezeTime, unsigned bufferLevel, std::string host)
+{
+  if (bitrate > 0)
+    {
+      g_bitrateSum += bitrate;
+      g_segments++;
+    }
+  if (g_playStart.find (userId) == g_playStart.end ())
+    {
+      // the freeze time of the first segment is the start-up delay
+      g_playStart[userId] = Simulator::Now ();
+      return;
+    }
+  g_stallMs += freezeTime;
+}
+
+static std::string Ipv4AddressToString (Ipv4Address ad)
+{
+  std::ostringstream oss;
+  ad.Print (oss);
+  return oss.str ();
+}
+
+/**
+ * DASH players behind links replaying capacity traces, e.g. of cellular
+ * networks, instead of simulating their radio stack.  Each player has
+ * its own link to the server, starting at a different position of the
+ * traces.
+ *
+ * ./waf --run "dash-trace-replay --downlink=traces/verizon-lte-driving.down --numberOfClients=4"
+ */
+int
+main (int argc, char *argv[])
+{
+  std::string AdaptationLogicToUse = "dash::player::RateAndBufferBasedAdaptationLogic";
+  std::map<std::pair<std::string, int>, std::string> serverTableList;
+
+  uint16_t numberOfClients = 1;
+  Time simTime = Seconds (60);
+  std::string downlink;
+  std::string uplink;
+  Time offsetStep = Seconds (10);
+  Time delay = MilliSeconds (20);
+  uint32_t seed = 1;
+
+  CommandLine cmd;
+  cmd.AddValue ("numberOfClients", "Number of DASH players", numberOfClients);
+  cmd.AddValue ("simTime", "Total duration of the simulation", simTime);
+  cmd.AddValue ("downlink", "Capacity trace of the server to client direction (Mahimahi or CSV)", downlink);
+  cmd.AddValue ("uplink", "Capacity trace of the client to server direction, the downlink trace if empty", uplink);
+  cmd.AddValue ("offsetStep", "Position in the traces of each player relative to the previous one", offsetStep);
+  cmd.AddValue ("delay", "One way delay of the links, added to the delay of the traces", delay);
+  cmd.AddValue ("seed", "Run number of the random number generators", seed);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_MSG_IF (downlink.empty (), "A downlink capacity trace is needed (--downlink)");
+  if (uplink.empty ())
+    {
+      uplink = downlink;
+    }
+  RngSeedManager::SetRun (seed);
+
+  NodeContainer serverNode;
+  serverNode.Create (1);
+  Ptr<Node> server = serverNode.Get (0);
+  NodeContainer clientNodes;
+  clientNodes.Create (numberOfClients);
+
+  InternetStackHelper internet;
+  internet.Install (serverNode);
+  internet.Install (clientNodes);
+
+  // the traces are loaded once and shared by all the links
+  TraceDrivenHelper traceLinks;
+  traceLinks.SetChannelAttribute ("Delay", TimeValue (delay));
+  Ipv4AddressHelper ipv4h;
+  ipv4h.SetBase ("10.1.0.0", "255.255.255.252");
+  std::vector<Ipv4InterfaceContainer> clientIfaces;
+  for (uint16_t i = 0; i < numberOfClients; i++)
+    {
+      traceLinks.SetDeviceAttribute ("TraceOffset", TimeValue (offsetStep * i));
+      NetDeviceContainer devices = traceLinks.Install (server, clientNodes.Get (i), downlink, uplink);
+      clientIfaces.push_back (ipv4h.Assign (devices));
+      ipv4h.NewNetwork ();
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  int dashPort = 80;
+  std::string representationStrings = "../content/representations/vid1.csv";
+  std::string strIpv4Server = Ipv4AddressToString (clientIfaces[0].GetAddress (0));
+
+  DASHServerHelper edgeServerCache(Ipv4Address::GetAny (), dashPort, strIpv4Server,
+  "/content/mpds/", representationStrings, "/content/segments/");
+
+  ApplicationContainer serverApps = edgeServerCache.Install (server);
+  serverApps.Start (Seconds (0.01));
+  serverApps.Stop (simTime);
+
+  for (uint16_t u = 0; u < numberOfClients; ++u)
+    {
+      Ptr<Node> client = clientNodes.Get (u);
+
+      // each player asks the server on its own link
+      std::string strIpv4Link = Ipv4AddressToString (clientIfaces[u].GetAddress (0));
+      std::stringstream ssMPDURL;
+      ssMPDURL << "http://" << strIpv4Link << "/content/mpds/" << "vid1" << ".mpd.gz";
+
+      DASHHttpClientHelper player(ssMPDURL.str ());
+      player.SetAttribute("AdaptationLogic", StringValue(AdaptationLogicToUse));
+      player.SetAttribute("StartUpDelay", StringValue("4"));
+      player.SetAttribute("ScreenWidth", UintegerValue(1920));
+      player.SetAttribute("ScreenHeight", UintegerValue(1080));
+      player.SetAttribute("UserId", UintegerValue(u));
+      player.SetAttribute("AllowDownscale", BooleanValue(true));
+      player.SetAttribute("AllowUpscale", BooleanValue(true));
+      player.SetAttribute("MaxBufferedSeconds", StringValue("60"));
+
+      ApplicationContainer clientApp = player.Install (client);
+      clientApp.Start (Seconds (0.27));
+      clientApp.Stop (simTime);
+
+      std::string strIpv4Bst = Ipv4AddressToString (client->GetObject<Ipv4> ()->GetAddress (1,0).GetBroadcast ());
+      client->GetApplication (0)->GetObject<HttpClientDashApplication> ()->setServerTableList (&serverTableList);
+      serverTableList[{strIpv4Bst, 1}] = strIpv4Link;
+    }
+
+  Config::ConnectWithoutContext ("/NodeList/*/ApplicationList/*/$ns3::HttpClientDashApplication::MultimediaConsumer/PlayerTracer",
+                                 MakeCallback (&NotifyPlayerSegment));
+
+  Simulator::Stop (simTime + MilliSeconds (20));
+  Simulator::Run ();
+
+  Time playTime;
+  for (std::map<unsigned, Time>::iterator it = g_playStart.begin (); it != g_playStart.end (); ++it)
+    {
+      playTime += simTime - it->second;
+    }
+  double stallRatio = playTime.IsStrictlyPositive () ? (g_stallMs / 1000.0) / playTime.GetSeconds () : 0.0;
+  std::cout << "trace " << downlink
+            << " seed " << seed
+            << " stallRatio " << stallRatio
+            << " meanBitrateKbps " << (g_segments > 0 ? g_bitrateSum / 1000.0 / g_segments : 0.0)
+            << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
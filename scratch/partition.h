@@ -0,0 +1,125 @@
+#ifndef PARTITION_HH_
+#define PARTITION_HH_
+
+#include <vector>
+#include <queue>
+#include <algorithm>
+
+#include "network-topology.h"
+
+
+using namespace std;
+
+// Splits a topology into MPI ranks by subtree. A BFS spanning tree is built
+// from root (the cloud, which also hosts the controller); the nodes above the
+// first level with at least nRanks subtrees stay in rank 0 and every subtree
+// of that level is assigned whole to the least loaded rank, heaviest first.
+// Keeping subtrees whole keeps an AP together with its wifi clients, so only
+// point-to-point backhaul links cross ranks.
+//
+// nodeLoad weights every node (e.g. 1 + clients of the AP); empty means 1.
+vector<uint32_t> PartitionBySubtree(NetworkTopology& network, unsigned root, unsigned nRanks,
+                                    vector<double> nodeLoad = vector<double>())
+{
+    unsigned n = network.getNodes().size();
+    vector<uint32_t> rank(n, 0);
+
+    if (nRanks <= 1 || n == 0) {
+        return rank;
+    }
+    if (nodeLoad.size() < n) {
+        nodeLoad.resize(n, 1.0);
+    }
+
+    vector<vector<unsigned>> adj(n);
+    for (auto& link : network.getLinks()) {
+        adj[link->getSrcId()].push_back(link->getDstId());
+        adj[link->getDstId()].push_back(link->getSrcId());
+    }
+
+    // spanning tree by BFS, nodes kept in BFS order
+    vector<int> parent(n, -1);
+    vector<unsigned> depth(n, 0);
+    vector<unsigned> order;
+    vector<bool> visited(n, false);
+    queue<unsigned> q;
+
+    q.push(root);
+    visited[root] = true;
+    while (!q.empty()) {
+        unsigned u = q.front();
+        q.pop();
+        order.push_back(u);
+
+        for (auto& v : adj[u]) {
+            if (!visited[v]) {
+                visited[v] = true;
+                parent[v]  = u;
+                depth[v]   = depth[u] + 1;
+                q.push(v);
+            }
+        }
+    }
+
+    // load of every subtree, accumulated bottom-up
+    vector<double> subtreeLoad(n, 0.0);
+    for (auto it = order.rbegin(); it != order.rend(); it++) {
+        subtreeLoad[*it] += nodeLoad[*it];
+        if (parent[*it] >= 0) {
+            subtreeLoad[parent[*it]] += subtreeLoad[*it];
+        }
+    }
+
+    // first level with enough subtrees to feed every rank
+    unsigned maxDepth = 0;
+    for (auto& u : order) {
+        maxDepth = max(maxDepth, depth[u]);
+    }
+
+    unsigned cut = maxDepth;
+    for (unsigned d = 1; d <= maxDepth; d++) {
+        unsigned count = 0;
+        for (auto& u : order) {
+            count += depth[u] == d;
+        }
+        if (count >= nRanks) {
+            cut = d;
+            break;
+        }
+    }
+
+    vector<unsigned> subtrees;
+    for (auto& u : order) {
+        if (depth[u] == cut) {
+            subtrees.push_back(u);
+        }
+    }
+    sort(subtrees.begin(), subtrees.end(), [&](unsigned a, unsigned b) {
+        return subtreeLoad[a] > subtreeLoad[b];
+    });
+
+    // rank 0 already holds everything above the cut
+    vector<double> rankLoad(nRanks, 0.0);
+    for (auto& u : order) {
+        if (depth[u] < cut) {
+            rankLoad[0] += nodeLoad[u];
+        }
+    }
+
+    for (auto& s : subtrees) {
+        unsigned target = min_element(rankLoad.begin(), rankLoad.end()) - rankLoad.begin();
+        rank[s] = target;
+        rankLoad[target] += subtreeLoad[s];
+    }
+
+    // BFS order visits parents first, so children inherit the subtree rank
+    for (auto& u : order) {
+        if (depth[u] > cut) {
+            rank[u] = rank[parent[u]];
+        }
+    }
+
+    return rank;
+}
+
+#endif // PARTITION_HH_
@@ -0,0 +1,627 @@
+#ifndef SCENARIO_LOADER_HH_
+#define SCENARIO_LOADER_HH_
+
+#include <string>
+#include <vector>
+#include <set>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "dash-define.h"
+
+
+using namespace std;
+
+// Read-only memory mapping of a whole file.
+class MappedFile
+{
+	public:
+		MappedFile() : data(0), size(0), mtime(0), fd(-1) {}
+		~MappedFile() { Close(); }
+
+		bool Open(const string& path)
+		{
+			Close();
+
+			fd = open(path.c_str(), O_RDONLY);
+			if (fd < 0) {
+				return false;
+			}
+
+			struct stat st;
+			if (fstat(fd, &st) != 0) {
+				Close();
+				return false;
+			}
+			size  = st.st_size;
+			mtime = (int64_t) st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+
+			if (size > 0) {
+				void *addr = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (addr == MAP_FAILED) {
+					Close();
+					return false;
+				}
+				madvise(addr, size, MADV_SEQUENTIAL);
+				data = (const char *) addr;
+			}
+			return true;
+		}
+
+		void Close()
+		{
+			if (data != 0) {
+				munmap((void *) data, size);
+			}
+			if (fd >= 0) {
+				close(fd);
+			}
+			data = 0;
+			size = 0;
+			fd   = -1;
+		}
+
+		const char *data;
+		size_t size;
+		int64_t mtime;
+
+	private:
+		int fd;
+};
+
+// Single pass tokenizer over a mapped scenario file. Fields are separated by
+// blanks or commas, blank lines and lines starting with '#' are skipped.
+// Numbers are converted in place, no per-field string is allocated.
+class ScenarioTokenizer
+{
+	public:
+		ScenarioTokenizer(const char *begin, const char *end)
+			: p(begin), end(end), line(0), inRecord(false) {}
+
+		// Moves to the next record, false at the end of the file.
+		bool NextRecord()
+		{
+			if (inRecord) {
+				SkipLine();
+			}
+			inRecord = false;
+
+			while (p < end) {
+				line++;
+				SkipBlanks();
+				if (p < end && *p != '\n' && *p != '#') {
+					inRecord = true;
+					return true;
+				}
+				SkipLine();
+			}
+			return false;
+		}
+
+		bool EndOfRecord()
+		{
+			SkipSeparators();
+			return p >= end || *p == '\n';
+		}
+
+		bool NextWord(const char *&word, size_t &len)
+		{
+			if (EndOfRecord()) {
+				return false;
+			}
+			word = p;
+			while (p < end && !IsSeparator(*p) && *p != '\n') {
+				p++;
+			}
+			len = p - word;
+			return true;
+		}
+
+		bool NextInt(int &value)
+		{
+			const char *word;
+			size_t len;
+			if (!NextWord(word, len)) {
+				return false;
+			}
+
+			size_t i = 0;
+			bool negative = false;
+			if (word[0] == '-' || word[0] == '+') {
+				negative = word[0] == '-';
+				i++;
+			}
+			if (i == len) {
+				return false;
+			}
+
+			long v = 0;
+			for (; i < len; i++) {
+				if (word[i] < '0' || word[i] > '9') {
+					return false;
+				}
+				v = v * 10 + (word[i] - '0');
+			}
+			value = negative ? -v : v;
+			return true;
+		}
+
+		bool NextDouble(double &value)
+		{
+			const char *word;
+			size_t len;
+			if (!NextWord(word, len) || len >= 64) {
+				return false;
+			}
+
+			// strtod needs a terminated buffer, the mapping is not
+			char buf[64];
+			memcpy(buf, word, len);
+			buf[len] = '\0';
+
+			char *last;
+			value = strtod(buf, &last);
+			return last == buf + len;
+		}
+
+		unsigned Line() { return line; }
+
+	private:
+		static bool IsSeparator(char c) { return c == ' ' || c == '\t' || c == ',' || c == '\r'; }
+
+		void SkipBlanks()
+		{
+			while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+				p++;
+			}
+		}
+
+		void SkipSeparators()
+		{
+			while (p < end && IsSeparator(*p)) {
+				p++;
+			}
+		}
+
+		void SkipLine()
+		{
+			const char *nl = (const char *) memchr(p, '\n', end - p);
+			p = nl ? nl + 1 : end;
+		}
+
+		const char *p;
+		const char *end;
+		unsigned line;
+		bool inRecord;
+};
+
+// Loads nodes, links, requests and routes of a scenario. With useCache set,
+// the parsed records are stored in a compact binary file next to the source
+// (<file>.cache) and later runs map it instead of parsing the text again.
+// The cache is discarded whenever the size or mtime of the source changes.
+class ScenarioLoader
+{
+	public:
+		ScenarioLoader(bool useCache = false) : useCache(useCache) {}
+
+		// id type [AdaptationLogic StartUpDelay AllowDownscale AllowUpscale MaxBufferedSeconds]
+		bool LoadNodes(const string& file, vector<_Node *>& nodes);
+
+		// source destination rate_bps delay_ms pkt_loss buffersize_pkts
+		bool LoadLinks(const string& file, vector<_Link *>& links, int numNodes = -1);
+
+		// [id] source server startsAt stopsAt videoId screenWidth screenHeight
+		bool LoadRequests(const string& file, vector<_Request *>& requests);
+
+		// source destination bw_alloc [hops...]
+		bool LoadRoutes(const string& file, vector<_Route *>& routes);
+
+		// Fills a NetworkTopology like object (AddNode, SetUpAdjList, AddLink).
+		template <class T>
+		bool LoadTopology(const string& linksFile, const string& nodesFile, T& net);
+
+	private:
+		enum Kind { NODES = 1, LINKS, REQUESTS, ROUTES };
+
+		struct CacheHeader {
+			uint32_t magic;
+			uint32_t kind;
+			uint64_t sourceSize;
+			int64_t  sourceMtime;
+			uint64_t count;
+		};
+
+		// binary record buffer, written to / read from the cache
+		class Record {
+			public:
+				template <class V> void Put(V v) { buf.append((const char *) &v, sizeof(v)); }
+				void PutString(const string& s) { Put<uint32_t>(s.size()); buf.append(s); }
+
+				string buf;
+		};
+
+		class Reader {
+			public:
+				Reader(const char *p, const char *end) : p(p), end(end) {}
+
+				template <class V> bool Get(V &v)
+				{
+					if (end - p < (long) sizeof(v)) {
+						return false;
+					}
+					memcpy(&v, p, sizeof(v));
+					p += sizeof(v);
+					return true;
+				}
+
+				bool GetString(string &s)
+				{
+					uint32_t len;
+					if (!Get(len) || end - p < (long) len) {
+						return false;
+					}
+					s.assign(p, len);
+					p += len;
+					return true;
+				}
+
+			private:
+				const char *p;
+				const char *end;
+		};
+
+		bool Error(const string& file, unsigned line, const string& what)
+		{
+			cerr << "ScenarioLoader: " << file << ":" << line << ": " << what << endl;
+			return false;
+		}
+
+		string CacheFile(const string& file) { return file + ".cache"; }
+
+		bool OpenCache(const string& file, const MappedFile& source, Kind kind, MappedFile& cache, uint64_t& count);
+		void WriteCache(const string& file, const MappedFile& source, Kind kind, uint64_t count, const Record& records);
+
+		bool useCache;
+};
+
+bool ScenarioLoader::OpenCache(const string& file, const MappedFile& source, Kind kind, MappedFile& cache, uint64_t& count)
+{
+	if (!useCache || !cache.Open(CacheFile(file)) || cache.size < sizeof(CacheHeader)) {
+		return false;
+	}
+
+	CacheHeader header;
+	memcpy(&header, cache.data, sizeof(header));
+	if (header.magic != 0x4353534e /* NSSC */ || header.kind != (uint32_t) kind
+			|| header.sourceSize != source.size || header.sourceMtime != source.mtime) {
+		cache.Close();
+		return false;
+	}
+
+	count = header.count;
+	return true;
+}
+
+void ScenarioLoader::WriteCache(const string& file, const MappedFile& source, Kind kind, uint64_t count, const Record& records)
+{
+	if (!useCache) {
+		return;
+	}
+
+	CacheHeader header = {0x4353534e, (uint32_t) kind, source.size, source.mtime, count};
+
+	// concurrent runs may load the same scenario, publish the cache atomically
+	string tmp = CacheFile(file) + "." + to_string(getpid());
+	ofstream out(tmp.c_str(), ios::out | ios::binary);
+	out.write((const char *) &header, sizeof(header));
+	out.write(records.buf.data(), records.buf.size());
+	out.close();
+
+	if (!out || rename(tmp.c_str(), CacheFile(file).c_str()) != 0) {
+		unlink(tmp.c_str());
+	}
+}
+
+bool ScenarioLoader::LoadNodes(const string& file, vector<_Node *>& nodes)
+{
+	MappedFile source, cache;
+	uint64_t count;
+
+	if (!source.Open(file)) {
+		return Error(file, 0, "cannot open file");
+	}
+
+	if (OpenCache(file, source, NODES, cache, count)) {
+		Reader in(cache.data + sizeof(CacheHeader), cache.data + cache.size);
+		for (uint64_t i = 0; i < count; i++) {
+			int32_t id;
+			string fields[6];
+			if (!in.Get(id)) {
+				return Error(CacheFile(file), 0, "truncated cache");
+			}
+			for (auto& f : fields) {
+				if (!in.GetString(f)) {
+					return Error(CacheFile(file), 0, "truncated cache");
+				}
+			}
+			nodes.push_back(new _Node(id, fields[0], fields[1], fields[2], fields[3], fields[4], fields[5]));
+		}
+		return true;
+	}
+
+	Record records;
+	set<int> ids;
+	count = 0;
+
+	ScenarioTokenizer tok(source.data, source.data + source.size);
+	while (tok.NextRecord()) {
+		int id;
+		const char *word;
+		size_t len;
+
+		if (!tok.NextInt(id) || !tok.NextWord(word, len)) {
+			return Error(file, tok.Line(), "expected <id> <type>");
+		}
+		if (!ids.insert(id).second) {
+			return Error(file, tok.Line(), "duplicated node id " + to_string(id));
+		}
+
+		// player settings only apply to clients
+		string type(word, len);
+		string fields[5] = {"", "", "no", "no", ""};
+		for (auto& f : fields) {
+			if (!tok.NextWord(word, len)) {
+				break;
+			}
+			if (type == "client") {
+				f.assign(word, len);
+			}
+		}
+
+		nodes.push_back(new _Node(id, type, fields[0], fields[1], fields[2], fields[3], fields[4]));
+
+		records.Put<int32_t>(id);
+		records.PutString(type);
+		for (auto& f : fields) {
+			records.PutString(f);
+		}
+		count++;
+	}
+
+	WriteCache(file, source, NODES, count, records);
+	return true;
+}
+
+bool ScenarioLoader::LoadLinks(const string& file, vector<_Link *>& links, int numNodes)
+{
+	MappedFile source, cache;
+	uint64_t count;
+
+	if (!source.Open(file)) {
+		return Error(file, 0, "cannot open file");
+	}
+
+	if (OpenCache(file, source, LINKS, cache, count)) {
+		Reader in(cache.data + sizeof(CacheHeader), cache.data + cache.size);
+		for (uint64_t i = 0; i < count; i++) {
+			int32_t src, dst, buffer;
+			double rate, delay, ploss;
+			if (!in.Get(src) || !in.Get(dst) || !in.Get(rate) || !in.Get(delay) || !in.Get(ploss) || !in.Get(buffer)) {
+				return Error(CacheFile(file), 0, "truncated cache");
+			}
+			links.push_back(new _Link(src, dst, rate, delay, ploss, buffer));
+		}
+		return true;
+	}
+
+	Record records;
+	count = 0;
+
+	ScenarioTokenizer tok(source.data, source.data + source.size);
+	while (tok.NextRecord()) {
+		int src, dst;
+		double rate, delay, ploss, buffer;
+
+		if (!tok.NextInt(src) || !tok.NextInt(dst) || !tok.NextDouble(rate)
+				|| !tok.NextDouble(delay) || !tok.NextDouble(ploss) || !tok.NextDouble(buffer)) {
+			return Error(file, tok.Line(), "expected <src> <dst> <rate_bps> <delay_ms> <pkt_loss> <buffersize_pkts>");
+		}
+		if (numNodes >= 0 && (src < 0 || src >= numNodes || dst < 0 || dst >= numNodes)) {
+			return Error(file, tok.Line(), "link endpoint out of range");
+		}
+		if (rate <= 0 || delay < 0 || ploss < 0 || ploss > 1 || buffer < 0) {
+			return Error(file, tok.Line(), "invalid link parameters");
+		}
+
+		links.push_back(new _Link(src, dst, rate, delay, ploss, buffer));
+
+		records.Put<int32_t>(src);
+		records.Put<int32_t>(dst);
+		records.Put<double>(rate);
+		records.Put<double>(delay);
+		records.Put<double>(ploss);
+		records.Put<int32_t>(buffer);
+		count++;
+	}
+
+	WriteCache(file, source, LINKS, count, records);
+	return true;
+}
+
+bool ScenarioLoader::LoadRequests(const string& file, vector<_Request *>& requests)
+{
+	MappedFile source, cache;
+	uint64_t count;
+
+	if (!source.Open(file)) {
+		return Error(file, 0, "cannot open file");
+	}
+
+	if (OpenCache(file, source, REQUESTS, cache, count)) {
+		Reader in(cache.data + sizeof(CacheHeader), cache.data + cache.size);
+		for (uint64_t i = 0; i < count; i++) {
+			int32_t id, src, server, video, width, height;
+			double startsAt, stopsAt;
+			if (!in.Get(id) || !in.Get(src) || !in.Get(server) || !in.Get(startsAt) || !in.Get(stopsAt)
+					|| !in.Get(video) || !in.Get(width) || !in.Get(height)) {
+				return Error(CacheFile(file), 0, "truncated cache");
+			}
+			requests.push_back(new _Request(id, src, server, startsAt, stopsAt, video, width, height));
+		}
+		return true;
+	}
+
+	Record records;
+	count = 0;
+
+	ScenarioTokenizer tok(source.data, source.data + source.size);
+	while (tok.NextRecord()) {
+		// without the id column (7 fields) requests are numbered in file order
+		double v[8];
+		unsigned n = 0;
+		while (n < 8 && tok.NextDouble(v[n])) {
+			n++;
+		}
+		if ((n != 7 && n != 8) || !tok.EndOfRecord()) {
+			return Error(file, tok.Line(), "expected [id] <src> <server> <startsAt> <stopsAt> <videoId> <screenWidth> <screenHeight>");
+		}
+
+		double *f = (n == 8) ? v + 1 : v;
+		int id = (n == 8) ? (int) v[0] : (int) count;
+		if (f[3] < f[2]) {
+			return Error(file, tok.Line(), "request stops before it starts");
+		}
+
+		requests.push_back(new _Request(id, f[0], f[1], f[2], f[3], f[4], f[5], f[6]));
+
+		records.Put<int32_t>(id);
+		records.Put<int32_t>(f[0]);
+		records.Put<int32_t>(f[1]);
+		records.Put<double>(f[2]);
+		records.Put<double>(f[3]);
+		records.Put<int32_t>(f[4]);
+		records.Put<int32_t>(f[5]);
+		records.Put<int32_t>(f[6]);
+		count++;
+	}
+
+	WriteCache(file, source, REQUESTS, count, records);
+	return true;
+}
+
+bool ScenarioLoader::LoadRoutes(const string& file, vector<_Route *>& routes)
+{
+	MappedFile source, cache;
+	uint64_t count;
+
+	if (!source.Open(file)) {
+		return Error(file, 0, "cannot open file");
+	}
+
+	vector<int> hops;
+
+	if (OpenCache(file, source, ROUTES, cache, count)) {
+		Reader in(cache.data + sizeof(CacheHeader), cache.data + cache.size);
+		for (uint64_t i = 0; i < count; i++) {
+			int32_t src, dst;
+			double bw;
+			uint32_t nhops;
+			if (!in.Get(src) || !in.Get(dst) || !in.Get(bw) || !in.Get(nhops)) {
+				return Error(CacheFile(file), 0, "truncated cache");
+			}
+			hops.resize(nhops);
+			for (auto& h : hops) {
+				int32_t hop;
+				if (!in.Get(hop)) {
+					return Error(CacheFile(file), 0, "truncated cache");
+				}
+				h = hop;
+			}
+			routes.push_back(new _Route(src, dst, bw, hops));
+		}
+		return true;
+	}
+
+	Record records;
+	count = 0;
+
+	ScenarioTokenizer tok(source.data, source.data + source.size);
+	while (tok.NextRecord()) {
+		int src, dst, hop;
+		double bw;
+
+		if (!tok.NextInt(src) || !tok.NextInt(dst) || !tok.NextDouble(bw)) {
+			return Error(file, tok.Line(), "expected <src> <dst> <bw_alloc> [hops...]");
+		}
+
+		// the path always starts at src and ends at dst
+		hops.clear();
+		hops.push_back(src);
+		while (tok.NextInt(hop)) {
+			hops.push_back(hop);
+		}
+		if (!tok.EndOfRecord()) {
+			return Error(file, tok.Line(), "invalid hop");
+		}
+		hops.push_back(dst);
+
+		routes.push_back(new _Route(src, dst, bw, hops));
+
+		records.Put<int32_t>(src);
+		records.Put<int32_t>(dst);
+		records.Put<double>(bw);
+		records.Put<uint32_t>(hops.size());
+		for (auto& h : hops) {
+			records.Put<int32_t>(h);
+		}
+		count++;
+	}
+
+	WriteCache(file, source, ROUTES, count, records);
+	return true;
+}
+
+template <class T>
+bool ScenarioLoader::LoadTopology(const string& linksFile, const string& nodesFile, T& net)
+{
+	vector<_Node *> nodes;
+	vector<_Link *> links;
+
+	if (!LoadNodes(nodesFile, nodes)) {
+		return false;
+	}
+
+	// node ids index the node containers of the scenarios
+	for (unsigned i = 0; i < nodes.size(); i++) {
+		if (nodes[i]->getId() < 0 || nodes[i]->getId() >= (int) nodes.size()) {
+			return Error(nodesFile, 0, "node ids must be 0.." + to_string(nodes.size() - 1));
+		}
+	}
+
+	if (!LoadLinks(linksFile, links, nodes.size())) {
+		return false;
+	}
+
+	for (auto& node : nodes) {
+		net.AddNode(node->getId(), node->getType());
+		delete node;
+	}
+	net.SetUpAdjList(nodes.size());
+
+	for (auto& link : links) {
+		net.AddLink(link->getSrcId(), link->getDstId(), link->getRate(), link->getDelay(), link->getPLoss(), link->getBufferSize());
+		delete link;
+	}
+
+	return true;
+}
+
+#endif // SCENARIO_LOADER_HH_
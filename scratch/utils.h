@@ -3,6 +3,7 @@
 
 #include "ns3/internet-module.h"
 #include "ns3/string.h"
+#include "ns3/system-path.h"
 
 
 #include <string>
@@ -37,9 +38,8 @@ string GetCurrentWorkingDir(void)
 
 string CreateDir(string name)
 {
-	if(system(string(string("mkdir -p ") + name).c_str()) != -1)
-		return name;
-    return "";
+	SystemPath::MakeDirectories(name);
+	return name;
 }
 
 vector<string> str_split(const string& s, const string& delimiter, const bool& removeEmptyEntries = false)
@@ -63,118 +63,10 @@ vector<string> str_split(const string& s, const string& delimiter, const bool& r
     return tokens;
 }
 
-template <typename T>
-bool ReadTopology(string linksFile, string nodesFile, T &net)
+template <class T>
+bool ReadTopology(string linksFile, string nodesFile, T &net, bool useCache = false)
 {
-	// node data
-    int id;
-    string type;
-    int n=0;
-    int linecount = 0;
-
-    ifstream nodes_file(nodesFile.c_str());
-    linecount = 0;
-    while (nodes_file) {
-        string line;
-        linecount++;
-        if (!getline(nodes_file, line)) {
-           break;
-        }
-
-        cout << line << endl;
-
-        if (linecount > 1) {
-            // Get each element of the demand
-            istringstream linestream( line );
-            int columncount = 1;
-            while (linestream) {
-                string s;
-                if (!getline(linestream, s, ' ')) {
-                    break;
-                }
-                switch (columncount) {
-                    case 1:
-                        id = std::atoi(s.c_str());
-                        break;
-                    case 2:
-                        type = s;
-                        break;
-                }
-                columncount++;
-            }
-            net.AddNode(id, type);
-            n++;
-        }
-    }
-    nodes_file.close();
-
-    net.SetUpAdjList(n);
-
-
-    ifstream links_file(linksFile.c_str());
-
-    // link data
-    int src_id;
-    int dst_id;
-    double rate;
-    double delay;
-    double ploss;
-    double buffersize_pkts;
-
-    while (links_file) {
-        string line;
-        linecount++;
-
-        if (!getline(links_file, line)) {
-            break;
-        }
-        if (line == "\n") {
-            break;
-        }
-
-        cout << line << endl;
-
-    	if (linecount > 1) {
-            istringstream linestream(line);
-            int columncount = 1;
-            while (linestream) {
-                string str;
-
-                if (!getline(linestream, str, ' ')) {
-                    break;
-                }
-
-                switch (columncount) {
-                    case 1:
-                        src_id = atoi(str.c_str());
-                        break;
-                    case 2:
-                        dst_id = atoi(str.c_str());
-                        break;
-                    case 3:
-                        rate = atof(str.c_str());
-                        break;
-                    case 4:
-                        delay = atof(str.c_str());
-                        break;
-                    case 5:
-                        ploss = atof(str.c_str());
-                        break;
-                    case 6:
-                        buffersize_pkts = atof(str.c_str());
-                        break;
-                }
-                columncount++;
-            }
-            net.AddLink(src_id, dst_id, rate, delay, ploss, buffersize_pkts);
-        }
-    }
-    links_file.close();
-
-//	net.printAdjList();
-//	getchar();
-
-    return true;
+    return ScenarioLoader(useCache).LoadTopology(linksFile, nodesFile, net);
 }
 
 std::vector< double > sum_probs;
@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "access-link-helper.h"
+
+#include "ns3/access-link-channel.h"
+#include "ns3/access-link-net-device.h"
+#include "ns3/log.h"
+#include "ns3/mac48-address.h"
+#include "ns3/node.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AccessLinkHelper");
+
+AccessLinkHelper::AccessLinkHelper ()
+{
+  m_deviceFactory.SetTypeId ("ns3::AccessLinkNetDevice");
+  m_channelFactory.SetTypeId ("ns3::AccessLinkChannel");
+}
+
+void
+AccessLinkHelper::SetDeviceAttribute (std::string n1, const AttributeValue &v1)
+{
+  m_deviceFactory.Set (n1, v1);
+}
+
+void
+AccessLinkHelper::SetChannelAttribute (std::string n1, const AttributeValue &v1)
+{
+  m_channelFactory.Set (n1, v1);
+}
+
+NetDeviceContainer
+AccessLinkHelper::Install (Ptr<Node> ap, NodeContainer stations)
+{
+  NS_LOG_FUNCTION (this << ap);
+
+  Ptr<AccessLinkChannel> channel = m_channelFactory.Create<AccessLinkChannel> ();
+  NetDeviceContainer devices;
+
+  // the AP must be the first device attached to the channel
+  for (uint32_t i = 0; i <= stations.GetN (); i++)
+    {
+      Ptr<NetDevice> device = InstallDevice (i == 0 ? ap : stations.Get (i - 1));
+      device->GetObject<AccessLinkNetDevice> ()->SetChannel (channel);
+      devices.Add (device);
+    }
+  return devices;
+}
+
+Ptr<NetDevice>
+AccessLinkHelper::InstallDevice (Ptr<Node> node)
+{
+  Ptr<AccessLinkNetDevice> device = m_deviceFactory.Create<AccessLinkNetDevice> ();
+  device->SetAddress (Mac48Address::Allocate ());
+  node->AddDevice (device);
+  return device;
+}
+
+} // namespace ns3
@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef ACCESS_LINK_HELPER_H
+#define ACCESS_LINK_HELPER_H
+
+#include <string>
+
+#include "ns3/object-factory.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node-container.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup access-link
+ * \brief Build an access cell (AccessLinkChannel) with an AP and its stations.
+ */
+class AccessLinkHelper
+{
+public:
+  AccessLinkHelper ();
+
+  /**
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set
+   *
+   * Set these attributes on each ns3::AccessLinkNetDevice created
+   * by AccessLinkHelper::Install
+   */
+  void SetDeviceAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set
+   *
+   * Set these attributes on each ns3::AccessLinkChannel created
+   * by AccessLinkHelper::Install
+   */
+  void SetChannelAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * \param ap the access point node
+   * \param stations the station nodes
+   * \return the devices, the AP device first
+   *
+   * Creates one channel, and attaches one device of the AP and one device of
+   * every station to it.
+   */
+  NetDeviceContainer Install (Ptr<Node> ap, NodeContainer stations);
+
+private:
+  /**
+   * \param node the node
+   * \return a new device installed on the node
+   */
+  Ptr<NetDevice> InstallDevice (Ptr<Node> node);
+
+  ObjectFactory m_channelFactory;       //!< Channel Factory
+  ObjectFactory m_deviceFactory;        //!< Device Factory
+};
+
+} // namespace ns3
+
+#endif /* ACCESS_LINK_HELPER_H */
@@ -0,0 +1,276 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "access-link-channel.h"
+#include "access-link-net-device.h"
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/trace-source-accessor.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AccessLinkChannel");
+
+NS_OBJECT_ENSURE_REGISTERED (AccessLinkChannel);
+
+TypeId
+AccessLinkChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AccessLinkChannel")
+    .SetParent<Channel> ()
+    .SetGroupName ("AccessLink")
+    .AddConstructor<AccessLinkChannel> ()
+    .AddAttribute ("DataRate", "Aggregate capacity shared by the stations of the cell",
+                   DataRateValue (DataRate ("54Mbps")),
+                   MakeDataRateAccessor (&AccessLinkChannel::m_dataRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("Delay", "Access delay added after every transmission",
+                   TimeValue (MilliSeconds (2)),
+                   MakeTimeAccessor (&AccessLinkChannel::m_delay),
+                   MakeTimeChecker ())
+    .AddAttribute ("Quantum", "Deficit round robin quantum, in bytes",
+                   UintegerValue (1500),
+                   MakeUintegerAccessor (&AccessLinkChannel::m_quantum),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxFlowSize", "Maximum number of packets queued per station",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&AccessLinkChannel::m_maxFlowSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddTraceSource ("Drop", "A packet was dropped because the queue of its station was full",
+                     MakeTraceSourceAccessor (&AccessLinkChannel::m_dropTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+AccessLinkChannel::AccessLinkChannel ()
+  : m_busy (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+AccessLinkChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_wakeup.Cancel ();
+  m_devices.clear ();
+  m_flows.clear ();
+  m_active.clear ();
+  Channel::DoDispose ();
+}
+
+void
+AccessLinkChannel::Attach (Ptr<AccessLinkNetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  m_index[Mac48Address::ConvertFrom (device->GetAddress ())] = m_devices.size ();
+  m_devices.push_back (device);
+
+  Flow flow;
+  flow.deficit = 0;
+  flow.nextEligible = Seconds (0);
+  flow.active = false;
+  m_flows.push_back (flow);
+}
+
+Ptr<AccessLinkNetDevice>
+AccessLinkChannel::GetAccessPoint (void) const
+{
+  return m_devices.empty () ? 0 : m_devices[0];
+}
+
+bool
+AccessLinkChannel::Send (Ptr<Packet> p, uint16_t protocol, Mac48Address to, Mac48Address from,
+                         Ptr<AccessLinkNetDevice> sender)
+{
+  NS_LOG_FUNCTION (this << p << protocol << to << from << sender);
+
+  // uplink frames belong to their sender, downlink frames to their
+  // destination; AP broadcasts use the flow of the AP itself
+  std::map<Mac48Address, uint32_t>::const_iterator senderIt =
+    m_index.find (Mac48Address::ConvertFrom (sender->GetAddress ()));
+  NS_ASSERT_MSG (senderIt != m_index.end (), "Device " << sender << " is not attached to this channel");
+  uint32_t flowId = senderIt->second;
+  if (flowId == 0)
+    {
+      std::map<Mac48Address, uint32_t>::const_iterator it = m_index.find (to);
+      if (it != m_index.end ())
+        {
+          flowId = it->second;
+        }
+    }
+
+  Flow &flow = m_flows[flowId];
+  if (flow.queue.size () >= m_maxFlowSize)
+    {
+      NS_LOG_LOGIC ("flow " << flowId << " full, dropping " << p);
+      m_dropTrace (p);
+      return false;
+    }
+
+  Item item;
+  item.packet = p;
+  item.protocol = protocol;
+  item.to = to;
+  item.from = from;
+  item.sender = sender;
+  flow.queue.push_back (item);
+
+  if (!flow.active)
+    {
+      flow.active = true;
+      flow.deficit = 0;
+      m_active.push_back (flowId);
+    }
+
+  TryTransmit ();
+  return true;
+}
+
+void
+AccessLinkChannel::TryTransmit (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_busy)
+    {
+      return;
+    }
+
+  Time now = Simulator::Now ();
+  Time wakeup = Time::Max ();
+  std::size_t skipped = 0;
+
+  while (!m_active.empty () && skipped < m_active.size ())
+    {
+      uint32_t flowId = m_active.front ();
+      Flow &flow = m_flows[flowId];
+
+      if (flow.nextEligible > now)
+        {
+          // station above its own rate, give the turn away
+          wakeup = std::min (wakeup, flow.nextEligible);
+          m_active.splice (m_active.end (), m_active, m_active.begin ());
+          skipped++;
+          continue;
+        }
+      skipped = 0;
+
+      Item item = flow.queue.front ();
+      uint32_t size = item.packet->GetSize ();
+      if (flow.deficit < size)
+        {
+          flow.deficit += m_quantum;
+          m_active.splice (m_active.end (), m_active, m_active.begin ());
+          continue;
+        }
+
+      flow.deficit -= size;
+      flow.queue.pop_front ();
+      if (flow.queue.empty ())
+        {
+          flow.active = false;
+          flow.deficit = 0;
+          m_active.pop_front ();
+        }
+
+      DataRate cap = m_devices[flowId]->GetDataRate ();
+      if (flowId != 0 && cap.GetBitRate () > 0)
+        {
+          // credit back up to one packet of lateness, so that waiting for
+          // the other stations does not push the station below its cap
+          Time txTime = cap.CalculateBytesTxTime (size);
+          flow.nextEligible = std::max (flow.nextEligible, now - txTime) + txTime;
+        }
+
+      item.sender->NotifyTx (item.packet);
+
+      m_busy = true;
+      Simulator::Schedule (m_dataRate.CalculateBytesTxTime (size),
+                           &AccessLinkChannel::TransmitComplete, this, item);
+      return;
+    }
+
+  // every backlogged station is rate capped, wait for the first to become eligible
+  if (!m_active.empty ())
+    {
+      m_wakeup.Cancel ();
+      m_wakeup = Simulator::Schedule (wakeup - now, &AccessLinkChannel::TryTransmit, this);
+    }
+}
+
+void
+AccessLinkChannel::TransmitComplete (Item item)
+{
+  NS_LOG_FUNCTION (this << item.packet);
+  m_busy = false;
+
+  Deliver (item);
+  TryTransmit ();
+}
+
+void
+AccessLinkChannel::Deliver (const Item &item)
+{
+  if (item.to.IsBroadcast () || item.to.IsGroup ())
+    {
+      for (std::size_t i = 0; i < m_devices.size (); i++)
+        {
+          Ptr<AccessLinkNetDevice> device = m_devices[i];
+          if (device == item.sender)
+            {
+              continue;
+            }
+          Simulator::ScheduleWithContext (device->GetNode ()->GetId (), m_delay,
+                                          &AccessLinkNetDevice::Receive, device,
+                                          item.packet->Copy (), item.protocol, item.to, item.from);
+        }
+      return;
+    }
+
+  std::map<Mac48Address, uint32_t>::const_iterator it = m_index.find (item.to);
+  if (it == m_index.end ())
+    {
+      NS_LOG_LOGIC ("no device for " << item.to << ", dropping");
+      return;
+    }
+
+  Ptr<AccessLinkNetDevice> device = m_devices[it->second];
+  Simulator::ScheduleWithContext (device->GetNode ()->GetId (), m_delay,
+                                  &AccessLinkNetDevice::Receive, device,
+                                  item.packet, item.protocol, item.to, item.from);
+}
+
+std::size_t
+AccessLinkChannel::GetNDevices (void) const
+{
+  return m_devices.size ();
+}
+
+Ptr<NetDevice>
+AccessLinkChannel::GetDevice (std::size_t i) const
+{
+  return m_devices[i];
+}
+
+} // namespace ns3
@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef ACCESS_LINK_CHANNEL_H
+#define ACCESS_LINK_CHANNEL_H
+
+#include <deque>
+#include <list>
+#include <map>
+#include <vector>
+
+#include "ns3/channel.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/mac48-address.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+class AccessLinkNetDevice;
+class Packet;
+
+/**
+ * \ingroup access-link
+ * \brief Shared-capacity access network (one AP cell) without a PHY/MAC model.
+ *
+ * The first attached device is the access point, the others are stations.
+ * Every station owns one flow, holding both its uplink and its downlink
+ * packets. The channel serves one packet at a time at the aggregate
+ * DataRate. Backlogged flows are served by deficit round robin, and a
+ * station is not served again before its own DataRate allows. Delivery
+ * happens Delay after the end of the transmission.
+ *
+ * This keeps the access bottleneck of a wifi or LTE cell at the cost of
+ * two events per packet, independently of the number of stations.
+ */
+class AccessLinkChannel : public Channel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  AccessLinkChannel ();
+
+  /**
+   * \brief Attach a device, the first one is the access point
+   * \param device the device
+   */
+  void Attach (Ptr<AccessLinkNetDevice> device);
+
+  /**
+   * \brief Queue a packet in the flow of the station involved
+   * \param p packet
+   * \param protocol protocol number
+   * \param to destination address
+   * \param from source address
+   * \param sender sender device
+   * \return false if the flow queue is full and the packet was dropped
+   */
+  bool Send (Ptr<Packet> p, uint16_t protocol, Mac48Address to, Mac48Address from,
+             Ptr<AccessLinkNetDevice> sender);
+
+  /**
+   * \return the access point of this channel
+   */
+  Ptr<AccessLinkNetDevice> GetAccessPoint (void) const;
+
+  // inherited from ns3::Channel
+  virtual std::size_t GetNDevices (void) const;
+  virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// A queued frame
+  struct Item
+  {
+    Ptr<Packet> packet;                 //!< the packet
+    uint16_t protocol;                  //!< protocol number
+    Mac48Address to;                    //!< destination
+    Mac48Address from;                  //!< source
+    Ptr<AccessLinkNetDevice> sender;    //!< sender device
+  };
+
+  /// Per-station flow
+  struct Flow
+  {
+    std::deque<Item> queue;             //!< backlog
+    uint32_t deficit;                   //!< DRR deficit (bytes)
+    Time nextEligible;                  //!< earliest service allowed by the station rate cap
+    bool active;                        //!< flow is in the round robin list
+  };
+
+  /// Start the next transmission if the channel is idle
+  void TryTransmit (void);
+
+  /**
+   * \brief End of a transmission
+   * \param item the transmitted frame
+   */
+  void TransmitComplete (Item item);
+
+  /**
+   * \brief Hand a frame to its receiver(s)
+   * \param item the frame
+   */
+  void Deliver (const Item &item);
+
+  DataRate m_dataRate;      //!< aggregate capacity of the cell
+  Time m_delay;             //!< propagation and access delay
+  uint32_t m_quantum;       //!< DRR quantum (bytes)
+  uint32_t m_maxFlowSize;   //!< maximum packets queued per station
+
+  std::vector<Ptr<AccessLinkNetDevice> > m_devices;            //!< m_devices[0] is the AP
+  std::map<Mac48Address, uint32_t> m_index;                    //!< device index by address
+  std::vector<Flow> m_flows;                                   //!< flow of each station
+  std::list<uint32_t> m_active;                                //!< backlogged flows
+  bool m_busy;                                                 //!< transmission in progress
+  EventId m_wakeup;                                            //!< wait for a rate capped flow
+
+  TracedCallback<Ptr<const Packet> > m_dropTrace;              //!< flow queue overflow
+};
+
+} // namespace ns3
+
+#endif /* ACCESS_LINK_CHANNEL_H */
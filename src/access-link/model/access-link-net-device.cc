@@ -0,0 +1,316 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "access-link-net-device.h"
+#include "access-link-channel.h"
+
+#include "ns3/error-model.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/uinteger.h"
+#include "ns3/trace-source-accessor.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AccessLinkNetDevice");
+
+NS_OBJECT_ENSURE_REGISTERED (AccessLinkNetDevice);
+
+TypeId
+AccessLinkNetDevice::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AccessLinkNetDevice")
+    .SetParent<NetDevice> ()
+    .SetGroupName ("AccessLink")
+    .AddConstructor<AccessLinkNetDevice> ()
+    .AddAttribute ("Mtu", "The MAC-level Maximum Transmission Unit",
+                   UintegerValue (1500),
+                   MakeUintegerAccessor (&AccessLinkNetDevice::SetMtu,
+                                         &AccessLinkNetDevice::GetMtu),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("DataRate", "Rate cap of a station (zero means no cap, ignored for the AP)",
+                   DataRateValue (DataRate (0)),
+                   MakeDataRateAccessor (&AccessLinkNetDevice::m_dataRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("ReceiveErrorModel", "The receiver error model used to simulate packet loss",
+                   PointerValue (),
+                   MakePointerAccessor (&AccessLinkNetDevice::m_receiveErrorModel),
+                   MakePointerChecker<ErrorModel> ())
+    .AddTraceSource ("MacTx", "A packet starts its transmission on the channel",
+                     MakeTraceSourceAccessor (&AccessLinkNetDevice::m_macTxTrace),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("MacTxDrop", "A packet was dropped because the station queue was full",
+                     MakeTraceSourceAccessor (&AccessLinkNetDevice::m_macTxDropTrace),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("MacRx", "A packet was received and passed up",
+                     MakeTraceSourceAccessor (&AccessLinkNetDevice::m_macRxTrace),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("PhyRxDrop", "A packet was dropped by the receive error model",
+                     MakeTraceSourceAccessor (&AccessLinkNetDevice::m_phyRxDropTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+AccessLinkNetDevice::AccessLinkNetDevice ()
+  : m_node (0),
+    m_mtu (1500),
+    m_ifIndex (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+AccessLinkNetDevice::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_channel = 0;
+  m_node = 0;
+  m_receiveErrorModel = 0;
+  NetDevice::DoDispose ();
+}
+
+void
+AccessLinkNetDevice::SetChannel (Ptr<AccessLinkChannel> channel)
+{
+  NS_LOG_FUNCTION (this << channel);
+  m_channel = channel;
+  m_channel->Attach (this);
+  m_linkChangeCallbacks ();
+}
+
+void
+AccessLinkNetDevice::Receive (Ptr<Packet> packet, uint16_t protocol, Mac48Address to, Mac48Address from)
+{
+  NS_LOG_FUNCTION (this << packet << protocol << to << from);
+
+  if (m_receiveErrorModel && m_receiveErrorModel->IsCorrupt (packet))
+    {
+      m_phyRxDropTrace (packet);
+      return;
+    }
+
+  NetDevice::PacketType packetType;
+  if (to == m_address)
+    {
+      packetType = NetDevice::PACKET_HOST;
+    }
+  else if (to.IsBroadcast ())
+    {
+      packetType = NetDevice::PACKET_BROADCAST;
+    }
+  else if (to.IsGroup ())
+    {
+      packetType = NetDevice::PACKET_MULTICAST;
+    }
+  else
+    {
+      packetType = NetDevice::PACKET_OTHERHOST;
+    }
+
+  if (packetType != NetDevice::PACKET_OTHERHOST)
+    {
+      m_macRxTrace (packet);
+      m_rxCallback (this, packet, protocol, from);
+    }
+
+  if (!m_promiscCallback.IsNull ())
+    {
+      m_promiscCallback (this, packet, protocol, from, to, packetType);
+    }
+}
+
+DataRate
+AccessLinkNetDevice::GetDataRate (void) const
+{
+  return m_dataRate;
+}
+
+void
+AccessLinkNetDevice::NotifyTxDrop (Ptr<const Packet> packet)
+{
+  m_macTxDropTrace (packet);
+}
+
+void
+AccessLinkNetDevice::NotifyTx (Ptr<const Packet> packet)
+{
+  m_macTxTrace (packet);
+}
+
+void
+AccessLinkNetDevice::SetIfIndex (const uint32_t index)
+{
+  m_ifIndex = index;
+}
+
+uint32_t
+AccessLinkNetDevice::GetIfIndex (void) const
+{
+  return m_ifIndex;
+}
+
+Ptr<Channel>
+AccessLinkNetDevice::GetChannel (void) const
+{
+  return m_channel;
+}
+
+void
+AccessLinkNetDevice::SetAddress (Address address)
+{
+  m_address = Mac48Address::ConvertFrom (address);
+}
+
+Address
+AccessLinkNetDevice::GetAddress (void) const
+{
+  return m_address;
+}
+
+bool
+AccessLinkNetDevice::SetMtu (const uint16_t mtu)
+{
+  m_mtu = mtu;
+  return true;
+}
+
+uint16_t
+AccessLinkNetDevice::GetMtu (void) const
+{
+  return m_mtu;
+}
+
+bool
+AccessLinkNetDevice::IsLinkUp (void) const
+{
+  return m_channel != 0;
+}
+
+void
+AccessLinkNetDevice::AddLinkChangeCallback (Callback<void> callback)
+{
+  m_linkChangeCallbacks.ConnectWithoutContext (callback);
+}
+
+bool
+AccessLinkNetDevice::IsBroadcast (void) const
+{
+  return true;
+}
+
+Address
+AccessLinkNetDevice::GetBroadcast (void) const
+{
+  return Mac48Address ("ff:ff:ff:ff:ff:ff");
+}
+
+bool
+AccessLinkNetDevice::IsMulticast (void) const
+{
+  return true;
+}
+
+Address
+AccessLinkNetDevice::GetMulticast (Ipv4Address multicastGroup) const
+{
+  return Mac48Address::GetMulticast (multicastGroup);
+}
+
+Address
+AccessLinkNetDevice::GetMulticast (Ipv6Address addr) const
+{
+  return Mac48Address::GetMulticast (addr);
+}
+
+bool
+AccessLinkNetDevice::IsPointToPoint (void) const
+{
+  return false;
+}
+
+bool
+AccessLinkNetDevice::IsBridge (void) const
+{
+  return false;
+}
+
+bool
+AccessLinkNetDevice::Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << packet << dest << protocolNumber);
+  return SendFrom (packet, m_address, dest, protocolNumber);
+}
+
+bool
+AccessLinkNetDevice::SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << packet << source << dest << protocolNumber);
+
+  if (packet->GetSize () > GetMtu () || m_channel == 0)
+    {
+      m_macTxDropTrace (packet);
+      return false;
+    }
+
+  if (!m_channel->Send (packet, protocolNumber, Mac48Address::ConvertFrom (dest),
+                        Mac48Address::ConvertFrom (source), this))
+    {
+      m_macTxDropTrace (packet);
+      return false;
+    }
+  return true;
+}
+
+Ptr<Node>
+AccessLinkNetDevice::GetNode (void) const
+{
+  return m_node;
+}
+
+void
+AccessLinkNetDevice::SetNode (Ptr<Node> node)
+{
+  m_node = node;
+}
+
+bool
+AccessLinkNetDevice::NeedsArp (void) const
+{
+  return true;
+}
+
+void
+AccessLinkNetDevice::SetReceiveCallback (NetDevice::ReceiveCallback cb)
+{
+  m_rxCallback = cb;
+}
+
+void
+AccessLinkNetDevice::SetPromiscReceiveCallback (PromiscReceiveCallback cb)
+{
+  m_promiscCallback = cb;
+}
+
+bool
+AccessLinkNetDevice::SupportsSendFrom (void) const
+{
+  return true;
+}
+
+} // namespace ns3
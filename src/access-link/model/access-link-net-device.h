@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef ACCESS_LINK_NET_DEVICE_H
+#define ACCESS_LINK_NET_DEVICE_H
+
+#include <stdint.h>
+
+#include "ns3/data-rate.h"
+#include "ns3/mac48-address.h"
+#include "ns3/net-device.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+class AccessLinkChannel;
+class ErrorModel;
+class Node;
+
+/**
+ * \ingroup access-link
+ * \brief Device of an AccessLinkChannel, either its access point or a station.
+ *
+ * Frames are queued in the channel, which does the scheduling. The DataRate
+ * of a station caps its share of the cell, it is ignored for the AP.
+ */
+class AccessLinkNetDevice : public NetDevice
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  AccessLinkNetDevice ();
+
+  /**
+   * \brief Attach the device to a channel
+   * \param channel the channel
+   */
+  void SetChannel (Ptr<AccessLinkChannel> channel);
+
+  /**
+   * \brief Receive a frame from the channel
+   * \param packet the packet
+   * \param protocol protocol number
+   * \param to destination address
+   * \param from source address
+   */
+  void Receive (Ptr<Packet> packet, uint16_t protocol, Mac48Address to, Mac48Address from);
+
+  /**
+   * \return the station rate cap (zero means no cap)
+   */
+  DataRate GetDataRate (void) const;
+
+  /**
+   * \brief Called by the channel when a frame of this device is dropped
+   * \param packet the packet
+   */
+  void NotifyTxDrop (Ptr<const Packet> packet);
+
+  /**
+   * \brief Called by the channel when a frame of this device starts its transmission
+   * \param packet the packet
+   */
+  void NotifyTx (Ptr<const Packet> packet);
+
+  // inherited from NetDevice base class.
+  virtual void SetIfIndex (const uint32_t index);
+  virtual uint32_t GetIfIndex (void) const;
+  virtual Ptr<Channel> GetChannel (void) const;
+  virtual void SetAddress (Address address);
+  virtual Address GetAddress (void) const;
+  virtual bool SetMtu (const uint16_t mtu);
+  virtual uint16_t GetMtu (void) const;
+  virtual bool IsLinkUp (void) const;
+  virtual void AddLinkChangeCallback (Callback<void> callback);
+  virtual bool IsBroadcast (void) const;
+  virtual Address GetBroadcast (void) const;
+  virtual bool IsMulticast (void) const;
+  virtual Address GetMulticast (Ipv4Address multicastGroup) const;
+  virtual Address GetMulticast (Ipv6Address addr) const;
+  virtual bool IsPointToPoint (void) const;
+  virtual bool IsBridge (void) const;
+  virtual bool Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber);
+  virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber);
+  virtual Ptr<Node> GetNode (void) const;
+  virtual void SetNode (Ptr<Node> node);
+  virtual bool NeedsArp (void) const;
+  virtual void SetReceiveCallback (NetDevice::ReceiveCallback cb);
+  virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
+  virtual bool SupportsSendFrom (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  Ptr<AccessLinkChannel> m_channel;                   //!< the channel
+  NetDevice::ReceiveCallback m_rxCallback;            //!< receive callback
+  NetDevice::PromiscReceiveCallback m_promiscCallback; //!< promiscuous receive callback
+  Ptr<Node> m_node;                                   //!< node of this device
+  uint16_t m_mtu;                                     //!< MTU
+  uint32_t m_ifIndex;                                 //!< interface index
+  Mac48Address m_address;                             //!< MAC address
+  DataRate m_dataRate;                                //!< station rate cap
+  Ptr<ErrorModel> m_receiveErrorModel;                //!< receive error model
+
+  TracedCallback<Ptr<const Packet> > m_macTxTrace;     //!< frame handed to the channel
+  TracedCallback<Ptr<const Packet> > m_macTxDropTrace; //!< frame dropped by the channel queue
+  TracedCallback<Ptr<const Packet> > m_macRxTrace;     //!< frame received
+  TracedCallback<Ptr<const Packet> > m_phyRxDropTrace; //!< frame dropped by the error model
+  TracedCallback<> m_linkChangeCallbacks;             //!< link change callbacks
+};
+
+} // namespace ns3
+
+#endif /* ACCESS_LINK_NET_DEVICE_H */
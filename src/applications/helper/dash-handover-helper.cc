@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+#include "dash-handover-helper.h"
+#include "ns3/http-client-dash.h"
+#include "ns3/ipv4.h"
+#include "ns3/uinteger.h"
+#include "ns3/config.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DashHandoverHelper");
+
+DashHandoverHelper::DashHandoverHelper (Ptr<ControllerMain> controller)
+  : m_controller (controller)
+{
+}
+
+void
+DashHandoverHelper::SetCellEdge (uint16_t cellId, unsigned node)
+{
+  m_controller->setCellEdge (cellId, node);
+}
+
+void
+DashHandoverHelper::Install (NetDeviceContainer ueDevices) const
+{
+  for (NetDeviceContainer::Iterator i = ueDevices.Begin (); i != ueDevices.End (); ++i)
+    {
+      Ptr<NetDevice> device = *i;
+      Ptr<Node> node = device->GetNode ();
+
+      UintegerValue imsi;
+      device->GetAttribute ("Imsi", imsi);
+
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+      int32_t interface = ipv4->GetInterfaceForDevice (device);
+      NS_ABORT_MSG_IF (interface < 0, "DashHandoverHelper: no IPv4 address on the UE device of node " << node->GetId ());
+      std::ostringstream ip;
+      ipv4->GetAddress (interface, 0).GetLocal ().Print (ip);
+
+      Ptr<HttpClientDashApplication> client;
+      for (uint32_t j = 0; j < node->GetNApplications () && client == 0; ++j)
+        {
+          client = DynamicCast<HttpClientDashApplication> (node->GetApplication (j));
+        }
+      if (client == 0)
+        {
+          NS_LOG_WARN ("DashHandoverHelper: no DASH client on node " << node->GetId ());
+          continue;
+        }
+      UintegerValue content;
+      client->GetAttribute ("ContentId", content);
+
+      m_controller->addHandoverUser (imsi.Get (), ip.str (), content.Get ());
+
+      std::ostringstream path;
+      path << "/NodeList/" << node->GetId () << "/DeviceList/" << device->GetIfIndex () << "/LteUeRrc/";
+      Config::ConnectWithoutContext (path.str () + "HandoverStart",
+                                     MakeCallback (&ControllerMain::NotifyHandoverStart, m_controller));
+      Config::ConnectWithoutContext (path.str () + "HandoverEndOk",
+                                     MakeCallback (&ControllerMain::NotifyHandoverEndOk, m_controller));
+      Config::ConnectWithoutContext (path.str () + "HandoverEndError",
+                                     MakeCallback (&ControllerMain::NotifyHandoverEndError, m_controller));
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,71 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+#ifndef DASH_HANDOVER_HELPER_H
+#define DASH_HANDOVER_HELPER_H
+
+#include <stdint.h>
+#include "ns3/net-device-container.h"
+#include "ns3/ctrl-main.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup Http
+ * \brief Keep the DASH sessions of LTE users on the edge server of their cell
+ *
+ * The HandoverStart, HandoverEndOk and HandoverEndError traces of the
+ * RRC of each UE are connected to the ControllerMain: the content of the
+ * user is placed on the edge server of the target cell when the handover
+ * starts, and the user is redirected to this server once the handover is
+ * complete.  A user moving to a cell without an edge server, or whose
+ * handover fails, goes back to the server of its group.
+ *
+ * The traces are connected by their configuration path, so that the
+ * applications module does not depend on the lte module.
+ */
+class DashHandoverHelper
+{
+public:
+  /**
+   * \param controller the controller which places the contents and redirects the users
+   */
+  DashHandoverHelper (Ptr<ControllerMain> controller);
+
+  /**
+   * \brief Set the edge server of a cell
+   *
+   * \param cellId the cell identifier of the eNB
+   * \param node the edge server, as an index in the nodes of the controller
+   */
+  void SetCellEdge (uint16_t cellId, unsigned node);
+
+  /**
+   * \brief Follow the handovers of LTE users
+   *
+   * The DASH client of each UE must be installed before, since its
+   * ContentId attribute gives the content to place on the edge servers.
+   *
+   * \param ueDevices the LteUeNetDevices of the users
+   */
+  void Install (NetDeviceContainer ueDevices) const;
+
+private:
+  Ptr<ControllerMain> m_controller; //!< The controller
+};
+
+} // namespace ns3
+
+#endif /* DASH_HANDOVER_HELPER_H */
@@ -107,23 +107,21 @@ void AggregationApplication::StartApplication (void)
         if (m_socket->GetSocketType () != Socket::NS3_SOCK_STREAM &&
         m_socket->GetSocketType () != Socket::NS3_SOCK_SEQPACKET)
         {
-            fprintf(stderr,"Using BulkSend with an incompatible socket type. "
-                          "BulkSend requires SOCK_STREAM or SOCK_SEQPACKET. "
-                          "In other words, use TCP instead of UDP.\n");
+            NS_LOG_WARN ("Using BulkSend with an incompatible socket type. BulkSend requires SOCK_STREAM or SOCK_SEQPACKET. In other words, use TCP instead of UDP.");
         }
 
         if (Ipv4Address::IsMatchingType(m_listeningAddress) == true)
         {
             InetSocketAddress local = InetSocketAddress (Ipv4Address::ConvertFrom(m_listeningAddress), m_port);
-            std::cout << "Listening on Ipv4 " << Ipv4Address::ConvertFrom(m_listeningAddress) << ":" << m_port << std::endl;
+            NS_LOG_INFO ("Listening on Ipv4 " << Ipv4Address::ConvertFrom(m_listeningAddress) << ":" << m_port);
             m_socket->Bind (local);
         } else if (Ipv6Address::IsMatchingType(m_listeningAddress) == true)
         {
             Inet6SocketAddress local6 = Inet6SocketAddress (Ipv6Address::ConvertFrom(m_listeningAddress), m_port);
-            std::cout << "Listening on Ipv6 " << Ipv6Address::ConvertFrom(m_listeningAddress) << std::endl;
+            NS_LOG_INFO ("Listening on Ipv6 " << Ipv6Address::ConvertFrom(m_listeningAddress));
             m_socket->Bind (local6);
         } else {
-            std::cout << "Not sure what type the m_listeningaddress is... " << m_listeningAddress << std::endl;
+            NS_LOG_WARN ("Not sure what type the m_listeningaddress is... " << m_listeningAddress);
         }
     }
 
@@ -136,7 +134,7 @@ void AggregationApplication::StartApplication (void)
         MakeCallback(&AggregationApplication::ConnectionAccepted, this)
     );
 	
-	fprintf(stderr, "GTA Dash AggregationApplication Created!\n");
+	NS_LOG_INFO ("GTA Dash AggregationApplication Created!");
 }
 
 void AggregationApplication::StopApplication()
@@ -64,15 +64,32 @@ vector<GroupUser *>& BigTable::getGroups()
     return groups;
 }
 
+void BigTable::CacheClients()
+{
+    clientInfo.clear();
+    for (unsigned i = 0; i < getClientContainers()->GetN(); i++) {
+        Ptr<Node> user = getClientContainers()->Get(i);
+        Ptr<Ipv4> ipv4src = user->GetObject<Ipv4>();
+
+        ClientInfo info;
+        info.id        = user->GetId();
+        info.address   = Ipv4AddressToString(ipv4src->GetAddress(1,0).GetLocal());
+        info.broadcast = Ipv4AddressToString(ipv4src->GetAddress(1,0).GetBroadcast());
+        clientInfo.push_back(info);
+    }
+}
+
 GroupUser* BigTable::AddUserInGroup(unsigned from, unsigned to, int content, unsigned userId)
 {
-    Ptr<Node> user = getClientContainers()->Get(userId);
-    Ptr<Ipv4> ipv4src = user->GetObject<Ipv4>();
+    if (userId >= clientInfo.size()) {
+        CacheClients();
+    }
+    const ClientInfo& info = clientInfo[userId];
 
-    string strIpv4Src = Ipv4AddressToString(ipv4src->GetAddress(1,0).GetLocal());
-    string strIpv4Bst = Ipv4AddressToString(ipv4src->GetAddress(1,0).GetBroadcast());
+    string strIpv4Src = info.address;
+    string strIpv4Bst = info.broadcast;
 
-    EndUser *new_user = new EndUser(user->GetId(), strIpv4Src, content);
+    EndUser *new_user = new EndUser(info.id, strIpv4Src, content);
 
     bool insertGroup = false;
     for (auto& group : groups) {
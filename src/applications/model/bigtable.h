@@ -35,6 +35,11 @@ public:
 
     GroupUser* AddUserInGroup(unsigned from, unsigned to, int content, unsigned userId);
 
+    // Keeps the id and the addresses of every client, so that a table run by
+    // one thread of the multi-threaded simulator never touches the clients of
+    // the other threads. Call it once the addresses are assigned.
+    void CacheClients();
+
 private:
     string Ipv4AddressToString(Ipv4Address ad);
 
@@ -44,6 +49,13 @@ protected:
 private:
     NodeContainer* clientContainers;
 
+    struct ClientInfo {
+        uint32_t id;
+        string address;
+        string broadcast;
+    };
+    vector<ClientInfo> clientInfo; //!< see CacheClients
+
     map<pair<string, int>, string> *serverTable;
 };
 
@@ -31,11 +31,19 @@ TypeId ControllerMain::GetTypeId()
                    UintegerValue(1317),
                    MakeUintegerAccessor(&ControllerMain::m_port),
                    MakeUintegerChecker<uint16_t>())
+    .AddAttribute ("EdgeControlPort", "Port of the edge servers control socket, used to place contents on edges owned by other ranks.",
+                   UintegerValue(1318),
+                   MakeUintegerAccessor(&ControllerMain::m_edgeControlPort),
+                   MakeUintegerChecker<uint16_t>())
+    .AddTraceSource("Redirect", "A group of users is redirected to another edge server",
+                    MakeTraceSourceAccessor(&ControllerMain::m_redirectTrace),
+                    "ns3::ControllerMain::RedirectTracedCallback")
     ;
     return tid;
 }
 
 ControllerMain::ControllerMain()
+    : serverTable(0)
 {
     NS_LOG_FUNCTION (this);
 }
@@ -76,7 +84,7 @@ bool ControllerMain::ILPSolution(int actualNode, int nextNode)
     int numOfNodes = nodeContainers->GetN();
     vector<GroupUser *> groups = bigtable->getGroups();
 
-    cout << "Number of Nodes = " << numOfNodes << '\n';
+    NS_LOG_INFO ("Number of Nodes = " << numOfNodes);
     getchar();
     
     buffer << "python3.7 ../ILP-QoE/opt-main.py ";
@@ -99,7 +107,7 @@ bool ControllerMain::ILPSolution(int actualNode, int nextNode)
     ifstream ilpSolution(output);
 
     while (getline (ilpSolution, line)) {
-        cout << line << endl;
+        NS_LOG_LOGIC ("ILP solution: " << line);
         vector<string> vals = Split(line, " ");
 
         int groupId = ::stoi(vals[0]);
@@ -107,16 +115,7 @@ bool ControllerMain::ILPSolution(int actualNode, int nextNode)
 
         int content = groups[groupId]->getContent();
 
-        Ptr<Application> app = getNodeContainers()->Get(serverId)->GetApplication(0);
-        Ptr<EdgeDashFakeServerApplication> edgenode = app->GetObject<EdgeDashFakeServerApplication>();
-
-        if (edgenode->hasVideo(content)) {
-            DoRedirectUsers(groupId, serverId, content);
-        } else if (edgenode->VideoAssignment(content)) {
-            string strContent = edgenode->getVideoPath(content);
-
-            edgenode->AddVideo(strContent);
-
+        if (PlaceContent(serverId, content)) {
             DoRedirectUsers(groupId, serverId, content);
         }
     }
@@ -137,18 +136,252 @@ void ControllerMain::DoRedirectUsers(unsigned i, unsigned nextNode, int content)
 {
     vector<GroupUser *> groups = bigtable->getGroups();
 
-    cout << "group(" << groups[i]->getId() << "," << groups[i]->getContent() << ")\n";
-    cout << "group(" << groups[i]->getId() << "," << groups[i]->getContent() << ")\n";
+    NS_LOG_LOGIC ("group(" << groups[i]->getId() << "," << groups[i]->getContent() << ")");
     string newServerIp = getInterfaceNode(nextNode);
+    unsigned previousNode = groups[i]->getActualNode();
 
     groups[i]->setActualNode(nextNode);
     groups[i]->setServerIp(newServerIp);
 
-    (*serverTable)[{groups[i]->getId(), groups[i]->getContent()}] = newServerIp;
+    if (serverTable != 0) {
+        (*serverTable)[{groups[i]->getId(), groups[i]->getContent()}] = newServerIp;
+    }
+    // the latest decision wins: drop the entries left by handovers, which
+    // the clients look up before the entry of their group
+    for (auto& handover : m_handoverUser) {
+        if (handover.second.redirected && handover.second.content == groups[i]->getContent()
+                && groups[i]->hasUser(handover.second.ip)) {
+            handover.second.redirected = false;
+            if (serverTable != 0) {
+                serverTable->erase({handover.second.ip, handover.second.content});
+            }
+        }
+    }
+    PushRedirect(groups[i], newServerIp);
+    m_redirectTrace(groups[i]->getId(), groups[i]->getContent(), previousNode, nextNode);
+}
+
+bool ControllerMain::IsLocalNode(unsigned node)
+{
+    if (node < m_nodeSystemId.size()) {
+        return m_nodeSystemId[node] == GetNode()->GetSystemId();
+    }
+    return getNodeContainers()->Get(node)->GetSystemId() == GetNode()->GetSystemId();
+}
+
+bool ControllerMain::PlaceContent(unsigned node, int content)
+{
+    if (IsLocalNode(node)) {
+        Ptr<Application> app = getNodeContainers()->Get(node)->GetApplication(0);
+        Ptr<EdgeDashFakeServerApplication> edgenode = app->GetObject<EdgeDashFakeServerApplication>();
+
+        if (edgenode->hasVideo(content)) {
+            return true;
+        } else if (edgenode->VideoAssignment(content)) {
+            edgenode->AddVideo(edgenode->getVideoPath(content));
+            return true;
+        }
+        return false;
+    }
+
+    // the edge lives in another rank, decide on the mirrored placement
+    set<int>& placed = m_remotePlacement[node];
+    if (placed.count(content)) {
+        return true;
+    } else if (placed.size() < m_remoteCapacity[node]) {
+        placed.insert(content);
+        SendEdgeControl(node, "PLACE " + to_string(content) + "\n");
+        return true;
+    }
+    return false;
+}
+
+void ControllerMain::PushRedirect(GroupUser *group, string serverIp)
+{
+    // clients connected to the controller get the new server as a message, so
+    // redirects also reach clients simulated by other ranks
+    for (auto& user : group->getUsers()) {
+        SendRedirect(user->getIp(), serverIp);
+    }
+}
+
+void ControllerMain::SendRedirect(string userIp, string serverIp)
+{
+    auto it = m_clientSocket.find(userIp);
+    if (it == m_clientSocket.end()) {
+        return;
+    }
+
+    string message = serverIp + "\n";
+    it->second->Send(Create<Packet>((uint8_t *) message.c_str(), message.length()));
+}
+
+void ControllerMain::setCellEdge(uint16_t cellId, unsigned node)
+{
+    m_cellEdge[cellId] = node;
+}
+
+void ControllerMain::addHandoverUser(uint64_t imsi, string userIp, int content)
+{
+    HandoverUser user = {userIp, content, 0, false, false, false};
+    m_handoverUser[imsi] = user;
+}
+
+string ControllerMain::getUserGroupServer(string userIp, int content)
+{
+    if (bigtable == 0) {
+        return "";
+    }
+    for (auto& group : bigtable->getGroups()) {
+        if (group->getContent() == content && group->hasUser(userIp)) {
+            return group->getServerIp();
+        }
+    }
+    return "";
+}
+
+void ControllerMain::ResetHandoverRedirect(HandoverUser& user)
+{
+    if (!user.redirected) {
+        return;
+    }
+    user.redirected = false;
+
+    if (serverTable != 0) {
+        serverTable->erase({user.ip, user.content});
+    }
+    // back to the server of the group, an empty line sends a client without
+    // a group redirect back to its own server
+    SendRedirect(user.ip, getUserGroupServer(user.ip, user.content));
+}
+
+void ControllerMain::NotifyHandoverStart(uint64_t imsi, uint16_t cellId, uint16_t rnti, uint16_t targetCellId)
+{
+    auto user = m_handoverUser.find(imsi);
+    if (user == m_handoverUser.end()) {
+        return;
+    }
+
+    // the edge of the source cell is left behind, whatever the target cell
+    ResetHandoverRedirect(user->second);
+    user->second.pending = false;
+
+    auto edge = m_cellEdge.find(targetCellId);
+    if (edge == m_cellEdge.end()) {
+        NS_LOG_INFO ("ControllerMain: no edge server in cell " << targetCellId << ", user " << user->second.ip << " is back on the server of its group");
+        return;
+    }
+
+    // pre-warm: the edge server gets the content while the handover is in
+    // progress, so that it is ready to serve the next segments of the user
+    user->second.targetNode = edge->second;
+    user->second.warmed = PlaceContent(edge->second, user->second.content);
+    user->second.pending = true;
+
+    NS_LOG_INFO ("ControllerMain: handover of " << user->second.ip << " from cell " << cellId << " to cell " << targetCellId
+                 << ", content " << user->second.content << (user->second.warmed ? " placed on " : " does not fit on ")
+                 << "node " << edge->second);
+}
+
+void ControllerMain::NotifyHandoverEndOk(uint64_t imsi, uint16_t cellId, uint16_t rnti)
+{
+    auto user = m_handoverUser.find(imsi);
+    if (user == m_handoverUser.end() || !user->second.pending) {
+        return;
+    }
+    user->second.pending = false;
+
+    if (!user->second.warmed) {
+        return;
+    }
+
+    string serverIp = getInterfaceNode(user->second.targetNode);
+    NS_LOG_INFO ("ControllerMain: redirect " << user->second.ip << " to " << serverIp << " in cell " << cellId);
+
+    // the users of a cell share the entry of their subnet, the entry of the
+    // user address only redirects this one
+    if (serverTable != 0) {
+        (*serverTable)[{user->second.ip, user->second.content}] = serverIp;
+    }
+    user->second.redirected = true;
+    SendRedirect(user->second.ip, serverIp);
+}
+
+void ControllerMain::NotifyHandoverEndError(uint64_t imsi, uint16_t cellId, uint16_t rnti)
+{
+    auto user = m_handoverUser.find(imsi);
+    if (user == m_handoverUser.end()) {
+        return;
+    }
+    NS_LOG_INFO ("ControllerMain: handover of " << user->second.ip << " failed in cell " << cellId);
+
+    // the user reconnects to some cell on its own, keep it on the server of its group
+    user->second.pending = false;
+    ResetHandoverRedirect(user->second);
+}
+
+void ControllerMain::SendEdgeControl(unsigned node, string message)
+{
+    m_edgePending[node] += message;
+
+    if (m_edgeSocket.find(node) == m_edgeSocket.end()) {
+        Ptr<Socket> socket = Socket::CreateSocket(GetNode(), TypeId::LookupByName("ns3::TcpSocketFactory"));
+        socket->Bind();
+        socket->Connect(InetSocketAddress(Ipv4Address(getInterfaceNode(node).c_str()), m_edgeControlPort));
+        socket->SetConnectCallback(
+            MakeCallback(&ControllerMain::EdgeConnectionSucceeded, this),
+            MakeCallback(&ControllerMain::EdgeConnectionFailed, this)
+        );
+        m_edgeSocket[node] = socket;
+        return;
+    }
+
+    if (m_edgeConnected.count(node)) {
+        string& pending = m_edgePending[node];
+        m_edgeSocket[node]->Send(Create<Packet>((uint8_t *) pending.c_str(), pending.length()));
+        pending.clear();
+    }
+}
+
+void ControllerMain::EdgeConnectionSucceeded(Ptr<Socket> socket)
+{
+    for (auto& edge : m_edgeSocket) {
+        if (edge.second == socket) {
+            m_edgeConnected.insert(edge.first);
+
+            string& pending = m_edgePending[edge.first];
+            socket->Send(Create<Packet>((uint8_t *) pending.c_str(), pending.length()));
+            pending.clear();
+        }
+    }
+}
+
+void ControllerMain::EdgeConnectionFailed(Ptr<Socket> socket)
+{
+    NS_LOG_WARN("ControllerMain: failed to open control connection with edge server");
+}
+
+void ControllerMain::setEdgeCapacity(unsigned node, unsigned capacity)
+{
+    m_remoteCapacity[node] = capacity;
+}
+
+void ControllerMain::CacheNodes()
+{
+    m_nodeSystemId.clear();
+    m_nodeAddress.clear();
+    for (unsigned i = 0; i < getNodeContainers()->GetN(); i++) {
+        Ptr<Node> node = getNodeContainers()->Get(i);
+        m_nodeSystemId.push_back(node->GetSystemId());
+        m_nodeAddress.push_back(Ipv4AddressToString(node->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal()));
+    }
 }
 
 string ControllerMain::getInterfaceNode(int node)
 {
+    if (node >= 0 && (unsigned) node < m_nodeAddress.size()) {
+        return m_nodeAddress[node];
+    }
     Ptr<Node> nodesrc = getNodeContainers()->Get(node);
     Ptr<Ipv4> srcIpv4 = nodesrc->GetObject<Ipv4> ();
 
@@ -182,7 +415,7 @@ NodeContainer *ControllerMain::getNodeContainers(void)
 
 void ControllerMain::StartApplication()
 {
-    cout << "Starting Dash Controller" << endl;
+    NS_LOG_INFO ("Starting Dash Controller");
 
     if (m_socket == 0) {
         TypeId tid = TypeId::LookupByName("ns3::TcpSocketFactory");
@@ -193,9 +426,7 @@ void ControllerMain::StartApplication()
         if(m_socket->GetSocketType () != Socket::NS3_SOCK_STREAM &&
             m_socket->GetSocketType () != Socket::NS3_SOCK_SEQPACKET)
         {
-            fprintf (stderr,"Using BulkSend with an incompatible socket type. "
-                            "BulkSend requires SOCK_STREAM or SOCK_SEQPACKET. "
-                            "In other words, use TCP instead of UDP.\n");
+            NS_LOG_WARN ("Using BulkSend with an incompatible socket type. BulkSend requires SOCK_STREAM or SOCK_SEQPACKET. In other words, use TCP instead of UDP.");
         }
 
         if (Ipv4Address::IsMatchingType (m_listeningAddress) == true)
@@ -204,7 +435,7 @@ void ControllerMain::StartApplication()
                 Ipv4Address::ConvertFrom(m_listeningAddress),
                 m_port
             );
-            cout << "Listening on Ipv4 " << Ipv4Address::ConvertFrom(m_listeningAddress) << ":" << m_port << endl;
+            NS_LOG_INFO ("Listening on Ipv4 " << Ipv4Address::ConvertFrom(m_listeningAddress) << ":" << m_port);
             m_socket->Bind(local);
         } else if (Ipv6Address::IsMatchingType(m_listeningAddress) == true)
         {
@@ -212,10 +443,10 @@ void ControllerMain::StartApplication()
                 Ipv6Address::ConvertFrom(m_listeningAddress),
                 m_port
             );
-            cout << "Listening on Ipv6 " << Ipv6Address::ConvertFrom (m_listeningAddress) << endl;
+            NS_LOG_INFO ("Listening on Ipv6 " << Ipv6Address::ConvertFrom (m_listeningAddress));
             m_socket->Bind (local6);
         } else {
-            cout << "Not sure what type the m_listeningaddress is... " << m_listeningAddress << endl;
+            NS_LOG_WARN ("Not sure what type the m_listeningaddress is... " << m_listeningAddress);
         }
     }
 
@@ -237,7 +468,7 @@ void ControllerMain::StopApplication()
 
 bool ControllerMain::ConnectionRequested(Ptr<Socket> socket, const Address& address)
 {
-    cout << Simulator::Now () << " Socket = " << socket << " Server: ConnectionRequested" << endl;
+    NS_LOG_INFO (Simulator::Now () << " Socket = " << socket << " Server: ConnectionRequested");
     return true;
 }
 
@@ -245,9 +476,7 @@ void ControllerMain::ConnectionAccepted(Ptr<Socket> socket, const Address& addre
 {
     InetSocketAddress iaddr = InetSocketAddress::ConvertFrom(address);
 
-    cout << "ControllerMain(" << socket << ") " << Simulator::Now()
-        << " Successful socket creation Connection Accepted From " << iaddr.GetIpv4()
-        << " port: " << iaddr.GetPort ()<< endl;
+    NS_LOG_INFO ("ControllerMain(" << socket << ") " << Simulator::Now() << " Successful socket creation Connection Accepted From " << iaddr.GetIpv4() << " port: " << iaddr.GetPort ());
 
     m_clientSocket[Ipv4AddressToString(iaddr.GetIpv4())] = socket;
 
@@ -3,10 +3,12 @@
 
 
 #include <functional>
+#include <set>
 
 #include "ns3/application.h"
 #include "ns3/event-id.h"
 #include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
 
 #include "ns3/node-container.h"
 #include "ns3/internet-module.h"
@@ -40,6 +42,31 @@ public:
     void setServerTable(map<pair<string, int>, string> *serverTable);
     string getServerTable(string server, int content);
 
+    // Capacity of an edge server owned by another MPI rank. Its placement is
+    // mirrored here and changes are sent to it as control messages.
+    void setEdgeCapacity(unsigned node, unsigned capacity);
+
+    // Keeps the system id and the address of every node, so that a controller
+    // run by one thread of the multi-threaded simulator never touches the nodes
+    // of the other threads. Call it once the addresses are assigned.
+    void CacheNodes();
+
+    // Session continuity across LTE handovers, see DashHandoverHelper. The
+    // edge server of the target cell gets the content of the user when the
+    // handover starts, and the user is redirected to it once it completes.
+    // Every handover first drops the redirect of the user to the previous
+    // edge, and so does a later redirect of the group of the user.
+    void setCellEdge(uint16_t cellId, unsigned node);
+    void addHandoverUser(uint64_t imsi, string userIp, int content);
+
+    void NotifyHandoverStart(uint64_t imsi, uint16_t cellId, uint16_t rnti, uint16_t targetCellId);
+    void NotifyHandoverEndOk(uint64_t imsi, uint16_t cellId, uint16_t rnti);
+    void NotifyHandoverEndError(uint64_t imsi, uint16_t cellId, uint16_t rnti);
+
+    // Signature of the Redirect trace source: the group, its content, and the
+    // edge servers it is moved from and to.
+    typedef void (*RedirectTracedCallback)(string group, int content, unsigned fromNode, unsigned toNode);
+
 private:
     virtual void StartApplication(void);
     virtual void StopApplication(void);
@@ -57,6 +84,15 @@ private:
     string getInterfaceNode(int node);
     void DoRedirectUsers(unsigned i, unsigned nextNode, int content);
 
+    bool IsLocalNode(unsigned node);
+    bool PlaceContent(unsigned node, int content);
+    void PushRedirect(GroupUser *group, string serverIp);
+    void SendRedirect(string userIp, string serverIp);
+
+    void SendEdgeControl(unsigned node, string message);
+    void EdgeConnectionSucceeded(Ptr<Socket> socket);
+    void EdgeConnectionFailed(Ptr<Socket> socket);
+
 private:
     Address     m_listeningAddress;
     uint16_t    m_port; //!< Port on which we listen for incoming packets.
@@ -70,6 +106,33 @@ private:
 
     map<pair<string, int>, string> *serverTable;
 
+    uint16_t m_edgeControlPort;
+    map<unsigned, unsigned>    m_remoteCapacity;  //!< capacity of edges owned by other ranks
+    map<unsigned, set<int>>    m_remotePlacement; //!< contents placed on edges owned by other ranks
+    map<unsigned, Ptr<Socket>> m_edgeSocket;
+    map<unsigned, string>      m_edgePending;     //!< control messages waiting for the connection
+    set<unsigned>              m_edgeConnected;
+
+    vector<uint32_t> m_nodeSystemId; //!< system id of the nodes, see CacheNodes
+    vector<string>   m_nodeAddress;  //!< address of the nodes, see CacheNodes
+
+    struct HandoverUser {
+        string   ip;         //!< address of the user
+        int      content;    //!< content watched by the user
+        unsigned targetNode; //!< edge server of the target cell
+        bool     warmed;     //!< the target edge server has the content
+        bool     pending;    //!< a handover is in progress
+        bool     redirected; //!< the user has its own entry in the server table
+    };
+    map<uint16_t, unsigned>     m_cellEdge;     //!< edge server of each cell
+    map<uint64_t, HandoverUser> m_handoverUser; //!< users followed across handovers, by IMSI
+
+    string getUserGroupServer(string userIp, int content);
+    void ResetHandoverRedirect(HandoverUser& user);
+
+    // group, content, previous and new edge server of each group redirect
+    TracedCallback<string, int, unsigned, unsigned> m_redirectTrace;
+
     function<bool(int, int)> optimizerSol;
     // auto& optimizerSol;
 };
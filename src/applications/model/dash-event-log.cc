@@ -0,0 +1,287 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "dash-event-log.h"
+
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DashEventLog");
+
+namespace {
+
+/** A recorded event. */
+struct EventRecord
+{
+  int64_t ts;                                    //!< Time step of the event
+  uint32_t context;                              //!< Context of the event
+  const DashEventLog::Component *component;      //!< Source of the event
+  const char *event;                             //!< Static name of the event
+  int64_t a;                                     //!< First value
+  int64_t b;                                     //!< Second value
+};
+
+/** The components and the ring buffer, shared by all the threads. */
+struct EventLogState
+{
+  EventLogState ()
+    : next (0)
+  {
+    ring.resize (65536);
+  }
+
+  std::mutex mutex;                                           //!< Protects the state
+  std::map<std::string, DashEventLog::Component *> components; //!< Registered components
+  std::map<std::string, uint32_t> pending;                    //!< Enabled before registration
+  std::vector<EventRecord> ring;                              //!< The ring buffer
+  uint64_t next;                                              //!< Events recorded since Clear
+};
+
+/**
+ * \return the state, created on first use so that the components of the
+ * other translation units can register during static initialization
+ */
+EventLogState &
+GetState (void)
+{
+  static EventLogState state;
+  return state;
+}
+
+/**
+ * \brief Parse a specification of EnableFromString
+ * \param spec the specification
+ * \param periods receives the sampling period of each component
+ */
+void
+ParseSpec (const std::string &spec, std::map<std::string, uint32_t> &periods)
+{
+  std::string::size_type cur = 0;
+  while (cur <= spec.size ())
+    {
+      std::string::size_type end = spec.find (':', cur);
+      if (end == std::string::npos)
+        {
+          end = spec.size ();
+        }
+      std::string item = spec.substr (cur, end - cur);
+      cur = end + 1;
+      if (item.empty ())
+        {
+          continue;
+        }
+
+      uint32_t period = 1;
+      std::string::size_type equal = item.find ('=');
+      if (equal != std::string::npos)
+        {
+          period = std::max (1, std::atoi (item.substr (equal + 1).c_str ()));
+          item = item.substr (0, equal);
+        }
+      periods[item] = period;
+    }
+}
+
+} // anonymous namespace
+
+DashEventLog::Component::Component (const char *name)
+  : m_name (name),
+    m_enabled (false),
+    m_period (1),
+    m_count (0)
+{
+  // Runs during static initialization: no NS_LOG here
+  EventLogState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.mutex);
+  if (state.components.empty ())
+    {
+      const char *env = std::getenv ("DASH_EVENT_LOG");
+      if (env != 0)
+        {
+          ParseSpec (env, state.pending);
+        }
+    }
+  state.components[name] = this;
+
+  std::map<std::string, uint32_t>::const_iterator it = state.pending.find (name);
+  if (it == state.pending.end ())
+    {
+      it = state.pending.find ("*");
+    }
+  if (it != state.pending.end ())
+    {
+      Set (true, it->second);
+    }
+}
+
+void
+DashEventLog::Component::Set (bool enable, uint32_t period)
+{
+  m_period.store (period, std::memory_order_relaxed);
+  m_count.store (0, std::memory_order_relaxed);
+  m_enabled.store (enable, std::memory_order_relaxed);
+}
+
+void
+DashEventLog::Enable (const std::string &name, uint32_t period)
+{
+  NS_LOG_FUNCTION (name << period);
+  EventLogState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.mutex);
+  state.pending[name] = period;
+  for (std::map<std::string, Component *>::iterator it = state.components.begin ();
+       it != state.components.end (); ++it)
+    {
+      if (name == "*" || name == it->first)
+        {
+          it->second->Set (true, period);
+        }
+    }
+}
+
+void
+DashEventLog::Disable (const std::string &name)
+{
+  NS_LOG_FUNCTION (name);
+  EventLogState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.mutex);
+  if (name == "*")
+    {
+      state.pending.clear ();
+    }
+  else
+    {
+      state.pending.erase (name);
+    }
+  for (std::map<std::string, Component *>::iterator it = state.components.begin ();
+       it != state.components.end (); ++it)
+    {
+      if (name == "*" || name == it->first)
+        {
+          it->second->Set (false, 1);
+        }
+    }
+}
+
+void
+DashEventLog::EnableFromString (const std::string &spec)
+{
+  NS_LOG_FUNCTION (spec);
+  std::map<std::string, uint32_t> periods;
+  ParseSpec (spec, periods);
+  for (std::map<std::string, uint32_t>::const_iterator it = periods.begin ();
+       it != periods.end (); ++it)
+    {
+      Enable (it->first, it->second);
+    }
+}
+
+void
+DashEventLog::SetCapacity (uint32_t capacity)
+{
+  NS_LOG_FUNCTION (capacity);
+  NS_ABORT_MSG_IF (capacity == 0, "DashEventLog needs a capacity of at least one event");
+  EventLogState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.mutex);
+  state.ring.assign (capacity, EventRecord ());
+  state.next = 0;
+}
+
+void
+DashEventLog::Record (const Component &component, const char *event, int64_t a, int64_t b)
+{
+  EventRecord record;
+  record.ts = Simulator::Now ().GetTimeStep ();
+  record.context = Simulator::GetContext ();
+  record.component = &component;
+  record.event = event;
+  record.a = a;
+  record.b = b;
+
+  EventLogState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.mutex);
+  state.ring[state.next % state.ring.size ()] = record;
+  state.next++;
+}
+
+void
+DashEventLog::Dump (std::ostream &os)
+{
+  NS_LOG_FUNCTION (&os);
+  EventLogState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.mutex);
+  uint64_t size = state.ring.size ();
+  uint64_t count = std::min (state.next, size);
+  for (uint64_t i = state.next - count; i != state.next; ++i)
+    {
+      const EventRecord &record = state.ring[i % size];
+      os << TimeStep (record.ts).GetSeconds () << " ";
+      if (record.context == Simulator::NO_CONTEXT)
+        {
+          os << "-";
+        }
+      else
+        {
+          os << record.context;
+        }
+      os << " " << record.component->GetName ()
+         << " " << record.event
+         << " " << record.a
+         << " " << record.b << std::endl;
+    }
+}
+
+void
+DashEventLog::Dump (const std::string &filename)
+{
+  NS_LOG_FUNCTION (filename);
+  std::ofstream os (filename.c_str ());
+  if (!os.is_open ())
+    {
+      NS_LOG_ERROR ("DashEventLog: could not open " << filename);
+      return;
+    }
+  Dump (os);
+}
+
+void
+DashEventLog::Clear (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  EventLogState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.mutex);
+  state.next = 0;
+}
+
+uint64_t
+DashEventLog::GetNRecorded (void)
+{
+  EventLogState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.mutex);
+  return state.next;
+}
+
+} // namespace ns3
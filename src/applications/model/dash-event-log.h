@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DASH_EVENT_LOG_H
+#define DASH_EVENT_LOG_H
+
+#include <stdint.h>
+#include <atomic>
+#include <ostream>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ *
+ * \brief Sampled, ring-buffered log of structured DASH events
+ *
+ * The NS_LOG output of the DASH clients and servers formats a message
+ * for every packet, which is too slow to leave on in a long run.  This
+ * log records fixed-size records instead: the time, the context, the
+ * component, a static event name and two integer values, in a ring
+ * buffer which keeps the most recent events.  Nothing is formatted
+ * until Dump.
+ *
+ * Each source file defines its component with DASH_EVENT_COMPONENT_DEFINE
+ * and records with DASH_EVENT.  A disabled component costs one relaxed
+ * atomic load per event; an enabled one records one event out of its
+ * sampling period.  The components are enabled at runtime with Enable,
+ * or with the DASH_EVENT_LOG environment variable, which takes the same
+ * syntax as EnableFromString, e.g.
+ * \code
+ *   DASH_EVENT_LOG="HttpClientDashApplication:DashFakeVirtualClientSocket=10"
+ * \endcode
+ */
+class DashEventLog
+{
+public:
+  /** \brief A source of events, enabled and sampled independently. */
+  class Component
+  {
+  public:
+    /**
+     * \brief Register a component
+     * \param name the name of the component
+     */
+    Component (const char *name);
+
+    /** \return true if the events of this component are recorded */
+    bool IsEnabled (void) const
+    {
+      return m_enabled.load (std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Count an event against the sampling period
+     * \return true if this event is to be recorded
+     */
+    bool Sample (void)
+    {
+      uint32_t period = m_period.load (std::memory_order_relaxed);
+      return period <= 1 || m_count.fetch_add (1, std::memory_order_relaxed) % period == 0;
+    }
+
+    /** \return the name of the component */
+    const char * GetName (void) const
+    {
+      return m_name;
+    }
+
+  private:
+    friend class DashEventLog;
+
+    /**
+     * \brief Enable or disable the component
+     * \param enable are the events recorded
+     * \param period record one event out of period
+     */
+    void Set (bool enable, uint32_t period);
+
+    const char *m_name;               //!< Name of the component
+    std::atomic<bool> m_enabled;      //!< Are the events recorded
+    std::atomic<uint32_t> m_period;   //!< Record one event out of m_period
+    std::atomic<uint64_t> m_count;    //!< Events seen while enabled
+  };
+
+  /**
+   * \brief Enable a component
+   * \param name the name of the component, or "*" for all of them
+   * \param period record one event out of period
+   *
+   * A component which is not registered yet is enabled at registration.
+   */
+  static void Enable (const std::string &name, uint32_t period = 1);
+
+  /**
+   * \brief Disable a component
+   * \param name the name of the component, or "*" for all of them
+   */
+  static void Disable (const std::string &name);
+
+  /**
+   * \brief Enable components from a specification
+   * \param spec colon separated components, each optionally followed by
+   * "=period", e.g. "HttpClientApplication=100:HttpServerFakeClientSocket"
+   */
+  static void EnableFromString (const std::string &spec);
+
+  /**
+   * \brief Resize the ring buffer, dropping the recorded events
+   * \param capacity the number of events kept (default 65536)
+   */
+  static void SetCapacity (uint32_t capacity);
+
+  /**
+   * \brief Record an event, normally through DASH_EVENT
+   * \param component the component of the event
+   * \param event static name of the event
+   * \param a first value
+   * \param b second value
+   */
+  static void Record (const Component &component, const char *event, int64_t a, int64_t b);
+
+  /**
+   * \brief Write the recorded events, oldest first, one per line:
+   * "time(s) context component event a b"
+   * \param os the output stream
+   */
+  static void Dump (std::ostream &os);
+
+  /**
+   * \brief Write the recorded events to a file
+   * \param filename the file name
+   */
+  static void Dump (const std::string &filename);
+
+  /** \brief Drop the recorded events. */
+  static void Clear (void);
+
+  /** \return the number of events recorded since the last Clear,
+   * including those overwritten in the ring buffer */
+  static uint64_t GetNRecorded (void);
+};
+
+} // namespace ns3
+
+/**
+ * \ingroup applications
+ * Define the DASH event component of a source file.
+ * \param name the name of the component
+ */
+#define DASH_EVENT_COMPONENT_DEFINE(name)                               \
+  static ns3::DashEventLog::Component g_dashEventComponent (name)
+
+/**
+ * \ingroup applications
+ * Record an event of the component of this file with two values.  The
+ * values are not evaluated when the component is disabled.
+ * \param event static name of the event
+ * \param a first value
+ * \param b second value
+ */
+#define DASH_EVENT(event, a, b)                                         \
+  do                                                                    \
+    {                                                                   \
+      if (g_dashEventComponent.IsEnabled ()                             \
+          && g_dashEventComponent.Sample ())                            \
+        {                                                               \
+          ns3::DashEventLog::Record (g_dashEventComponent, event,       \
+                                     (int64_t)(a), (int64_t)(b));       \
+        }                                                               \
+    }                                                                   \
+  while (false)
+
+#endif /* DASH_EVENT_LOG_H */
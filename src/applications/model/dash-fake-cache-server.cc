@@ -66,12 +66,16 @@ TypeId DASHFakeCacheServer::GetTypeId (void)
                    StringValue("localhost"),
                    MakeStringAccessor(&DASHFakeCacheServer::m_remoteCDN),
                    MakeStringChecker())
+    .AddTraceSource("CacheLookup", "A segment is requested, found or not in the cache",
+                   MakeTraceSourceAccessor(&DASHFakeCacheServer::m_lookupTrace), "ns3::DASHFakeCacheServer::CacheLookupTracedCallback")
                     ;
   ;
   return tid;
 }
 
 DASHFakeCacheServer::DASHFakeCacheServer ()
+  : m_hits (0),
+    m_misses (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -143,14 +147,12 @@ void DASHFakeCacheServer::StartApplication (void)
   m_socket->SetAcceptCallback (MakeCallback(&DASHFakeCacheServer::ConnectionRequested, this),
       MakeCallback(&DASHFakeCacheServer::ConnectionAccepted, this)
   );
-
-  this->mpdFile = zlib_compress_string(ImportDASHRepresentations());
-  this->m_fileSizes["content/mpds/vid1.mpd.gz"] = this->mpdFile.size();
 }
 
 void DASHFakeCacheServer::StopApplication (void)
 {
   NS_LOG_FUNCTION (this);
+  NS_LOG_INFO ("CacheServer(" << m_hostName << "): " << m_hits << " hits, " << m_misses << " misses, hit ratio " << GetHitRatio());
 
   if (m_socket != 0) {
     m_socket->Close ();
@@ -169,12 +171,13 @@ bool DASHFakeCacheServer::ConnectionRequested (Ptr<Socket> socket, const Address
 void DASHFakeCacheServer::ConnectionAccepted (Ptr<Socket> socket, const Address& address)
 {
   NS_LOG_FUNCTION (this << socket << address);
-  fprintf(stderr, "DASH Fake Cache Server: Connection Accepted!\n");
+  NS_LOG_INFO ("DASH Fake Cache Server: Connection Accepted!");
   uint64_t socket_id = RegisterSocket(socket);
 
   m_activeClients[socket_id] = new DashFakeVirtualClientSocket(m_fileSizes,
-                  mpdFile, socket_id, socket, GetNode(), m_remoteCDN, m_hostName,
-                  MakeCallback(&DASHFakeCacheServer::FinishedCallback, this));
+                  m_expiries, socket_id, socket, GetNode(), m_remoteCDN, m_hostName,
+                  MakeCallback(&DASHFakeCacheServer::FinishedCallback, this),
+                  MakeCallback(&DASHFakeCacheServer::LookupCallback, this));
 
   // set callbacks for this socket to be in HttpServerFakeClientSocket class
   // socket->SetSendCallback(MakeCallback(&DashFakeVirtualClientSocket::HandleReadyToTransmit, m_activeClients[socket_id]));
@@ -193,26 +196,22 @@ void DASHFakeCacheServer::FinishedCallback(uint64_t socket_id)
 {
   // create timer to finish this, because if we do it in here, we will crash the app
   // Simulator::Schedule(Seconds(1.0), &DASHFakeServerApplication::DoFinishSocket, this, socket_id);
-  std::cout << "CacheServer running FinishedCallback function" << '\n';
+  NS_LOG_INFO ("CacheServer running FinishedCallback function");
 }
 
-std::string DASHFakeCacheServer::ImportDASHRepresentations()
+void DASHFakeCacheServer::LookupCallback(std::string filename, bool hit)
 {
-  std::ifstream infile("video.mpd");
-
-  if (!infile.is_open()) {
-    std::cout << "Error Opening video.mpd" << '\n';
-    return "";
+  if (hit) {
+    m_hits++;
+  } else {
+    m_misses++;
   }
+  m_lookupTrace(filename, hit);
+}
 
-  std::stringstream mpdData;
-  std::string line;
-
-  while (std::getline(infile,line))
-    mpdData << line << '\n';
-  infile.close();
-
-  return mpdData.str();
+double DASHFakeCacheServer::GetHitRatio (void) const
+{
+  return (m_hits + m_misses) > 0 ? (double) m_hits / (m_hits + m_misses) : 0.0;
 }
 
 }
@@ -8,6 +8,7 @@
 #include "ns3/address.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
+#include "ns3/traced-callback.h"
 
 #include <map>
 #include <vector>
@@ -35,12 +36,24 @@ public:
   DASHFakeCacheServer ();
   virtual ~DASHFakeCacheServer ();
 
+  /**
+   * \brief TracedCallback signature of the cache lookups
+   * \param filename the segment requested
+   * \param hit whether the segment was in the cache
+   */
+  typedef void (* CacheLookupTracedCallback)(std::string filename, bool hit);
+
   void TxTrace(Ptr<Packet const> packet);
   void RxTrace(Ptr<Packet const> packet);
 
   virtual void StartApplication (void);
   virtual void StopApplication (void);
 
+  /**
+   * \return the share of the segment requests served from the cache
+   */
+  double GetHitRatio (void) const;
+
 
 protected:
   bool ConnectionRequested (Ptr<Socket> socket, const Address& address);
@@ -49,8 +62,7 @@ protected:
   uint64_t RegisterSocket(Ptr<Socket> socket);
 
   void FinishedCallback(uint64_t socket_id);
-
-  std::string ImportDASHRepresentations();
+  void LookupCallback(std::string filename, bool hit);
 
 protected:
   uint64_t m_bytes_recv;
@@ -76,7 +88,12 @@ private:
   Address m_listeningAddress;
 
   std::map<std::string, long> m_fileSizes;
-  std::string mpdFile;
+  std::map<std::string, Time> m_expiries; //!< End of the time shift buffer of the cached live segments
+
+  uint64_t m_hits;   //!< Segment requests served from the cache
+  uint64_t m_misses; //!< Segment requests fetched from the remote CDN
+
+  TracedCallback<std::string, bool> m_lookupTrace; //!< Segment requested, and whether it was in the cache
 };
 
 }
@@ -30,6 +30,7 @@
 #include "ns3/address.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
+#include "ns3/nstime.h"
 
 #include <map>
 #include <vector>
@@ -142,6 +143,11 @@ private:
     std::string m_hostName;
     Address m_listeningAddress;
 
+    bool m_live; //!< Publish the videos as live streams
+    Time m_liveStartTime; //!< Availability start time of the live streams
+    Time m_timeShiftBufferDepth; //!< How long the live segments stay available
+    std::map<std::string, Time> m_liveAvailability; //!< Availability time of each live segment
+
     EventId m_reportStatsTimer;
     void ReportStats();
 
@@ -2,20 +2,28 @@
 
 #include "dash-fake-virtual-clientsocket.h"
 
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "dash-event-log.h"
+
 #define CRLF "\r\n"
 
 namespace ns3 {
 
+NS_LOG_COMPONENT_DEFINE ("DashFakeVirtualClientSocket");
+DASH_EVENT_COMPONENT_DEFINE ("DashFakeVirtualClientSocket");
+
 DashFakeVirtualClientSocket::DashFakeVirtualClientSocket(std::map<std::string, long>& fileSizes,
-  std::string& mpdFile,
+  std::map<std::string, Time>& expiries,
   uint64_t socket_id,
   Ptr<Socket> socket_usr,
   Ptr<Node> node,
   std::string m_remoteCDN,
   std::string m_hostName,
-  Callback<void, uint64_t> finished_callback) :
+  Callback<void, uint64_t> finished_callback,
+  Callback<void, std::string, bool> lookup_callback) :
   m_fileSizes(fileSizes),
-  mpdFile(mpdFile),
+  m_expiries(expiries),
   m_socket_usr(socket_usr),
   node(node),
   m_remoteCDN(m_remoteCDN),
@@ -24,6 +32,8 @@ DashFakeVirtualClientSocket::DashFakeVirtualClientSocket(std::map<std::string, l
 {
   this->m_socket_id = socket_id;
   this->m_finished_callback = finished_callback;
+  this->m_lookup_callback = lookup_callback;
+  this->m_maxAge = -1;
   this->_tmpbuffer = (uint8_t*)malloc(sizeof(uint8_t)* 128*1024); // 128 kB
 
   TryEstablishConnection();
@@ -31,7 +41,7 @@ DashFakeVirtualClientSocket::DashFakeVirtualClientSocket(std::map<std::string, l
 
 DashFakeVirtualClientSocket::~DashFakeVirtualClientSocket()
 {
-  fprintf(stderr, "Server(%ld): Destructing Client Socket(%ld)...\n", m_socket_id, m_socket_id);
+  NS_LOG_INFO ("Server(" << m_socket_id << "): Destructing Client Socket(" << m_socket_id << ")...");
   this->m_bytesToTransmit.clear();
 }
 
@@ -55,14 +65,14 @@ void DashFakeVirtualClientSocket::TryEstablishConnection()
     this->m_socket_svr->SetConnectCallback (MakeCallback (&DashFakeVirtualClientSocket::ConnectionComplete, this),
                               MakeCallback (&DashFakeVirtualClientSocket::ConnectionFailed, this));
   } else {
-    fprintf(stderr, "CacheServerClient(%d): ERROR: m_socket != 0\n", this->node->GetId());
+    NS_LOG_ERROR ("CacheServerClient(" << this->node->GetId() << "): ERROR: m_socket != 0");
   }
-  fprintf(stderr, "Waiting for reply from server...\n");
+  NS_LOG_INFO ("Waiting for reply from server...");
 }
 
 void DashFakeVirtualClientSocket::ConnectionComplete(Ptr<Socket> socket)
 {
-  fprintf(stderr, "Cache-Server successfully connected \n");
+  NS_LOG_INFO ("Cache-Server successfully connected");
 
   m_currentBytesTx = 0;
   m_totalBytesToTx = 0;
@@ -77,9 +87,8 @@ void DashFakeVirtualClientSocket::ConnectionFailed(Ptr<Socket> socket)
 
 void DashFakeVirtualClientSocket::IncomingDataFromServer(Ptr<Socket> socket)
 {
-  std::cout << "entrou aqui IncomingDataFromServer" << '\n';
-  std::cout << m_is_first_packet << '\n';
-  std::cout << bytes_recv_from_server << " " << requested_content_length << '\n';
+  NS_LOG_LOGIC ("CacheServerClient(" << node->GetId() << "): IncomingDataFromServer first=" << m_is_first_packet
+                << " received " << bytes_recv_from_server << " of " << requested_content_length);
   Ptr<Packet> packet;
   Address from;
 
@@ -99,21 +108,50 @@ void DashFakeVirtualClientSocket::IncomingDataFromServer(Ptr<Socket> socket)
     _tmpbuffer[packet_size] = '\0';
 
     bytes_recv_this_time += packet_size;
+    DASH_EVENT ("rx", node->GetId(), packet_size);
     if (m_is_first_packet) {
       m_is_first_packet = false;
       int status_code = 0;
 
       int where = ParseResponseHeader(_tmpbuffer, packet_size, &status_code, &(requested_content_length));
 
+      // e.g. a live segment out of its availability window, nothing to cache
+      if (status_code == 404) {
+        NS_LOG_INFO ("CacheServer: File " << this->m_fileToRequest << " not found on the server");
+        m_is_first_packet = true;
+        std::string replyString("HTTP/1.1 404 Not Found\r\n\r\n");
+        m_socket_usr->Send (Create<Packet> ((const uint8_t*)replyString.c_str(), replyString.length()));
+        break;
+      }
+
+      // a live segment may only be cached until it leaves the time shift buffer
+      std::string header((const char*)_tmpbuffer, where);
+      size_t pos = header.find("Cache-Control: max-age=");
+      m_maxAge = pos == std::string::npos ? -1 : atol(header.c_str() + pos + 23);
+
+      m_serverBody.clear();
+      if (IsMpd(m_fileToRequest)) {
+        m_serverBody.append((const char*)_tmpbuffer + where, packet_size - where);
+      }
       bytes_recv_from_server += packet_size - where;
     } else {
+      if (IsMpd(m_fileToRequest)) {
+        m_serverBody.append((const char*)_tmpbuffer, packet_size);
+      }
       bytes_recv_from_server += packet_size;
     }
-    std::cout << bytes_recv_from_server << " " << requested_content_length << '\n';
+    NS_LOG_LOGIC (bytes_recv_from_server << " " << requested_content_length);
 
     if (bytes_recv_from_server == requested_content_length) {
-      std::cout << "CacheServer: File "<< this->m_fileToRequest << " received with size " << requested_content_length << '\n';
-      this->m_fileSizes[this->m_fileToRequest] = requested_content_length;
+      NS_LOG_INFO ("CacheServer: File "<< this->m_fileToRequest << " received with size " << requested_content_length);
+      if (!IsMpd(m_fileToRequest)) {
+        this->m_fileSizes[this->m_fileToRequest] = requested_content_length;
+        if (m_maxAge >= 0) {
+          m_expiries[m_fileToRequest] = Simulator::Now() + Seconds(m_maxAge);
+        } else {
+          m_expiries.erase(m_fileToRequest);
+        }
+      }
 
       FinishedIncomingDataFromServer(m_socket_usr, m_activeRecvString);
     }
@@ -122,9 +160,10 @@ void DashFakeVirtualClientSocket::IncomingDataFromServer(Ptr<Socket> socket)
 
 void DashFakeVirtualClientSocket::FinishedIncomingDataFromServer(Ptr<Socket> socket, std::string data)
 {
-  fprintf(stderr, "CacheServer responding chunk %s to the server\n", this->m_fileToRequest.c_str());
+  NS_LOG_INFO ("CacheServer responding chunk " << this->m_fileToRequest << " to the server");
 
-  long filesize = GetFileSize(this->m_fileToRequest);
+  bool mpd = IsMpd(this->m_fileToRequest);
+  long filesize = mpd ? m_serverBody.size() : GetFileSize(this->m_fileToRequest);
 
   // Create HTTP 1.1 compatible request
   std::stringstream replySS;
@@ -141,25 +180,31 @@ void DashFakeVirtualClientSocket::FinishedIncomingDataFromServer(Ptr<Socket> soc
   uint8_t* buffer = (uint8_t*)replyString.c_str();
   AddBytesToTransmit(buffer, replyString.length());
 
-  fprintf(stderr, "VirtualCacheServer(%ld): Generating virtual payload with size %ld ...\n", (long int) node->GetId(), filesize);
+  if (mpd) {
+    // the MPD of the server as is, e.g. a dynamic MPD of a live stream
+    AddBytesToTransmit((const uint8_t*)m_serverBody.c_str(), m_serverBody.length());
+  } else {
+    NS_LOG_INFO ("VirtualCacheServer(" << node->GetId() << "): Generating virtual payload with size " << filesize << " ...");
+    DASH_EVENT ("payload", node->GetId(), filesize);
 
-  // now append the virtual payload data
-  uint8_t tmp[4096];
-  for (int i = 0; i < 4096; i++) {
-    tmp[i] = (uint8_t)rand();
-  }
+    // now append the virtual payload data
+    uint8_t tmp[4096];
+    for (int i = 0; i < 4096; i++) {
+      tmp[i] = (uint8_t)rand();
+    }
 
-  int cnt = 0;
-  while (cnt < filesize) {
-    if (cnt + 4096 < filesize) {
-      AddBytesToTransmit(tmp, 4096);
-    } else {
-      AddBytesToTransmit(tmp, filesize - cnt);
+    int cnt = 0;
+    while (cnt < filesize) {
+      if (cnt + 4096 < filesize) {
+        AddBytesToTransmit(tmp, 4096);
+      } else {
+        AddBytesToTransmit(tmp, filesize - cnt);
+      }
+      cnt += 4096;
     }
-    cnt += 4096;
   }
 
-  std::cout << m_currentBytesTx << " " << m_totalBytesToTx << " " << filesize << " " << m_bytesToTransmit.size() << '\n';
+  NS_LOG_LOGIC (m_currentBytesTx << " " << m_totalBytesToTx << " " << filesize << " " << m_bytesToTransmit.size());
   // getchar();
   //tOMORROW IMPLEMENT HandleReadyToTransmit
   m_currentBytesTx = 0;
@@ -230,13 +275,20 @@ void DashFakeVirtualClientSocket::IncomingDataFromUser(Ptr<Socket> socket)
 
 void DashFakeVirtualClientSocket::FinishedIncomingDataFromUser(Ptr<Socket> socket, std::string data)
 {
-  fprintf(stderr, "VirtualCacheServer(%ld)::FinishedIncomingDataFromUser(socket,data=str(%ld))\n", m_socket_id, data.length());
+  NS_LOG_INFO ("VirtualCacheServer(" << m_socket_id << ")::FinishedIncomingDataFromUser(socket,data=str(" << data.length() << "))");
   // getchar();
   std::string filename = ParseHTTPHeader(data);
+  // the MPDs are never cached, a live MPD changes as the segments are produced
+  bool mpd = IsMpd(filename);
+  bool hit = !mpd && IsCached(filename);
 
-  if (m_fileSizes.find(filename) != m_fileSizes.end()) {
+  if (!m_lookup_callback.IsNull() && !mpd) {
+    m_lookup_callback(filename, hit);
+  }
 
-    fprintf(stderr, "CacheServer(%ld): Opening \n", m_socket_id);
+  if (hit) {
+
+    NS_LOG_INFO ("CacheServer(" << m_socket_id << "): Opening");
 
     long filesize = GetFileSize(filename);
 
@@ -256,32 +308,27 @@ void DashFakeVirtualClientSocket::FinishedIncomingDataFromUser(Ptr<Socket> socke
     // now append the virtual payload data
     uint8_t tmp[4096];
 
-    if (string_ends_width(filename, ".mpd.gz")) {
-      // std::string bytes_memory = mpdFile;
-      AddBytesToTransmit((const uint8_t*)mpdFile.c_str(),mpdFile.length());
-    } else {
-
-      fprintf(stderr, "VirtualCacheServer(%ld): Generating virtual payload with size %ld ...\n", (long int) node->GetId(), filesize);
+    NS_LOG_INFO ("VirtualCacheServer(" << node->GetId() << "): Generating virtual payload with size " << filesize << " ...");
+    DASH_EVENT ("payload", node->GetId(), filesize);
 
-      for (int i = 0; i < 4096; i++) {
-        tmp[i] = (uint8_t)rand();
-      }
+    for (int i = 0; i < 4096; i++) {
+      tmp[i] = (uint8_t)rand();
+    }
 
-      int cnt = 0;
+    int cnt = 0;
 
-      while (cnt < filesize) {
-        if (cnt + 4096 < filesize) {
-          AddBytesToTransmit(tmp, 4096);
-        } else {
-          AddBytesToTransmit(tmp, filesize - cnt);
-        }
-        cnt += 4096;
+    while (cnt < filesize) {
+      if (cnt + 4096 < filesize) {
+        AddBytesToTransmit(tmp, 4096);
+      } else {
+        AddBytesToTransmit(tmp, filesize - cnt);
       }
+      cnt += 4096;
     }
 
     HandleReadyToTransmitFromUser(socket, socket->GetTxAvailable());
   } else {
-    std::cout << "Cache requesting " << filename << " to the servr\n" << std::endl;
+    NS_LOG_INFO ("Cache requesting " << filename << " to the servr");
     bytes_recv_from_server = 0;
 
     this->m_fileToRequest = filename;
@@ -306,8 +353,7 @@ void DashFakeVirtualClientSocket::FinishedIncomingDataFromUser(Ptr<Socket> socke
 
 void DashFakeVirtualClientSocket::HandleReadyToTransmitFromUser(Ptr<Socket> socket, uint32_t txSize)
 {
-  std::cout << "HandleReadyToTransmit func from Cache Server " << m_currentBytesTx
-            << " " <<  m_totalBytesToTx << '\n';
+  NS_LOG_LOGIC ("HandleReadyToTransmit func from Cache Server " << m_currentBytesTx << " " <<  m_totalBytesToTx);
 
   while (m_currentBytesTx < m_totalBytesToTx) {
 
@@ -316,8 +362,9 @@ void DashFakeVirtualClientSocket::HandleReadyToTransmitFromUser(Ptr<Socket> sock
 
     Ptr<Packet> replyPacket;
 
-    _tmpbuffer = (uint8_t*) &((this->m_bytesToTransmit)[m_currentBytesTx]);
-    replyPacket = Create<Packet> (_tmpbuffer, remainingBytes);
+    // not _tmpbuffer, which receives the next responses of the server
+    uint8_t* buffer = (uint8_t*) &((this->m_bytesToTransmit)[m_currentBytesTx]);
+    replyPacket = Create<Packet> (buffer, remainingBytes);
 
     int amountSent = socket->Send (replyPacket);
 
@@ -327,13 +374,13 @@ void DashFakeVirtualClientSocket::HandleReadyToTransmitFromUser(Ptr<Socket> sock
     m_currentBytesTx += amountSent;
   }
 
-  std::cout << "Total Bytes " << m_currentBytesTx << " Transmitted " << '\n';
+  NS_LOG_LOGIC ("Total Bytes " << m_currentBytesTx << " Transmitted ");
   this->m_bytesToTransmit.clear();
 }
 
 void DashFakeVirtualClientSocket::AskSegmentForServer(std::string data)
 {
-  fprintf(stderr, "Cache requesting to the servr\n");
+  NS_LOG_INFO ("Cache requesting to the servr");
 
   m_is_first_packet = true;
 
@@ -385,7 +432,7 @@ uint32_t DashFakeVirtualClientSocket::ParseResponseHeader(const uint8_t* buffer,
   Content-Length: {len}CRLFCRLF;
   */
 
-  fprintf(stderr, "CacheServerClient(%d): Parsing Response Header of length %ld\n", node->GetId(), len);
+  NS_LOG_LOGIC ("CacheServerClient(" << node->GetId() << "): Parsing Response Header of length " << len);
   const char* strbuffer = (const char*) buffer;
 
   //fprintf(stderr, "header=\n%s\n", buffer);
@@ -409,7 +456,8 @@ uint32_t DashFakeVirtualClientSocket::ParseResponseHeader(const uint8_t* buffer,
       int iStatusCode = atoi(actualStatusCode);
 
       if (iStatusCode == 404) {
-        fprintf(stderr, "CacheServerClient(%d): ParseHeader: Status Code 404, not found!\n", node->GetId());
+        NS_LOG_WARN ("CacheServerClient(" << node->GetId() << "): ParseHeader: Status Code 404, not found!");
+        *realStatusCode = iStatusCode;
       } else {
         // find Content-Length
         char needle2[17];
@@ -441,24 +489,24 @@ uint32_t DashFakeVirtualClientSocket::ParseResponseHeader(const uint8_t* buffer,
               pos = p - strbuffer;
               return pos+4; // +4 to skip CRLFCRLF
             } else {
-              fprintf(stderr, "ERROR: could not find where body begins\n");
+              NS_LOG_ERROR ("ERROR: could not find where body begins");
             }
           } else {
-            fprintf(stderr, "ERROR: No CRLF found?!?\n");
+            NS_LOG_ERROR ("ERROR: No CRLF found?!?");
           }
 
         } else {
-          fprintf(stderr, "ERROR: Server did not reply Content-Length Header field\n");
+          NS_LOG_ERROR ("ERROR: Server did not reply Content-Length Header field");
         }
       }
 
     } else {
-      fprintf(stderr, "Invalid HTTP Response, %s\n", strbuffer);
+      NS_LOG_WARN ("Invalid HTTP Response, " << strbuffer);
     }
 
   } else {
-    fprintf(stderr, "[CacheServer] Not sure what this response header means\n");
-    fprintf(stderr, "[CacheServer] Result=%s\n", strbuffer);
+    NS_LOG_WARN ("[CacheServer] Not sure what this response header means");
+    NS_LOG_WARN ("[CacheServer] Result=" << strbuffer);
   }
 
   return 0;
@@ -475,4 +523,26 @@ long DashFakeVirtualClientSocket::GetFileSize(std::string filename)
   return m_fileSizes[filename];
 }
 
+bool DashFakeVirtualClientSocket::IsMpd(std::string filename)
+{
+  return string_ends_width(filename, ".mpd.gz") || string_ends_width(filename, ".mpd");
+}
+
+bool DashFakeVirtualClientSocket::IsCached(std::string filename)
+{
+  if (m_fileSizes.find(filename) == m_fileSizes.end()) {
+    return false;
+  }
+  // out of the time shift buffer, the server answers 404 now
+  auto expiry = m_expiries.find(filename);
+  if (expiry != m_expiries.end() && Simulator::Now() > expiry->second) {
+    NS_LOG_INFO ("CacheServer(" << m_socket_id << "): " << filename << " expired at " << expiry->second.GetSeconds());
+    DASH_EVENT ("expired", node->GetId(), m_fileSizes[filename]);
+    m_fileSizes.erase(filename);
+    m_expiries.erase(expiry);
+    return false;
+  }
+  return true;
+}
+
 }
@@ -6,6 +6,7 @@
 #include "ns3/ptr.h"
 #include "ns3/string.h"
 #include "ns3/tcp-socket.h"
+#include "ns3/nstime.h"
 
 #include <map>
 #include <vector>
@@ -21,8 +22,9 @@ class Address;
 class DashFakeVirtualClientSocket
 {
 public:
-  DashFakeVirtualClientSocket(std::map<std::string, long>& fileSizes, std::string& mpdFile, uint64_t socket_id,
-    Ptr<Socket> socket, Ptr< Node > node, std::string m_remoteCDN, std::string m_hostName, Callback<void, uint64_t> finished_callback);
+  DashFakeVirtualClientSocket(std::map<std::string, long>& fileSizes, std::map<std::string, Time>& expiries, uint64_t socket_id,
+    Ptr<Socket> socket, Ptr< Node > node, std::string m_remoteCDN, std::string m_hostName, Callback<void, uint64_t> finished_callback,
+    Callback<void, std::string, bool> lookup_callback = MakeNullCallback<void, std::string, bool> ());
   virtual ~DashFakeVirtualClientSocket();
 
   void TryEstablishConnection();
@@ -41,6 +43,17 @@ public:
   void FinishedIncomingDataFromUser(Ptr<Socket> socket, std::string data);
 
   long GetFileSize(std::string filename);
+
+  /**
+   * \return true if the file is an MPD, which is always fetched from the server
+   */
+  bool IsMpd(std::string filename);
+
+  /**
+   * \brief Look a segment up in the cache, dropping it if it expired
+   * \return true if the segment is cached and still available
+   */
+  bool IsCached(std::string filename);
   std::string ParseHTTPHeader(std::string data);
   uint32_t ParseResponseHeader(const uint8_t* buffer, size_t len, int* realStatusCode, unsigned int* contentLength);
 
@@ -52,6 +65,7 @@ public:
 
 protected:
   Callback<void, uint64_t> m_finished_callback;
+  Callback<void, std::string, bool> m_lookup_callback; //!< Notified of each segment found, or not, in the cache
 
 protected:
   std::string m_outFile;
@@ -86,7 +100,10 @@ protected:
   std::string m_activeRecvString;
 
   std::map<std::string,long>& m_fileSizes;
-  std::string& mpdFile;
+  std::map<std::string, Time>& m_expiries; //!< End of the time shift buffer of the cached live segments
+
+  std::string m_serverBody; //!< Body of the MPD being fetched from the server
+  long m_maxAge;            //!< max-age of the response being fetched, -1 if none
 
   unsigned requested_content_length;
   bool m_keep_alive;
@@ -13,7 +13,13 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include <algorithm>
 #include <fstream>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 NS_LOG_COMPONENT_DEFINE("ns3.DASHPlayerTracer");
 
@@ -24,10 +30,210 @@ namespace ns3 {
 
 static std::list< Ptr< DASHPlayerTracer > > m_allTracers;
 
+// Online QoE accumulators. A user entry holds the playback history needed to
+// update its score in O(1) per segment, a group entry the sums over its users.
+struct QoEAccumulator {
+  QoEAccumulator()
+    : users(0), segments(0), sumBitrate(0), switches(0), stalls(0), stallTime(0), sumStartup(0)
+    , sumQuality(0), lastBitrate(0), firstStall(0), lastStall(0), mos(0) {}
+
+  unsigned users;
+  unsigned segments;
+  double sumBitrate;
+  unsigned switches;
+  unsigned stalls;
+  double stallTime;           // ms
+  double sumStartup;          // ms
+  double sumQuality;          // user: sum of the per-segment scores, group: sum of the user MOS
+  unsigned lastBitrate;       // user only
+  double firstStall;          // user only, media time of the first/last stall (s)
+  double lastStall;
+  double mos;                 // user only
+  std::vector<std::string> groups; // user only
+};
+
+static std::unordered_map<unsigned, QoEAccumulator> m_userQoE;
+static std::unordered_map<std::string, QoEAccumulator> m_groupQoE;
+
+// The players of a multi-threaded simulation report from several threads
+static std::mutex m_statsMutex;
+
+static bool m_p1203 = false;
+static bool m_segmentTrace = true;
+static std::string m_summaryFile;
+static double m_segmentDuration = 2.0;
+static double m_pixels = 1920.0 * 1080.0;
+static double m_frameRate = 24.0;
+
+// P.1203.1 mode 0 short-term video quality (O.22) of a segment, with coding
+// and display resolution taken equal.
+static double
+SegmentQuality(unsigned bitrate)
+{
+  const double a1 = 11.9983519, a2 = -2.99991847, a3 = 41.2475074, a4 = 0.13183165;
+  const double q1 = 4.66, q2 = -0.07, q3 = 4.06;
+
+  double kbps = std::max(bitrate / 1000.0, 1.0);
+  double bpp = kbps * 1000.0 / (m_pixels * m_frameRate);
+  double quant = a1 + a2 * std::log(a3 + std::log(kbps) + std::log(kbps * bpp + a4));
+  double mos = q1 + q2 * std::exp(q3 * std::min(std::max(quant, 0.0), 1.0));
+  return std::min(std::max(mos, 1.0), 5.0);
+}
+
+// Integration over the session in the form of P.1203.3: mean segment quality,
+// lowered by the switch frequency, then scaled by the stalling impact. The
+// initial loading counts for a third of its duration.
+static double
+SessionQuality(const QoEAccumulator& user)
+{
+  const double s1 = 9.35158684, s2 = 0.91890815, s3 = 11.0567558;
+  const double switchPenalty = 0.1; // MOS per switch per minute, at most 1
+
+  double T = user.segments * m_segmentDuration;
+  double base = user.sumQuality / user.segments;
+  base -= std::min(switchPenalty * user.switches * 60.0 / T, 1.0);
+
+  double stallLength = (user.stallTime + user.sumStartup / 3.0) / 1000.0;
+  double avgInterval = user.stalls > 1 ? (user.lastStall - user.firstStall) / (user.stalls - 1) : 0.0;
+  double impact = std::exp(-(double) user.stalls / s1) * std::exp(-(stallLength / T) / s2)
+                * std::exp(-(avgInterval / T) / s3);
+
+  return std::min(std::max(1.0 + (base - 1.0) * impact, 1.0), 5.0);
+}
+
+static void
+FillQoE(const QoEAccumulator& acc, bool isUser, DASHPlayerTracer::QoE& qoe)
+{
+  qoe.users        = isUser ? 1 : acc.users;
+  qoe.segments     = acc.segments;
+  qoe.meanBitrate  = acc.segments > 0 ? acc.sumBitrate / acc.segments : 0.0;
+  qoe.switches     = acc.switches;
+  qoe.stalls       = acc.stalls;
+  qoe.stallTime    = acc.stallTime;
+  qoe.startupDelay = qoe.users > 0 ? acc.sumStartup / qoe.users : 0.0;
+  qoe.mos          = isUser ? acc.mos : (acc.users > 0 ? acc.sumQuality / acc.users : 0.0);
+}
+
+static void
+WriteQoE(std::ofstream& os, const std::string& scope, const std::string& id, const DASHPlayerTracer::QoE& qoe)
+{
+  os << scope << "\t" << id << "\t" << qoe.users << "\t" << qoe.segments << "\t" << qoe.meanBitrate
+     << "\t" << qoe.switches << "\t" << qoe.stalls << "\t" << qoe.stallTime << "\t" << qoe.startupDelay
+     << "\t" << qoe.mos << "\n";
+}
 
 void DASHPlayerTracer::Destroy()
 {
+  std::lock_guard<std::mutex> lock(m_statsMutex);
+
+  if (!m_summaryFile.empty()) {
+    std::ofstream os(m_summaryFile.c_str(), std::ios_base::out | std::ios_base::trunc);
+    os << "Scope\tId\tUsers\tSegments\tMeanBitrate(bit/s)\tSwitches\tStalls\tStallingTime(msec)"
+       << "\tStartUpDelay(msec)\tMOS\n";
+
+    // groups first, "all" on top, then users in id order
+    std::map<std::string, QoEAccumulator*> groups;
+    for (auto& group : m_groupQoE) {
+      groups[group.first] = &group.second;
+    }
+    std::map<unsigned, QoEAccumulator*> users;
+    for (auto& user : m_userQoE) {
+      if (user.second.segments > 0) {
+        users[user.first] = &user.second;
+      }
+    }
+
+    QoE qoe;
+    if (groups.count("all")) {
+      FillQoE(*groups["all"], false, qoe);
+      WriteQoE(os, "group", "all", qoe);
+    }
+    for (auto& group : groups) {
+      if (group.first != "all") {
+        FillQoE(*group.second, false, qoe);
+        WriteQoE(os, "group", group.first, qoe);
+      }
+    }
+    for (auto& user : users) {
+      FillQoE(*user.second, true, qoe);
+      WriteQoE(os, "user", std::to_string(user.first), qoe);
+    }
+  }
+
   m_allTracers.clear();
+  m_userQoE.clear();
+  m_groupQoE.clear();
+}
+
+void DASHPlayerTracer::SetQoEModel(const std::string& model)
+{
+  NS_ABORT_MSG_UNLESS(model == "basic" || model == "p1203", "Unknown QoE model " << model);
+  m_p1203 = (model == "p1203");
+}
+
+void DASHPlayerTracer::SetVideoParameters(double segmentDuration, unsigned width, unsigned height, double frameRate)
+{
+  m_segmentDuration = segmentDuration;
+  m_pixels = (double) width * height;
+  m_frameRate = frameRate;
+}
+
+void DASHPlayerTracer::SetSegmentTrace(bool enable)
+{
+  m_segmentTrace = enable;
+}
+
+void DASHPlayerTracer::SetSummaryFile(const std::string& file)
+{
+  m_summaryFile = file;
+}
+
+void DASHPlayerTracer::SetUserGroup(unsigned userId, const std::string& group)
+{
+  std::lock_guard<std::mutex> lock(m_statsMutex);
+
+  QoEAccumulator& user = m_userQoE[userId];
+  if (std::find(user.groups.begin(), user.groups.end(), group) != user.groups.end()) {
+    return;
+  }
+  user.groups.push_back(group);
+
+  // a user which already played joins the group with its whole history
+  if (user.segments > 0) {
+    QoEAccumulator& acc = m_groupQoE[group];
+    acc.users++;
+    acc.segments += user.segments;
+    acc.sumBitrate += user.sumBitrate;
+    acc.switches += user.switches;
+    acc.stalls += user.stalls;
+    acc.stallTime += user.stallTime;
+    acc.sumStartup += user.sumStartup;
+    acc.sumQuality += user.mos;
+  }
+}
+
+bool DASHPlayerTracer::GetUserQoE(unsigned userId, QoE& qoe)
+{
+  std::lock_guard<std::mutex> lock(m_statsMutex);
+
+  std::unordered_map<unsigned, QoEAccumulator>::const_iterator it = m_userQoE.find(userId);
+  if (it == m_userQoE.end() || it->second.segments == 0) {
+    return false;
+  }
+  FillQoE(it->second, true, qoe);
+  return true;
+}
+
+bool DASHPlayerTracer::GetGroupQoE(const std::string& group, QoE& qoe)
+{
+  std::lock_guard<std::mutex> lock(m_statsMutex);
+
+  std::unordered_map<std::string, QoEAccumulator>::const_iterator it = m_groupQoE.find(group);
+  if (it == m_groupQoE.end() || it->second.users == 0) {
+    return false;
+  }
+  FillQoE(it->second, false, qoe);
+  return true;
 }
 
 void DASHPlayerTracer::InstallAll(const std::string& file)
@@ -70,14 +276,14 @@ void DASHPlayerTracer::Install(const NodeContainer& nodes, const std::string& fi
     return;
   }
 
-  fprintf(stderr, "Installing tracers on all nodes in nodecontainer...\n");
+  NS_LOG_INFO ("Installing tracers on all nodes in nodecontainer...");
   // for each node in the node container, install the tracer with that one output stream
   for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
     Ptr<DASHPlayerTracer> trace = Install(*node, os);
     tracers.push_back(trace);
     m_allTracers.push_back(trace);
   }
-  fprintf(stderr, "Done!\n");
+  NS_LOG_INFO ("Done!");
 
   if (tracers.size() > 0) {
     tracers.front()->PrintHeader(*os);
@@ -154,6 +360,14 @@ DASHPlayerTracer::~DASHPlayerTracer()
 
 void DASHPlayerTracer::Connect()
 {
+  if (m_nodePtr != 0) {
+    // resolve relative to the node, so that installing on every node of a
+    // large NodeList does not match "/NodeList/<id>" against the whole list
+    static const Config::PreparedPath path("ApplicationList/*/PlayerTracer");
+    path.ConnectWithoutContext(m_nodePtr, MakeCallback(&DASHPlayerTracer::ConsumeStats, this));
+    return;
+  }
+
   Config::ConnectWithoutContext("/NodeList/" + m_node
                                   + "/ApplicationList/*/PlayerTracer",
                                 MakeCallback(&DASHPlayerTracer::ConsumeStats,
@@ -197,9 +411,66 @@ void DASHPlayerTracer::ConsumeStats(Ptr<ns3::Application> app, unsigned int user
   //     depIdStr.append (","+*it);
   // }
 
-  (*m_os) << Simulator::Now().ToDouble(Time::S) << "\t" << m_node << "\t" << userId << "\t" /*<< app->GetId() << "\t"*/
-        << segmentNr << "\t" << representationId << "\t"
-        << segmentExperiencedBitrate << "\t" << bufferLevel << "\t" << stallingTime << "\t" << hostName << "\n" ;//depIdStr << "\n";
+  std::lock_guard<std::mutex> lock(m_statsMutex);
+
+  if (m_segmentTrace) {
+    (*m_os) << Simulator::Now().ToDouble(Time::S) << "\t" << m_node << "\t" << userId << "\t" /*<< app->GetId() << "\t"*/
+          << segmentNr << "\t" << representationId << "\t"
+          << segmentExperiencedBitrate << "\t" << bufferLevel << "\t" << stallingTime << "\t" << hostName << "\n" ;//depIdStr << "\n";
+  }
+
+  // segments never downloaded are reported with a zero bitrate when the player stops
+  if (segmentExperiencedBitrate == 0) {
+    return;
+  }
+
+  QoEAccumulator& user = m_userQoE[userId];
+  bool first = (user.segments == 0);
+  bool switched = !first && segmentExperiencedBitrate != user.lastBitrate;
+  bool stalled = !first && stallingTime > 0;
+  double oldMos = user.mos;
+
+  if (first) {
+    // the first record carries the start-up delay in the stalling column
+    user.sumStartup = stallingTime;
+    if (std::find(user.groups.begin(), user.groups.end(), "all") == user.groups.end()) {
+      user.groups.push_back("all");
+    }
+  } else if (switched) {
+    user.switches++;
+  }
+  if (stalled) {
+    double mediaTime = user.segments * m_segmentDuration;
+    if (user.stalls == 0) {
+      user.firstStall = mediaTime;
+    }
+    user.lastStall = mediaTime;
+    user.stalls++;
+    user.stallTime += stallingTime;
+  }
+  user.segments++;
+  user.sumBitrate += segmentExperiencedBitrate;
+  user.lastBitrate = segmentExperiencedBitrate;
+  if (m_p1203) {
+    user.sumQuality += SegmentQuality(segmentExperiencedBitrate);
+    user.mos = SessionQuality(user);
+  }
+
+  for (const std::string& name : user.groups) {
+    QoEAccumulator& group = m_groupQoE[name];
+    if (first) {
+      group.users++;
+      group.sumStartup += stallingTime;
+    }
+    group.segments++;
+    group.sumBitrate += segmentExperiencedBitrate;
+    group.switches += switched ? 1 : 0;
+    if (stalled) {
+      group.stalls++;
+      group.stallTime += stallingTime;
+    }
+    group.sumQuality += user.mos - oldMos;
+  }
 }
 
 } // namespace ns3
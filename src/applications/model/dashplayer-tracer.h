@@ -29,9 +29,79 @@ class Packet;
  */
 class DASHPlayerTracer : public ns3::Object {
 public:
+  /**
+   * @brief QoE of a user or of a group of users, accumulated online by ConsumeStats
+   */
+  struct QoE {
+    unsigned users;         ///< users contributing (1 for a single user)
+    unsigned segments;      ///< played segments
+    double meanBitrate;     ///< mean experienced bitrate (bit/s)
+    unsigned switches;      ///< representation switches
+    unsigned stalls;        ///< stalls after the start of the playback
+    double stallTime;       ///< total stalling time (ms)
+    double startupDelay;    ///< mean start-up delay (ms)
+    double mos;             ///< integrated quality (1..5), 0 unless the "p1203" model is selected
+  };
+
+  /**
+   * @brief Write the QoE summary (if a summary file was set), release the tracers and reset the
+   *accumulators
+   */
   static void
   Destroy();
 
+  /**
+   * @brief Select the QoE model: "basic" (raw metrics only) or "p1203" (also computes a MOS in the
+   *spirit of ITU-T P.1203 mode 0)
+   */
+  static void
+  SetQoEModel(const std::string& model);
+
+  /**
+   * @brief Parameters of the P.1203 model, which the player trace does not carry
+   *
+   * @param segmentDuration media duration of a segment (s)
+   * @param width coding/display width
+   * @param height coding/display height
+   * @param frameRate frame rate
+   */
+  static void
+  SetVideoParameters(double segmentDuration, unsigned width, unsigned height, double frameRate);
+
+  /**
+   * @brief Enable or disable the per-segment trace file (enabled by default). The QoE
+   *accumulators are updated either way
+   */
+  static void
+  SetSegmentTrace(bool enable);
+
+  /**
+   * @brief File receiving the per-group and per-user QoE table at Destroy (empty: none)
+   */
+  static void
+  SetSummaryFile(const std::string& file);
+
+  /**
+   * @brief Add a user to a group (e.g. its AP). Every user is also part of the group "all".
+   *The segments the user already played, if any, are added to the group
+   */
+  static void
+  SetUserGroup(unsigned userId, const std::string& group);
+
+  /**
+   * @brief Current QoE of a user
+   * @returns false if the user has not played any segment yet
+   */
+  static bool
+  GetUserQoE(unsigned userId, QoE& qoe);
+
+  /**
+   * @brief Current QoE of a group
+   * @returns false if no user of the group has played any segment yet
+   */
+  static bool
+  GetGroupQoE(const std::string& group, QoE& qoe);
+
   /**
    * @brief Helper method to install tracers on all simulation nodes
    *
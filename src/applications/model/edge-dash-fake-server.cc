@@ -23,6 +23,7 @@
 #include <fstream>
 
 #include "ns3/log.h"
+#include "ns3/abort.h"
 #include "ns3/address.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/inet6-socket-address.h"
@@ -39,8 +40,10 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
 
 #include <stdio.h>
+#include <ctime>
 
 #include "edge-dash-fake-server.h"
 
@@ -94,6 +97,22 @@ EdgeDashFakeServerApplication::GetTypeId (void)
                   UintegerValue (0),
                   MakeUintegerAccessor (&EdgeDashFakeServerApplication::assignedVideos),
                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("ControlPort", "Port receiving content placement messages from a controller in another rank (0: disabled).",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&EdgeDashFakeServerApplication::m_controlPort),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("Live", "Publish the videos as live streams, in a dynamic MPD whose segments are produced as the simulation advances",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&EdgeDashFakeServerApplication::m_live),
+                   MakeBooleanChecker ())
+    .AddAttribute ("LiveStartTime", "Simulation time, in whole seconds, at which the first segment of the live streams starts being produced",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&EdgeDashFakeServerApplication::m_liveStartTime),
+                   MakeTimeChecker ())
+    .AddAttribute ("TimeShiftBufferDepth", "How long a live segment stays available once produced",
+                   TimeValue (Seconds (30)),
+                   MakeTimeAccessor (&EdgeDashFakeServerApplication::m_timeShiftBufferDepth),
+                   MakeTimeChecker ())
     .AddTraceSource("ThroughputTracer", "Trace Throughput statistics of this server",
                       MakeTraceSourceAccessor(&EdgeDashFakeServerApplication::m_throughputTrace), "bla")
                     ;
@@ -151,7 +170,21 @@ std::string EdgeDashFakeServerApplication::ImportDASHRepresentations (std::strin
   mpdData << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << std::endl
           << "<MPD xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"" << std::endl
           << "xmlns=\"urn:mpeg:DASH:schema:MPD:2011\" xsi:schemaLocation=\"urn:mpeg:DASH:schema:MPD:2011\"" << std::endl
-          << "profiles=\"urn:mpeg:dash:profile:isoff-main:2011\" type=\"static\"" << std::endl;
+          << "profiles=\"urn:mpeg:dash:profile:isoff-main:2011\" ";
+
+  if (m_live) {
+    // the simulation starts on 1970-01-01, the clock of the clients
+    char availabilityStartTime[32];
+    // the MPD and the segment availability share this start, in whole seconds
+    NS_ABORT_MSG_IF (m_liveStartTime.IsStrictlyNegative () || m_liveStartTime.GetNanoSeconds () % 1000000000 != 0,
+                     "LiveStartTime must be a whole number of seconds, not " << m_liveStartTime.GetSeconds () << " s");
+    time_t start = m_liveStartTime.GetNanoSeconds () / 1000000000;
+    strftime(availabilityStartTime, sizeof(availabilityStartTime), "%Y-%m-%dT%H:%M:%SZ", gmtime(&start));
+    mpdData << "type=\"dynamic\" availabilityStartTime=\"" << availabilityStartTime << "\" "
+            << "timeShiftBufferDepth=\"PT" << m_timeShiftBufferDepth.GetSeconds() << "S\"" << std::endl;
+  } else {
+    mpdData << "type=\"static\"" << std::endl;
+  }
 
 
   int totalVideoDuration = number_of_segments * segment_duration;
@@ -199,7 +232,7 @@ std::string EdgeDashFakeServerApplication::ImportDASHRepresentations (std::strin
 
             int iBitrate = atoi(repr_bitrate.c_str()); // read bitrate in kilobit/s
 
-            fprintf(stderr, "Representation ID = %s, height = %s, bitrate = %s\n", repr_id.c_str(), repr_height.c_str(), repr_bitrate.c_str());
+            NS_LOG_INFO ("Representation ID = " << repr_id << ", height = " << repr_height << ", bitrate = " << repr_bitrate);
             mpdData << "<Representation id=\"" << repr_id << "\" codecs=\"avc1\" mimeType=\"video/mp4\"" <<
                  " width=\"" << repr_width << "\" height=\"" << repr_height << "\" startWithSAP=\"1\" bandwidth=\"" << (iBitrate*1000) << "\">" << std::endl;
             mpdData << "<SegmentList duration=\"" << segment_duration << "\">" << std::endl;
@@ -215,6 +248,10 @@ std::string EdgeDashFakeServerApplication::ImportDASHRepresentations (std::strin
               m_fileSizes[m_metaDataContentDirectory + segmentFileName.str()] = iSegmentSize;
 
               m_virtualFiles.push_back(m_metaDataContentDirectory + segmentFileName.str());
+              if (m_live) {
+                // segment i is produced at the end of its duration
+                m_liveAvailability[m_metaDataContentDirectory + segmentFileName.str()] = m_liveStartTime + Seconds((i + 1) * segment_duration);
+              }
               mpdData << "<SegmentURL media=\"" <<  "repr_" << repr_id << "_seg_" << i << ".264" << "\"/> " << std::endl;
               //fprintf(stderr, "SegmentName=%s\n", (m_metaDataContentDirectory + segmentFileName.str()).c_str());
             }
@@ -316,6 +353,16 @@ void EdgeDashFakeServerApplication::StartApplication (void)
         MakeCallback(&EdgeDashFakeServerApplication::ConnectionRequested, this),
         MakeCallback(&EdgeDashFakeServerApplication::ConnectionAccepted, this)
     );
+
+    if (m_controlPort != 0 && m_controlSocket == 0) {
+        m_controlSocket = Socket::CreateSocket (GetNode (), TypeId::LookupByName ("ns3::TcpSocketFactory"));
+        m_controlSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_controlPort));
+        m_controlSocket->Listen ();
+        m_controlSocket->SetAcceptCallback (
+            MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+            MakeCallback (&EdgeDashFakeServerApplication::ControlConnectionAccepted, this)
+        );
+    }
 }
 
 void EdgeDashFakeServerApplication::StopApplication ()
@@ -326,6 +373,45 @@ void EdgeDashFakeServerApplication::StopApplication ()
         m_socket->Close ();
         m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
     }
+
+    if (m_controlSocket != 0) {
+        m_controlSocket->Close ();
+    }
+}
+
+void EdgeDashFakeServerApplication::ControlConnectionAccepted (Ptr<Socket> socket, const Address& address)
+{
+    NS_LOG_FUNCTION (this << socket << address);
+    socket->SetRecvCallback (MakeCallback (&EdgeDashFakeServerApplication::HandleControl, this));
+}
+
+void EdgeDashFakeServerApplication::HandleControl (Ptr<Socket> socket)
+{
+    Ptr<Packet> packet;
+    while ((packet = socket->Recv ())) {
+        uint8_t *buffer = new uint8_t[packet->GetSize ()];
+        packet->CopyData (buffer, packet->GetSize ());
+        m_controlBuffer += string (buffer, buffer + packet->GetSize ());
+        delete[] buffer;
+    }
+
+    // one "PLACE <content>" message per line
+    size_t end;
+    while ((end = m_controlBuffer.find ('\n')) != string::npos) {
+        istringstream message (m_controlBuffer.substr (0, end));
+        m_controlBuffer.erase (0, end + 1);
+
+        string command;
+        int content;
+        if (!(message >> command >> content) || command != "PLACE") {
+            NS_LOG_WARN ("Unknown control message");
+            continue;
+        }
+
+        if (!hasVideo (content) && VideoAssignment (content)) {
+            AddVideo (getVideoPath (content));
+        }
+    }
 }
 
 void EdgeDashFakeServerApplication::AddVideo(std::string video)
@@ -339,7 +425,7 @@ void EdgeDashFakeServerApplication::AddVideo(std::string video)
 
     // compress
     std::string compressedMpdData = zlib_compress_string(mpdData);
-    fprintf(stderr, "Size of compressed = %ld, uncompressed = %ld\n", compressedMpdData.length(), mpdData.length());
+    NS_LOG_INFO ("Size of compressed = " << compressedMpdData.length() << ", uncompressed = " << mpdData.length());
 
     std::stringstream SSMpdFilename;
 
@@ -347,7 +433,7 @@ void EdgeDashFakeServerApplication::AddVideo(std::string video)
 
     m_fileSizes[SSMpdFilename.str()] = compressedMpdData.size();
 
-    fprintf(stderr, "Adding '%s' to m_fileSizes with size %ld\n", SSMpdFilename.str().c_str(), compressedMpdData.size());
+    NS_LOG_INFO ("Adding '" << SSMpdFilename.str() << "' to m_fileSizes with size " << compressedMpdData.size());
 
     m_mpdFileContents[SSMpdFilename.str()] = compressedMpdData;
 
@@ -356,7 +442,7 @@ void EdgeDashFakeServerApplication::AddVideo(std::string video)
 
 void EdgeDashFakeServerApplication::OnReadySend(Ptr<Socket> socket, unsigned int txSize)
 {
-    fprintf(stderr, "Server says it is ready to send something now...\n");
+    NS_LOG_INFO ("Server says it is ready to send something now...");
 }
 
 bool EdgeDashFakeServerApplication::ConnectionRequested (Ptr<Socket> socket, const Address& address)
@@ -369,11 +455,11 @@ bool EdgeDashFakeServerApplication::ConnectionRequested (Ptr<Socket> socket, con
 void EdgeDashFakeServerApplication::ConnectionAccepted (Ptr<Socket> socket, const Address& address)
 {
     NS_LOG_FUNCTION (this << socket << address);
-    fprintf(stderr, "DASH Fake Server(%s): Connection Accepted!\n", m_hostName.c_str());
+    NS_LOG_INFO ("DASH Fake Server(" << m_hostName << "): Connection Accepted!");
 
     uint64_t socket_id = RegisterSocket(socket);
 
-    m_activeClients[socket_id] = new HttpServerFakeVirtualClientSocket(
+    HttpServerFakeVirtualClientSocket* client = new HttpServerFakeVirtualClientSocket(
         socket_id,
         "/",
         m_fileSizes,
@@ -381,6 +467,10 @@ void EdgeDashFakeServerApplication::ConnectionAccepted (Ptr<Socket> socket, cons
         m_mpdFileContents,
         MakeCallback(&EdgeDashFakeServerApplication::FinishedCallback, this)
     );
+    if (m_live) {
+        client->SetLiveSchedule(&m_liveAvailability, m_timeShiftBufferDepth);
+    }
+    m_activeClients[socket_id] = client;
 
     NS_LOG_DEBUG (socket << " " << Simulator::Now () << " Successful socket id : " << socket_id << " Connection Accepted From " << address);
 
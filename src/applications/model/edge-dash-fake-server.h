@@ -30,6 +30,7 @@
 #include "ns3/address.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
+#include "ns3/nstime.h"
 
 #include <map>
 #include <vector>
@@ -91,6 +92,9 @@ protected:
     bool ConnectionRequested (Ptr<Socket> socket, const Address& address);
     void ConnectionAccepted (Ptr<Socket> socket, const Address& address);
 
+    void ControlConnectionAccepted (Ptr<Socket> socket, const Address& address);
+    void HandleControl (Ptr<Socket> socket);
+
 
     TracedCallback<Ptr<ns3::Application> /*App*/,
     uint64_t /* TxBytes*/,uint64_t /* RxBytes */, uint32_t /* ConnectionCount */> m_throughputTrace;
@@ -136,12 +140,21 @@ private:
     uint16_t m_port; //!< Port on which we listen for incoming packets.
     Ptr<Socket> m_socket; //!< IPv4 Socket
 
+    uint16_t m_controlPort; //!< Port receiving placement messages from the controller
+    Ptr<Socket> m_controlSocket;
+    std::string m_controlBuffer;
+
     std::string m_mpdDirectory;
     std::string m_mpdMetaDataFiles;
     std::string m_metaDataContentDirectory;
     std::string m_hostName;
     Address m_listeningAddress;
 
+    bool m_live; //!< Publish the videos as live streams
+    Time m_liveStartTime; //!< Availability start time of the live streams
+    Time m_timeShiftBufferDepth; //!< How long the live segments stay available
+    std::map<std::string, Time> m_liveAvailability; //!< Availability time of each live segment
+
     EventId m_reportStatsTimer;
     void ReportStats();
 
@@ -58,6 +58,14 @@ class GroupUser
 
 		void addUser(EndUser *user) {this->users.push_back(user);}
 		vector<EndUser *> getUsers() {return this->users;}
+		bool hasUser(string ip) {
+			for (auto user : this->users) {
+				if (user->getIp() == ip) {
+					return true;
+				}
+			}
+			return false;
+		}
 
 		void setAp(unsigned ap) {this->ap = ap;}
 		unsigned getAp() {return this->ap;}
@@ -29,7 +29,7 @@ GTADash::GTADash()
 {
 	NS_LOG_FUNCTION (this);
 
-    fprintf(stderr, "GTA Dash Client Created!\n");
+    NS_LOG_INFO ("GTA Dash Client Created!");
 }
 
 GTADash::~GTADash()
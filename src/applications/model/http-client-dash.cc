@@ -1,21 +1,28 @@
 
 #include "ns3/log.h"
+#include "dash-event-log.h"
 #include "ns3/string.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
+#include "ns3/nstime.h"
 
 #include "ns3/simulator.h"
 
 #include "http-client-dash.h"
 
 #include <fstream>
+#include <mutex>
+#include <algorithm>
 
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("HttpClientDashApplication");
+DASH_EVENT_COMPONENT_DEFINE ("HttpClientDashApplication");
 NS_OBJECT_ENSURE_REGISTERED (HttpClientDashApplication);
 
+static std::mutex g_usersConnectionMutex; //!< guards the UsersConnectionFile
+
 TypeId
 HttpClientDashApplication::GetTypeId (void)
 {
@@ -50,10 +57,42 @@ HttpClientDashApplication::GetTypeId (void)
                    BooleanValue(false),
                    MakeBooleanAccessor(&HttpClientDashApplication::m_keepAlive),
                    MakeBooleanChecker())
+    .AddAttribute("UsersConnectionFile", "File where the user to server assignment is kept up to date",
+                   StringValue("UsersConnection"),
+                   MakeStringAccessor(&HttpClientDashApplication::m_usersConnectionFile),
+                   MakeStringChecker())
+    .AddAttribute("ControllerAddress", "Address of the controller pushing server redirects. When set, "
+                   "redirects are received as messages instead of through a shared server table",
+                   AddressValue(),
+                   MakeAddressAccessor(&HttpClientDashApplication::m_controllerAddress),
+                   MakeAddressChecker())
+    .AddAttribute("ControllerPort", "Port of the controller pushing server redirects",
+                   UintegerValue(1317),
+                   MakeUintegerAccessor(&HttpClientDashApplication::m_controllerPort),
+                   MakeUintegerChecker<uint16_t>())
     .AddAttribute("ContentId", "Content video of the screen",
                    UintegerValue(1),
                    MakeUintegerAccessor(&HttpClientDashApplication::m_contentId),
                    MakeUintegerChecker<uint32_t>())
+    .AddAttribute("MultiSource", "Download the segments in byte ranges from the assigned server, the MPD server "
+                   "and the BaseURLs of the MPD in parallel",
+                   BooleanValue(false),
+                   MakeBooleanAccessor(&HttpClientDashApplication::m_multiSource),
+                   MakeBooleanChecker())
+    .AddAttribute("MultiSourceMaxServers", "Maximum number of servers of a multi-source download",
+                   UintegerValue(2),
+                   MakeUintegerAccessor(&HttpClientDashApplication::m_maxSources),
+                   MakeUintegerChecker<uint32_t>(1))
+    .AddAttribute("MultiSourceChunkTime", "Download time of a range at the estimated throughput of its server, "
+                   "which sizes the ranges in proportion to the servers throughput",
+                   TimeValue(Seconds(0.5)),
+                   MakeTimeAccessor(&HttpClientDashApplication::m_chunkTime),
+                   MakeTimeChecker())
+    .AddAttribute("MultiSourceStallTimeout", "Time without data after which a server of a multi-source download "
+                   "is dropped and its range requested from the other servers",
+                   TimeValue(Seconds(1.0)),
+                   MakeTimeAccessor(&HttpClientDashApplication::m_stallTimeout),
+                   MakeTimeChecker())
     .AddTraceSource("FileDownloadFinished", "Trace called every time a download finishes",
                    MakeTraceSourceAccessor(&HttpClientDashApplication::m_downloadFinishedTrace),
                    "bla")
@@ -78,10 +117,14 @@ HttpClientDashApplication::HttpClientDashApplication ()
   this->m_socket = 0;
 
   this->_tmpbuffer = NULL; // init this thing
+  this->serverTableList = NULL;
 
   this->m_tried_connecting = 0;
   this->m_success_connecting = 0;
   this->m_failed_connecting = 0;
+
+  this->m_msActive = false;
+  this->m_msReceived = 0;
 }
 
 HttpClientDashApplication::~HttpClientDashApplication()
@@ -91,7 +134,7 @@ HttpClientDashApplication::~HttpClientDashApplication()
 
   if (_tmpbuffer != NULL)
   {
-    fprintf(stderr, "tmpbuffer is still not empty...\n");
+    NS_LOG_LOGIC ("tmpbuffer is still not empty...");
     free(_tmpbuffer);
   }
 }
@@ -108,7 +151,7 @@ void HttpClientDashApplication::StartApplication()
   m_active = true;
   _start_time = Simulator::Now ().GetMilliSeconds ();
 
-  fprintf(stderr, "Establishing connection (time=%f)...\n",Simulator::Now().GetSeconds());
+  NS_LOG_INFO ("Establishing connection (time=" << Simulator::Now().GetSeconds() << ")...");
 
   TryEstablishConnection();
 }
@@ -116,10 +159,21 @@ void HttpClientDashApplication::StartApplication()
 void HttpClientDashApplication::StopApplication()
 {
     NS_LOG_FUNCTION_NOARGS();
-    fprintf(stderr, "Client(%d): Stopping...\n", this->node_id);
+    NS_LOG_INFO ("Client(" << this->node_id << "): Stopping...");
 
     m_active = false;
 
+    // an interrupted multi-source download is dropped, the sockets are kept
+    if (m_msActive) {
+      m_msActive = false;
+      m_msStallEvent.Cancel();
+      for (uint32_t i = 0; i < m_sources.size(); i++) {
+        if (m_sources[i].busy) {
+          MultiSourceAbort(i);
+        }
+      }
+    }
+
     if (this->_tmpbuffer != NULL) {
       free(this->_tmpbuffer);
       this->_tmpbuffer = NULL;
@@ -129,7 +183,7 @@ void HttpClientDashApplication::StopApplication()
       m_socket->Close();
       m_socket = 0;
     } else {
-      fprintf(stderr, "We are in stop application, but keep alive ...\n");
+      NS_LOG_INFO ("We are in stop application, but keep alive ...");
     }
 }
 
@@ -143,10 +197,15 @@ void HttpClientDashApplication::TryEstablishConnection()
   m_bytesRecv = 0;
   m_bytesSent = 0;
 
+  if (m_multiSource && !m_isMpd) {
+    StartMultiSourceDownload();
+    return;
+  }
+
   if (!m_keepAlive || m_socket == 0) {
 
     if (m_socket == 0) {
-      std::cout << "creating socket client" << '\n';
+      NS_LOG_INFO ("creating socket client");
       TypeId tid = TypeId::LookupByName ("ns3::TcpSocketFactory");
       m_socket = Socket::CreateSocket (GetNode (), tid); //  TCP NewReno per default (according to documentation)
       if (Ipv4Address::IsMatchingType(m_peerAddress) == true) {
@@ -169,7 +228,7 @@ void HttpClientDashApplication::TryEstablishConnection()
                                  MakeCallback (&HttpClientDashApplication::ConnectionClosedError, this));
 
   } else {
-    fprintf(stderr, "Keeping connection alive...\n");
+    NS_LOG_INFO ("Keeping connection alive...");
     OnReadySend(m_socket, 1200);
   }
 }
@@ -179,7 +238,7 @@ void HttpClientDashApplication::ConnectionComplete (Ptr<Socket> socket)
   NS_LOG_FUNCTION (this << socket);
   NS_LOG_DEBUG("Client Connection Completed!");
 
-  fprintf(stderr, "Client successfully connected at time=%f\n", Simulator::Now().GetSeconds());
+  NS_LOG_INFO ("Client successfully connected at time=" << Simulator::Now().GetSeconds());
   m_success_connecting++;
 
   // Get ready to receive.
@@ -189,7 +248,7 @@ void HttpClientDashApplication::ConnectionComplete (Ptr<Socket> socket)
 void HttpClientDashApplication::ConnectionFailed (Ptr<Socket> socket)
 {
   NS_LOG_FUNCTION (this << socket);
-  fprintf(stderr, "Client(%d): ERROR: OnConnectionFailed - failed to open connection\n", node_id);
+  NS_LOG_ERROR ("Client(" << node_id << "): ERROR: OnConnectionFailed - failed to open connection");
 }
 
 void HttpClientDashApplication::ConnectionClosedNormal (Ptr<Socket> socket)
@@ -198,7 +257,7 @@ void HttpClientDashApplication::ConnectionClosedNormal (Ptr<Socket> socket)
     return;
   }
 
-  fprintf(stderr, "Client(%d): Socket was closed normally\n", node_id);
+  NS_LOG_INFO ("Client(" << node_id << "): Socket was closed normally");
   // socket is in CLOSE_WAIT state --> close the socket here --> socket will be in LAST_ACK state
   socket->Close();
 
@@ -210,7 +269,7 @@ void HttpClientDashApplication::ConnectionClosedError (Ptr<Socket> socket)
   if (socket == 0) {
     return;
   }
-  fprintf(stderr,"Client(%d): Socket was closed with an error, errno=%d; Trying to open it again...\n", node_id, socket->GetErrno());
+  NS_LOG_WARN ("Client(" << node_id << "): Socket was closed with an error, errno=" << socket->GetErrno() << "; Trying to open it again...");
   socket->SetCloseCallbacks(MakeNullCallback<void, Ptr<Socket> > (),MakeNullCallback<void, Ptr<Socket> > ());
 
   // let's try opening the second again again in 0.5 second
@@ -260,31 +319,7 @@ void HttpClientDashApplication::DoSendGetRequest (Ptr<Socket> localSocket, uint3
 
   string hostname = getServerTableList(strNodeIpv4, m_contentId);
   if (m_hostName != hostname ) {
-    fprintf(stderr, "Client(%d,%s): Old Hostname = %s new Hostname = %s\n", node_id, strNodeIpv4.c_str(), m_hostName.c_str(), hostname.c_str());
-
-    stringstream ssValue;
-    ifstream inputFile("UsersConnection");
-
-    string line;
-		while (getline(inputFile, line)) {
-      vector<string> values = split(line, " ");
-      string strNodeId = to_string(node_id);
-
-      if(strNodeId == values[0]) {
-        ssValue << values[0] << " " << values[1] << " " <<  values[2] << " " << values[3] << " " << hostname << endl;
-      } else {
-        ssValue << values[0] << " " << values[1] << " " <<  values[2] << " " << values[3] << " " << values[4] << endl;
-      }
-		}
-    inputFile.close();
-
-    ofstream newOutputFile;
-    newOutputFile.open("UsersConnection", ios::out);
-    newOutputFile << ssValue.str();
-    newOutputFile.flush();
-  	newOutputFile.close();
-
-    m_hostName = hostname;
+    RecordServerChange(hostname);
     SetRemote(Ipv4Address(m_hostName.c_str()),80);
     SetAttribute("KeepAlive", StringValue("false"));
 
@@ -296,7 +331,8 @@ void HttpClientDashApplication::DoSendGetRequest (Ptr<Socket> localSocket, uint3
 
   // Create HTTP 1.1 compatible request
   stringstream requestSS;
-  fprintf(stderr, "Client(%d, %f): Executing  'GET %s'\n", node_id, Simulator::Now().GetSeconds(), m_fileToRequest.c_str());
+  NS_LOG_INFO ("Client(" << node_id << ", " << Simulator::Now().GetSeconds() << "): Executing  'GET " << m_fileToRequest << "'");
+  DASH_EVENT ("get", node_id, 0);
   requestSS << "GET " << m_fileToRequest << " HTTP/1.1" << CRLF;
   requestSS << "Host: " << m_hostName << CRLF;
   //requestSS << "Pragma: no-cache" << CRLF;
@@ -315,7 +351,7 @@ void HttpClientDashApplication::DoSendGetRequest (Ptr<Socket> localSocket, uint3
   string requestString = requestSS.str();
 
   NS_LOG_INFO ("CLIENT: Initiating GET request of length " << requestString.length());
-  cout << "CLIENT: Initiating GET request of length " << requestString.length() << " in hostname " << m_hostName << "****" << endl;
+  NS_LOG_INFO ("CLIENT: Initiating GET request of length " << requestString.length() << " in hostname " << m_hostName << "****");
 
   // copy the pointer
   uint8_t* buffer = (uint8_t*)requestString.c_str();
@@ -341,6 +377,38 @@ void HttpClientDashApplication::DoSendGetRequest (Ptr<Socket> localSocket, uint3
   m_sent++;
 }
 
+void HttpClientDashApplication::RecordServerChange (string hostname)
+{
+  NS_LOG_INFO ("Client(" << node_id << "," << strNodeIpv4 << "): Old Hostname = " << m_hostName << " new Hostname = " << hostname);
+
+  // the players of a multi-threaded simulation share the file
+  std::lock_guard<std::mutex> lock(g_usersConnectionMutex);
+
+  stringstream ssValue;
+  ifstream inputFile(m_usersConnectionFile.c_str());
+
+  string line;
+  while (getline(inputFile, line)) {
+    vector<string> values = split(line, " ");
+    string strNodeId = to_string(node_id);
+
+    if(strNodeId == values[0]) {
+      ssValue << values[0] << " " << values[1] << " " <<  values[2] << " " << values[3] << " " << hostname << endl;
+    } else {
+      ssValue << values[0] << " " << values[1] << " " <<  values[2] << " " << values[3] << " " << values[4] << endl;
+    }
+  }
+  inputFile.close();
+
+  ofstream newOutputFile;
+  newOutputFile.open(m_usersConnectionFile.c_str(), ios::out);
+  newOutputFile << ssValue.str();
+  newOutputFile.flush();
+  newOutputFile.close();
+
+  m_hostName = hostname;
+}
+
 void HttpClientDashApplication::HandleRead (Ptr<Socket> socket)
 {
   NS_LOG_FUNCTION(this << socket << "URL=" << m_fileToRequest);
@@ -350,7 +418,7 @@ void HttpClientDashApplication::HandleRead (Ptr<Socket> socket)
   // std::cout << m_bytesRecv << " " << requested_content_length << '\n';
 
   if (m_finished_download) {
-    fprintf(stderr, "Client(%d)::HandleRead(time=%f) Client is asked to HandleRead although it should have finished already...\n", node_id, Simulator::Now().GetSeconds());
+    NS_LOG_WARN ("Client(" << node_id << ")::HandleRead(time=" << Simulator::Now().GetSeconds() << ") Client is asked to HandleRead although it should have finished already...");
     return;
   }
 
@@ -374,6 +442,7 @@ void HttpClientDashApplication::HandleRead (Ptr<Socket> socket)
     _tmpbuffer[packet_size] = '\0';
 
     bytes_recv_this_time += packet_size;
+    DASH_EVENT ("rx", node_id, packet_size);
 
     if (m_is_first_packet) {
       m_is_first_packet = false;
@@ -382,8 +451,15 @@ void HttpClientDashApplication::HandleRead (Ptr<Socket> socket)
       int status_code = 0;
       int where = ParseResponseHeader(_tmpbuffer, packet_size, &status_code, &(this->requested_content_length));
       //fprintf(stderr, "content starts at position %d, with length %d (status code %d)\n", where, requested_content_length, status_code);
+
+      // e.g. a live segment out of its availability window
+      if (status_code == 404) {
+        OnFileReceived(404, 0);
+        break;
+      }
       m_bytesRecv += packet_size - where;
 
+      DASH_EVENT ("header", node_id, requested_content_length);
       m_headerReceivedTrace(this, this->m_fileToRequest, requested_content_length);
 
       // write to file
@@ -410,12 +486,11 @@ void HttpClientDashApplication::HandleRead (Ptr<Socket> socket)
     // we have received the whole file!
     if (m_bytesRecv == requested_content_length) {
       NS_LOG_DEBUG("All bytes received, this means we are done...");
-      fprintf(stderr, "Client(%d) All bytes received, this means we are done...\n", node_id);
+      NS_LOG_INFO ("Client(" << node_id << ") All bytes received, this means we are done...");
       OnFileReceived(0, requested_content_length);
       break;
     } else if (m_bytesRecv > requested_content_length) {
-      fprintf(stderr, "Client(%d)::HandleRead(time=%f) Expected only %d bytes, but received already %d bytes\n",
-              node_id, Simulator::Now().GetSeconds(), requested_content_length, m_bytesRecv);
+      NS_LOG_WARN ("Client(" << node_id << ")::HandleRead(time=" << Simulator::Now().GetSeconds() << ") Expected only " << requested_content_length << " bytes, but received already " << m_bytesRecv << " bytes");
     }
   }
 }
@@ -428,7 +503,7 @@ uint32_t HttpClientDashApplication::ParseResponseHeader(const uint8_t* buffer, s
     Content-Length: {len}CRLFCRLF;
   */
 
-  fprintf(stderr, "Client(%d): Parsing Response Header of length %ld\n", node_id, len);
+  NS_LOG_LOGIC ("Client(" << node_id << "): Parsing Response Header of length " << len);
   const char* strbuffer = (const char*) buffer;
 
   // should start with a HTTP response
@@ -450,7 +525,8 @@ uint32_t HttpClientDashApplication::ParseResponseHeader(const uint8_t* buffer, s
       int iStatusCode = atoi(actualStatusCode);
 
       if (iStatusCode == 404) {
-        fprintf(stderr, "Client(%d): ParseHeader: Status Code 404, not found!\n", node_id);
+        NS_LOG_WARN ("Client(" << node_id << "): ParseHeader: Status Code 404, not found!");
+        *realStatusCode = iStatusCode;
       } else {
         // find Content-Length
         char needle2[17];
@@ -479,21 +555,21 @@ uint32_t HttpClientDashApplication::ParseResponseHeader(const uint8_t* buffer, s
               pos = p - strbuffer;
               return pos+4; // +4 to skip CRLFCRLF
             } else {
-              fprintf(stderr, "ERROR: could not find where body begins\n");
+              NS_LOG_ERROR ("ERROR: could not find where body begins");
             }
           } else {
-            fprintf(stderr, "ERROR: No CRLF found?!?\n");
+            NS_LOG_ERROR ("ERROR: No CRLF found?!?");
           }
         } else {
-          fprintf(stderr, "ERROR: Server did not reply Content-Length Header field\n");
+          NS_LOG_ERROR ("ERROR: Server did not reply Content-Length Header field");
         }
       }
     } else {
-      fprintf(stderr, "Invalid HTTP Response, %s\n", strbuffer);
+      NS_LOG_WARN ("Invalid HTTP Response, " << strbuffer);
     }
   } else {
-    fprintf(stderr, "Not sure what this response header means\n");
-    fprintf(stderr, "Result=%s\n", strbuffer);
+    NS_LOG_WARN ("Not sure what this response header means");
+    NS_LOG_WARN ("Result=" << strbuffer);
   }
 
   return 0;
@@ -501,9 +577,13 @@ uint32_t HttpClientDashApplication::ParseResponseHeader(const uint8_t* buffer, s
 
 void HttpClientDashApplication::OnFileReceived(unsigned status, unsigned length)
 {
-  fprintf(stderr, "Client(%d, %f): File received\n", node_id, Simulator::Now().GetSeconds());
+  NS_LOG_INFO ("Client(" << node_id << ", " << Simulator::Now().GetSeconds() << "): File received");
+  DASH_EVENT ("done", node_id, length);
 
   m_finished_download = true;
+  if (status != 0) {
+    return;
+  }
   _finished_time = Simulator::Now().GetMilliSeconds ();
 
   long milliSeconds = _finished_time - _start_time;
@@ -523,6 +603,18 @@ void HttpClientDashApplication::setServerTableList (std::map<std::pair<std::stri
 
 string HttpClientDashApplication::getServerTableList (std::string server, int content)
 {
+  // without a shared table (e.g. the controller lives in another MPI rank) the
+  // current server is the last one pushed by the controller
+  if (serverTableList == NULL) {
+    return m_redirectHostName.empty() ? m_hostName : m_redirectHostName;
+  }
+  // a client redirected on its own (e.g. after a handover) has an entry of its address
+  if (!strLocalIpv4.empty()) {
+    auto user = serverTableList->find({strLocalIpv4, content});
+    if (user != serverTableList->end()) {
+      return user->second;
+    }
+  }
   return (*serverTableList)[{server, content}];
 }
 
@@ -556,6 +648,8 @@ void HttpClientDashApplication::ForceCloseSocket()
   if (gta_socket != 0) {
     gta_socket->Close();
   }
+
+  MultiSourceCloseAll();
 }
 
 
@@ -571,14 +665,16 @@ void HttpClientDashApplication::AgentTryEstablishConnection()
     TypeId tid = TypeId::LookupByName("ns3::TcpSocketFactory");
     gta_socket = Socket::CreateSocket(GetNode (), tid); //  TCP NewReno per default (according to documentation)
 
-    if (Ipv4Address::IsMatchingType(m_peerAddress) == true) {
+    Address agentAddress = m_controllerAddress.IsInvalid() ? m_peerAddress : m_controllerAddress;
+
+    if (Ipv4Address::IsMatchingType(agentAddress) == true) {
       gta_socket->Bind();
-      gta_socket->Connect(InetSocketAddress(Ipv4Address::ConvertFrom(m_peerAddress), 1317));
+      gta_socket->Connect(InetSocketAddress(Ipv4Address::ConvertFrom(agentAddress), m_controllerPort));
 
-      NS_LOG_DEBUG("Binding to Ipv4:" << Ipv4Address::ConvertFrom(m_peerAddress) << ":" << 1317);
-    } else if (Ipv6Address::IsMatchingType(m_peerAddress) == true) {
+      NS_LOG_DEBUG("Binding to Ipv4:" << Ipv4Address::ConvertFrom(agentAddress) << ":" << m_controllerPort);
+    } else if (Ipv6Address::IsMatchingType(agentAddress) == true) {
       gta_socket->Bind6();
-      gta_socket->Connect(Inet6SocketAddress (Ipv6Address::ConvertFrom(m_peerAddress), 1317));
+      gta_socket->Connect(Inet6SocketAddress (Ipv6Address::ConvertFrom(agentAddress), m_controllerPort));
 
       NS_LOG_DEBUG("Binding to Ipv6...");
     }
@@ -592,7 +688,7 @@ void HttpClientDashApplication::AgentConnectionComplete (Ptr<Socket> socket)
 {
     NS_LOG_FUNCTION (this << socket);
     NS_LOG_DEBUG("Client Connection Completed with Aggregation!");
-    fprintf(stderr, "Client successfully connected with DashReqServer at time=%f\n", Simulator::Now().GetSeconds());
+    NS_LOG_INFO ("Client successfully connected with DashReqServer at time=" << Simulator::Now().GetSeconds());
 
     // Get ready to receive.
     socket->SetRecvCallback (MakeCallback (&HttpClientDashApplication::AgentHandleRead, this));
@@ -601,7 +697,7 @@ void HttpClientDashApplication::AgentConnectionComplete (Ptr<Socket> socket)
 void HttpClientDashApplication::AgentConnectionFailed (Ptr<Socket> socket)
 {
     // NS_LOG_FUNCTION (this << socket);
-    fprintf(stderr, "Client(%d): ERROR: OnConnectionFailed - failed to open connection with DashReqServer\n", node_id);
+    NS_LOG_ERROR ("Client(" << node_id << "): ERROR: OnConnectionFailed - failed to open connection with DashReqServer");
 //     // Well, this is not supposed to happen...
 //     NS_LOG_WARN ("Client failed to open connection.");
 }
@@ -619,11 +715,36 @@ void HttpClientDashApplication::AgentHandleRead (Ptr<Socket> socket)
 	uint8_t *buffer = new uint8_t[packet->GetSize ()];
 	packet->CopyData(buffer, packet->GetSize ());
 
-	string str_ip = string(buffer, buffer+packet->GetSize());
+	m_agentBuffer += string(buffer, buffer+packet->GetSize());
+	delete[] buffer;
 
-	cout << "Client(" << node_id << "," << ") --> New hostname=" << str_ip << " Old=" << m_hostName << endl;
+  // redirects are newline terminated, TCP may deliver several or a partial one
+  size_t end = m_agentBuffer.rfind('\n');
+  if (end == string::npos) {
+    return;
+  }
+
+  size_t begin = (end == 0) ? string::npos : m_agentBuffer.rfind('\n', end - 1);
+  begin = (begin == string::npos) ? 0 : begin + 1;
+
+  string str_ip = m_agentBuffer.substr(begin, end - begin);
+  m_agentBuffer.erase(0, end + 1);
+
+  if (str_ip.empty()) {
+    // the controller dropped the redirect of this client alone (e.g. after a
+    // handover into a cell without an edge server): back to the server of the MPD
+    if (m_sourceHosts.empty()) {
+      return;
+    }
+    str_ip = m_sourceHosts.front();
+  }
+
+	NS_LOG_INFO ("Client(" << node_id << "," << ") --> New hostname=" << str_ip << " Old=" << m_hostName);
 
-	if (str_ip != m_hostName) {
+  if (serverTableList == NULL) {
+    // picked up by the next DoSendGetRequest, which reconnects and updates the UsersConnection file
+    m_redirectHostName = str_ip;
+  } else if (str_ip != m_hostName) {
     m_hostName = str_ip;
 
     SetRemote(Ipv4Address(m_hostName.c_str()), 80);
@@ -633,6 +754,349 @@ void HttpClientDashApplication::AgentHandleRead (Ptr<Socket> socket)
 	}
 }
 
+//=======================================================================================
+// MULTI-SOURCE DOWNLOAD
+//=======================================================================================
+
+// The file is split in byte ranges requested from several servers at once, one
+// request in flight per server. A server gets its next range as soon as it has
+// delivered the previous one, sized to last MultiSourceChunkTime at the throughput
+// measured on this server: the faster servers get the larger share of the file. A
+// server silent for MultiSourceStallTimeout is dropped at once, the rest of its
+// range going to the other servers.
+
+void HttpClientDashApplication::StartMultiSourceDownload()
+{
+  NS_LOG_FUNCTION (this);
+
+  // the assigned server first, then the other ones
+  string hostname = getServerTableList(strNodeIpv4, m_contentId);
+  if (m_hostName != hostname) {
+    RecordServerChange(hostname);
+  }
+  vector<string> hosts(1, m_hostName);
+  for (auto& host : m_sourceHosts) {
+    if (hosts.size() < m_maxSources && find(hosts.begin(), hosts.end(), host) == hosts.end()) {
+      hosts.push_back(host);
+    }
+  }
+
+  // the connections to the servers still used are kept
+  vector<Source> sources;
+  for (auto& host : hosts) {
+    auto it = find_if(m_sources.begin(), m_sources.end(), [&host](const Source& s) { return s.host == host; });
+    if (it != m_sources.end()) {
+      sources.push_back(*it);
+      m_sources.erase(it);
+    } else {
+      Source source;
+      source.host       = host;
+      source.connected  = false;
+      source.throughput = lastDownloadBitrate > 0 ? lastDownloadBitrate : 1e6;
+      sources.push_back(source);
+    }
+    sources.back().busy   = false;
+    sources.back().failed = false;
+  }
+  MultiSourceCloseAll();
+  m_sources = sources;
+
+  m_ranges.Reset();
+  m_msActive   = true;
+  m_msReceived = 0;
+
+  m_downloadStartedTrace(this, this->m_fileToRequest);
+  NS_LOG_INFO ("Client(" << node_id << ", " << Simulator::Now().GetSeconds() << "): Executing  'GET " << m_fileToRequest << "' from " << m_sources.size() << " servers");
+  DASH_EVENT ("get", node_id, m_sources.size());
+
+  m_msStallEvent.Cancel();
+  m_msStallEvent = Simulator::Schedule(Seconds(m_stallTimeout.GetSeconds() / 2), &HttpClientDashApplication::MultiSourceCheckStall, this);
+  MultiSourceRequest();
+}
+
+void HttpClientDashApplication::MultiSourceConnect(uint32_t i)
+{
+  Source& source = m_sources[i];
+  NS_LOG_FUNCTION (this << source.host);
+
+  TypeId tid = TypeId::LookupByName ("ns3::TcpSocketFactory");
+  source.socket = Socket::CreateSocket (GetNode (), tid);
+  source.socket->Bind();
+  source.socket->Connect (InetSocketAddress (Ipv4Address(source.host.c_str()), m_peerPort));
+  source.socket->SetConnectCallback (MakeCallback (&HttpClientDashApplication::MultiSourceConnectionComplete, this),
+                                     MakeCallback (&HttpClientDashApplication::MultiSourceConnectionFailed, this));
+  source.socket->SetCloseCallbacks (MakeCallback (&HttpClientDashApplication::MultiSourceConnectionClosed, this),
+                                    MakeCallback (&HttpClientDashApplication::MultiSourceConnectionClosed, this));
+}
+
+int HttpClientDashApplication::MultiSourceFind(Ptr<Socket> socket)
+{
+  for (uint32_t i = 0; i < m_sources.size(); i++) {
+    if (m_sources[i].socket == socket) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void HttpClientDashApplication::MultiSourceConnectionComplete(Ptr<Socket> socket)
+{
+  int i = MultiSourceFind(socket);
+  if (i < 0) {
+    return;
+  }
+  NS_LOG_INFO ("Client(" << node_id << "): connected to " << m_sources[i].host);
+  m_sources[i].connected = true;
+  socket->SetRecvCallback (MakeCallback (&HttpClientDashApplication::MultiSourceHandleRead, this));
+  MultiSourceRequest();
+}
+
+void HttpClientDashApplication::MultiSourceConnectionFailed(Ptr<Socket> socket)
+{
+  int i = MultiSourceFind(socket);
+  if (i < 0) {
+    return;
+  }
+  NS_LOG_WARN ("Client(" << node_id << "): failed to connect to " << m_sources[i].host);
+  m_sources[i].socket = 0;
+  m_sources[i].failed = true;
+  MultiSourceRequest();
+}
+
+void HttpClientDashApplication::MultiSourceConnectionClosed(Ptr<Socket> socket)
+{
+  int i = MultiSourceFind(socket);
+  if (i < 0) {
+    return;
+  }
+  NS_LOG_INFO ("Client(" << node_id << "): connection to " << m_sources[i].host << " closed");
+  if (m_sources[i].busy) {
+    m_sources[i].failed = true;
+  }
+  MultiSourceAbort(i);
+  MultiSourceRequest();
+}
+
+void HttpClientDashApplication::MultiSourceRequest()
+{
+  if (!m_msActive) {
+    return;
+  }
+
+  uint32_t usable = 0;
+  for (auto& source : m_sources) {
+    usable += source.failed ? 0 : 1;
+  }
+  // every server failed, try them all again
+  if (usable == 0) {
+    for (auto& source : m_sources) {
+      source.failed = false;
+    }
+    usable = m_sources.size();
+  }
+
+  // the fastest servers first
+  vector<uint32_t> order;
+  for (uint32_t i = 0; i < m_sources.size(); i++) {
+    order.push_back(i);
+  }
+  sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return m_sources[a].throughput > m_sources[b].throughput; });
+
+  for (uint32_t i : order) {
+    Source& source = m_sources[i];
+    if (source.busy || source.failed) {
+      continue;
+    }
+    // the size of the file is known from the first response only
+    if (m_ranges.GetTotal() == 0 && any_of(m_sources.begin(), m_sources.end(), [](const Source& s) { return s.busy; })) {
+      return;
+    }
+    if (!source.connected) {
+      if (source.socket == 0) {
+        MultiSourceConnect(i);
+      }
+      continue;
+    }
+
+    uint32_t first, last;
+    if (!m_ranges.NextRange(source.throughput, usable, m_chunkTime.GetSeconds(), &first, &last)) {
+      return;
+    }
+
+    source.busy         = true;
+    source.headerDone   = false;
+    source.header.clear();
+    source.first        = first;
+    source.last         = last;
+    source.received     = 0;
+    source.requestTime  = Simulator::Now();
+    source.lastProgress = Simulator::Now();
+
+    stringstream requestSS;
+    requestSS << "GET " << m_fileToRequest << " HTTP/1.1" << CRLF;
+    requestSS << "Host: " << source.host << CRLF;
+    requestSS << "Range: bytes=" << first << "-";
+    if (last != HttpRangePlanner::OPEN_RANGE) {
+      requestSS << last;
+    }
+    requestSS << CRLF;
+    requestSS << "Accept-Encoding: identity" << CRLF;
+    requestSS << "Connection: keep-alive" << CRLF;
+    requestSS << CRLF;
+
+    string requestString = requestSS.str();
+    NS_LOG_INFO ("Client(" << node_id << "): requesting bytes " << first << "-" << last << " from " << source.host);
+    DASH_EVENT ("range", node_id, first);
+
+    Ptr<Packet> p = Create<Packet> ((uint8_t*)requestString.c_str(), requestString.length());
+    m_txTrace (p);
+    source.socket->Send (p);
+    m_bytesSent += requestString.length();
+    m_sent++;
+  }
+}
+
+bool HttpClientDashApplication::MultiSourceParseHeader(uint32_t i)
+{
+  Source& source = m_sources[i];
+  bool sizeKnown = m_ranges.GetTotal() > 0;
+  uint32_t first, last;
+  if (!m_ranges.ParseResponse(source.header, source.first, &first, &last)) {
+    NS_LOG_WARN ("Client(" << node_id << "): unexpected answer of " << source.host << " to a range request");
+    return false;
+  }
+  source.first = first;
+  source.last  = last;
+  if (!sizeKnown) {
+    uint32_t total = m_ranges.GetTotal();
+    requested_content_length = total;
+    DASH_EVENT ("header", node_id, total);
+    m_headerReceivedTrace(this, this->m_fileToRequest, total);
+  }
+  return true;
+}
+
+void HttpClientDashApplication::MultiSourceHandleRead(Ptr<Socket> socket)
+{
+  int i = MultiSourceFind(socket);
+  if (i < 0) {
+    return;
+  }
+
+  Ptr<Packet> packet;
+  Address from;
+  while ((packet = socket->RecvFrom (from)) && packet->GetSize () > 0) {
+    Source& source = m_sources[i];
+    if (!source.busy) {
+      NS_LOG_WARN ("Client(" << node_id << "): unexpected data from " << source.host);
+      continue;
+    }
+
+    uint32_t size = packet->GetSize ();
+    uint32_t payload = size;
+    if (!source.headerDone) {
+      // only the header is copied, the payload is counted
+      vector<uint8_t> buffer(size);
+      packet->CopyData (buffer.data(), size);
+      source.header.append ((const char*) buffer.data(), size);
+
+      size_t end = source.header.find (CRLF CRLF);
+      if (end == string::npos) {
+        continue;
+      }
+      payload = source.header.size() - (end + 4);
+      source.header.resize (end + 4);
+
+      // the file is on none of the servers, e.g. a live segment out of its availability window
+      if (source.header.compare(0, 12, "HTTP/1.1 404") == 0) {
+        m_msActive = false;
+        m_msStallEvent.Cancel();
+        MultiSourceCloseAll();
+        OnFileReceived(404, 0);
+        return;
+      }
+      if (!MultiSourceParseHeader(i)) {
+        source.failed = true;
+        MultiSourceAbort(i);
+        MultiSourceRequest();
+        return;
+      }
+      source.headerDone = true;
+    }
+
+    payload = min(payload, source.last - source.first + 1 - source.received);
+    source.received    += payload;
+    source.lastProgress = Simulator::Now();
+    m_msReceived       += payload;
+    m_bytesRecv        += payload;
+    DASH_EVENT ("rx", node_id, size);
+
+    if (source.received < source.last - source.first + 1) {
+      continue;
+    }
+
+    // the range is complete
+    double seconds = (Simulator::Now() - source.requestTime).GetSeconds();
+    if (seconds > 0) {
+      source.throughput = 0.7 * source.throughput + 0.3 * source.received * 8.0 / seconds;
+    }
+    source.busy = false;
+
+    if (m_msReceived >= m_ranges.GetTotal()) {
+      NS_LOG_INFO ("Client(" << node_id << ") All bytes received from " << m_sources.size() << " servers");
+      m_msActive = false;
+      m_msStallEvent.Cancel();
+      OnFileReceived(0, m_ranges.GetTotal());
+      return;
+    }
+    MultiSourceRequest();
+  }
+}
+
+void HttpClientDashApplication::MultiSourceAbort(uint32_t i)
+{
+  Source& source = m_sources[i];
+  NS_LOG_FUNCTION (this << source.host);
+
+  if (source.busy) {
+    m_ranges.Requeue(source.first + source.received, source.last);
+    source.busy = false;
+  }
+  if (source.socket != 0) {
+    source.socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+    source.socket->SetCloseCallbacks (MakeNullCallback<void, Ptr<Socket> > (), MakeNullCallback<void, Ptr<Socket> > ());
+    source.socket->Close ();
+    source.socket = 0;
+  }
+  source.connected = false;
+}
+
+void HttpClientDashApplication::MultiSourceCheckStall()
+{
+  if (!m_msActive) {
+    return;
+  }
+  for (uint32_t i = 0; i < m_sources.size(); i++) {
+    Source& source = m_sources[i];
+    if (source.busy && Simulator::Now() - source.lastProgress > m_stallTimeout) {
+      NS_LOG_INFO ("Client(" << node_id << "): " << source.host << " stalled, requesting its range from the other servers");
+      DASH_EVENT ("stall", node_id, i);
+      source.failed = true;
+      source.throughput /= 2;
+      MultiSourceAbort(i);
+    }
+  }
+  MultiSourceRequest();
+  m_msStallEvent = Simulator::Schedule(Seconds(m_stallTimeout.GetSeconds() / 2), &HttpClientDashApplication::MultiSourceCheckStall, this);
+}
+
+void HttpClientDashApplication::MultiSourceCloseAll()
+{
+  for (uint32_t i = 0; i < m_sources.size(); i++) {
+    MultiSourceAbort(i);
+  }
+}
+
 // void HttpClientDashApplication::AgentDoSend (Ptr<Socket> socket, uint32_t txSpace, double qoe)
 // {
 //   string str_qoe = to_string(qoe);
@@ -30,9 +30,13 @@
 #include "ns3/address.h"
 #include "ns3/traced-callback.h"
 #include "ns3/tcp-socket.h"
+#include "ns3/nstime.h"
 
 #include "ns3/ipv4.h"
+#include "ns3/http-range.h"
 
+#include <list>
+#include <vector>
 
 
 #define CRLF "\r\n"
@@ -111,6 +115,43 @@ protected:
   void AgentConnectionFailed (Ptr<Socket> socket);
   void AgentHandleRead (Ptr<Socket> socket);
 
+  //=======================================================================================
+  // MULTI-SOURCE DOWNLOAD
+  //=======================================================================================
+
+  /**
+  * \brief Download m_fileToRequest in byte ranges from the assigned server
+  * and the servers of m_sourceHosts, each one getting ranges sized by its
+  * throughput estimate
+  */
+  void StartMultiSourceDownload();
+
+  void MultiSourceConnect(uint32_t i);
+  void MultiSourceConnectionComplete(Ptr<Socket> socket);
+  void MultiSourceConnectionFailed(Ptr<Socket> socket);
+  void MultiSourceConnectionClosed(Ptr<Socket> socket);
+  void MultiSourceHandleRead(Ptr<Socket> socket);
+
+  /**
+  * \brief Request the next range on every idle source
+  */
+  void MultiSourceRequest();
+
+  /**
+  * \brief Parse the header of the response to the range request of a source
+  * \return false if the response does not match the request
+  */
+  bool MultiSourceParseHeader(uint32_t i);
+
+  /**
+  * \brief Close the connection of a source, the missing bytes of its range
+  * are requested from the other sources
+  */
+  void MultiSourceAbort(uint32_t i);
+  void MultiSourceCheckStall();
+  void MultiSourceCloseAll();
+  int  MultiSourceFind(Ptr<Socket> socket);
+
 private:
   /**
   * \brief Callback from Socket when ready to send a packet
@@ -122,6 +163,11 @@ private:
   */
   virtual void DoSendGetRequest (Ptr<Socket> localSocket, uint32_t txSpace);
 
+  /**
+  * \brief Keep the server of this client up to date in the UsersConnection file
+  */
+  void RecordServerChange (string hostname);
+
   /**
   * \brief Handle a packet reception.
   *
@@ -140,6 +186,7 @@ protected:
   uint32_t node_id;
   uint32_t m_contentId;
   string   strNodeIpv4;
+  string   strLocalIpv4; //!< Address of the client, for the redirects of this client only
 
 
   TracedCallback<Ptr<ns3::Application>, std::string> m_downloadStartedTrace;
@@ -150,6 +197,7 @@ protected:
   std::string m_fileToRequest;
   std::string m_hostName; //!< The hostname of the destiatnion server
   std::string m_outFile;
+  std::string m_usersConnectionFile; //!< File mapping users to their current server
 
   bool m_finished_download;
   bool m_isMpd;
@@ -162,6 +210,10 @@ protected:
   double lastDownloadBitrate;
 
   map<pair<string, int>, string> *serverTableList;
+  string m_redirectHostName; //!< Last server pushed by the controller (used when there is no shared table)
+  Address m_controllerAddress; //!< Controller pushing redirects (invalid: use the aggregator at the peer)
+
+  vector<string> m_sourceHosts; //!< Other servers of the multi-source downloads, e.g. the origin and the MPD BaseURLs
 
 private:
   uint8_t* _tmpbuffer;
@@ -193,6 +245,40 @@ private:
   //=======================================================================================
 
   Ptr<Socket> gta_socket;
+  uint16_t m_controllerPort;
+  string   m_agentBuffer; //!< Partial redirect message received from the controller
+
+
+  //=======================================================================================
+  // MULTI-SOURCE DOWNLOAD
+  //=======================================================================================
+
+  struct Source {
+    string      host;
+    Ptr<Socket> socket;
+    bool        connected;
+    bool        busy;         //!< a range request is in flight
+    bool        failed;       //!< stalled or unreachable, skipped until the next file
+    bool        headerDone;   //!< the header of the response was received
+    string      header;       //!< partial header of the response
+    uint32_t    first;        //!< first byte of the requested range
+    uint32_t    last;         //!< last byte of the requested range
+    uint32_t    received;     //!< bytes of the range received so far
+    Time        requestTime;
+    Time        lastProgress;
+    double      throughput;   //!< estimate, in bit/s
+  };
+
+  bool     m_multiSource;
+  uint32_t m_maxSources;
+  Time     m_chunkTime;       //!< download time of a range at the estimated throughput of its source
+  Time     m_stallTimeout;
+
+  vector<Source> m_sources;
+  HttpRangePlanner m_ranges;  //!< bytes of the file left to request
+  bool     m_msActive;        //!< a multi-source download is in progress
+  uint32_t m_msReceived;
+  EventId  m_msStallEvent;
 };
 
 }
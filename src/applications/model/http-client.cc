@@ -22,6 +22,7 @@
 
 
 #include "ns3/log.h"
+#include "dash-event-log.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/nstime.h"
@@ -47,6 +48,7 @@
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("HttpClientApplication");
+DASH_EVENT_COMPONENT_DEFINE ("HttpClientApplication");
 
 NS_OBJECT_ENSURE_REGISTERED (HttpClientApplication);
 
@@ -121,7 +123,7 @@ HttpClientApplication::~HttpClientApplication()
 
   if (_tmpbuffer != NULL)
   {
-    fprintf(stderr, "tmpbuffer is still not empty...\n");
+    NS_LOG_LOGIC ("tmpbuffer is still not empty...");
     free(_tmpbuffer);
   }
 }
@@ -160,12 +162,12 @@ void HttpClientApplication::LogStateChange(const ns3::TcpSocket::TcpStates_t old
   NS_LOG_DEBUG("HttpClient(" << this << "): Socket State Change " << ns3::TcpSocket::TcpStateName[old_state] << " -> "
       << ns3::TcpSocket::TcpStateName[new_state]);
 
-  fprintf(stderr, "Client(%d): Time=%f Socket %s -> %s\n", node_id, Simulator::Now().GetSeconds(), ns3::TcpSocket::TcpStateName[old_state], ns3::TcpSocket::TcpStateName[new_state]);
+  NS_LOG_LOGIC ("Client(" << node_id << "): Time=" << Simulator::Now().GetSeconds() << " Socket " << ns3::TcpSocket::TcpStateName[old_state] << " -> " << ns3::TcpSocket::TcpStateName[new_state]);
 }
 
 void HttpClientApplication::LogCwndChange(uint32_t oldCwnd, uint32_t newCwnd)
 {
-  fprintf(stderr, "Client(%d): Cwnd Changed %d -> %d\n", node_id, oldCwnd, newCwnd);
+  NS_LOG_LOGIC ("Client(" << node_id << "): Cwnd Changed " << oldCwnd << " -> " << newCwnd);
   this->cur_cwnd = newCwnd;
 }
 
@@ -209,7 +211,7 @@ void HttpClientApplication::TryEstablishConnection (void)
       m_socket->SetConnectCallback (MakeCallback (&HttpClientApplication::ConnectionComplete, this),
                                 MakeCallback (&HttpClientApplication::ConnectionFailed, this));
     } else {
-      fprintf(stderr, "Client(%d): ERROR: m_socket != 0\n", node_id);
+      NS_LOG_ERROR ("Client(" << node_id << "): ERROR: m_socket != 0");
     }
 
     m_socket->SetSendCallback (MakeCallback (&HttpClientApplication::OnReadySend, this));
@@ -226,10 +228,10 @@ void HttpClientApplication::TryEstablishConnection (void)
       MakeCallback(&HttpClientApplication::LogCwndChange, this));
     */
 
-    fprintf(stderr, "Waiting for reply from server...\n");
+    NS_LOG_INFO ("Waiting for reply from server...");
 
   } else {
-    fprintf(stderr, "Keeping connection alive...\n");
+    NS_LOG_INFO ("Keeping connection alive...");
     OnReadySend(m_socket, 1200);
   }
 }
@@ -251,13 +253,13 @@ void HttpClientApplication::StartApplication (void)
   // Create OutFile
   if (!m_outFile.empty())
   {
-    fprintf(stderr, "Client(%d): Creating outfile %s\n", node_id, m_outFile.c_str());
+    NS_LOG_INFO ("Client(" << node_id << "): Creating outfile " << m_outFile);
     // (re)create outfile
     FILE* fp = fopen(m_outFile.c_str(), "w");
     fclose(fp);
   }
 
-  fprintf(stderr, "Establishing connection (time=%f)...\n",Simulator::Now().GetSeconds());
+  NS_LOG_INFO ("Establishing connection (time=" << Simulator::Now().GetSeconds() << ")...");
   AgentTryEstablishConnection();
   TryEstablishConnection();
 
@@ -297,7 +299,7 @@ void HttpClientApplication::ReportStats()
 
 void HttpClientApplication::ConnectionClosedNormal (Ptr<Socket> socket)
 {
-  fprintf(stderr, "Client(%d): Socket was closed normally\n", node_id);
+  NS_LOG_INFO ("Client(" << node_id << "): Socket was closed normally");
   // socket is in CLOSE_WAIT state --> close the socket here --> socket will be in LAST_ACK state
   socket->Close();
   socket->SetCloseCallbacks(MakeNullCallback<void, Ptr<Socket> > (),MakeNullCallback<void, Ptr<Socket> > ());
@@ -305,7 +307,7 @@ void HttpClientApplication::ConnectionClosedNormal (Ptr<Socket> socket)
 
 void HttpClientApplication::ConnectionClosedError (Ptr<Socket> socket)
 {
-  fprintf(stderr,"Client(%d): Socket was closed with an error, errno=%d; Trying to open it again...\n", node_id, socket->GetErrno());
+  NS_LOG_WARN ("Client(" << node_id << "): Socket was closed with an error, errno=" << socket->GetErrno() << "; Trying to open it again...");
   socket->SetCloseCallbacks(MakeNullCallback<void, Ptr<Socket> > (),MakeNullCallback<void, Ptr<Socket> > ());
 
   // let's try opening the second again again in 0.5 second
@@ -324,12 +326,12 @@ void HttpClientApplication::StopApplication ()
   m_active = false;
 
   if (m_socket != 0 && !m_keepAlive) {
-    fprintf(stderr, "Client(%d): Socket is still open, closing it...\n", node_id);
+    NS_LOG_INFO ("Client(" << node_id << "): Socket is still open, closing it...");
     m_socket->Close ();
     m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
     m_socket = 0;
   } else {
-    fprintf(stderr, "We are in stop application, but keeping alive...\n");
+    NS_LOG_INFO ("We are in stop application, but keeping alive...");
   }
 
   if (!Simulator::IsExpired(m_reportStatsEvent)) {
@@ -343,7 +345,7 @@ void HttpClientApplication::ConnectionComplete (Ptr<Socket> socket)
   NS_LOG_FUNCTION (this << socket);
   NS_LOG_DEBUG("Client Connection Completed!");
 
-  fprintf(stderr, "Client successfully connected at time=%f\n", Simulator::Now().GetSeconds());
+  NS_LOG_INFO ("Client successfully connected at time=" << Simulator::Now().GetSeconds());
 
   m_success_connecting++;
 
@@ -355,7 +357,7 @@ void HttpClientApplication::ConnectionComplete (Ptr<Socket> socket)
 void HttpClientApplication::ConnectionFailed (Ptr<Socket> socket)
 {
   NS_LOG_FUNCTION (this << socket);
-  fprintf(stderr, "Client(%d): ERROR: OnConnectionFailed - failed to open connection\n", node_id);
+  NS_LOG_ERROR ("Client(" << node_id << "): ERROR: OnConnectionFailed - failed to open connection");
 
   m_failed_connecting++;
 
@@ -366,7 +368,7 @@ void HttpClientApplication::ConnectionFailed (Ptr<Socket> socket)
 void HttpClientApplication::OnReadySend (Ptr<Socket> localSocket, uint32_t txSpace)
 {
   NS_LOG_FUNCTION (this);
-  fprintf(stderr, "HttpClientApp::OnReadySend()\n");
+  NS_LOG_LOGIC ("HttpClientApp::OnReadySend()");
   if (!m_sentGetRequest) {
     m_sentGetRequest = true;
     DoSendGetRequest(localSocket, txSpace);
@@ -381,7 +383,8 @@ void HttpClientApplication::DoSendGetRequest (Ptr<Socket> localSocket, uint32_t
 
   // Create HTTP 1.1 compatible request
   std::stringstream requestSS;
-  fprintf(stderr, "Client(%d, %f): Executing  'GET %s'\n", node_id, Simulator::Now().GetSeconds(), m_fileToRequest.c_str());
+  NS_LOG_INFO ("Client(" << node_id << ", " << Simulator::Now().GetSeconds() << "): Executing  'GET " << m_fileToRequest << "'");
+  DASH_EVENT ("get", node_id, 0);
   requestSS << "GET " << m_fileToRequest << " HTTP/1.1" << CRLF;
   requestSS << "Host: " << m_hostName << CRLF;
   //requestSS << "Pragma: no-cache" << CRLF;
@@ -448,7 +451,7 @@ uint32_t HttpClientApplication::ParseResponseHeader(const uint8_t* buffer, size_
   Content-Length: {len}CRLFCRLF;
   */
 
-  fprintf(stderr, "Client(%d): Parsing Response Header of length %ld\n", node_id, len);
+  NS_LOG_LOGIC ("Client(" << node_id << "): Parsing Response Header of length " << len);
   const char* strbuffer = (const char*) buffer;
 
   //fprintf(stderr, "header=\n%s\n", buffer);
@@ -473,7 +476,7 @@ uint32_t HttpClientApplication::ParseResponseHeader(const uint8_t* buffer, size_
       int iStatusCode = atoi(actualStatusCode);
 
       if (iStatusCode == 404) {
-        fprintf(stderr, "Client(%d): ParseHeader: Status Code 404, not found!\n", node_id);
+        NS_LOG_WARN ("Client(" << node_id << "): ParseHeader: Status Code 404, not found!");
       } else {
         // find Content-Length
         char needle2[17];
@@ -505,24 +508,24 @@ uint32_t HttpClientApplication::ParseResponseHeader(const uint8_t* buffer, size_
               pos = p - strbuffer;
               return pos+4; // +4 to skip CRLFCRLF
             } else {
-              fprintf(stderr, "ERROR: could not find where body begins\n");
+              NS_LOG_ERROR ("ERROR: could not find where body begins");
             }
           } else {
-            fprintf(stderr, "ERROR: No CRLF found?!?\n");
+            NS_LOG_ERROR ("ERROR: No CRLF found?!?");
           }
 
         } else {
-          fprintf(stderr, "ERROR: Server did not reply Content-Length Header field\n");
+          NS_LOG_ERROR ("ERROR: Server did not reply Content-Length Header field");
         }
       }
 
     } else {
-      fprintf(stderr, "Invalid HTTP Response, %s\n", strbuffer);
+      NS_LOG_WARN ("Invalid HTTP Response, " << strbuffer);
     }
 
   } else {
-    fprintf(stderr, "Not sure what this response header means\n");
-    fprintf(stderr, "Result=%s\n", strbuffer);
+    NS_LOG_WARN ("Not sure what this response header means");
+    NS_LOG_WARN ("Result=" << strbuffer);
   }
 
 
@@ -535,7 +538,8 @@ void HttpClientApplication::OnFileReceived(unsigned status, unsigned length)
   if (!m_active)
     return;
 
-  fprintf(stderr, "Client(%d, %f): File received\n", node_id, Simulator::Now().GetSeconds());
+  NS_LOG_INFO ("Client(" << node_id << ", " << Simulator::Now().GetSeconds() << "): File received");
+  DASH_EVENT ("done", node_id, length);
 
   m_finished_download = true;
   _finished_time = Simulator::Now().GetMilliSeconds ();
@@ -565,12 +569,11 @@ void HttpClientApplication::ForceCloseSocket()
 void HttpClientApplication::HandleRead (Ptr<Socket> socket)
 {
   NS_LOG_FUNCTION(this << socket << "URL=" << m_fileToRequest);
-  std::cout << "entrou aqui IncomingDataFromServer" << '\n';
-  std::cout << m_is_first_packet << '\n';
-  std::cout << m_bytesRecv << " " << requested_content_length << '\n';
+  NS_LOG_LOGIC ("Client(" << node_id << "): IncomingDataFromServer first=" << m_is_first_packet
+                << " received " << m_bytesRecv << " of " << requested_content_length);
 
   if (m_finished_download) {
-    fprintf(stderr, "Client(%d)::HandleRead(time=%f) Client is asked to HandleRead although it should have finished already...\n", node_id, Simulator::Now().GetSeconds());
+    NS_LOG_WARN ("Client(" << node_id << ")::HandleRead(time=" << Simulator::Now().GetSeconds() << ") Client is asked to HandleRead although it should have finished already...");
     return;
   }
 
@@ -596,6 +599,7 @@ void HttpClientApplication::HandleRead (Ptr<Socket> socket)
     _tmpbuffer[packet_size] = '\0';
 
     bytes_recv_this_time += packet_size;
+    DASH_EVENT ("rx", node_id, packet_size);
 
     if (m_is_first_packet)
     {
@@ -606,6 +610,7 @@ void HttpClientApplication::HandleRead (Ptr<Socket> socket)
       //fprintf(stderr, "content starts at position %d, with length %d (status code %d)\n", where, requested_content_length, status_code);
       m_bytesRecv += packet_size - where;
 
+      DASH_EVENT ("header", node_id, requested_content_length);
       m_headerReceivedTrace(this, this->m_fileToRequest, requested_content_length);
 
       // write to file
@@ -639,8 +644,7 @@ void HttpClientApplication::HandleRead (Ptr<Socket> socket)
       OnFileReceived(0, requested_content_length);
       break;
     } else if (m_bytesRecv > requested_content_length) {
-      fprintf(stderr, "Client(%d)::HandleRead(time=%f) Expected only %d bytes, but received already %d bytes\n",
-        node_id, Simulator::Now().GetSeconds(), requested_content_length, m_bytesRecv);
+      NS_LOG_WARN ("Client(" << node_id << ")::HandleRead(time=" << Simulator::Now().GetSeconds() << ") Expected only " << requested_content_length << " bytes, but received already " << m_bytesRecv << " bytes");
     }
 
   }
@@ -694,7 +698,7 @@ void HttpClientApplication::AgentConnectionComplete (Ptr<Socket> socket)
 void HttpClientApplication::AgentConnectionFailed (Ptr<Socket> socket)
 {
     NS_LOG_FUNCTION (this << socket);
-    fprintf(stderr, "Client(%d): ERROR: OnConnectionFailed - failed to open connection with DashReqServer\n", node_id);
+    NS_LOG_ERROR ("Client(" << node_id << "): ERROR: OnConnectionFailed - failed to open connection with DashReqServer");
 
     // Well, this is not supposed to happen...
     NS_LOG_WARN ("Client failed to open connection.");
@@ -704,7 +708,7 @@ void HttpClientApplication::AgentDoSend (Ptr<Socket> socket, uint32_t txSpace, d
 {
   std::string str_qoe = std::to_string(qoe);
 
-	std::cout << "Client (" << node_id << "," << strNodeIpv4 << ") " << Simulator::Now ().GetSeconds() << " Socket AgentDoSend QoE video " << str_qoe << std::endl;
+	NS_LOG_LOGIC ("Client (" << node_id << "," << strNodeIpv4 << ") " << Simulator::Now ().GetSeconds() << " Socket AgentDoSend QoE video " << str_qoe);
   // getchar();
 
   uint8_t* buffer = (uint8_t*)str_qoe.c_str();
@@ -730,7 +734,7 @@ void HttpClientApplication::AgentHandleRead (Ptr<Socket> socket)
 
 	std::string str_ip = std::string(buffer, buffer+packet->GetSize());
 
-	std::cout << "Client(" << node_id << "," << ")--> New hostname=" << str_ip << " Old=" << m_hostName << std::endl;
+	NS_LOG_INFO ("Client(" << node_id << "," << ")--> New hostname=" << str_ip << " Old=" << m_hostName);
 	if (str_ip != m_hostName) {
     m_hostName = str_ip;
 
@@ -27,6 +27,9 @@
 #include "ns3/trace-source-accessor.h"
 
 
+#include <algorithm>
+#include <cmath>
+
 
 NS_LOG_COMPONENT_DEFINE("MultimediaConsumer");
 
@@ -40,6 +43,24 @@ NS_OBJECT_ENSURE_REGISTERED(HTTPMultimediaConsumer);
 
 template <typename Parent> std::string MultimediaConsumer<Parent>::alphabet = std::string("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890");
 
+// seconds since 1970-01-01 of an xs:dateTime in UTC, e.g. "1970-01-01T00:01:30Z"
+static double ParseDateTime(const string& dateTime)
+{
+  int year, month, day, hour, minute;
+  double second;
+  if (sscanf(dateTime.c_str(), "%d-%d-%dT%d:%d:%lf", &year, &month, &day, &hour, &minute, &second) != 6) {
+    return 0.0;
+  }
+  // days from the civil date
+  year -= month <= 2;
+  int era = (year >= 0 ? year : year - 399) / 400;
+  int yoe = year - era * 400;
+  int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  long days = era * 146097L + doe - 719468;
+  return days * 86400.0 + hour * 3600 + minute * 60 + second;
+}
+
 template<class Parent>
 TypeId MultimediaConsumer<Parent>::GetTypeId(void)
 {
@@ -76,10 +97,21 @@ TypeId MultimediaConsumer<Parent>::GetTypeId(void)
                     MakeDoubleAccessor(&MultimediaConsumer<Parent>::startupDelay), MakeDoubleChecker<double>())
       .template AddAttribute("UserId", "The ID of this user (optional)", UintegerValue(0),
                     MakeUintegerAccessor(&MultimediaConsumer<Parent>::m_userId), MakeUintegerChecker<uint32_t>())
+      .template AddAttribute("LiveTargetLatency", "Latency, in seconds, behind the live point to join a live stream at", DoubleValue(10.0),
+                    MakeDoubleAccessor(&MultimediaConsumer<Parent>::m_liveTargetLatency), MakeDoubleChecker<double>(0.0))
+      .template AddAttribute("MaxSegmentRetries", "Number of times a segment answered with a 404 is requested again "
+                          "before the download stops. A VoD segment is requested again after 1, 2, 4... seconds",
+                          UintegerValue(3),
+                    MakeUintegerAccessor(&MultimediaConsumer<Parent>::m_maxSegmentRetries), MakeUintegerChecker<uint32_t>())
       // .template AddAttribute("ContentId", "Content video of the screen", UintegerValue(1),
       //               MakeUintegerAccessor(&MultimediaConsumer<Parent>::m_contentId), MakeUintegerChecker<uint32_t>())
       .AddTraceSource("PlayerTracer", "Trace Player consumes of multimedia data",
                       MakeTraceSourceAccessor(&MultimediaConsumer<Parent>::m_playerTracer), "bla")
+      .AddTraceSource("BufferLevel", "Buffer level in seconds and bitrate of the requested representation, on every change",
+                      MakeTraceSourceAccessor(&MultimediaConsumer<Parent>::m_bufferLevelTrace), "ns3::MultimediaConsumer::BufferLevelTracedCallback")
+      .AddTraceSource("LiveLatency", "Latency of the segments of a live stream when they start to play, "
+                      "since the capture of their first frame",
+                      MakeTraceSourceAccessor(&MultimediaConsumer<Parent>::m_liveLatencyTrace), "ns3::MultimediaConsumer::LiveLatencyTracedCallback")
                     ;
 
   return tid;
@@ -111,6 +143,10 @@ void MultimediaConsumer<Parent>::StartApplication() // Called at time specified
   node->GetObject<Ipv4>()->GetAddress(1,0).GetBroadcast().Print(oss);
 
   super::strNodeIpv4 = oss.str();
+
+  ostringstream ossLocal;
+  node->GetObject<Ipv4>()->GetAddress(1,0).GetLocal().Print(ossLocal);
+  super::strLocalIpv4 = ossLocal.str();
   super::node_id = super::GetNode ()->GetId();
 
   NS_LOG_DEBUG("Client(" << super::node_id << "," << super::strNodeIpv4 << "): Starting Multimedia Consumer - Device Type: " << m_deviceType);
@@ -125,12 +161,15 @@ void MultimediaConsumer<Parent>::StartApplication() // Called at time specified
     int pos = new_url.find("/");
 
     string hostname = new_url.substr(0,pos);
+    super::m_hostName = hostname;
     super::m_hostName = super::getServerTableList(super::strNodeIpv4, super::m_contentId);
-    fprintf(stderr, "Client(%d,%s): Old Hostname = %s new Hostname = %s\n", super::node_id, super::strNodeIpv4.c_str(), hostname.c_str(), super::m_hostName.c_str());
+    // the server of the MPD, i.e. the origin, is a source of the multi-source downloads
+    super::m_sourceHosts.assign(1, hostname);
+    NS_LOG_INFO ("Client(" << super::node_id << "," << super::strNodeIpv4 << "): Old Hostname = " << hostname << " new Hostname = " << super::m_hostName);
 
     if (super::m_hostName != hostname) {
       stringstream ssValue;
-      ifstream inputFile("UsersConnection");
+      ifstream inputFile(super::m_usersConnectionFile.c_str());
 
       string line;
       while (getline(inputFile, line)) {
@@ -146,7 +185,7 @@ void MultimediaConsumer<Parent>::StartApplication() // Called at time specified
       inputFile.close();
 
       ofstream newOutputFile;
-      newOutputFile.open("UsersConnection", ios::out);
+      newOutputFile.open(super::m_usersConnectionFile.c_str(), ios::out);
       newOutputFile << ssValue.str();
       newOutputFile.flush();
       newOutputFile.close();
@@ -156,6 +195,10 @@ void MultimediaConsumer<Parent>::StartApplication() // Called at time specified
     mpd_request_name = new_url.substr(pos+1);
   }
 
+  if (!super::m_controllerAddress.IsInvalid()) {
+    super::AgentTryEstablishConnection();
+  }
+
   stringstream ss_tempDir;
   ss_tempDir << "-ns3-node-" << super::node_id;
 
@@ -178,6 +221,10 @@ void MultimediaConsumer<Parent>::StartApplication() // Called at time specified
   this->m_hasDownloadedAllSegments = false;
   this->m_freezeStartTime          = 0;
   this->totalConsumedSegments      = 0;
+  this->m_live                     = false;
+  this->m_liveOffset               = 0;
+  this->m_liveSegments.clear();
+  this->m_segmentRetries           = 0;
   this->requestedRepresentation    = NULL;
   this->requestedSegmentURL        = NULL;
 
@@ -196,7 +243,7 @@ void MultimediaConsumer<Parent>::StartApplication() // Called at time specified
 
   // do base stuff
   super::StartApplication();
-  fprintf(stderr, "Client(%d): Done starting multimedia application!\n", super::node_id);
+  NS_LOG_INFO ("Client(" << super::node_id << "): Done starting multimedia application!");
 }
 
 // Stop Application - Cancel any outstanding events
@@ -251,7 +298,33 @@ void MultimediaConsumer<Parent>::OnFileReceived(unsigned status, unsigned length
 {
   super::OnFileReceived(status, length);
 
-  fprintf(stderr, "Client: On File Received called\n");
+  NS_LOG_INFO ("Client: On File Received called");
+  if (status == 404) {
+    if (!m_mpdParsed) {
+      NS_LOG_ERROR ("Client(" << super::node_id << "): MPD not found");
+    } else if (m_segmentRetries >= m_maxSegmentRetries) {
+      NS_LOG_ERROR ("Client(" << super::node_id << "): segment " << super::m_fileToRequest << " not found after "
+                    << m_segmentRetries << " retries, stopping the download");
+      m_hasDownloadedAllSegments = true;
+      super::ForceCloseSocket();
+    } else if (m_live) {
+      // the segment left the time shift buffer, join the live point again
+      m_segmentRetries++;
+      NS_LOG_INFO ("Client(" << super::node_id << "): live segment " << requestedSegmentNr + m_liveOffset << " not available");
+      m_liveOffset = std::max(m_liveOffset, GetLiveSegment() - std::min(GetLiveSegment(), requestedSegmentNr));
+      RequestLiveSegment();
+    } else {
+      // e.g. an edge server which does not hold the content yet
+      Time backoff = Seconds(std::ldexp(1.0, m_segmentRetries));
+      m_segmentRetries++;
+      NS_LOG_WARN ("Client(" << super::node_id << "): segment " << super::m_fileToRequest << " not found, retrying in "
+                   << backoff.GetSeconds() << " s");
+      m_downloadEventTimer.Cancel();
+      m_downloadEventTimer = Simulator::Schedule(backoff, &MultimediaConsumer<Parent>::DownloadSegment, this);
+    }
+    return;
+  }
+  m_segmentRetries = 0;
   if (!m_mpdParsed) {
     OnMpdFile();
   } else {
@@ -296,6 +369,17 @@ void MultimediaConsumer<Parent>::OnMpdFile()
   this->m_baseURL = "";
   vector<dash::mpd::IBaseUrl*> baseUrls = this->mpd->GetBaseUrls ();
 
+  // every server of the base URLs is a source of the multi-source downloads
+  for (auto baseUrl : baseUrls) {
+    string url = baseUrl->GetUrl();
+    if (url.find("http://") == 0) {
+      string host = url.substr(7, url.find("/", 7) - 7);
+      if (find(super::m_sourceHosts.begin(), super::m_sourceHosts.end(), host) == super::m_sourceHosts.end()) {
+        super::m_sourceHosts.push_back(host);
+      }
+    }
+  }
+
   if (baseUrls.size() > 0) {
     if (baseUrls.size() == 1) {
       this->m_baseURL = baseUrls.at(0)->GetUrl();
@@ -326,6 +410,13 @@ void MultimediaConsumer<Parent>::OnMpdFile()
     return;
   }
 
+  // a dynamic MPD is a live stream, its segments are produced as time advances
+  this->m_live = this->mpd->GetType() == "dynamic";
+  if (this->m_live) {
+    this->m_availabilityStartTime = ParseDateTime(this->mpd->GetAvailabilityStarttime());
+    NS_LOG_DEBUG("Client(" << super::node_id << "): Live stream available since " << this->m_availabilityStartTime << " s");
+  }
+
   // Get the adaptation sets, though we are only takeing the first one
   vector<IAdaptationSet *> allAdaptationSets = currentPeriod->GetAdaptationSets();
 
@@ -447,6 +538,15 @@ void MultimediaConsumer<Parent>::OnMpdFile()
 
   this->m_curRepId = this->m_startRepresentationId;
 
+  if (this->m_live) {
+    ISegmentList* segmentList = this->m_availableRepresentations[this->m_curRepId]->GetSegmentList();
+    unsigned timescale = segmentList->GetTimescale() > 0 ? segmentList->GetTimescale() : 1;
+    this->m_segmentDuration = (double) segmentList->GetDuration() / timescale;
+    // join the live point, the target latency behind the last produced segment
+    this->m_liveOffset = GetLiveSegment();
+    NS_LOG_DEBUG("Client(" << super::node_id << "): Joining the live stream at segment " << this->m_liveOffset);
+  }
+
   // okay, check init segment
   if (initSegment == "" && this->m_hasInitSegment == true) {
     NS_LOG_DEBUG("Using init segment of representation " << m_startRepresentationId);
@@ -479,7 +579,7 @@ void MultimediaConsumer<Parent>::OnMpdFile()
   /* also we can delete the folder (m_tempDir) the MPD is stored in */
   string rmdir_cmd = "rm -rf " + m_tempDir;
   if (system(rmdir_cmd.c_str()) != 0) {
-    fprintf(stderr, "Error: could not delete directory '%s'.\n", m_tempDir.c_str());
+    NS_LOG_ERROR ("Error: could not delete directory '" << m_tempDir << "'.");
   }
 
   super::m_isMpd = false;
@@ -488,7 +588,7 @@ void MultimediaConsumer<Parent>::OnMpdFile()
 template<class Parent>
 void MultimediaConsumer<Parent>::OnMultimediaFile()
 {
-  fprintf(stderr, "Client(%d): On Multimedia File '%s'\n", super::node_id, super::m_fileToRequest.c_str());
+  NS_LOG_INFO ("Client(" << super::node_id << "): On Multimedia File '" << super::m_fileToRequest << "'");
 
   if (!super::m_active) {
     return;
@@ -517,9 +617,10 @@ void MultimediaConsumer<Parent>::OnMultimediaFile()
 
     // check if there is enough space in buffer
     if(mPlayer->EnoughSpaceInBuffer(requestedSegmentNr, requestedRepresentation, m_isLayeredContent)) {
-      if(mPlayer->AddToBuffer(requestedSegmentNr, requestedRepresentation, super::lastDownloadBitrate, m_isLayeredContent))
+      if(mPlayer->AddToBuffer(requestedSegmentNr, requestedRepresentation, super::lastDownloadBitrate, m_isLayeredContent)) {
         NS_LOG_DEBUG("Segment Accepted for Buffering");
-      else
+        NotifyBufferLevel();
+      } else
         NS_LOG_DEBUG("Segment Rejected for Buffering");
     } else {
       // try again in 1 second, and again and again... but do not donwload anything in the meantime
@@ -540,7 +641,7 @@ bool MultimediaConsumer<Parent>::DecompressFile(string source, string filename)
 
   //Tests if the file is being opened correctly.
   if (!infile) {
-   cerr << "Can't open file: " << source << endl;
+   NS_LOG_ERROR ("Can't open file: " << source);
    return false;
   }
 
@@ -624,10 +725,21 @@ double MultimediaConsumer<Parent>::consume()
       NS_LOG_DEBUG("Freeze Of " << freezeTime << " milliseconds is over!");
     }
 
+    if (this->m_live) {
+      auto liveSegment = this->m_liveSegments.find(entry.segmentNumber);
+      if (liveSegment != this->m_liveSegments.end()) {
+        // since the capture of the first frame of the segment, which is available one duration later
+        double latency = Simulator::Now().GetSeconds() - this->m_availabilityStartTime - liveSegment->second * this->m_segmentDuration;
+        m_liveLatencyTrace(liveSegment->second, latency);
+        this->m_liveSegments.erase(liveSegment);
+      }
+    }
+
     //fprintf(stderr,  "Current Buffer Level: %f\n", mPlayer->GetBufferLevel());
     m_playerTracer(this, this->m_userId, entry.segmentNumber, entry.repId, entry.experienced_bitrate_bit_s, freezeTime, (unsigned) (this->mPlayer->GetBufferLevel()), super::m_hostName);//entry.depIds);
 
     this->totalConsumedSegments++;
+    NotifyBufferLevel();
     return consumedSeconds;
   } else {
     // could not consume, means buffer is empty
@@ -635,6 +747,7 @@ double MultimediaConsumer<Parent>::consume()
       // this actually means that we have a stall/free (m_hasStartedPlaying == false would mean that this is part of start up delay)
       // set m_freezeStartTime
       this->m_freezeStartTime = Simulator::Now().GetMilliSeconds();
+      NotifyBufferLevel();
     }
 
     // continue trying to consume... - these are unsmooth seconds
@@ -642,6 +755,14 @@ double MultimediaConsumer<Parent>::consume()
   }
 }
 
+// lets the network (e.g. a video-aware LTE scheduler) know how close to a stall the player is
+template<class Parent>
+void MultimediaConsumer<Parent>::NotifyBufferLevel()
+{
+  uint64_t bitrate = (requestedRepresentation != NULL) ? requestedRepresentation->GetBandwidth() : 0;
+  m_bufferLevelTrace(this->mPlayer->GetBufferLevel(), bitrate);
+}
+
 template<class Parent>
 void MultimediaConsumer<Parent>::ScheduleDownloadOfInitSegment()
 {
@@ -691,10 +812,54 @@ void MultimediaConsumer<Parent>::DownloadSegment()
     return;
   }
 
+  if (this->m_live) {
+    RequestLiveSegment();
+    return;
+  }
+
+  RequestSegment(requestedSegmentURL->GetMediaURI());
+}
+
+template<class Parent>
+void MultimediaConsumer<Parent>::RequestSegment(string url)
+{
   super::StopApplication();
-  super::SetAttribute("FileToRequest", StringValue(m_baseURL + requestedSegmentURL->GetMediaURI()));
+  super::SetAttribute("FileToRequest", StringValue(m_baseURL + url));
   super::SetAttribute("WriteOutfile", StringValue(""));
   super::StartApplication();
 }
 
+// the segment of the live stream the target latency behind the last produced one
+template<class Parent>
+unsigned MultimediaConsumer<Parent>::GetLiveSegment()
+{
+  double produced = (Simulator::Now().GetSeconds() - this->m_availabilityStartTime - this->m_liveTargetLatency) / this->m_segmentDuration;
+  return produced > 0 ? (unsigned) produced : 0;
+}
+
+template<class Parent>
+void MultimediaConsumer<Parent>::RequestLiveSegment()
+{
+  unsigned segmentNr = this->requestedSegmentNr + this->m_liveOffset;
+  const vector<ISegmentURL*>& segmentURLs = this->requestedRepresentation->GetSegmentList()->GetSegmentURLs();
+
+  if (segmentNr >= segmentURLs.size()) {
+    NS_LOG_DEBUG("End of the live stream\n");
+    this->m_hasDownloadedAllSegments = true;
+    super::ForceCloseSocket();
+    return;
+  }
+  this->m_liveSegments[this->requestedSegmentNr] = segmentNr;
+
+  // wait for the segment to be produced
+  Time available = Seconds(this->m_availabilityStartTime + (segmentNr + 1) * this->m_segmentDuration);
+  if (available > Simulator::Now()) {
+    NS_LOG_DEBUG("Client(" << super::node_id << "): Waiting for live segment " << segmentNr << " until " << available.GetSeconds());
+    this->m_downloadEventTimer = Simulator::Schedule(available - Simulator::Now(), &MultimediaConsumer<Parent>::RequestSegment,
+                                                     this, segmentURLs.at(segmentNr)->GetMediaURI());
+    return;
+  }
+  RequestSegment(segmentURLs.at(segmentNr)->GetMediaURI());
+}
+
 } // namespace ns3
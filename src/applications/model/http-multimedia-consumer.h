@@ -71,6 +71,21 @@ public:
   MultimediaConsumer();
   virtual ~MultimediaConsumer();
 
+  /**
+   * \brief TracedCallback signature of the buffer level changes
+   * \param bufferLevel the buffer level, in seconds
+   * \param bitrate the bitrate of the requested representation, in bit/s
+   */
+  typedef void (* BufferLevelTracedCallback)(double bufferLevel, uint64_t bitrate);
+
+  /**
+   * \brief TracedCallback signature of the latency of a live stream
+   * \param segmentNumber the number of the segment starting to play
+   * \param latency how long after the capture of its first frame, i.e. after
+   *        availabilityStartTime + segmentNumber * duration, the segment starts to play, in seconds
+   */
+  typedef void (* LiveLatencyTracedCallback)(unsigned segmentNumber, double latency);
+
   virtual void   StartApplication(void);
   virtual void StopApplication(void);
 
@@ -91,9 +106,15 @@ protected:
 
   void DownloadSegment();
 
+  void RequestSegment(string url);
+
+  void RequestLiveSegment();
+  unsigned GetLiveSegment();
+
   void SchedulePlay(double wait_time = MULTIMEDIA_CONSUMER_LOOP_TIMER);
   void DoPlay();
   double consume();
+  void NotifyBufferLevel();
 
 protected:
   static string alphabet;
@@ -147,12 +168,24 @@ protected:
 
   bool m_isLayeredContent; ///< \brief tells us whether the content that this player is requesting is layered (e.g., SVC) or not (e.g., AVC)
 
+  bool m_live;                    ///< \brief whether the MPD is dynamic, i.e. a live stream
+  double m_liveTargetLatency;     ///< \brief the latency, in seconds, to join the live stream with
+  double m_availabilityStartTime; ///< \brief when the live stream started, in seconds of simulation time
+  double m_segmentDuration;       ///< \brief the duration of the segments, in seconds
+  unsigned m_liveOffset;          ///< \brief the segment of the live stream the player joined at
+  map<unsigned, unsigned> m_liveSegments; ///< \brief the segment of the live stream of each buffered segment
+  uint32_t m_maxSegmentRetries;   ///< \brief how many times a segment answered with a 404 is requested again
+  uint32_t m_segmentRetries;      ///< \brief the 404 answers received in a row
+
   EventId m_consumerLoopTimer;
   EventId m_downloadEventTimer;
 
   TracedCallback<Ptr<Application>, unsigned, unsigned, string, unsigned,
                 unsigned, unsigned, string /*vector<string>*/> m_playerTracer;
 
+  TracedCallback<double, uint64_t> m_bufferLevelTrace; ///< \brief buffer level (seconds) and bitrate (bit/s) of the requested representation
+  TracedCallback<unsigned, double> m_liveLatencyTrace; ///< \brief latency (seconds) of the live segments starting to play
+
 };
 
 } // namespace ns3
@@ -0,0 +1,192 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "http-range.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace ns3 {
+
+const uint32_t HttpRangePlanner::OPEN_RANGE;
+const uint32_t HttpRangePlanner::MIN_RANGE;
+
+bool
+ParseHttpRange (const std::string &request, long filesize, long *first, long *last)
+{
+  std::string::size_type pos = request.find ("Range: bytes=");
+  if (pos == std::string::npos || filesize <= 0)
+    {
+      return false;
+    }
+  const char *range = request.c_str () + pos + 13;
+  if (range[0] == '-')
+    {
+      // the last bytes of the file
+      long suffix;
+      if (std::sscanf (range + 1, "%ld", &suffix) != 1 || suffix <= 0)
+        {
+          return false;
+        }
+      *first = std::max (0L, filesize - suffix);
+      *last = filesize - 1;
+      return true;
+    }
+  // an open range goes to the end of the file
+  *last = filesize - 1;
+  if (std::sscanf (range, "%ld-%ld", first, last) < 1)
+    {
+      return false;
+    }
+  *last = std::min (*last, filesize - 1);
+  return *first >= 0 && *first <= *last;
+}
+
+HttpRangePlanner::HttpRangePlanner ()
+{
+  Reset ();
+}
+
+void
+HttpRangePlanner::Reset (void)
+{
+  m_total = 0;
+  m_nextByte = 0;
+  m_pending.clear ();
+}
+
+bool
+HttpRangePlanner::NextRange (double throughput, uint32_t servers, double chunkTime, uint32_t *first, uint32_t *last)
+{
+  if (m_pending.empty () && (m_total > 0 ? m_nextByte >= m_total : m_nextByte == OPEN_RANGE))
+    {
+      return false;
+    }
+
+  // a single server gets the whole file
+  uint32_t size = OPEN_RANGE;
+  if (servers > 1)
+    {
+      size = std::max (MIN_RANGE, static_cast<uint32_t> (std::min (throughput / 8 * chunkTime, 4294967295.0)));
+    }
+
+  if (!m_pending.empty ())
+    {
+      std::pair<uint32_t, uint32_t> &range = m_pending.front ();
+      *first = range.first;
+      *last = (range.second - *first < size) ? range.second : *first + size - 1;
+      if (*last == range.second)
+        {
+          m_pending.pop_front ();
+        }
+      else
+        {
+          range.first = *last + 1;
+        }
+      return true;
+    }
+
+  *first = m_nextByte;
+  *last = (size == OPEN_RANGE) ? OPEN_RANGE : *first + size - 1;
+  if (m_total > 0)
+    {
+      *last = std::min (*last, m_total - 1);
+    }
+  m_nextByte = (*last == OPEN_RANGE) ? OPEN_RANGE : *last + 1;
+  return true;
+}
+
+void
+HttpRangePlanner::Requeue (uint32_t first, uint32_t last)
+{
+  if (first <= last && (m_total == 0 || first < m_total))
+    {
+      m_pending.push_front (std::make_pair (first, m_total > 0 ? std::min (last, m_total - 1) : last));
+    }
+}
+
+bool
+HttpRangePlanner::ParseResponse (const std::string &header, uint32_t requested, uint32_t *first, uint32_t *last)
+{
+  if (header.compare (0, 9, "HTTP/1.1 ") != 0)
+    {
+      return false;
+    }
+  int status = std::atoi (header.c_str () + 9);
+
+  unsigned long total = 0;
+  if (status == 206)
+    {
+      std::string::size_type pos = header.find ("Content-Range: bytes ");
+      unsigned long begin, end;
+      if (pos == std::string::npos
+          || std::sscanf (header.c_str () + pos + 21, "%lu-%lu/%lu", &begin, &end, &total) != 3
+          || begin != requested || begin > end || end >= total)
+        {
+          return false;
+        }
+      *first = begin;
+      *last = end;
+    }
+  else if (status == 200 && m_total == 0)
+    {
+      // a server without ranges sends the whole file, to the only request in flight
+      std::string::size_type pos = header.find ("Content-Length: ");
+      if (pos == std::string::npos || (total = std::strtoul (header.c_str () + pos + 16, NULL, 10)) == 0)
+        {
+          return false;
+        }
+      m_pending.clear ();
+      *first = 0;
+      *last = total - 1;
+    }
+  else
+    {
+      return false;
+    }
+
+  if (m_total == 0)
+    {
+      m_total = total;
+      m_nextByte = std::max (std::min (m_nextByte, m_total), *last + 1);
+      for (std::list<std::pair<uint32_t, uint32_t> >::iterator range = m_pending.begin (); range != m_pending.end (); )
+        {
+          if (range->first >= m_total)
+            {
+              range = m_pending.erase (range);
+            }
+          else
+            {
+              range->second = std::min (range->second, m_total - 1);
+              ++range;
+            }
+        }
+    }
+  else if (total != m_total)
+    {
+      return false;
+    }
+  return true;
+}
+
+uint32_t
+HttpRangePlanner::GetTotal (void) const
+{
+  return m_total;
+}
+
+} // namespace ns3
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef HTTP_RANGE_H
+#define HTTP_RANGE_H
+
+#include <stdint.h>
+#include <list>
+#include <string>
+#include <utility>
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ *
+ * \brief Parse the "Range: bytes=" header of an HTTP request
+ *
+ * Three forms are understood: "first-last", the open range "first-" up to
+ * the end of the file and the suffix range "-n" of the last n bytes.  The
+ * last byte is clamped to the end of the file.
+ *
+ * \param request the HTTP request
+ * \param filesize the size of the requested file
+ * \param [out] first the first byte of the range
+ * \param [out] last the last byte of the range
+ * \return false if the request has no range the file can satisfy, the whole
+ *         file is then sent with a 200
+ */
+bool ParseHttpRange (const std::string &request, long filesize, long *first, long *last);
+
+/**
+ * \ingroup applications
+ *
+ * \brief Split a file in byte ranges downloaded from several servers
+ *
+ * The planner holds the bytes of the file still to request: the first byte
+ * never requested, and the ranges of the aborted requests, which are
+ * requested again first.  Each range is sized to last a given time at the
+ * throughput of the server which gets it, so the faster servers carry the
+ * larger share of the file.  The size of the file is unknown until the
+ * first response: a single server, or the first request, gets an open
+ * range.
+ */
+class HttpRangePlanner
+{
+public:
+  /** Last byte of an open range, up to the end of the file. */
+  static const uint32_t OPEN_RANGE = 0xffffffff;
+  /** Smallest range given to a server. */
+  static const uint32_t MIN_RANGE = 16 * 1024;
+
+  HttpRangePlanner ();
+
+  /** \brief Start a new file, of unknown size */
+  void Reset (void);
+
+  /**
+   * \brief Give the next range to a server
+   * \param throughput the throughput estimate of the server, in bit/s
+   * \param servers the number of servers sharing the file
+   * \param chunkTime the download time of a range at the throughput, in seconds
+   * \param [out] first the first byte of the range
+   * \param [out] last the last byte of the range, OPEN_RANGE for an open range
+   * \return false if no byte is left to request
+   */
+  bool NextRange (double throughput, uint32_t servers, double chunkTime, uint32_t *first, uint32_t *last);
+
+  /**
+   * \brief Request the bytes of an aborted range again, before the other ones
+   * \param first the first byte not received
+   * \param last the last byte of the aborted range
+   */
+  void Requeue (uint32_t first, uint32_t last);
+
+  /**
+   * \brief Check the header of the response to a range request
+   *
+   * A 206 must start at the requested byte.  A 200, from a server ignoring
+   * the Range header, is only accepted while the size of the file is
+   * unknown: it carries the whole file, so nothing is left to request.
+   * The first response sets the size of the file.
+   *
+   * \param header the header of the response
+   * \param requested the first byte requested
+   * \param [out] first the first byte of the response
+   * \param [out] last the last byte of the response
+   * \return false if the response does not match the request
+   */
+  bool ParseResponse (const std::string &header, uint32_t requested, uint32_t *first, uint32_t *last);
+
+  /** \return the size of the file, 0 until the first response */
+  uint32_t GetTotal (void) const;
+
+private:
+  uint32_t m_total; //!< size of the file, 0 until the first response
+  uint32_t m_nextByte; //!< first byte never requested
+  std::list<std::pair<uint32_t, uint32_t> > m_pending; //!< ranges of aborted requests, to request again
+};
+
+} // namespace ns3
+
+#endif /* HTTP_RANGE_H */
@@ -6,6 +6,9 @@
 
 #include "ns3/socket.h"
 #include "ns3/packet.h"
+#include "ns3/log.h"
+#include "dash-event-log.h"
+#include "http-range.h"
 
 
 #include <sys/types.h>
@@ -16,6 +19,9 @@
 namespace ns3
 {
 
+NS_LOG_COMPONENT_DEFINE ("HttpServerFakeClientSocket");
+DASH_EVENT_COMPONENT_DEFINE ("HttpServerFakeClientSocket");
+
 
 HttpServerFakeClientSocket::HttpServerFakeClientSocket(uint64_t socket_id,
     std::string contentDir,
@@ -40,7 +46,7 @@ HttpServerFakeClientSocket::HttpServerFakeClientSocket(uint64_t socket_id,
 
 HttpServerFakeClientSocket::~HttpServerFakeClientSocket()
 {
-  fprintf(stderr, "Server(%ld): Destructing Client Socket(%ld)...\n", m_socket_id, m_socket_id);
+  NS_LOG_INFO ("Server(" << m_socket_id << "): Destructing Client Socket(" << m_socket_id << ")...");
   this->m_bytesToTransmit.clear();
 }
 
@@ -126,7 +132,7 @@ void HttpServerFakeClientSocket::ConnectionClosedNormal(Ptr<Socket> socket)
   if (socket == 0) {
     return;
   }
-  fprintf(stderr, "Server(%ld): Connection closing normally...\n", m_socket_id);
+  NS_LOG_INFO ("Server(" << m_socket_id << "): Connection closing normally...");
   // just in case, make sure the callbacks are no longer active
 
   // remove the send callback
@@ -141,7 +147,7 @@ void HttpServerFakeClientSocket::ConnectionClosedError(Ptr<Socket> socket)
   if (socket == 0) {
     return;
   }
-  fprintf(stderr, "Server(%ld): Connection closing with error...\n", m_socket_id);
+  NS_LOG_WARN ("Server(" << m_socket_id << "): Connection closing with error...");
   // just in case, make sure the callbacks are no longer active
 
   // remove the send callback
@@ -169,29 +175,30 @@ long HttpServerFakeClientSocket::GetFileSize(std::string filename)
     return stat_buf.st_size;
   }
   // else: file not found
-  fprintf(stderr, "Server(%ld) ERROR: File not found: '%s'\n", m_socket_id, filename.c_str());
+  NS_LOG_ERROR ("Server(" << m_socket_id << ") ERROR: File not found: '" << filename << "'");
   return -1;
 }
 
 void HttpServerFakeClientSocket::LogCwndChange(uint32_t oldCwnd, uint32_t newCwnd)
 {
-  fprintf(stderr, "Server(%ld): Cwnd Changed %d -> %d\n", m_socket_id, oldCwnd, newCwnd);
+  NS_LOG_LOGIC ("Server(" << m_socket_id << "): Cwnd Changed " << oldCwnd << " -> " << newCwnd);
 }
 
 void HttpServerFakeClientSocket::LogStateChange(const ns3::TcpSocket::TcpStates_t old_state, const ns3::TcpSocket::TcpStates_t new_state)
 {
-  fprintf(stderr, "Server(%ld): Socket State Change %s -> %s\n", m_socket_id, ns3::TcpSocket::TcpStateName[old_state], ns3::TcpSocket::TcpStateName[new_state]);
+  NS_LOG_LOGIC ("Server(" << m_socket_id << "): Socket State Change " << ns3::TcpSocket::TcpStateName[old_state] << " -> " << ns3::TcpSocket::TcpStateName[new_state]);
 }
 
 void HttpServerFakeClientSocket::FinishedIncomingData(Ptr<Socket> socket, Address from, std::string data)
 {
-  fprintf(stderr, "Server(%ld)::FinishedIncomingData(socket,data=str(%ld))\n", m_socket_id, data.length());
+  NS_LOG_INFO ("Server(" << m_socket_id << ")::FinishedIncomingData(socket,data=str(" << data.length() << "))");
   // now parse this request (TODO) and reply
   std::string filename = m_content_dir  + ParseHTTPHeader(data);
 
   // fprintf(stderr, "Server(%ld): Opening '%s'\n", m_socket_id, filename.c_str());
 
   long filesize = GetFileSize(filename);
+  DASH_EVENT ("request", m_socket_id, filesize);
 
   m_is_virtual_file = false;
 
@@ -204,11 +211,22 @@ void HttpServerFakeClientSocket::FinishedIncomingData(Ptr<Socket> socket, Addres
     AddBytesToTransmit((uint8_t*)replyString.c_str(), replyString.length());
   } else
   {
+    long first = 0, last = filesize - 1;
+    bool partial = ParseHttpRange(data, filesize, &first, &last);
+    long length = last - first + 1;
+
     // Create a proper header
     std::stringstream replySS;
-    replySS << "HTTP/1.1 200 OK" << CRLF; // OR HTTP/1.1 404 Not Found
+    if (partial)
+    {
+      replySS << "HTTP/1.1 206 Partial Content" << CRLF;
+      replySS << "Content-Range: bytes " << first << "-" << last << "/" << filesize << CRLF;
+    } else
+    {
+      replySS << "HTTP/1.1 200 OK" << CRLF; // OR HTTP/1.1 404 Not Found
+    }
     replySS << "Content-Type: text/xml; charset=utf-8" << CRLF; // e.g., when sending the MPD
-    replySS << "Content-Length: " << filesize << CRLF;
+    replySS << "Content-Length: " << length << CRLF;
     replySS << CRLF;
 
     //fprintf(stderr, "Replying with header:\n%s\n", replySS.str().c_str());
@@ -228,7 +246,7 @@ void HttpServerFakeClientSocket::FinishedIncomingData(Ptr<Socket> socket, Addres
       // fprintf(stderr, "Server(%ld): Generating virtual payload of size %ld ...\n", m_socket_id, filesize);
 
 
-      this->m_totalBytesToTx += filesize;
+      this->m_totalBytesToTx += length;
       this->m_is_virtual_file = true;
 
       /*
@@ -255,16 +273,18 @@ void HttpServerFakeClientSocket::FinishedIncomingData(Ptr<Socket> socket, Addres
       // fprintf(stderr, "Server(%ld): Opening file on disk with size %ld ...\n", m_socket_id, filesize);
       // handle actual payload
       FILE* fp = fopen(filename.c_str(), "rb");
+      fseek(fp, first, SEEK_SET);
 
       int size_returned = 4096;
 
-      while (size_returned == 4096)
+      while (size_returned == 4096 && length > 0)
       {
-        size_returned = fread(tmp, 1, 4096, fp);
+        size_returned = fread(tmp, 1, std::min(4096L, length), fp);
 
         if (size_returned > 0)
         {
           AddBytesToTransmit(tmp, size_returned);
+          length -= size_returned;
         }
       }
 
@@ -293,7 +313,7 @@ HttpServerFakeClientSocket::HandleReadyToTransmit(Ptr<Socket> socket, uint32_t t
     {
       if (!m_is_shutdown)
       {
-        fprintf(stderr, "Server(%ld)::HandleReadyToTransmit: Sent %d bytes, now shutting down client socket (socket->close())\n", m_socket_id, m_currentBytesTx);
+        NS_LOG_LOGIC ("Server(" << m_socket_id << ")::HandleReadyToTransmit: Sent " << m_currentBytesTx << " bytes, now shutting down client socket (socket->close())");
 
         // Request this socket to close
         socket->Close();
@@ -361,12 +381,13 @@ HttpServerFakeClientSocket::HandleReadyToTransmit(Ptr<Socket> socket, uint32_t t
 
     int amountSent = socket->Send (replyPacket);
     if (amountSent <= 0) {
-      fprintf(stderr, "Server(%ld): failed to transmit %d bytes, waiting for next transmit...\n", m_socket_id, remainingBytes);
+      NS_LOG_WARN ("Server(" << m_socket_id << "): failed to transmit " << remainingBytes << " bytes, waiting for next transmit...");
       // we will be called again, when new TX space becomes available;
       return;
     }
 
     m_currentBytesTx += amountSent;
+    DASH_EVENT ("tx", m_socket_id, amountSent);
 
     //fprintf(stderr, "Server(%ld)::HandleReadyToTransmit - Transmitted %d bytes, %u remaining\n", m_socket_id, amountSent, m_totalBytesToTx - m_currentBytesTx);
   }
@@ -7,6 +7,10 @@
 
 #include "ns3/socket.h"
 #include "ns3/packet.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "dash-event-log.h"
+#include "http-range.h"
 
 
 #include <sys/types.h>
@@ -17,6 +21,9 @@
 namespace ns3
 {
 
+NS_LOG_COMPONENT_DEFINE ("HttpServerFakeVirtualClientSocket");
+DASH_EVENT_COMPONENT_DEFINE ("HttpServerFakeVirtualClientSocket");
+
 HttpServerFakeVirtualClientSocket::HttpServerFakeVirtualClientSocket(uint64_t socket_id,
     std::string contentDir,
     std::map<std::string /* filename */, long /* file size */>& fileSizes,
@@ -24,20 +31,41 @@ HttpServerFakeVirtualClientSocket::HttpServerFakeVirtualClientSocket(uint64_t so
     std::map<std::string, std::string>&  virtualHostedFiles, /* virtual file host */
     Callback<void, uint64_t> finished_callback) :
      HttpServerFakeClientSocket(socket_id, contentDir, fileSizes, fakeFiles, finished_callback),
-     m_virtualHostedFiles(virtualHostedFiles)
+     m_virtualHostedFiles(virtualHostedFiles),
+     m_liveAvailability(NULL)
 {
 
 }
 
 HttpServerFakeVirtualClientSocket::~HttpServerFakeVirtualClientSocket()
 {
-  fprintf(stderr, "Server(%ld): Destructing Fake Virtual Client Socket(%ld)...\n", m_socket_id, m_socket_id);
+  NS_LOG_INFO ("Server(" << m_socket_id << "): Destructing Fake Virtual Client Socket(" << m_socket_id << ")...");
   this->m_bytesToTransmit.clear();
 }
 
+void HttpServerFakeVirtualClientSocket::SetLiveSchedule(const std::map<std::string, Time>* availability, Time timeShiftBufferDepth)
+{
+  m_liveAvailability = availability;
+  m_timeShiftBufferDepth = timeShiftBufferDepth;
+}
+
+bool HttpServerFakeVirtualClientSocket::IsAvailable(std::string filename)
+{
+  if (m_liveAvailability == NULL) {
+    return true;
+  }
+  auto it = m_liveAvailability->find(filename);
+  if (it == m_liveAvailability->end()) {
+    return true;
+  }
+  // not produced yet, or out of the time shift buffer already
+  Time now = Simulator::Now();
+  return now >= it->second && now <= it->second + m_timeShiftBufferDepth;
+}
+
 void HttpServerFakeVirtualClientSocket::FinishedIncomingData(Ptr<Socket> socket, Address from, std::string data)
 {
-  fprintf(stderr, "VirtualServer(%ld)::FinishedIncomingData(socket,data=str(%ld))\n", m_socket_id, data.length());
+  NS_LOG_INFO ("VirtualServer(" << m_socket_id << ")::FinishedIncomingData(socket,data=str(" << data.length() << "))");
   // now parse this request (TODO) and reply
   std::string filename = m_content_dir  + ParseHTTPHeader(data);
 
@@ -45,6 +73,12 @@ void HttpServerFakeVirtualClientSocket::FinishedIncomingData(Ptr<Socket> socket,
 
   long filesize = GetFileSize(filename);
 
+  if (filesize != -1 && !IsAvailable(filename)) {
+    NS_LOG_INFO ("VirtualServer(" << m_socket_id << "): '" << filename << "' is not available at " << Simulator::Now().GetSeconds());
+    DASH_EVENT ("unavailable", m_socket_id, filesize);
+    filesize = -1;
+  }
+
   if (filesize == -1) {
     // fprintf(stderr, "VirtualServer(%ld): Error, '%s' not found!\n", m_socket_id, filename.c_str());
     // return 404
@@ -52,11 +86,27 @@ void HttpServerFakeVirtualClientSocket::FinishedIncomingData(Ptr<Socket> socket,
 
     AddBytesToTransmit((uint8_t*)replyString.c_str(), replyString.length());
   } else {
+    long first = 0, last = filesize - 1;
+    bool partial = ParseHttpRange(data, filesize, &first, &last);
+    long length = last - first + 1;
+
     // Create a proper header
     std::stringstream replySS;
-    replySS << "HTTP/1.1 200 OK" << CRLF; // OR HTTP/1.1 404 Not Found
+    if (partial) {
+      replySS << "HTTP/1.1 206 Partial Content" << CRLF;
+      replySS << "Content-Range: bytes " << first << "-" << last << "/" << filesize << CRLF;
+    } else {
+      replySS << "HTTP/1.1 200 OK" << CRLF; // OR HTTP/1.1 404 Not Found
+    }
     replySS << "Content-Type: text/xml; charset=utf-8" << CRLF; // e.g., when sending the MPD
-    replySS << "Content-Length: " << filesize << CRLF;
+    replySS << "Content-Length: " << length << CRLF;
+    if (m_liveAvailability != NULL) {
+      // the caches must drop a live segment when it leaves the time shift buffer
+      auto it = m_liveAvailability->find(filename);
+      if (it != m_liveAvailability->end()) {
+        replySS << "Cache-Control: max-age=" << (long) (it->second + m_timeShiftBufferDepth - Simulator::Now()).GetSeconds() << CRLF;
+      }
+    }
     replySS << CRLF;
 
     std::string replyString = replySS.str();
@@ -68,17 +118,18 @@ void HttpServerFakeVirtualClientSocket::FinishedIncomingData(Ptr<Socket> socket,
 
     if (std::find(m_virtualFiles.begin(), m_virtualFiles.end(), filename) != m_virtualFiles.end()) {
       // handle virtual payload fill tmp with some random data
-      fprintf(stderr, "VirtualServer(%ld): Generating virtual payload with size %ld ...\n", m_socket_id, filesize);
+      NS_LOG_INFO ("VirtualServer(" << m_socket_id << "): Generating virtual payload with size " << length << " ...");
+      DASH_EVENT ("payload", m_socket_id, length);
       for (int i = 0; i < 4096; i++) {
         tmp[i] = (uint8_t)rand();
       }
 
       int cnt = 0;
-      while (cnt < filesize) {
-        if (cnt + 4096 < filesize) {
+      while (cnt < length) {
+        if (cnt + 4096 < length) {
           AddBytesToTransmit(tmp, 4096);
         } else {
-          AddBytesToTransmit(tmp, filesize - cnt);
+          AddBytesToTransmit(tmp, length - cnt);
         }
         cnt += 4096;
       }
@@ -88,20 +139,22 @@ void HttpServerFakeVirtualClientSocket::FinishedIncomingData(Ptr<Socket> socket,
 
       std::string bytes_memory = m_virtualHostedFiles[filename];
 
-      AddBytesToTransmit((const uint8_t*)bytes_memory.c_str(),bytes_memory.length());
+      AddBytesToTransmit((const uint8_t*)bytes_memory.c_str() + first, length);
 
     } else {
       // fprintf(stderr, "VirtualServer(%ld): Opening file on disk with size %ld ...\n", m_socket_id, filesize);
       // handle actual payload
       FILE* fp = fopen(filename.c_str(), "rb");
+      fseek(fp, first, SEEK_SET);
 
       int size_returned = 4096;
 
-      while (size_returned == 4096) {
-        size_returned = fread(tmp, 1, 4096, fp);
+      while (size_returned == 4096 && length > 0) {
+        size_returned = fread(tmp, 1, std::min(4096L, length), fp);
 
         if (size_returned > 0) {
           AddBytesToTransmit(tmp, size_returned);
+          length -= size_returned;
         }
       }
 
@@ -3,6 +3,8 @@
 
 #include "http-server-fake-clientsocket.h"
 
+#include "ns3/nstime.h"
+
 namespace ns3
 {
 class Socket;
@@ -19,9 +21,20 @@ public:
 
   ~HttpServerFakeVirtualClientSocket();
 
+  /**
+   * Serve the segments of a live stream only within their availability window:
+   * from their availability time and during timeShiftBufferDepth
+   */
+  void SetLiveSchedule(const std::map<std::string, Time>* availability, Time timeShiftBufferDepth);
+
 protected:
   std::map<std::string,std::string>& m_virtualHostedFiles;
 
+  const std::map<std::string, Time>* m_liveAvailability;
+  Time m_timeShiftBufferDepth;
+
+  bool IsAvailable(std::string filename);
+
   void FinishedIncomingData(Ptr<Socket> socket, Address from, std::string data);
 
 
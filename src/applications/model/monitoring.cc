@@ -28,7 +28,7 @@ TypeId Monitoring::GetTypeId (void)
     return tid;
 }
 
-Monitoring::Monitoring()
+Monitoring::Monitoring() : totalBytes(0)
 {
     NS_LOG_FUNCTION (this);
 }
@@ -55,6 +55,7 @@ void Monitoring::RateCallback(string context, Ptr<const Packet> packet)
     string ipAddrBdst = Ipv4AddressToString(iaddr.GetBroadcast());
 
     setLinkMap(ipAddrBdst, getLinkMap(ipAddrBdst) + packet->GetSize());
+    totalBytes += packet->GetSize();
 }
 
 void Monitoring::BandwidthEstimator()
@@ -73,7 +74,7 @@ void Monitoring::BandwidthEstimator()
             int actualNode = this->peerMap[iplink].first;
             int nextNode   = this->peerMap[iplink].second;
 
-            cout << "Congested Link = ("<< actualNode << ", " << nextNode << ")" << endl;
+            NS_LOG_INFO ("Congested Link = ("<< actualNode << ", " << nextNode << ")");
 
             this->controller->OptimizerComponent(actualNode, nextNode);
         }
@@ -88,6 +89,11 @@ void Monitoring::setController(Ptr<ControllerMain> controller)
 }
 
 
+uint64_t Monitoring::getTotalBytes()
+{
+    return this->totalBytes;
+}
+
 void Monitoring::setToRedirect(bool toRedirect)
 {
     this->toRedirect = toRedirect;
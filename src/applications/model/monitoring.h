@@ -45,6 +45,8 @@ public:
 
     void setController(Ptr<ControllerMain> controller);
 
+    uint64_t getTotalBytes();
+
 private:
     string Ipv4AddressToString (Ipv4Address ad);
 
@@ -53,6 +55,8 @@ private:
     string pathFile;
     double stepsTime;
 
+    uint64_t totalBytes;
+
     map<string, double> linkMap;
     map<string, double> linkCapacityMap;
     map<string, pair<int, int>> peerMap;
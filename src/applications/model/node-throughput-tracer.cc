@@ -153,6 +153,13 @@ NodeThroughputTracer::~NodeThroughputTracer()
 void
 NodeThroughputTracer::Connect()
 {
+  if (m_nodePtr != 0) {
+    // only visit the applications of this node
+    static const Config::PreparedPath path("ApplicationList/*/ThroughputTracer");
+    path.ConnectWithoutContext(m_nodePtr, MakeCallback(&NodeThroughputTracer::ThroughputStats, this));
+    return;
+  }
+
   Config::ConnectWithoutContext("/NodeList/" + m_node
                                   + "/ApplicationList/*/ThroughputTracer",
                                 MakeCallback(&NodeThroughputTracer::ThroughputStats,
@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/dash-event-log.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+
+#include <sstream>
+
+using namespace ns3;
+
+DASH_EVENT_COMPONENT_DEFINE ("DashEventLogTest");
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Record events from scheduled events and check the dumped records:
+ * time, context, component, event name and values, oldest first.
+ */
+class DashEventLogRecordTestCase : public TestCase
+{
+public:
+  DashEventLogRecordTestCase ();
+  virtual ~DashEventLogRecordTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Record an event.
+   * \param a first value
+   * \param b second value
+   */
+  static void RecordEvent (int64_t a, int64_t b);
+};
+
+DashEventLogRecordTestCase::DashEventLogRecordTestCase ()
+  : TestCase ("Fields of the recorded DASH events")
+{
+}
+
+DashEventLogRecordTestCase::~DashEventLogRecordTestCase ()
+{
+}
+
+void
+DashEventLogRecordTestCase::RecordEvent (int64_t a, int64_t b)
+{
+  DASH_EVENT ("get", a, b);
+}
+
+void
+DashEventLogRecordTestCase::DoRun (void)
+{
+  DashEventLog::Clear ();
+  DashEventLog::Enable ("DashEventLogTest");
+
+  Simulator::ScheduleWithContext (3, Seconds (1.5), &DashEventLogRecordTestCase::RecordEvent, 10, 20);
+  Simulator::ScheduleWithContext (7, Seconds (2), &DashEventLogRecordTestCase::RecordEvent, -1, 1500000000000);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  // outside of the simulation: no context
+  RecordEvent (4, 5);
+
+  std::ostringstream os;
+  DashEventLog::Dump (os);
+  NS_TEST_ASSERT_MSG_EQ (DashEventLog::GetNRecorded (), 3, "Wrong number of recorded events");
+  NS_TEST_ASSERT_MSG_EQ (os.str (),
+                         "1.5 3 DashEventLogTest get 10 20\n"
+                         "2 7 DashEventLogTest get -1 1500000000000\n"
+                         "0 - DashEventLogTest get 4 5\n",
+                         "Wrong dumped records");
+
+  // a disabled component records nothing and does not evaluate the values
+  DashEventLog::Disable ("DashEventLogTest");
+  int evaluated = 0;
+  DASH_EVENT ("get", ++evaluated, 0);
+  NS_TEST_ASSERT_MSG_EQ (evaluated, 0, "Values evaluated for a disabled component");
+  NS_TEST_ASSERT_MSG_EQ (DashEventLog::GetNRecorded (), 3, "Event recorded by a disabled component");
+
+  DashEventLog::Clear ();
+  std::ostringstream cleared;
+  DashEventLog::Dump (cleared);
+  NS_TEST_ASSERT_MSG_EQ (cleared.str (), "", "Events dumped after Clear");
+}
+
+void
+DashEventLogRecordTestCase::DoTeardown (void)
+{
+  DashEventLog::Disable ("DashEventLogTest");
+  DashEventLog::Clear ();
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Check the sampling period set by EnableFromString and the ring
+ * buffer, which keeps the most recent events.
+ */
+class DashEventLogSamplingTestCase : public TestCase
+{
+public:
+  DashEventLogSamplingTestCase ();
+  virtual ~DashEventLogSamplingTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+};
+
+DashEventLogSamplingTestCase::DashEventLogSamplingTestCase ()
+  : TestCase ("Sampling and ring buffer of the DASH event log")
+{
+}
+
+DashEventLogSamplingTestCase::~DashEventLogSamplingTestCase ()
+{
+}
+
+void
+DashEventLogSamplingTestCase::DoRun (void)
+{
+  DashEventLog::Clear ();
+  DashEventLog::EnableFromString ("DashEventLogTest=3:DashEventLogUnknown");
+  for (int i = 0; i < 9; ++i)
+    {
+      DASH_EVENT ("rx", i, 0);
+    }
+  std::ostringstream sampled;
+  DashEventLog::Dump (sampled);
+  NS_TEST_ASSERT_MSG_EQ (sampled.str (),
+                         "0 - DashEventLogTest rx 0 0\n"
+                         "0 - DashEventLogTest rx 3 0\n"
+                         "0 - DashEventLogTest rx 6 0\n",
+                         "Wrong sampled records");
+
+  // the ring keeps the last events, oldest first
+  DashEventLog::SetCapacity (4);
+  DashEventLog::Enable ("DashEventLogTest");
+  for (int i = 0; i < 6; ++i)
+    {
+      DASH_EVENT ("rx", i, 2 * i);
+    }
+  std::ostringstream ring;
+  DashEventLog::Dump (ring);
+  NS_TEST_ASSERT_MSG_EQ (DashEventLog::GetNRecorded (), 6, "Overwritten events not counted");
+  NS_TEST_ASSERT_MSG_EQ (ring.str (),
+                         "0 - DashEventLogTest rx 2 4\n"
+                         "0 - DashEventLogTest rx 3 6\n"
+                         "0 - DashEventLogTest rx 4 8\n"
+                         "0 - DashEventLogTest rx 5 10\n",
+                         "Wrong records kept by the ring buffer");
+}
+
+void
+DashEventLogSamplingTestCase::DoTeardown (void)
+{
+  DashEventLog::Disable ("*");
+  DashEventLog::SetCapacity (65536);
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief DASH event log TestSuite
+ */
+class DashEventLogTestSuite : public TestSuite
+{
+public:
+  DashEventLogTestSuite ();
+};
+
+DashEventLogTestSuite::DashEventLogTestSuite ()
+  : TestSuite ("dash-event-log", UNIT)
+{
+  AddTestCase (new DashEventLogRecordTestCase, TestCase::QUICK);
+  AddTestCase (new DashEventLogSamplingTestCase, TestCase::QUICK);
+}
+
+static DashEventLogTestSuite dashEventLogTestSuite; ///< Static variable for test initialization
@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/ctrl-main.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Check the server table entries of a user followed across LTE handovers
+ * by the ControllerMain: the user is redirected to the edge server of
+ * its new cell, and goes back to the server of its group when it moves
+ * to a cell without an edge server or when the handover fails.
+ */
+class DashHandoverRedirectTestCase : public TestCase
+{
+public:
+  DashHandoverRedirectTestCase ();
+  virtual ~DashHandoverRedirectTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+DashHandoverRedirectTestCase::DashHandoverRedirectTestCase ()
+  : TestCase ("Redirect of the DASH users across LTE handovers")
+{
+}
+
+DashHandoverRedirectTestCase::~DashHandoverRedirectTestCase ()
+{
+}
+
+void
+DashHandoverRedirectTestCase::DoRun (void)
+{
+  const std::string user = "7.0.0.2";
+  const std::string group = "7.255.255.255";
+  const uint64_t imsi = 1;
+  const int content = 1;
+
+  // the edge servers belong to another rank, so that the controller only
+  // keeps the placement of the contents without opening their files
+  Ptr<Node> controllerNode = CreateObject<Node> ();
+  NodeContainer edges;
+  edges.Add (CreateObject<Node> (1));
+  edges.Add (CreateObject<Node> (1));
+
+  NodeContainer all (controllerNode, edges);
+  InternetStackHelper internet;
+  internet.Install (all);
+  SimpleNetDeviceHelper simple;
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (simple.Install (all));
+  std::ostringstream edge1;
+  interfaces.GetAddress (2).Print (edge1);
+
+  std::map<std::pair<std::string, int>, std::string> serverTable;
+  serverTable[std::make_pair (group, content)] = "1.0.0.2";
+
+  Ptr<ControllerMain> controller = CreateObject<ControllerMain> ();
+  controllerNode->AddApplication (controller);
+  controller->SetStartTime (Seconds (1000));
+  controller->setNodeContainers (&edges);
+  controller->setServerTable (&serverTable);
+  controller->setEdgeCapacity (0, 1);
+  controller->setEdgeCapacity (1, 1);
+  controller->CacheNodes ();
+
+  // cell 3 has no edge server
+  controller->setCellEdge (1, 0);
+  controller->setCellEdge (2, 1);
+  controller->addHandoverUser (imsi, user, content);
+
+  controller->NotifyHandoverStart (imsi, 1, 1, 2);
+  NS_TEST_ASSERT_MSG_EQ (serverTable.count (std::make_pair (user, content)), 0, "Redirected before the end of the handover");
+  controller->NotifyHandoverEndOk (imsi, 2, 2);
+  NS_TEST_ASSERT_MSG_EQ (serverTable.count (std::make_pair (user, content)), 1, "Not redirected after the handover");
+  NS_TEST_ASSERT_MSG_EQ (serverTable[std::make_pair (user, content)], edge1.str (), "Not redirected to the edge of the new cell");
+
+  controller->NotifyHandoverStart (imsi, 2, 2, 3);
+  NS_TEST_ASSERT_MSG_EQ (serverTable.count (std::make_pair (user, content)), 0, "Still pinned to the edge of the previous cell");
+  controller->NotifyHandoverEndOk (imsi, 3, 3);
+  NS_TEST_ASSERT_MSG_EQ (serverTable.count (std::make_pair (user, content)), 0, "Redirected in a cell without edge server");
+
+  controller->NotifyHandoverStart (imsi, 3, 3, 2);
+  controller->NotifyHandoverEndOk (imsi, 2, 4);
+  NS_TEST_ASSERT_MSG_EQ (serverTable.count (std::make_pair (user, content)), 1, "Not redirected after the second handover");
+
+  controller->NotifyHandoverStart (imsi, 2, 4, 1);
+  controller->NotifyHandoverEndError (imsi, 2, 4);
+  NS_TEST_ASSERT_MSG_EQ (serverTable.count (std::make_pair (user, content)), 0, "Still pinned to an edge after a failed handover");
+  NS_TEST_ASSERT_MSG_EQ (serverTable[std::make_pair (group, content)], "1.0.0.2", "The entry of the group changed");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief DASH handover TestSuite
+ */
+class DashHandoverTestSuite : public TestSuite
+{
+public:
+  DashHandoverTestSuite ();
+};
+
+DashHandoverTestSuite::DashHandoverTestSuite ()
+  : TestSuite ("dash-handover", UNIT)
+{
+  AddTestCase (new DashHandoverRedirectTestCase, TestCase::QUICK);
+}
+
+static DashHandoverTestSuite dashHandoverTestSuite; ///< Static variable for test initialization
@@ -0,0 +1,337 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/http-range.h"
+#include "ns3/test.h"
+
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * Build the header of a 206 response.
+ * \param first the first byte of the range
+ * \param last the last byte of the range
+ * \param total the size of the file
+ * \return the header
+ */
+static std::string
+PartialContent (uint32_t first, uint32_t last, uint32_t total)
+{
+  std::ostringstream os;
+  os << "HTTP/1.1 206 Partial Content\r\n"
+     << "Content-Range: bytes " << first << "-" << last << "/" << total << "\r\n"
+     << "Content-Length: " << last - first + 1 << "\r\n\r\n";
+  return os.str ();
+}
+
+/**
+ * Format a range.
+ * \param first the first byte of the range
+ * \param last the last byte of the range
+ * \return "first-last"
+ */
+static std::string
+Range (long first, long last)
+{
+  std::ostringstream os;
+  os << first << "-" << last;
+  return os.str ();
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Check the ranges the fake HTTP servers read from the requests: closed,
+ * open and suffix ranges, clamped to the file.
+ */
+class HttpRangeParseTestCase : public TestCase
+{
+public:
+  HttpRangeParseTestCase ();
+  virtual ~HttpRangeParseTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Parse the range of a request for a file of 1000 bytes.
+   * \param range the value of the Range header, empty for no header
+   * \return the range, or "all" if the whole file is sent
+   */
+  static std::string Parse (const std::string &range);
+};
+
+HttpRangeParseTestCase::HttpRangeParseTestCase ()
+  : TestCase ("Ranges of the HTTP requests")
+{
+}
+
+HttpRangeParseTestCase::~HttpRangeParseTestCase ()
+{
+}
+
+std::string
+HttpRangeParseTestCase::Parse (const std::string &range)
+{
+  std::string request = "GET /video/seg1.m4s HTTP/1.1\r\nHost: 10.0.0.1\r\n";
+  if (!range.empty ())
+    {
+      request += "Range: " + range + "\r\n";
+    }
+  request += "Connection: keep-alive\r\n\r\n";
+  long first = -1, last = -1;
+  if (!ParseHttpRange (request, 1000, &first, &last))
+    {
+      return "all";
+    }
+  return Range (first, last);
+}
+
+void
+HttpRangeParseTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (Parse (""), "all", "Range without a Range header");
+  NS_TEST_ASSERT_MSG_EQ (Parse ("bytes=10-19"), "10-19", "Wrong closed range");
+  NS_TEST_ASSERT_MSG_EQ (Parse ("bytes=990-2000"), "990-999", "Range not clamped to the file");
+  NS_TEST_ASSERT_MSG_EQ (Parse ("bytes=100-"), "100-999", "Wrong open range");
+  NS_TEST_ASSERT_MSG_EQ (Parse ("bytes=-300"), "700-999", "Wrong suffix range");
+  NS_TEST_ASSERT_MSG_EQ (Parse ("bytes=-5000"), "0-999", "Suffix range not clamped to the file");
+  NS_TEST_ASSERT_MSG_EQ (Parse ("bytes=-0"), "all", "Empty suffix range accepted");
+  NS_TEST_ASSERT_MSG_EQ (Parse ("bytes=1000-"), "all", "Range after the end of the file accepted");
+  NS_TEST_ASSERT_MSG_EQ (Parse ("bytes=20-10"), "all", "Reversed range accepted");
+  NS_TEST_ASSERT_MSG_EQ (Parse ("bytes=x"), "all", "Malformed range accepted");
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Split a file between a fast and a slow server: each range lasts the
+ * chunk time at the throughput of its server, the ranges cover the
+ * file once, and a single server gets an open range.
+ */
+class HttpRangeSplitTestCase : public TestCase
+{
+public:
+  HttpRangeSplitTestCase ();
+  virtual ~HttpRangeSplitTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+HttpRangeSplitTestCase::HttpRangeSplitTestCase ()
+  : TestCase ("Throughput-proportional ranges")
+{
+}
+
+HttpRangeSplitTestCase::~HttpRangeSplitTestCase ()
+{
+}
+
+void
+HttpRangeSplitTestCase::DoRun (void)
+{
+  HttpRangePlanner planner;
+  uint32_t first, last;
+
+  // a single server gets the whole file
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (8e6, 1, 0.5, &first, &last), true, "No range for a single server");
+  NS_TEST_ASSERT_MSG_EQ (first, 0, "Wrong first byte of the open range");
+  NS_TEST_ASSERT_MSG_EQ (last, HttpRangePlanner::OPEN_RANGE, "No open range for a single server");
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (8e6, 1, 0.5, &first, &last), false, "Range after an open range");
+
+  // 8 Mb/s and 2 Mb/s, 0.5 s per range: 500000 and 125000 bytes
+  planner.Reset ();
+  const uint32_t total = 1875000;
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (8e6, 2, 0.5, &first, &last), true, "No first range");
+  NS_TEST_ASSERT_MSG_EQ (Range (first, last), "0-499999", "Wrong range of the fast server");
+  NS_TEST_ASSERT_MSG_EQ (planner.ParseResponse (PartialContent (first, last, total), first, &first, &last), true,
+                         "First response rejected");
+  NS_TEST_ASSERT_MSG_EQ (planner.GetTotal (), total, "Size of the file not set by the first response");
+
+  uint32_t bytes[2] = { 500000, 0 };
+  uint32_t next = 500000;
+  for (uint32_t i = 1; ; ++i)
+    {
+      uint32_t server = i % 2;
+      if (!planner.NextRange (server == 0 ? 8e6 : 2e6, 2, 0.5, &first, &last))
+        {
+          break;
+        }
+      NS_TEST_ASSERT_MSG_EQ (first, next, "Range " << i << " does not follow the previous one");
+      uint32_t expected = server == 0 ? 500000 : 125000;
+      NS_TEST_ASSERT_MSG_EQ (last - first + 1, std::min (expected, total - first), "Wrong size of range " << i);
+      bytes[server] += last - first + 1;
+      next = last + 1;
+    }
+  NS_TEST_ASSERT_MSG_EQ (next, total, "The ranges do not cover the file");
+  NS_TEST_ASSERT_MSG_EQ (bytes[0], 1500000, "Wrong share of the fast server");
+  NS_TEST_ASSERT_MSG_EQ (bytes[1], 375000, "Wrong share of the slow server");
+
+  // a very slow server still gets the smallest range
+  planner.Reset ();
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (1e3, 2, 0.5, &first, &last), true, "No range for a slow server");
+  NS_TEST_ASSERT_MSG_EQ (last - first + 1, HttpRangePlanner::MIN_RANGE, "Range smaller than the smallest range");
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * A server stalls in the middle of its range: the bytes it did not send
+ * are requested again from the other server, before the bytes never
+ * requested.
+ */
+class HttpRangeRequeueTestCase : public TestCase
+{
+public:
+  HttpRangeRequeueTestCase ();
+  virtual ~HttpRangeRequeueTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+HttpRangeRequeueTestCase::HttpRangeRequeueTestCase ()
+  : TestCase ("Requeue the rest of a stalled range")
+{
+}
+
+HttpRangeRequeueTestCase::~HttpRangeRequeueTestCase ()
+{
+}
+
+void
+HttpRangeRequeueTestCase::DoRun (void)
+{
+  HttpRangePlanner planner;
+  uint32_t first, last;
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (8e6, 2, 0.5, &first, &last), true, "No first range");
+  NS_TEST_ASSERT_MSG_EQ (planner.ParseResponse (PartialContent (0, 499999, 1000000), 0, &first, &last), true,
+                         "First response rejected");
+
+  // the fast server stalls after 200000 bytes of its range
+  planner.Requeue (200000, 499999);
+
+  // the slow server gets the rest in ranges of its size, then the new bytes
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (2e6, 2, 0.5, &first, &last), true, "No range after the stall");
+  NS_TEST_ASSERT_MSG_EQ (Range (first, last), "200000-324999", "Wrong first requeued range");
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (2e6, 2, 0.5, &first, &last), true, "No second requeued range");
+  NS_TEST_ASSERT_MSG_EQ (Range (first, last), "325000-449999", "Wrong second requeued range");
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (2e6, 2, 0.5, &first, &last), true, "No end of the requeued range");
+  NS_TEST_ASSERT_MSG_EQ (Range (first, last), "450000-499999", "Wrong end of the requeued range");
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (2e6, 2, 0.5, &first, &last), true, "No range after the requeued bytes");
+  NS_TEST_ASSERT_MSG_EQ (Range (first, last), "500000-624999", "Wrong range after the requeued bytes");
+
+  // an open range stalls before the size of the file is known: the size
+  // of the first response trims the requeued range
+  planner.Reset ();
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (8e6, 1, 0.5, &first, &last), true, "No open range");
+  planner.Requeue (0, last);
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (8e6, 2, 0.5, &first, &last), true, "Stalled open range not requeued");
+  NS_TEST_ASSERT_MSG_EQ (Range (first, last), "0-499999", "Wrong range of the requeued open range");
+  NS_TEST_ASSERT_MSG_EQ (planner.ParseResponse (PartialContent (0, 499999, 600000), 0, &first, &last), true,
+                         "Response to the requeued range rejected");
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (8e6, 2, 0.5, &first, &last), true, "No rest of the requeued open range");
+  NS_TEST_ASSERT_MSG_EQ (Range (first, last), "500000-599999", "Requeued open range not trimmed");
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (8e6, 2, 0.5, &first, &last), false, "Range after the end of the file");
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Check the responses to the range requests: a server ignoring the Range
+ * header sends the whole file with a 200, which ends the splitting, and
+ * the responses which do not match the request are rejected.
+ */
+class HttpRangeResponseTestCase : public TestCase
+{
+public:
+  HttpRangeResponseTestCase ();
+  virtual ~HttpRangeResponseTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+HttpRangeResponseTestCase::HttpRangeResponseTestCase ()
+  : TestCase ("Responses to the range requests")
+{
+}
+
+HttpRangeResponseTestCase::~HttpRangeResponseTestCase ()
+{
+}
+
+void
+HttpRangeResponseTestCase::DoRun (void)
+{
+  HttpRangePlanner planner;
+  uint32_t first, last;
+
+  // a 200 to the first request carries the whole file
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (8e6, 2, 0.5, &first, &last), true, "No first range");
+  planner.Requeue (100, 200);
+  NS_TEST_ASSERT_MSG_EQ (planner.ParseResponse ("HTTP/1.1 200 OK\r\nContent-Length: 3000000\r\n\r\n", 0, &first, &last), true,
+                         "200 fallback rejected");
+  NS_TEST_ASSERT_MSG_EQ (Range (first, last), "0-2999999", "The 200 does not carry the whole file");
+  NS_TEST_ASSERT_MSG_EQ (planner.GetTotal (), 3000000, "Size of the file not set by the 200");
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (8e6, 2, 0.5, &first, &last), false, "Range requested after a 200");
+
+  // once the size is known, a 200 does not match a range request
+  planner.Reset ();
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (8e6, 2, 0.5, &first, &last), true, "No first range");
+  NS_TEST_ASSERT_MSG_EQ (planner.ParseResponse (PartialContent (0, 499999, 1000000), 0, &first, &last), true,
+                         "First response rejected");
+  NS_TEST_ASSERT_MSG_EQ (planner.NextRange (8e6, 2, 0.5, &first, &last), true, "No second range");
+  NS_TEST_ASSERT_MSG_EQ (planner.ParseResponse ("HTTP/1.1 200 OK\r\nContent-Length: 1000000\r\n\r\n", first, &first, &last), false,
+                         "200 accepted after the size of the file is known");
+  NS_TEST_ASSERT_MSG_EQ (planner.ParseResponse (PartialContent (400000, 999999, 1000000), 500000, &first, &last), false,
+                         "206 not starting at the requested byte accepted");
+  NS_TEST_ASSERT_MSG_EQ (planner.ParseResponse (PartialContent (500000, 999999, 2000000), 500000, &first, &last), false,
+                         "206 of a file of another size accepted");
+  NS_TEST_ASSERT_MSG_EQ (planner.ParseResponse ("HTTP/1.1 404 Not Found\r\n\r\n", 500000, &first, &last), false,
+                         "404 accepted");
+  NS_TEST_ASSERT_MSG_EQ (planner.ParseResponse (PartialContent (500000, 999999, 1000000), 500000, &first, &last), true,
+                         "Matching 206 rejected");
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief HTTP range TestSuite
+ */
+class HttpRangeTestSuite : public TestSuite
+{
+public:
+  HttpRangeTestSuite ();
+};
+
+HttpRangeTestSuite::HttpRangeTestSuite ()
+  : TestSuite ("http-range", UNIT)
+{
+  AddTestCase (new HttpRangeParseTestCase, TestCase::QUICK);
+  AddTestCase (new HttpRangeSplitTestCase, TestCase::QUICK);
+  AddTestCase (new HttpRangeRequeueTestCase, TestCase::QUICK);
+  AddTestCase (new HttpRangeResponseTestCase, TestCase::QUICK);
+}
+
+static HttpRangeTestSuite httpRangeTestSuite; ///< Static variable for test initialization
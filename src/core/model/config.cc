@@ -150,6 +150,8 @@ MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &
 /**
  * \ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is parsed once, into a list of index ranges.
  */
 class ArrayMatcher
 {
@@ -176,8 +178,16 @@ private:
    * \returns \c true if the string could be converted.
    */
   bool StringToUint32 (std::string str, uint32_t *value) const;
+  /**
+   * Parse one alternative of the specification into m_ranges.
+   *
+   * \param [in] element A "*", "[min-max]" or index alternative.
+   */
+  void Parse (std::string element);
   /** The Config path element. */
   std::string m_element;
+  /** The index ranges, bounds included, matched by m_element. */
+  std::vector<std::pair<std::size_t, std::size_t> > m_ranges;
 
 };  // class ArrayMatcher
 
@@ -186,66 +196,59 @@ ArrayMatcher::ArrayMatcher (std::string element)
   : m_element (element)
 {
   NS_LOG_FUNCTION (this << element);
-}
-bool
-ArrayMatcher::Matches (std::size_t i) const
-{
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  std::string::size_type start = 0;
+  std::string::size_type bar;
+  while ((bar = element.find ("|", start)) != std::string::npos)
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches *");
-      return true;
+      Parse (element.substr (start, bar - start));
+      start = bar + 1;
     }
-  std::string::size_type tmp;
-  tmp = m_element.find ("|");
-  if (tmp != std::string::npos)
+  Parse (element.substr (start));
+}
+void
+ArrayMatcher::Parse (std::string element)
+{
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
     {
-      std::string left = m_element.substr (0, tmp-0);
-      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-      return false;
+      m_ranges.push_back (std::make_pair (0, static_cast<std::size_t> (-1)));
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1 &&
       dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
       if (StringToUint32 (lowerBound, &min) && 
-          StringToUint32 (upperBound, &max) &&
-          i >= min && i <= max)
+          StringToUint32 (upperBound, &max))
         {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-          return true;
-        }
-      else
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" does not "<<m_element);
-          return false;
+          m_ranges.push_back (std::make_pair (min, max));
         }
+      return;
     }
   uint32_t value;
-  if (StringToUint32 (m_element, &value) &&
-      i == value)
+  if (StringToUint32 (element, &value))
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-      return true;
+      m_ranges.push_back (std::make_pair (value, value));
+    }
+}
+bool
+ArrayMatcher::Matches (std::size_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  for (std::vector<std::pair<std::size_t, std::size_t> >::const_iterator it = m_ranges.begin ();
+       it != m_ranges.end (); ++it)
+    {
+      if (i >= it->first && i <= it->second)
+        {
+          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
+          return true;
+        }
     }
   NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
   return false;
@@ -261,6 +264,80 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
   return !iss.bad () && !iss.fail ();
 }
 
+/**
+ * \ingroup config-impl
+ * A Config path split into its elements, each parsed once.
+ */
+class PathElements : public SimpleRefCount<PathElements>
+{
+public:
+  /**
+   * Split and parse a Config path.
+   *
+   * \param [in] path The Config path.
+   */
+  PathElements (std::string path);
+
+  /** One element of the path. */
+  struct Element
+  {
+    /**
+     * Parse one element.
+     *
+     * \param [in] element The element, without slashes.
+     */
+    Element (std::string element);
+    std::string item;      //!< the element
+    bool isNames;          //!< the element starts the "/Names" name space
+    bool isGetObject;      //!< the element is "$TypeId", a call to GetObject
+    std::string tidName;   //!< the TypeId name of a GetObject element
+    bool tidFound;         //!< tid is valid
+    TypeId tid;            //!< the TypeId of a GetObject element
+    ArrayMatcher matcher;  //!< the element read as an array index
+  };
+
+  /** The elements of the path. */
+  std::vector<Element> m_elements;
+};
+
+PathElements::Element::Element (std::string element)
+  : item (element),
+    isNames (element.compare (0, 5, "Names") == 0),
+    isGetObject (element.find ("$") == 0),
+    tidFound (false),
+    matcher (element)
+{
+  if (isGetObject)
+    {
+      tidName = element.substr (1, element.size () - 1);
+      // the type may not be registered yet, it is looked up again on use
+      tidFound = TypeId::LookupByNameFailSafe (tidName, &tid);
+    }
+}
+
+PathElements::PathElements (std::string path)
+{
+  NS_LOG_FUNCTION (this << path);
+
+  // ensure that we start and end with a '/'
+  if (path.find ("/") != 0)
+    {
+      path = "/" + path;
+    }
+  if (path.find_last_of ("/") != path.size () - 1)
+    {
+      path = path + "/";
+    }
+
+  std::string::size_type start = 1;
+  std::string::size_type next;
+  while ((next = path.find ("/", start)) != std::string::npos)
+    {
+      m_elements.push_back (Element (path.substr (start, next - start)));
+      start = next + 1;
+    }
+}
+
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
@@ -274,6 +351,13 @@ public:
    * \param [in] path The Config path.
    */
   Resolver (std::string path);
+  /**
+   * Construct from an already parsed Config path.
+   *
+   * \param [in] path The Config path.
+   * \param [in] elements The parsed \p path.
+   */
+  Resolver (std::string path, Ptr<const PathElements> elements);
   /** Destructor. */
   virtual ~Resolver ();
 
@@ -287,23 +371,31 @@ public:
   void Resolve (Ptr<Object> root);
   
 private:
-  /** Ensure the Config path starts and ends with a '/'. */
-  void Canonicalize (void);
   /**
    * Parse the next element in the Config path.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] i The index of the next element of the Config path.
    * \param [in] root The object corresponding to the current position
    *                  in the Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolve (std::size_t i, Ptr<Object> root);
   /**
    * Parse an index on the Config path.
    *
-   * \param [in] path The remaining Config path.
+   * \param [in] i The index of the next element of the Config path.
    * \param [in,out] vector The resulting list of matching objects.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolve (std::size_t i, const ObjectPtrContainerValue &vector);
+  /**
+   * Follow one attribute of the current object.
+   *
+   * \param [in] i The index of the next element of the Config path.
+   * \param [in] root The current object on the Config path.
+   * \param [in] info The attribute to follow.
+   * \returns \c true if the attribute holds an object or a container.
+   */
+  bool DoAttributeResolve (std::size_t i, Ptr<Object> root,
+                           const struct TypeId::AttributeInformation &info);
   /**
    * Handle one object found on the path.
    *
@@ -328,37 +420,26 @@ private:
   std::vector<std::string> m_workStack;
   /** The Config path. */
   std::string m_path;
+  /** The parsed Config path. */
+  Ptr<const PathElements> m_elements;
 
 };  // class Resolver
 
 Resolver::Resolver (std::string path)
-  : m_path (path)
+  : m_path (path),
+    m_elements (Create<PathElements> (path))
 {
   NS_LOG_FUNCTION (this << path);
-  Canonicalize ();
 }
-Resolver::~Resolver ()
+Resolver::Resolver (std::string path, Ptr<const PathElements> elements)
+  : m_path (path),
+    m_elements (elements)
 {
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (this << path << elements);
 }
-void
-Resolver::Canonicalize (void)
+Resolver::~Resolver ()
 {
   NS_LOG_FUNCTION (this);
-
-  // ensure that we start and end with a '/'
-  std::string::size_type tmp = m_path.find ("/");
-  if (tmp != 0)
-    {
-      // no slash at start
-      m_path = "/" + m_path;
-    }
-  tmp = m_path.find_last_of ("/");
-  if (tmp != (m_path.size () - 1))
-    {
-      // no slash at end
-      m_path = m_path + "/";
-    }
 }
 
 void 
@@ -366,7 +447,7 @@ Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -392,13 +473,11 @@ Resolver::DoResolveOne (Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (std::size_t i, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << i << root);
 
-  if (next == std::string::npos)
+  if (i == m_elements->m_elements.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name 
@@ -414,8 +493,8 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const PathElements::Element &element = m_elements->m_elements[i];
+  const std::string &item = element.item;
 
   //
   // If root is zero, we're beginning to see if we can use the object name 
@@ -424,16 +503,12 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   // the root of the "/Names" namespace, so we just ignore it and move on to 
   // the next segment.
   //
-  if (root == 0)
+  if (root == 0 && element.isNames)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
-        {
-          m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
-          m_workStack.pop_back ();
-          return;
-        }
+      m_workStack.push_back (item);
+      DoResolve (i + 1, root);
+      m_workStack.pop_back ();
+      return;
     }
 
   //
@@ -447,7 +522,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (i + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -463,21 +538,19 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       return;
     }
-  std::string::size_type dollarPos = item.find ("$");
-  if (dollarPos == 0)
+  if (element.isGetObject)
     {
       // This is a call to GetObject
-      std::string tidString = item.substr (1, item.size () - 1);
-      NS_LOG_DEBUG ("GetObject="<<tidString<<" on path="<<GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
+      NS_LOG_DEBUG ("GetObject="<<element.tidName<<" on path="<<GetResolvedPath ());
+      TypeId tid = element.tidFound ? element.tid : TypeId::LookupByName (element.tidName);
       Ptr<Object> object = root->GetObject<Object> (tid);
       if (object == 0)
         {
-          NS_LOG_DEBUG ("GetObject ("<<tidString<<") failed on path="<<GetResolvedPath ());
+          NS_LOG_DEBUG ("GetObject ("<<element.tidName<<") failed on path="<<GetResolvedPath ());
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (i + 1, object);
       m_workStack.pop_back ();
     }
   else 
@@ -490,50 +563,22 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
       do
         {
           tid = nextTid;
-          
-          for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+
+          if (item == "*")
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute(i);
-              if (info.name != item && item != "*")
-                {
-                  continue;
-                }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *pChecker = dynamic_cast<const PointerChecker *> (PeekPointer(info.checker));
-              if (pChecker != 0)
+              for (std::size_t j = 0; j < tid.GetAttributeN (); j++)
                 {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)="<<info.name<<" on path="<<GetResolvedPath ());
-                  PointerValue pValue;
-                  root->GetAttribute (info.name, pValue);
-                  Ptr<Object> object = pValue.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\""<<item<<
-                                    "\" exists on path=\""<<GetResolvedPath ()<<"\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
+                  foundMatch |= DoAttributeResolve (i, root, tid.GetAttribute (j));
                 }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker = 
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
+            }
+          else
+            {
+              // a named attribute, use the TypeId index instead of a scan
+              std::size_t j;
+              if (tid.FindAttribute (item, &j))
                 {
-                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
+                  foundMatch |= DoAttributeResolve (i, root, tid.GetAttribute (j));
                 }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
             }
 
           nextTid = tid.GetParent ();
@@ -547,21 +592,60 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     }
 }
 
+bool
+Resolver::DoAttributeResolve (std::size_t i, Ptr<Object> root,
+                              const struct TypeId::AttributeInformation &info)
+{
+  NS_LOG_FUNCTION (this << i << root << info.name);
+  bool foundMatch = false;
+  // attempt to cast to a pointer checker.
+  const PointerChecker *pChecker = dynamic_cast<const PointerChecker *> (PeekPointer(info.checker));
+  if (pChecker != 0)
+    {
+      NS_LOG_DEBUG ("GetAttribute(ptr)="<<info.name<<" on path="<<GetResolvedPath ());
+      PointerValue pValue;
+      root->GetAttribute (info.name, pValue);
+      Ptr<Object> object = pValue.Get<Object> ();
+      if (object == 0)
+        {
+          NS_LOG_ERROR ("Requested object name=\""<<m_elements->m_elements[i].item<<
+                        "\" exists on path=\""<<GetResolvedPath ()<<"\""
+                        " but is null.");
+          return false;
+        }
+      foundMatch = true;
+      m_workStack.push_back (info.name);
+      DoResolve (i + 1, object);
+      m_workStack.pop_back ();
+    }
+  // attempt to cast to an object vector.
+  const ObjectPtrContainerChecker *vectorChecker = 
+    dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
+  if (vectorChecker != 0)
+    {
+      NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath ());
+      foundMatch = true;
+      ObjectPtrContainerValue vector;
+      root->GetAttribute (info.name, vector);
+      m_workStack.push_back (info.name);
+      DoArrayResolve (i + 1, vector);
+      m_workStack.pop_back ();
+    }
+  // this could be anything else and we don't know what to do with it.
+  // So, we just ignore it.
+  return foundMatch;
+}
+
 void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (std::size_t i, const ObjectPtrContainerValue &container)
 {
-  NS_LOG_FUNCTION(this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION(this << i << &container);
+  if (i == m_elements->m_elements.size ())
     {
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
 
-  ArrayMatcher matcher = ArrayMatcher (item);
+  const ArrayMatcher &matcher = m_elements->m_elements[i].matcher;
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
@@ -570,7 +654,7 @@ Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &conta
           std::ostringstream oss;
           oss << (*it).first;
           m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
+          DoResolve (i + 1, (*it).second);
           m_workStack.pop_back ();
         }
     }
@@ -595,6 +679,13 @@ public:
   void Disconnect (std::string path, const CallbackBase &cb);
   /** \copydoc Config::LookupMatches() */
   MatchContainer LookupMatches (std::string path);
+  /**
+   * Find the objects matching an already parsed path.
+   * \param [in] path The path.
+   * \param [in] elements The parsed \p path.
+   * \returns The matching objects.
+   */
+  MatchContainer LookupMatches (std::string path, Ptr<const PathElements> elements);
 
   /** \copydoc Config::RegisterRootNamespaceObject() */
   void RegisterRootNamespaceObject (Ptr<Object> obj);
@@ -713,24 +804,40 @@ ConfigImpl::Disconnect (std::string path, const CallbackBase &cb)
   container.Disconnect (leaf, cb);
 }
 
+/**
+ * \ingroup config-impl
+ * Resolver which collects the matching objects and their contexts.
+ */
+class LookupMatchesResolver : public Resolver 
+{
+public:
+  /**
+   * \copydoc Resolver::Resolver(std::string,Ptr<const PathElements>)
+   */
+  LookupMatchesResolver (std::string path, Ptr<const PathElements> elements)
+    : Resolver (path, elements)
+  {}
+  virtual void DoOne (Ptr<Object> object, std::string path)
+  {
+    m_objects.push_back (object);
+    m_contexts.push_back (path);
+  }
+  std::vector<Ptr<Object> > m_objects;   //!< the matching objects
+  std::vector<std::string> m_contexts;   //!< their contexts
+};
+
 MatchContainer 
 ConfigImpl::LookupMatches (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
-  class LookupMatchesResolver : public Resolver 
-  {
-  public:
-    LookupMatchesResolver (std::string path)
-      : Resolver (path)
-    {}
-    virtual void DoOne (Ptr<Object> object, std::string path)
-    {
-      m_objects.push_back (object);
-      m_contexts.push_back (path);
-    }
-    std::vector<Ptr<Object> > m_objects;
-    std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
+  return LookupMatches (path, Create<PathElements> (path));
+}
+
+MatchContainer 
+ConfigImpl::LookupMatches (std::string path, Ptr<const PathElements> elements)
+{
+  NS_LOG_FUNCTION (this << path << elements);
+  LookupMatchesResolver resolver (path, elements);
   for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
     {
       resolver.Resolve (*i);
@@ -782,6 +889,125 @@ ConfigImpl::GetRootNamespaceObject (std::size_t i) const
 }
 
 
+PreparedPath::PreparedPath (std::string path)
+  : m_path (path)
+{
+  NS_LOG_FUNCTION (this << path);
+  std::string::size_type slash = path.find_last_of ("/");
+  if (slash == std::string::npos)
+    {
+      m_leaf = path;
+    }
+  else
+    {
+      m_root = path.substr (0, slash);
+      m_leaf = path.substr (slash + 1, path.size () - (slash + 1));
+    }
+  m_elements = Create<PathElements> (m_root);
+}
+PreparedPath::PreparedPath (const PreparedPath &o)
+  : m_path (o.m_path),
+    m_root (o.m_root),
+    m_leaf (o.m_leaf),
+    m_elements (o.m_elements)
+{
+  NS_LOG_FUNCTION (this << &o);
+}
+PreparedPath &
+PreparedPath::operator = (const PreparedPath &o)
+{
+  NS_LOG_FUNCTION (this << &o);
+  m_path = o.m_path;
+  m_root = o.m_root;
+  m_leaf = o.m_leaf;
+  m_elements = o.m_elements;
+  return *this;
+}
+PreparedPath::~PreparedPath ()
+{
+  NS_LOG_FUNCTION (this);
+}
+std::string
+PreparedPath::GetPath (void) const
+{
+  return m_path;
+}
+MatchContainer
+PreparedPath::LookupMatches (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return ConfigImpl::Get ()->LookupMatches (m_root, m_elements);
+}
+MatchContainer
+PreparedPath::LookupMatches (Ptr<Object> root) const
+{
+  NS_LOG_FUNCTION (this << root);
+  LookupMatchesResolver resolver (m_root, m_elements);
+  resolver.Resolve (root);
+  return MatchContainer (resolver.m_objects, resolver.m_contexts, m_root);
+}
+void
+PreparedPath::Set (const AttributeValue &value) const
+{
+  NS_LOG_FUNCTION (this << &value);
+  LookupMatches ().Set (m_leaf, value);
+}
+void
+PreparedPath::Set (Ptr<Object> root, const AttributeValue &value) const
+{
+  NS_LOG_FUNCTION (this << root << &value);
+  LookupMatches (root).Set (m_leaf, value);
+}
+void
+PreparedPath::Connect (const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << &cb);
+  LookupMatches ().Connect (m_leaf, cb);
+}
+void
+PreparedPath::Connect (Ptr<Object> root, const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << root << &cb);
+  LookupMatches (root).Connect (m_leaf, cb);
+}
+void
+PreparedPath::ConnectWithoutContext (const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << &cb);
+  LookupMatches ().ConnectWithoutContext (m_leaf, cb);
+}
+void
+PreparedPath::ConnectWithoutContext (Ptr<Object> root, const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << root << &cb);
+  LookupMatches (root).ConnectWithoutContext (m_leaf, cb);
+}
+void
+PreparedPath::Disconnect (const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << &cb);
+  LookupMatches ().Disconnect (m_leaf, cb);
+}
+void
+PreparedPath::Disconnect (Ptr<Object> root, const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << root << &cb);
+  LookupMatches (root).Disconnect (m_leaf, cb);
+}
+void
+PreparedPath::DisconnectWithoutContext (const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << &cb);
+  LookupMatches ().DisconnectWithoutContext (m_leaf, cb);
+}
+void
+PreparedPath::DisconnectWithoutContext (Ptr<Object> root, const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << root << &cb);
+  LookupMatches (root).DisconnectWithoutContext (m_leaf, cb);
+}
+
+
 void Reset (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -258,6 +258,114 @@ private:
  */
 MatchContainer LookupMatches (std::string path);
 
+class PathElements;
+
+/**
+ * \ingroup config
+ * \brief A Config path parsed once, to be resolved many times.
+ *
+ * The free Config functions split and parse their path on every call.
+ * A PreparedPath does it once, when it is constructed.  It can then be
+ * resolved from the registered roots, like the free functions, or from
+ * any object: connecting a trace source of the applications of each node
+ * of a large NodeList then only visits the applications of that node,
+ * instead of matching "/NodeList/<i>" against the whole list every time.
+ *
+ * When resolved from an object, the path is relative to that object, and
+ * so are the contexts passed by Connect().
+ */
+class PreparedPath
+{
+public:
+  /**
+   * \param [in] path The Config path, its last element is the attribute
+   *                  or trace source name used by Set() and Connect().
+   */
+  PreparedPath (std::string path);
+  /** \param [in] o The PreparedPath to copy. */
+  PreparedPath (const PreparedPath &o);
+  /**
+   * \param [in] o The PreparedPath to copy.
+   * \returns This PreparedPath.
+   */
+  PreparedPath &operator = (const PreparedPath &o);
+  ~PreparedPath ();
+
+  /**
+   * \returns The path this object was constructed with.
+   */
+  std::string GetPath (void) const;
+
+  /**
+   * \returns The objects matching the path, leaf excluded, from the
+   *          registered roots.
+   * \sa ns3::Config::LookupMatches
+   */
+  MatchContainer LookupMatches (void) const;
+  /**
+   * \param [in] root The object the path is relative to.
+   * \returns The objects matching the path, leaf excluded, from \p root.
+   */
+  MatchContainer LookupMatches (Ptr<Object> root) const;
+
+  /**
+   * \param [in] value The value to set to the leaf attribute.
+   * \sa ns3::Config::Set
+   */
+  void Set (const AttributeValue &value) const;
+  /**
+   * \param [in] root The object the path is relative to.
+   * \param [in] value The value to set to the leaf attribute.
+   */
+  void Set (Ptr<Object> root, const AttributeValue &value) const;
+  /**
+   * \param [in] cb The sink to connect to the leaf trace source.
+   * \sa ns3::Config::Connect
+   */
+  void Connect (const CallbackBase &cb) const;
+  /**
+   * \param [in] root The object the path is relative to.
+   * \param [in] cb The sink to connect to the leaf trace source.
+   */
+  void Connect (Ptr<Object> root, const CallbackBase &cb) const;
+  /**
+   * \param [in] cb The sink to connect to the leaf trace source.
+   * \sa ns3::Config::ConnectWithoutContext
+   */
+  void ConnectWithoutContext (const CallbackBase &cb) const;
+  /**
+   * \param [in] root The object the path is relative to.
+   * \param [in] cb The sink to connect to the leaf trace source.
+   */
+  void ConnectWithoutContext (Ptr<Object> root, const CallbackBase &cb) const;
+  /**
+   * \param [in] cb The sink to disconnect from the leaf trace source.
+   * \sa ns3::Config::Disconnect
+   */
+  void Disconnect (const CallbackBase &cb) const;
+  /**
+   * \param [in] root The object the path is relative to.
+   * \param [in] cb The sink to disconnect from the leaf trace source.
+   */
+  void Disconnect (Ptr<Object> root, const CallbackBase &cb) const;
+  /**
+   * \param [in] cb The sink to disconnect from the leaf trace source.
+   * \sa ns3::Config::DisconnectWithoutContext
+   */
+  void DisconnectWithoutContext (const CallbackBase &cb) const;
+  /**
+   * \param [in] root The object the path is relative to.
+   * \param [in] cb The sink to disconnect from the leaf trace source.
+   */
+  void DisconnectWithoutContext (Ptr<Object> root, const CallbackBase &cb) const;
+
+private:
+  std::string m_path;                 //!< the path
+  std::string m_root;                 //!< the path, leaf excluded
+  std::string m_leaf;                 //!< the last element of the path
+  Ptr<const PathElements> m_elements; //!< the parsed path, leaf excluded
+};
+
 /**
  * \ingroup config
  * \param [in] obj A new root object
@@ -31,6 +31,93 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+namespace {
+
+/** Size granularity of the event pool, in bytes. */
+const std::size_t POOL_GRANULARITY = 16;
+/** Number of pooled size classes; larger events are not pooled. */
+const std::size_t POOL_CLASSES = 8;
+/** Maximum number of free events kept per size class and thread. */
+const std::size_t POOL_MAX_FREE = 4096;
+
+/** A free event of the pool. */
+struct PoolBlock
+{
+  PoolBlock *next;                 //!< next free event of the size class
+};
+
+/** Free events of one thread, given back to the heap when the thread exits. */
+struct EventPool
+{
+  /** Free the events of the free lists, and stop pooling. */
+  ~EventPool ();
+
+  PoolBlock *free[POOL_CLASSES];   //!< free lists by size class
+  std::size_t count[POOL_CLASSES]; //!< length of the free lists
+};
+
+/**
+ * Set when the pool of the thread is destroyed: events deleted later by
+ * the destructors of other objects of the thread go to the heap.  It is
+ * trivially destructible, so unlike the pool it stays valid until the
+ * thread ends.
+ */
+thread_local bool g_eventPoolClosed = false;
+
+EventPool::~EventPool ()
+{
+  for (std::size_t i = 0; i < POOL_CLASSES; ++i)
+    {
+      while (free[i] != 0)
+        {
+          PoolBlock *block = free[i];
+          free[i] = block->next;
+          ::operator delete (block);
+        }
+      count[i] = 0;
+    }
+  g_eventPoolClosed = true;
+}
+
+/** The pool of the thread, zero-initialized. */
+thread_local EventPool g_eventPool;
+
+} // anonymous namespace
+
+void *
+EventImpl::operator new (std::size_t size)
+{
+  std::size_t sizeClass = (size - 1) / POOL_GRANULARITY;
+  if (sizeClass >= POOL_CLASSES || g_eventPoolClosed)
+    {
+      return ::operator new (size);
+    }
+  PoolBlock *block = g_eventPool.free[sizeClass];
+  if (block == 0)
+    {
+      return ::operator new ((sizeClass + 1) * POOL_GRANULARITY);
+    }
+  g_eventPool.free[sizeClass] = block->next;
+  g_eventPool.count[sizeClass]--;
+  return block;
+}
+
+void
+EventImpl::operator delete (void *p, std::size_t size)
+{
+  std::size_t sizeClass = (size - 1) / POOL_GRANULARITY;
+  if (sizeClass >= POOL_CLASSES || g_eventPoolClosed
+      || g_eventPool.count[sizeClass] >= POOL_MAX_FREE)
+    {
+      ::operator delete (p);
+      return;
+    }
+  PoolBlock *block = static_cast<PoolBlock *> (p);
+  block->next = g_eventPool.free[sizeClass];
+  g_eventPool.free[sizeClass] = block;
+  g_eventPool.count[sizeClass]++;
+}
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -66,6 +67,26 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * Allocate an event from the pool of the calling thread.
+   *
+   * Events are short-lived and of a few distinct sizes, so freed events
+   * are kept in per-thread free lists by size class and reused by the
+   * next events of the same size, instead of going back to the heap.
+   * Large events bypass the pool.
+   *
+   * \param [in] size The size of the event.
+   * \returns The allocated memory.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Give an event back to the pool of the calling thread.
+   *
+   * \param [in] p The event memory.
+   * \param [in] size The size of the event.
+   */
+  static void operator delete (void *p, std::size_t size);
+
 protected:
   /**
    * Implementation for Invoke().
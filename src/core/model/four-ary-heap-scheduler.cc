@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "four-ary-heap-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::FourAryHeapScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FourAryHeapScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (FourAryHeapScheduler);
+
+TypeId
+FourAryHeapScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FourAryHeapScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<FourAryHeapScheduler> ()
+  ;
+  return tid;
+}
+
+FourAryHeapScheduler::FourAryHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FourAryHeapScheduler::~FourAryHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FourAryHeapScheduler::BottomUp (std::size_t id, const Scheduler::Event &ev)
+{
+  while (id > 0)
+    {
+      std::size_t parent = (id - 1) / 4;
+      if (!(ev.key < m_heap[parent].key))
+        {
+          break;
+        }
+      m_heap[id] = m_heap[parent];
+      id = parent;
+    }
+  m_heap[id] = ev;
+}
+
+void
+FourAryHeapScheduler::TopDown (std::size_t id, const Scheduler::Event &ev)
+{
+  std::size_t size = m_heap.size ();
+  for (;;)
+    {
+      std::size_t first = 4 * id + 1;
+      if (first >= size)
+        {
+          break;
+        }
+      std::size_t last = first + 4 < size ? first + 4 : size;
+      std::size_t smallest = first;
+      for (std::size_t child = first + 1; child < last; child++)
+        {
+          if (m_heap[child].key < m_heap[smallest].key)
+            {
+              smallest = child;
+            }
+        }
+      if (!(m_heap[smallest].key < ev.key))
+        {
+          break;
+        }
+      m_heap[id] = m_heap[smallest];
+      id = smallest;
+    }
+  m_heap[id] = ev;
+}
+
+void
+FourAryHeapScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << &ev);
+  m_heap.push_back (ev);
+  BottomUp (m_heap.size () - 1, ev);
+}
+
+bool
+FourAryHeapScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_heap.empty ();
+}
+
+Scheduler::Event
+FourAryHeapScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  return m_heap.front ();
+}
+
+Scheduler::Event
+FourAryHeapScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Event next = m_heap.front ();
+  Event last = m_heap.back ();
+  m_heap.pop_back ();
+  if (!m_heap.empty ())
+    {
+      TopDown (0, last);
+    }
+  return next;
+}
+
+void
+FourAryHeapScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << &ev);
+  uint32_t uid = ev.key.m_uid;
+  for (std::size_t i = 0; i < m_heap.size (); i++)
+    {
+      if (uid == m_heap[i].key.m_uid)
+        {
+          NS_ASSERT (m_heap[i].impl == ev.impl);
+          Event last = m_heap.back ();
+          m_heap.pop_back ();
+          if (i == m_heap.size ())
+            {
+              return;
+            }
+          // the last event may belong above or below the hole
+          if (i > 0 && last.key < m_heap[(i - 1) / 4].key)
+            {
+              BottomUp (i, last);
+            }
+          else
+            {
+              TopDown (i, last);
+            }
+          return;
+        }
+    }
+  NS_ASSERT (false);
+}
+
+} // namespace ns3
@@ -0,0 +1,94 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FOUR_ARY_HEAP_SCHEDULER_H
+#define FOUR_ARY_HEAP_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::FourAryHeapScheduler declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a 4-ary implicit heap event scheduler
+ *
+ * The events are kept by value in a single array, so that inserting and
+ * removing an event never allocates once the array has grown to the
+ * population of the simulation.  Each node has four children, stored
+ * next to each other: the heap is half as deep as a binary heap and the
+ * children compared at each level of RemoveNext share one or two cache
+ * lines.
+ *
+ * Insertion and removal move a hole instead of swapping entries.
+ *
+ * Remove () finds the event by a linear scan of the array, O(n) like
+ * HeapScheduler, before an O(log n) repair of the heap.  Only
+ * Simulator::Remove calls it: Simulator::Cancel marks the event and
+ * leaves it in the heap, at no cost.  Simulations which remove many
+ * events from a large population should use MapScheduler instead.
+ */
+class FourAryHeapScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  FourAryHeapScheduler ();
+  /** Destructor. */
+  virtual ~FourAryHeapScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /**
+   * Move an event up from a hole to its place.
+   *
+   * \param [in] id The index of the hole.
+   * \param [in] ev The event to place.
+   */
+  void BottomUp (std::size_t id, const Scheduler::Event &ev);
+  /**
+   * Move an event down from a hole to its place.
+   *
+   * \param [in] id The index of the hole.
+   * \param [in] ev The event to place.
+   */
+  void TopDown (std::size_t id, const Scheduler::Event &ev);
+
+  /** The event list, managed as a heap rooted at index zero. */
+  std::vector<Scheduler::Event> m_heap;
+};
+
+} // namespace ns3
+
+#endif /* FOUR_ARY_HEAP_SCHEDULER_H */
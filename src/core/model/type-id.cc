@@ -264,6 +264,28 @@ public:
    * \returns Detailed information about the requested trace source.
    */
   struct TypeId::TraceSourceInformation GetTraceSource (uint16_t uid, std::size_t i) const;
+  /**
+   * Find an Attribute declared by a type id, without looking at its parents.
+   * \param [in] uid The id.
+   * \param [in] hash The hash of \p name.
+   * \param [in] name The Attribute name.
+   * \returns The index of the Attribute, or -1 if \p uid does not declare it.
+   */
+  std::size_t FindAttribute (uint16_t uid, TypeId::hash_t hash, const std::string &name) const;
+  /**
+   * Find a TraceSource declared by a type id, without looking at its parents.
+   * \param [in] uid The id.
+   * \param [in] hash The hash of \p name.
+   * \param [in] name The TraceSource name.
+   * \returns The index of the TraceSource, or -1 if \p uid does not declare it.
+   */
+  std::size_t FindTraceSource (uint16_t uid, TypeId::hash_t hash, const std::string &name) const;
+  /**
+   * Hashing function.
+   * \param [in] name The type id, attribute or trace source name.
+   * \returns The hashed value of \p name.
+   */
+  static TypeId::hash_t Hasher (const std::string name);
   /**
    * Check if this TypeId should not be listed in documentation.
    * \param [in] uid The id.
@@ -286,12 +308,9 @@ private:
    * \returns \c true if \p uid has the Attribute \p name.
    */
   bool HasAttribute (uint16_t uid, std::string name);
-  /**
-   * Hashing function.
-   * \param [in] name The type id name.
-   * \returns The hashed value of \p name.
-   */
-  static TypeId::hash_t Hasher (const std::string name);
+
+  /** Type of the by-name-hash index of the Attributes or TraceSources of a type id. */
+  typedef std::multimap<TypeId::hash_t, std::size_t> indexmap_t;
 
   /** The information record about a single type id. */
   struct IidInformation {
@@ -315,6 +334,10 @@ private:
     std::vector<struct TypeId::AttributeInformation> attributes;
     /** The container of TraceSources. */
     std::vector<struct TypeId::TraceSourceInformation> traceSources;
+    /** The Attributes indexed by name hash. */
+    indexmap_t attributeIndex;
+    /** The TraceSources indexed by name hash. */
+    indexmap_t traceSourceIndex;
     /** Support level/deprecation. */
     TypeId::SupportLevel supportLevel;
     /** Support message. */
@@ -676,6 +699,8 @@ IidManager::AddAttribute (uint16_t uid,
   info.supportLevel = supportLevel;
   info.supportMsg = supportMsg;
   information->attributes.push_back (info);
+  information->attributeIndex.insert (std::make_pair (Hasher (name),
+                                                      information->attributes.size () - 1));
   NS_LOG_LOGIC (IIDL << information->attributes.size () - 1);
 }
 void 
@@ -767,6 +792,8 @@ IidManager::AddTraceSource (uint16_t uid,
   source.supportLevel = supportLevel;
   source.supportMsg = supportMsg;
   information->traceSources.push_back (source);
+  information->traceSourceIndex.insert (std::make_pair (Hasher (name),
+                                                        information->traceSources.size () - 1));
   NS_LOG_LOGIC (IIDL << information->traceSources.size () - 1);
 }
 std::size_t
@@ -787,6 +814,38 @@ IidManager::GetTraceSource (uint16_t uid, std::size_t i) const
   NS_LOG_LOGIC (IIDL << information->name);
   return information->traceSources[i];
 }
+std::size_t
+IidManager::FindAttribute (uint16_t uid, TypeId::hash_t hash, const std::string &name) const
+{
+  NS_LOG_FUNCTION (IID << uid << hash << name);
+  struct IidInformation *information = LookupInformation (uid);
+  std::pair<indexmap_t::const_iterator, indexmap_t::const_iterator> range =
+    information->attributeIndex.equal_range (hash);
+  for (indexmap_t::const_iterator i = range.first; i != range.second; ++i)
+    {
+      if (information->attributes[i->second].name == name)
+        {
+          return i->second;
+        }
+    }
+  return static_cast<std::size_t> (-1);
+}
+std::size_t
+IidManager::FindTraceSource (uint16_t uid, TypeId::hash_t hash, const std::string &name) const
+{
+  NS_LOG_FUNCTION (IID << uid << hash << name);
+  struct IidInformation *information = LookupInformation (uid);
+  std::pair<indexmap_t::const_iterator, indexmap_t::const_iterator> range =
+    information->traceSourceIndex.equal_range (hash);
+  for (indexmap_t::const_iterator i = range.first; i != range.second; ++i)
+    {
+      if (information->traceSources[i->second].name == name)
+        {
+          return i->second;
+        }
+    }
+  return static_cast<std::size_t> (-1);
+}
 bool 
 IidManager::MustHideFromDocumentation (uint16_t uid) const
 {
@@ -877,33 +936,33 @@ bool
 TypeId::LookupAttributeByName (std::string name, struct TypeId::AttributeInformation *info) const
 {
   NS_LOG_FUNCTION (this << name << info);
+  IidManager *manager = IidManager::Get ();
+  TypeId::hash_t hash = IidManager::Hasher (name);
   TypeId tid;
   TypeId nextTid = *this;
   do {
       tid = nextTid;
-      for (std::size_t i = 0; i < tid.GetAttributeN (); i++)
+      std::size_t i = manager->FindAttribute (tid.m_tid, hash, name);
+      if (i != static_cast<std::size_t> (-1))
         {
           struct TypeId::AttributeInformation tmp = tid.GetAttribute (i);
-          if (tmp.name == name)
+          if (tmp.supportLevel == TypeId::SUPPORTED)
+            {
+              *info = tmp;
+              return true;
+            }
+          else if (tmp.supportLevel == TypeId::DEPRECATED)
+            {
+              std::cerr << "Attribute '" << name << "' is deprecated: "
+                             << tmp.supportMsg << std::endl;
+              *info = tmp;
+              return true;
+            }
+          else if (tmp.supportLevel == TypeId::OBSOLETE)
             {
-              if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                  *info = tmp;
-                  return true;
-                }
-              else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                  std::cerr << "Attribute '" << name << "' is deprecated: "
-                                 << tmp.supportMsg << std::endl;
-                  *info = tmp;
-                  return true;
-                }
-              else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                  NS_FATAL_ERROR ("Attribute '" << name
-                                  << "' is obsolete, with no fallback: "
-                                  << tmp.supportMsg);
-                }
+              NS_FATAL_ERROR ("Attribute '" << name
+                              << "' is obsolete, with no fallback: "
+                              << tmp.supportMsg);
             }
         }
       nextTid = tid.GetParent ();
@@ -911,6 +970,19 @@ TypeId::LookupAttributeByName (std::string name, struct TypeId::AttributeInforma
   return false;
 }
 
+bool
+TypeId::FindAttribute (std::string name, std::size_t *i) const
+{
+  NS_LOG_FUNCTION (this << name << i);
+  std::size_t index = IidManager::Get ()->FindAttribute (m_tid, IidManager::Hasher (name), name);
+  if (index == static_cast<std::size_t> (-1))
+    {
+      return false;
+    }
+  *i = index;
+  return true;
+}
+
 TypeId 
 TypeId::SetParent (TypeId tid)
 {
@@ -1137,34 +1209,33 @@ TypeId::LookupTraceSourceByName (std::string name,
                                  struct TraceSourceInformation *info) const
 {
   NS_LOG_FUNCTION (this << name);
+  IidManager *manager = IidManager::Get ();
+  TypeId::hash_t hash = IidManager::Hasher (name);
   TypeId tid;
   TypeId nextTid = *this;
-  struct TypeId::TraceSourceInformation tmp;
   do {
       tid = nextTid;
-      for (std::size_t i = 0; i < tid.GetTraceSourceN(); i++)
+      std::size_t i = manager->FindTraceSource (tid.m_tid, hash, name);
+      if (i != static_cast<std::size_t> (-1))
         {
-          tmp = tid.GetTraceSource (i);
-          if (tmp.name == name)
+          struct TypeId::TraceSourceInformation tmp = tid.GetTraceSource (i);
+          if (tmp.supportLevel == TypeId::SUPPORTED)
+            {
+              *info = tmp;
+              return tmp.accessor;
+            }
+          else if (tmp.supportLevel == TypeId::DEPRECATED)
+            {
+              std::cerr << "TraceSource '" << name << "' is deprecated: "
+                             << tmp.supportMsg << std::endl;
+              *info = tmp;
+              return tmp.accessor;
+            }
+          else  if (tmp.supportLevel == TypeId::OBSOLETE)
             {
-              if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                  *info = tmp;
-                   return tmp.accessor;
-                }
-              else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                  std::cerr << "TraceSource '" << name << "' is deprecated: "
-                                 << tmp.supportMsg << std::endl;
-                  *info = tmp;
-                  return tmp.accessor;
-                }
-              else  if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                  NS_FATAL_ERROR ("TraceSource '" << name
-                                  << "' is obsolete, with no fallback: "
-                                  << tmp.supportMsg);
-                }
+              NS_FATAL_ERROR ("TraceSource '" << name
+                              << "' is obsolete, with no fallback: "
+                              << tmp.supportMsg);
             }
         }
       nextTid = tid.GetParent ();
@@ -485,6 +485,17 @@ public:
    * \returns \c true if the requested attribute could be found.
    */
   bool LookupAttributeByName (std::string name, struct AttributeInformation *info) const;
+  /**
+   * Find an Attribute declared by this TypeId.
+   *
+   * Unlike LookupAttributeByName(), the parents of this TypeId are not
+   * searched and the support level of the attribute is not checked.
+   *
+   * \param [in]  name The name of the requested attribute
+   * \param [out] i The index of the attribute, if found.
+   * \returns \c true if this TypeId declares the attribute \p name.
+   */
+  bool FindAttribute (std::string name, std::size_t *i) const;
   /**
    * Find a TraceSource by name.
    *
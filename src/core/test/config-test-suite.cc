@@ -830,6 +830,111 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+/**
+ * \ingroup config-tests
+ * Test for Config::PreparedPath.
+ */
+class PreparedPathConfigTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  PreparedPathConfigTestCase ();
+  /** Destructor. */
+  virtual ~PreparedPathConfigTestCase () {}
+
+  /**
+   * Trace callback with context path.
+   * \param path The context path.
+   * \param old The old value.
+   * \param newValue The new value.
+   */
+  void TraceWithPath (std::string path, int16_t old, int16_t newValue)
+  { 
+    NS_UNUSED (old); 
+    m_newValue = newValue; 
+    m_path = path; 
+  }
+
+private:
+  virtual void DoRun (void);
+
+  int16_t m_newValue; //!< Flag to detect tracing result.
+  std::string m_path; //!< The context path.
+};
+
+PreparedPathConfigTestCase::PreparedPathConfigTestCase ()
+  : TestCase ("Check that a prepared path matches like the equivalent Config path")
+{
+}
+
+void
+PreparedPathConfigTestCase::DoRun (void)
+{
+  IntegerValue iv;
+
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject> ();
+  root->SetNodeA (a);
+  Ptr<ConfigTestObject> b = CreateObject<ConfigTestObject> ();
+  a->SetNodeB (b);
+  std::vector<Ptr<ConfigTestObject> > objs;
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      objs.push_back (CreateObject<ConfigTestObject> ());
+      b->AddNodeB (objs.back ());
+    }
+
+  //
+  // The prepared path must find the same objects, with the same contexts,
+  // as the free function, however often it is resolved.  The roots of the
+  // previous test cases are still registered, so both see their objects too.
+  //
+  Config::PreparedPath prepared ("/NodeA/NodeB/NodesB/|[0-1]|3||[7-9]|/A");
+  for (uint32_t round = 0; round < 2; round++)
+    {
+      Config::MatchContainer expected = Config::LookupMatches ("/NodeA/NodeB/NodesB/|[0-1]|3||[7-9]|");
+      Config::MatchContainer matches = prepared.LookupMatches ();
+      NS_TEST_ASSERT_MSG_EQ (matches.GetN (), expected.GetN (), "Prepared path and Config path disagree");
+      for (std::size_t i = 0; i < matches.GetN (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (matches.Get (i), expected.Get (i), "Prepared path matched another object");
+          NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (i), expected.GetMatchedPath (i),
+                                 "Prepared path matched another context");
+        }
+    }
+
+  prepared.Set (IntegerValue (-5));
+  for (uint32_t i = 0; i < objs.size (); i++)
+    {
+      objs[i]->GetAttribute ("A", iv);
+      NS_TEST_ASSERT_MSG_EQ (iv.Get (), (i == 2 || i == 4) ? 10 : -5, "Object Attribute \"A\" not set as expected");
+    }
+
+  //
+  // Resolved from an object, the path and the contexts are relative to it.
+  //
+  Config::PreparedPath relative ("NodesB/*/Source");
+  relative.Connect (b, MakeCallback (&PreparedPathConfigTestCase::TraceWithPath, this));
+  m_newValue = 0;
+  m_path = "";
+  objs[2]->SetAttribute ("Source", IntegerValue (-3));
+  NS_TEST_ASSERT_MSG_EQ (m_newValue, -3, "Trace 2 did not fire as expected");
+  NS_TEST_ASSERT_MSG_EQ (m_path, "/NodesB/2/Source", "Trace 2 did not provide expected context");
+
+  relative.Disconnect (b, MakeCallback (&PreparedPathConfigTestCase::TraceWithPath, this));
+  m_newValue = 0;
+  objs[2]->SetAttribute ("Source", IntegerValue (-4));
+  NS_TEST_ASSERT_MSG_EQ (m_newValue, 0, "Trace 2 fired after being disconnected");
+
+  Config::PreparedPath leaf ("B");
+  leaf.Set (objs[4], IntegerValue (-6));
+  objs[4]->GetAttribute ("B", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), -6, "Object Attribute \"B\" not set on the root object");
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -848,6 +953,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase);
   AddTestCase (new ObjectVectorConfigTestCase);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase);
+  AddTestCase (new PreparedPathConfigTestCase);
 }
 
 /**
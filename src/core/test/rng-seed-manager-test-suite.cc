@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/system-thread.h"
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup randomvariable
+ * \ingroup randomvariable-tests
+ * RngSeedManager test suite.
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup randomvariable-tests
+ *
+ * Check that threads asking for stream indices at the same time, as the
+ * partitions of a multi-threaded simulation do, never get the same
+ * index and do not skip any.
+ */
+class RngSeedManagerThreadedStreamIndexTestCase : public TestCase
+{
+public:
+  RngSeedManagerThreadedStreamIndexTestCase ();
+  virtual ~RngSeedManagerThreadedStreamIndexTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Get stream indices in a thread.
+   * \param thread the index of the calling thread
+   */
+  void GetIndices (uint32_t thread);
+
+  /** The indices got by each thread. */
+  std::vector<std::vector<uint64_t> > m_indices;
+};
+
+/** Number of threads asking for stream indices. */
+static const uint32_t N_THREADS = 8;
+/** Number of stream indices asked by each thread. */
+static const uint32_t N_INDICES = 20000;
+
+RngSeedManagerThreadedStreamIndexTestCase::RngSeedManagerThreadedStreamIndexTestCase ()
+  : TestCase ("Concurrent stream index assignment")
+{
+}
+
+RngSeedManagerThreadedStreamIndexTestCase::~RngSeedManagerThreadedStreamIndexTestCase ()
+{
+}
+
+void
+RngSeedManagerThreadedStreamIndexTestCase::GetIndices (uint32_t thread)
+{
+  std::vector<uint64_t> &indices = m_indices[thread];
+  for (uint32_t i = 0; i < N_INDICES; ++i)
+    {
+      indices.push_back (RngSeedManager::GetNextStreamIndex ());
+    }
+}
+
+void
+RngSeedManagerThreadedStreamIndexTestCase::DoRun (void)
+{
+  m_indices.assign (N_THREADS, std::vector<uint64_t> ());
+  uint64_t first = RngSeedManager::GetNextStreamIndex ();
+
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t t = 0; t < N_THREADS; ++t)
+    {
+      threads.push_back (Create<SystemThread> (MakeCallback (&RngSeedManagerThreadedStreamIndexTestCase::GetIndices, this).Bind (t)));
+    }
+  for (uint32_t t = 0; t < N_THREADS; ++t)
+    {
+      threads[t]->Start ();
+    }
+  for (uint32_t t = 0; t < N_THREADS; ++t)
+    {
+      threads[t]->Join ();
+    }
+
+  std::vector<uint64_t> all;
+  for (uint32_t t = 0; t < N_THREADS; ++t)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_indices[t].size (), N_INDICES, "Thread " << t << " did not get all its indices");
+      // each thread sees increasing indices
+      NS_TEST_ASSERT_MSG_EQ (std::is_sorted (m_indices[t].begin (), m_indices[t].end ()), true,
+                             "Indices not increasing in thread " << t);
+      all.insert (all.end (), m_indices[t].begin (), m_indices[t].end ());
+    }
+  std::sort (all.begin (), all.end ());
+  for (std::size_t i = 0; i < all.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (all[i], first + 1 + i, "Stream index given twice or skipped");
+    }
+  NS_TEST_ASSERT_MSG_EQ (RngSeedManager::GetNextStreamIndex (), first + 1 + all.size (),
+                         "Next stream index lost increments");
+}
+
+/**
+ * \ingroup randomvariable-tests
+ *
+ * \brief RngSeedManager TestSuite
+ */
+class RngSeedManagerTestSuite : public TestSuite
+{
+public:
+  RngSeedManagerTestSuite ();
+};
+
+RngSeedManagerTestSuite::RngSeedManagerTestSuite ()
+  : TestSuite ("rng-seed-manager", UNIT)
+{
+  AddTestCase (new RngSeedManagerThreadedStreamIndexTestCase, TestCase::QUICK);
+}
+
+static RngSeedManagerTestSuite g_rngSeedManagerTestSuite; //!< Static variable for test initialization
@@ -22,10 +22,13 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
 #include <fstream>
 #include <sstream>
 
 #define PERIODIC_CHECK_INTERVAL (Seconds (1))
+#define MAX_INDEXED_FLOW_ID 65536
 
 namespace ns3 {
 
@@ -69,6 +72,25 @@ FlowMonitor::GetTypeId (void)
                    TimeValue (Seconds (0.5)),
                    MakeTimeAccessor (&FlowMonitor::m_flowInterruptionsMinTime),
                    MakeTimeChecker ())
+    .AddAttribute ("FastPacketTracking", ("Track the packets in flight in an open-addressing hash table, and find "
+                                          "the lost ones with a timing wheel instead of a scan of all the packets. "
+                                          "Must be set before the monitoring starts."),
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&FlowMonitor::m_fastPacketTracking),
+                   MakeBooleanChecker ())
+    .AddAttribute ("LogScaleHistograms", ("Use histograms with a fixed number of bins of logarithmic width. "
+                                          "The bin width attributes then set the end of the first bin."),
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&FlowMonitor::m_logScaleHistograms),
+                   MakeBooleanChecker ())
+    .AddAttribute ("HistogramBinsPerDecade", ("The number of bins per power of ten of the log scale histograms."),
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&FlowMonitor::m_histogramBinsPerDecade),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("HistogramMaxBins", ("The number of bins of the log scale histograms."),
+                   UintegerValue (64),
+                   MakeUintegerAccessor (&FlowMonitor::m_histogramMaxBins),
+                   MakeUintegerChecker<uint32_t> (2))
   ;
   return tid;
 }
@@ -80,7 +102,11 @@ FlowMonitor::GetInstanceTypeId (void) const
 }
 
 FlowMonitor::FlowMonitor ()
-  : m_enabled (false)
+  : m_fastPacketTracking (false),
+    m_enabled (false),
+    m_logScaleHistograms (false),
+    m_histogramBinsPerDecade (10),
+    m_histogramMaxBins (64)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -102,6 +128,7 @@ FlowMonitor::DoDispose (void)
       m_flowProbes[i]->Dispose ();
       m_flowProbes[i] = 0;
     }
+  m_packetTable.Clear ();
   Object::DoDispose ();
 }
 
@@ -109,11 +136,16 @@ inline FlowMonitor::FlowStats&
 FlowMonitor::GetStatsForFlow (FlowId flowId)
 {
   NS_LOG_FUNCTION (this);
+  if (flowId < m_flowStatsIndex.size () && m_flowStatsIndex[flowId] != 0)
+    {
+      return *m_flowStatsIndex[flowId];
+    }
   FlowStatsContainerI iter;
   iter = m_flowStats.find (flowId);
   if (iter == m_flowStats.end ())
     {
-      FlowMonitor::FlowStats &ref = m_flowStats[flowId];
+      iter = m_flowStats.insert (std::make_pair (flowId, FlowStats ())).first;
+      FlowMonitor::FlowStats &ref = iter->second;
       ref.delaySum = Seconds (0);
       ref.jitterSum = Seconds (0);
       ref.lastDelay = Seconds (0);
@@ -123,16 +155,31 @@ FlowMonitor::GetStatsForFlow (FlowId flowId)
       ref.rxPackets = 0;
       ref.lostPackets = 0;
       ref.timesForwarded = 0;
-      ref.delayHistogram.SetDefaultBinWidth (m_delayBinWidth);
-      ref.jitterHistogram.SetDefaultBinWidth (m_jitterBinWidth);
-      ref.packetSizeHistogram.SetDefaultBinWidth (m_packetSizeBinWidth);
-      ref.flowInterruptionsHistogram.SetDefaultBinWidth (m_flowInterruptionsBinWidth);
-      return ref;
+      if (m_logScaleHistograms)
+        {
+          ref.delayHistogram.SetLogScale (m_delayBinWidth, m_histogramBinsPerDecade, m_histogramMaxBins);
+          ref.jitterHistogram.SetLogScale (m_jitterBinWidth, m_histogramBinsPerDecade, m_histogramMaxBins);
+          ref.packetSizeHistogram.SetLogScale (m_packetSizeBinWidth, m_histogramBinsPerDecade, m_histogramMaxBins);
+          ref.flowInterruptionsHistogram.SetLogScale (m_flowInterruptionsBinWidth, m_histogramBinsPerDecade, m_histogramMaxBins);
+        }
+      else
+        {
+          ref.delayHistogram.SetDefaultBinWidth (m_delayBinWidth);
+          ref.jitterHistogram.SetDefaultBinWidth (m_jitterBinWidth);
+          ref.packetSizeHistogram.SetDefaultBinWidth (m_packetSizeBinWidth);
+          ref.flowInterruptionsHistogram.SetDefaultBinWidth (m_flowInterruptionsBinWidth);
+        }
     }
-  else
+  // the elements of a map are never moved: index the small FlowIds
+  if (flowId < MAX_INDEXED_FLOW_ID)
     {
-      return iter->second;
+      if (flowId >= m_flowStatsIndex.size ())
+        {
+          m_flowStatsIndex.resize (flowId + 1, 0);
+        }
+      m_flowStatsIndex[flowId] = &iter->second;
     }
+  return iter->second;
 }
 
 
@@ -146,10 +193,17 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
       return;
     }
   Time now = Simulator::Now ();
-  TrackedPacket &tracked = m_trackedPackets[std::make_pair (flowId, packetId)];
-  tracked.firstSeenTime = now;
-  tracked.lastSeenTime = tracked.firstSeenTime;
-  tracked.timesForwarded = 0;
+  if (m_fastPacketTracking)
+    {
+      m_packetTable.Insert (flowId, packetId, now);
+    }
+  else
+    {
+      TrackedPacket &tracked = m_trackedPackets[std::make_pair (flowId, packetId)];
+      tracked.firstSeenTime = now;
+      tracked.lastSeenTime = tracked.firstSeenTime;
+      tracked.timesForwarded = 0;
+    }
   NS_LOG_DEBUG ("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId=" << packetId
                                                                 << ").");
 
@@ -175,19 +229,38 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
       NS_LOG_DEBUG ("FlowMonitor not enabled; returning");
       return;
     }
-  std::pair<FlowId, FlowPacketId> key (flowId, packetId);
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
-  if (tracked == m_trackedPackets.end ())
+  Time now = Simulator::Now ();
+  Time firstSeenTime;
+  if (m_fastPacketTracking)
     {
-      NS_LOG_WARN ("Received packet forward report (flowId=" << flowId << ", packetId=" << packetId
-                                                             << ") but not known to be transmitted.");
-      return;
+      FlowPacketTable::Entry *tracked = m_packetTable.Find (flowId, packetId);
+      if (tracked == 0)
+        {
+          NS_LOG_WARN ("Received packet forward report (flowId=" << flowId << ", packetId=" << packetId
+                                                                 << ") but not known to be transmitted.");
+          return;
+        }
+      tracked->timesForwarded++;
+      m_packetTable.Touch (tracked, now);
+      firstSeenTime = tracked->firstSeenTime;
     }
+  else
+    {
+      std::pair<FlowId, FlowPacketId> key (flowId, packetId);
+      TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
+      if (tracked == m_trackedPackets.end ())
+        {
+          NS_LOG_WARN ("Received packet forward report (flowId=" << flowId << ", packetId=" << packetId
+                                                                 << ") but not known to be transmitted.");
+          return;
+        }
 
-  tracked->second.timesForwarded++;
-  tracked->second.lastSeenTime = Simulator::Now ();
+      tracked->second.timesForwarded++;
+      tracked->second.lastSeenTime = now;
+      firstSeenTime = tracked->second.firstSeenTime;
+    }
 
-  Time delay = (Simulator::Now () - tracked->second.firstSeenTime);
+  Time delay = (now - firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
 }
 
@@ -201,16 +274,39 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
       NS_LOG_DEBUG ("FlowMonitor not enabled; returning");
       return;
     }
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
-  if (tracked == m_trackedPackets.end ())
+  Time firstSeenTime;
+  uint32_t timesForwarded;
+  if (m_fastPacketTracking)
     {
-      NS_LOG_WARN ("Received packet last-tx report (flowId=" << flowId << ", packetId=" << packetId
-                                                             << ") but not known to be transmitted.");
-      return;
+      FlowPacketTable::Entry *tracked = m_packetTable.Find (flowId, packetId);
+      if (tracked == 0)
+        {
+          NS_LOG_WARN ("Received packet last-tx report (flowId=" << flowId << ", packetId=" << packetId
+                                                                 << ") but not known to be transmitted.");
+          return;
+        }
+      firstSeenTime = tracked->firstSeenTime;
+      timesForwarded = tracked->timesForwarded;
+      m_packetTable.Erase (tracked); // we don't need to track this packet anymore
+    }
+  else
+    {
+      TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
+      if (tracked == m_trackedPackets.end ())
+        {
+          NS_LOG_WARN ("Received packet last-tx report (flowId=" << flowId << ", packetId=" << packetId
+                                                                 << ") but not known to be transmitted.");
+          return;
+        }
+      firstSeenTime = tracked->second.firstSeenTime;
+      timesForwarded = tracked->second.timesForwarded;
+      m_trackedPackets.erase (tracked); // we don't need to track this packet anymore
     }
+  NS_LOG_DEBUG ("ReportLastTx: removed tracked packet (flowId="
+                << flowId << ", packetId=" << packetId << ").");
 
   Time now = Simulator::Now ();
-  Time delay = (now - tracked->second.firstSeenTime);
+  Time delay = (now - firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
 
   FlowStats &stats = GetStatsForFlow (flowId);
@@ -249,12 +345,7 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
         }
     }
   stats.timeLastRxPacket = now;
-  stats.timesForwarded += tracked->second.timesForwarded;
-
-  NS_LOG_DEBUG ("ReportLastTx: removing tracked packet (flowId="
-                << flowId << ", packetId=" << packetId << ").");
-
-  m_trackedPackets.erase (tracked); // we don't need to track this packet anymore
+  stats.timesForwarded += timesForwarded;
 }
 
 void
@@ -281,6 +372,17 @@ FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetI
   stats.bytesDropped[reasonCode] += packetSize;
   NS_LOG_DEBUG ("++stats.packetsDropped[" << reasonCode<< "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
+  if (m_fastPacketTracking)
+    {
+      FlowPacketTable::Entry *tracked = m_packetTable.Find (flowId, packetId);
+      if (tracked != 0)
+        {
+          NS_LOG_DEBUG ("ReportDrop: removing tracked packet (flowId="
+                        << flowId << ", packetId=" << packetId << ").");
+          m_packetTable.Erase (tracked);
+        }
+      return;
+    }
   TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
   if (tracked != m_trackedPackets.end ())
     {
@@ -305,6 +407,18 @@ FlowMonitor::CheckForLostPackets (Time maxDelay)
   NS_LOG_FUNCTION (this << maxDelay.GetSeconds ());
   Time now = Simulator::Now ();
 
+  if (m_fastPacketTracking)
+    {
+      std::vector<FlowId> lostFlows;
+      m_packetTable.Expire (now - maxDelay, lostFlows);
+      for (std::vector<FlowId>::const_iterator iter = lostFlows.begin (); iter != lostFlows.end (); iter++)
+        {
+          // packet is considered lost, add it to the loss statistics
+          GetStatsForFlow (*iter).lostPackets++;
+        }
+      return;
+    }
+
   for (TrackedPacketMap::iterator iter = m_trackedPackets.begin ();
        iter != m_trackedPackets.end (); )
     {
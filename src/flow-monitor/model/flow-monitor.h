@@ -29,6 +29,7 @@
 #include "ns3/flow-probe.h"
 #include "ns3/flow-classifier.h"
 #include "ns3/histogram.h"
+#include "ns3/flow-packet-table.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 
@@ -277,9 +278,14 @@ private:
   /// FlowId --> FlowStats
   FlowStatsContainer m_flowStats;
 
+  /// FlowId --> FlowStats of m_flowStats, for the small FlowIds
+  std::vector<FlowStats *> m_flowStatsIndex;
+
   /// (FlowId,PacketId) --> TrackedPacket
   typedef std::map< std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
   TrackedPacketMap m_trackedPackets; //!< Tracked packets
+  bool m_fastPacketTracking; //!< Track the packets in m_packetTable instead of m_trackedPackets
+  FlowPacketTable m_packetTable; //!< Tracked packets, in the FastPacketTracking mode
   Time m_maxPerHopDelay; //!< Minimum per-hop delay
   FlowProbeContainer m_flowProbes; //!< all the FlowProbes
 
@@ -293,6 +299,9 @@ private:
   double m_jitterBinWidth;  //!< Jitter bin width (for histograms)
   double m_packetSizeBinWidth;  //!< packet size bin width (for histograms)
   double m_flowInterruptionsBinWidth; //!< Flow interruptions bin width (for histograms)
+  bool m_logScaleHistograms; //!< Use histograms of logarithmic bins
+  uint32_t m_histogramBinsPerDecade; //!< Number of bins per power of ten (log scale histograms)
+  uint32_t m_histogramMaxBins; //!< Number of bins (log scale histograms)
   Time m_flowInterruptionsMinTime; //!< Flow interruptions minimum time
 
   /// Get the stats for a given flow
@@ -0,0 +1,244 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "flow-packet-table.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+
+#define INITIAL_BITS 10
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FlowPacketTable");
+
+FlowPacketTable::FlowPacketTable (Time slotWidth)
+  : m_bits (INITIAL_BITS),
+    m_size (0),
+    m_slotWidth (slotWidth.GetTimeStep ()),
+    m_firstSlot (0),
+    m_wheelSize (0)
+{
+  NS_ASSERT (m_slotWidth > 0);
+  Entry unused = { 0, 0, Time (), Time (), 0, false };
+  m_buckets.assign (1 << m_bits, unused);
+}
+
+uint32_t
+FlowPacketTable::Hash (FlowId flowId, FlowPacketId packetId) const
+{
+  // Fibonacci hashing: the high bits of the product mix all the bits of the key
+  uint64_t key = (static_cast<uint64_t> (flowId) << 32) | packetId;
+  return static_cast<uint32_t> ((key * 0x9E3779B97F4A7C15ULL) >> (64 - m_bits));
+}
+
+FlowPacketTable::Entry &
+FlowPacketTable::Insert (FlowId flowId, FlowPacketId packetId, Time now)
+{
+  if (2 * (m_size + 1) > m_buckets.size ())
+    {
+      Grow ();
+    }
+  uint32_t mask = m_buckets.size () - 1;
+  uint32_t i = Hash (flowId, packetId);
+  while (m_buckets[i].used
+         && (m_buckets[i].flowId != flowId || m_buckets[i].packetId != packetId))
+    {
+      i = (i + 1) & mask;
+    }
+  Entry &entry = m_buckets[i];
+  if (!entry.used)
+    {
+      entry.used = true;
+      entry.flowId = flowId;
+      entry.packetId = packetId;
+      m_size++;
+    }
+  entry.firstSeenTime = now;
+  entry.lastSeenTime = now;
+  entry.timesForwarded = 0;
+  Schedule (flowId, packetId, now);
+  return entry;
+}
+
+FlowPacketTable::Entry *
+FlowPacketTable::Find (FlowId flowId, FlowPacketId packetId)
+{
+  uint32_t mask = m_buckets.size () - 1;
+  for (uint32_t i = Hash (flowId, packetId); m_buckets[i].used; i = (i + 1) & mask)
+    {
+      if (m_buckets[i].flowId == flowId && m_buckets[i].packetId == packetId)
+        {
+          return &m_buckets[i];
+        }
+    }
+  return 0;
+}
+
+void
+FlowPacketTable::Touch (Entry *entry, Time now)
+{
+  entry->lastSeenTime = now;
+  Schedule (entry->flowId, entry->packetId, now);
+}
+
+void
+FlowPacketTable::Erase (Entry *entry)
+{
+  NS_ASSERT (entry->used);
+  uint32_t mask = m_buckets.size () - 1;
+  uint32_t hole = entry - &m_buckets[0];
+  // backward shift deletion: move back the following packets of the
+  // cluster which are not in their home bucket, so that no tombstone
+  // is needed
+  for (uint32_t j = (hole + 1) & mask; m_buckets[j].used; j = (j + 1) & mask)
+    {
+      uint32_t home = Hash (m_buckets[j].flowId, m_buckets[j].packetId);
+      // the packet stays if its home is cyclically in (hole, j]
+      bool stays = hole <= j ? (hole < home && home <= j) : (hole < home || home <= j);
+      if (!stays)
+        {
+          m_buckets[hole] = m_buckets[j];
+          hole = j;
+        }
+    }
+  m_buckets[hole].used = false;
+  m_size--;
+}
+
+void
+FlowPacketTable::Grow (void)
+{
+  NS_LOG_FUNCTION (this << m_buckets.size ());
+  std::vector<Entry> old;
+  old.swap (m_buckets);
+  m_bits++;
+  Entry unused = { 0, 0, Time (), Time (), 0, false };
+  m_buckets.assign (1 << m_bits, unused);
+  uint32_t mask = m_buckets.size () - 1;
+  for (std::vector<Entry>::const_iterator it = old.begin (); it != old.end (); ++it)
+    {
+      if (it->used)
+        {
+          uint32_t i = Hash (it->flowId, it->packetId);
+          while (m_buckets[i].used)
+            {
+              i = (i + 1) & mask;
+            }
+          m_buckets[i] = *it;
+        }
+    }
+}
+
+void
+FlowPacketTable::Schedule (FlowId flowId, FlowPacketId packetId, Time lastSeen)
+{
+  int64_t ts = lastSeen.GetTimeStep ();
+  int64_t slot = ts / m_slotWidth;
+  if (m_wheelSize == 0)
+    {
+      // do not keep the empty slots of an idle period
+      m_slots.clear ();
+      m_firstSlot = slot;
+    }
+  else if (slot < m_firstSlot)
+    {
+      slot = m_firstSlot;
+    }
+  if (slot - m_firstSlot >= static_cast<int64_t> (m_slots.size ()))
+    {
+      m_slots.resize (slot - m_firstSlot + 1);
+    }
+  WheelEntry wheelEntry = { flowId, packetId, ts };
+  m_slots[slot - m_firstSlot].push_back (wheelEntry);
+  m_wheelSize++;
+}
+
+bool
+FlowPacketTable::ExpireEntry (const WheelEntry &wheelEntry, int64_t deadline, std::vector<FlowId> &lostFlows)
+{
+  Entry *entry = Find (wheelEntry.flowId, wheelEntry.packetId);
+  if (entry == 0 || entry->lastSeenTime.GetTimeStep () != wheelEntry.lastSeen)
+    {
+      // received, dropped or seen again since this entry was added
+      return true;
+    }
+  if (wheelEntry.lastSeen > deadline)
+    {
+      return false;
+    }
+  lostFlows.push_back (entry->flowId);
+  Erase (entry);
+  return true;
+}
+
+void
+FlowPacketTable::Expire (Time deadline, std::vector<FlowId> &lostFlows)
+{
+  NS_LOG_FUNCTION (this << deadline.GetSeconds ());
+  int64_t limit = deadline.GetTimeStep ();
+  while (!m_slots.empty ())
+    {
+      std::vector<WheelEntry> &slot = m_slots.front ();
+      if ((m_firstSlot + 1) * m_slotWidth - 1 <= limit)
+        {
+          // all the packets of the slot were last seen before the deadline
+          for (std::vector<WheelEntry>::const_iterator it = slot.begin (); it != slot.end (); ++it)
+            {
+              ExpireEntry (*it, limit, lostFlows);
+            }
+          m_wheelSize -= slot.size ();
+          m_slots.pop_front ();
+          m_firstSlot++;
+        }
+      else
+        {
+          // the slot of the deadline: keep the packets seen after it
+          std::vector<WheelEntry>::iterator kept = slot.begin ();
+          for (std::vector<WheelEntry>::const_iterator it = slot.begin (); it != slot.end (); ++it)
+            {
+              if (!ExpireEntry (*it, limit, lostFlows))
+                {
+                  *kept++ = *it;
+                }
+            }
+          m_wheelSize -= slot.end () - kept;
+          slot.erase (kept, slot.end ());
+          break;
+        }
+    }
+}
+
+uint32_t
+FlowPacketTable::GetSize (void) const
+{
+  return m_size;
+}
+
+void
+FlowPacketTable::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Entry>::iterator it = m_buckets.begin (); it != m_buckets.end (); ++it)
+    {
+      it->used = false;
+    }
+  m_size = 0;
+  m_slots.clear ();
+  m_firstSlot = 0;
+  m_wheelSize = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef FLOW_PACKET_TABLE_H
+#define FLOW_PACKET_TABLE_H
+
+#include <stdint.h>
+#include <vector>
+#include <deque>
+
+#include "ns3/nstime.h"
+#include "ns3/flow-classifier.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup flow-monitor
+ * \brief The packets tracked by a FlowMonitor in its FastPacketTracking mode
+ *
+ * The packets are stored in an open-addressing hash table with linear
+ * probing, keyed by their (FlowId, FlowPacketId) pair.  Their last seen
+ * times are also recorded in a timing wheel, a queue of slots of fixed
+ * width, so that the lost packets are found by only visiting the slots
+ * older than the loss deadline, instead of all the tracked packets.
+ *
+ * The wheel entries are not removed when a packet is received, dropped
+ * or seen again: an entry whose packet is no longer in the table, or
+ * was seen at another time, is simply skipped when its slot expires.
+ */
+class FlowPacketTable
+{
+public:
+  /// A tracked packet
+  struct Entry
+  {
+    FlowId flowId;           //!< flow of the packet
+    FlowPacketId packetId;   //!< packet identifier within the flow
+    Time firstSeenTime;      //!< absolute time when the packet was first seen by a probe
+    Time lastSeenTime;       //!< absolute time when the packet was last seen by a probe
+    uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
+    bool used;               //!< true if the bucket holds a packet
+  };
+
+  /**
+   * \brief Constructor
+   * \param slotWidth width of the slots of the timing wheel
+   */
+  FlowPacketTable (Time slotWidth = MilliSeconds (100));
+
+  /**
+   * \brief Start tracking a packet, or restart if it is already tracked
+   * \param flowId flow of the packet
+   * \param packetId packet identifier within the flow
+   * \param now the current time
+   * \return the tracked packet, valid until the next call to Insert or Erase
+   */
+  Entry & Insert (FlowId flowId, FlowPacketId packetId, Time now);
+
+  /**
+   * \brief Find a tracked packet
+   * \param flowId flow of the packet
+   * \param packetId packet identifier within the flow
+   * \return the tracked packet, or 0 if it is not tracked
+   */
+  Entry * Find (FlowId flowId, FlowPacketId packetId);
+
+  /**
+   * \brief Record that a tracked packet was seen again
+   * \param entry the tracked packet
+   * \param now the current time
+   */
+  void Touch (Entry *entry, Time now);
+
+  /**
+   * \brief Stop tracking a packet
+   * \param entry the tracked packet
+   */
+  void Erase (Entry *entry);
+
+  /**
+   * \brief Stop tracking the packets last seen at or before a deadline
+   * \param deadline the deadline
+   * \param lostFlows receives the flow of each packet no longer tracked
+   */
+  void Expire (Time deadline, std::vector<FlowId> &lostFlows);
+
+  /**
+   * \return the number of tracked packets
+   */
+  uint32_t GetSize (void) const;
+
+  /// Stop tracking all the packets
+  void Clear (void);
+
+private:
+  /// An entry of the timing wheel
+  struct WheelEntry
+  {
+    FlowId flowId;          //!< flow of the packet
+    FlowPacketId packetId;  //!< packet identifier within the flow
+    int64_t lastSeen;       //!< last seen time of the packet, in time steps
+  };
+
+  /**
+   * \param flowId flow of the packet
+   * \param packetId packet identifier within the flow
+   * \return the home bucket of the packet
+   */
+  uint32_t Hash (FlowId flowId, FlowPacketId packetId) const;
+
+  /**
+   * \brief Double the number of buckets and insert the packets again
+   */
+  void Grow (void);
+
+  /**
+   * \brief Add a packet to the timing wheel
+   * \param flowId flow of the packet
+   * \param packetId packet identifier within the flow
+   * \param lastSeen last seen time of the packet
+   */
+  void Schedule (FlowId flowId, FlowPacketId packetId, Time lastSeen);
+
+  /**
+   * \brief Expire a wheel entry if its packet was last seen at or before a deadline
+   * \param wheelEntry the wheel entry
+   * \param deadline the deadline, in time steps
+   * \param lostFlows receives the flow of the packet if it is expired
+   * \return false if the packet is tracked and was seen after the deadline
+   */
+  bool ExpireEntry (const WheelEntry &wheelEntry, int64_t deadline, std::vector<FlowId> &lostFlows);
+
+  std::vector<Entry> m_buckets;                   //!< The hash table
+  uint32_t m_bits;                                //!< Log2 of the number of buckets
+  uint32_t m_size;                                //!< Number of tracked packets
+  int64_t m_slotWidth;                            //!< Slot width, in time steps
+  std::deque<std::vector<WheelEntry> > m_slots;   //!< The timing wheel, oldest slot first
+  int64_t m_firstSlot;                            //!< Index of the oldest slot
+  uint32_t m_wheelSize;                           //!< Number of wheel entries
+};
+
+} // namespace ns3
+
+#endif /* FLOW_PACKET_TABLE_H */
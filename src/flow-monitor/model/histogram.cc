@@ -45,20 +45,32 @@ Histogram::GetNBins () const
 }
 
 double 
-Histogram::GetBinStart (uint32_t index)
+Histogram::GetBinStart (uint32_t index) const
 {
+  if (m_logScale)
+    {
+      return index == 0 ? 0 : GetBinEnd (index - 1);
+    }
   return index*m_binWidth;
 }
 
 double 
-Histogram::GetBinEnd (uint32_t index)
+Histogram::GetBinEnd (uint32_t index) const
 {
+  if (m_logScale)
+    {
+      return m_binWidth * std::pow (10.0, (double) index / m_binsPerDecade);
+    }
   return (index + 1) * m_binWidth;
 }
 
 double 
 Histogram::GetBinWidth (uint32_t index) const
 {
+  if (m_logScale)
+    {
+      return GetBinEnd (index) - GetBinStart (index);
+    }
   return m_binWidth;
 }
 
@@ -69,6 +81,17 @@ Histogram::SetDefaultBinWidth (double binWidth)
   m_binWidth = binWidth;
 }
 
+void
+Histogram::SetLogScale (double minValue, uint32_t binsPerDecade, uint32_t maxBins)
+{
+  NS_ASSERT (m_histogram.size () == 0); //we can only change the bins if no values were added
+  NS_ASSERT (minValue > 0 && binsPerDecade > 0 && maxBins > 1);
+  m_logScale = true;
+  m_binWidth = minValue;
+  m_binsPerDecade = binsPerDecade;
+  m_maxBins = maxBins;
+}
+
 uint32_t 
 Histogram::GetBinCount (uint32_t index) 
 {
@@ -79,7 +102,20 @@ Histogram::GetBinCount (uint32_t index)
 void 
 Histogram::AddValue (double value)
 {
-  uint32_t index = (uint32_t)std::floor (value/m_binWidth);
+  uint32_t index;
+  if (!m_logScale)
+    {
+      index = (uint32_t)std::floor (value/m_binWidth);
+    }
+  else if (value < m_binWidth)
+    {
+      index = 0;
+    }
+  else
+    {
+      double bin = 1 + std::floor (std::log10 (value / m_binWidth) * m_binsPerDecade);
+      index = bin < m_maxBins ? (uint32_t) bin : m_maxBins - 1;
+    }
 
   //check if we need to resize the vector
   NS_LOG_DEBUG ("AddValue: index=" << index << ", m_histogram.size()=" << m_histogram.size ());
@@ -92,11 +128,17 @@ Histogram::AddValue (double value)
 }
 
 Histogram::Histogram (double binWidth)
+  : m_logScale (false),
+    m_binsPerDecade (0),
+    m_maxBins (0)
 {
   m_binWidth = binWidth;
 }
 
 Histogram::Histogram ()
+  : m_logScale (false),
+    m_binsPerDecade (0),
+    m_maxBins (0)
 {
   m_binWidth = DEFAULT_BIN_WIDTH;
 }
@@ -117,8 +159,8 @@ Histogram::SerializeToXmlStream (std::ostream &os, uint16_t indent, std::string
           os << std::string ( indent, ' ' );
           os << "<bin"
              << " index=\"" << (index) << "\""
-             << " start=\"" << (index*m_binWidth) << "\""
-             << " width=\"" << m_binWidth << "\""
+             << " start=\"" << GetBinStart (index) << "\""
+             << " width=\"" << GetBinWidth (index) << "\""
              << " count=\"" << m_histogram[index] << "\""
              << " />\n";
         }
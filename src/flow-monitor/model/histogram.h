@@ -36,6 +36,12 @@ namespace ns3 {
  *
  * This class only handles \a positive bins, i.e., it does \a not handles negative data.
  *
+ * Alternatively, the histogram can use a fixed number of bins of
+ * logarithmic width (see SetLogScale): bin 0 groups the data below a
+ * minimum value, bin \a i the data from [min*10^((i-1)/binsPerDecade),
+ * min*10^(i/binsPerDecade)), and the last bin all the larger data.
+ * Its memory is then bounded whatever the range of the data.
+ *
  * \todo Add support for negative data.
  *
  * \todo Add method(s) to estimate parameters from the histogram,
@@ -65,17 +71,18 @@ public:
    * \param index the bin index
    * \return the bin start
    */
-  double GetBinStart (uint32_t index);
+  double GetBinStart (uint32_t index) const;
   /**
    * \brief Returns the bin end, i.e., (index+1)*binWidth
    * \param index the bin index
    * \return the bin start
    */
-  double GetBinEnd (uint32_t index);
+  double GetBinEnd (uint32_t index) const;
   /**
    * \brief Returns the bin width.
    *
-   * Note that all the bins have the same width.
+   * Note that all the bins have the same width, unless the histogram
+   * uses a log scale.
    *
    * \param index the bin index
    * \return the bin width
@@ -89,6 +96,16 @@ public:
    * \param binWidth the bin width
    */
   void SetDefaultBinWidth (double binWidth);
+  /**
+   * \brief Use bins of logarithmic width.
+   *
+   * Note that you can change the bins only if the histogram is empty.
+   *
+   * \param minValue the end of the first bin
+   * \param binsPerDecade the number of bins per power of ten
+   * \param maxBins the maximum number of bins
+   */
+  void SetLogScale (double minValue, uint32_t binsPerDecade, uint32_t maxBins);
   /**
    * \brief Get the number of data added to the bin.
    * \param index the bin index
@@ -115,6 +132,9 @@ public:
 private:
   std::vector<uint32_t> m_histogram; //!< Histogram data
   double m_binWidth; //!< Bin width
+  bool m_logScale; //!< Bins of logarithmic width
+  uint32_t m_binsPerDecade; //!< Number of bins per power of ten (log scale)
+  uint32_t m_maxBins; //!< Maximum number of bins (log scale)
 };
 
 
@@ -23,6 +23,8 @@
 
 #include <stdint.h>
 #include <map>
+#include <vector>
+#include <unordered_map>
 
 #include "ns3/ipv4-header.h"
 #include "ns3/flow-classifier.h"
@@ -92,12 +94,26 @@ public:
 
 private:
 
+  /// Hash function of the FiveTuple
+  struct FiveTupleHash
+  {
+    /// \param tuple the FiveTuple
+    /// \return the hash of the tuple
+    std::size_t operator() (const FiveTuple &tuple) const;
+  };
+
+  /// State of a flow
+  struct FlowInfo
+  {
+    FiveTuple tuple;             //!< Five tuple of the flow
+    FlowPacketId lastPacketId;   //!< Identifier of the last packet
+    uint32_t dscpCounts[64];     //!< Packet count of each DSCP value
+  };
+
   /// Map to Flows Identifiers to FlowIds
-  std::map<FiveTuple, FlowId> m_flowMap;
-  /// Map to FlowIds to FlowPacketId
-  std::map<FlowId, FlowPacketId> m_flowPktIdMap;
-  /// Map FlowIds to (DSCP value, packet count) pairs
-  std::map<FlowId, std::map<Ipv4Header::DscpType, uint32_t> > m_flowDscpMap;
+  std::unordered_map<FiveTuple, FlowId, FiveTupleHash> m_flowMap;
+  /// The flows, indexed by FlowId - 1
+  std::vector<FlowInfo> m_flows;
 
 };
 
@@ -0,0 +1,344 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/flow-packet-table.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief A FlowProbe reporting the events scripted by a test
+ */
+class TestFlowProbe : public FlowProbe
+{
+public:
+  /**
+   * Constructor
+   * \param monitor the FlowMonitor
+   */
+  TestFlowProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief Check that the FastPacketTracking mode of the FlowMonitor
+ * gives the same flow statistics as the default mode.
+ */
+class FlowMonitorTrackingTestCase : public TestCase
+{
+public:
+  FlowMonitorTrackingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// Scripted packet events
+  enum EventType
+  {
+    FIRST_TX,
+    FORWARD,
+    LAST_RX,
+    DROP
+  };
+
+  /**
+   * \brief Report a packet event to the monitor
+   * \param type the event
+   * \param flowId the flow of the packet
+   * \param packetId the packet
+   */
+  void Report (uint32_t type, FlowId flowId, FlowPacketId packetId);
+
+  /**
+   * \brief Run the scenario
+   * \param fast enable the FastPacketTracking
+   * \return the flow statistics
+   */
+  FlowMonitor::FlowStatsContainer RunOne (bool fast);
+
+  Ptr<FlowMonitor> m_monitor; //!< The monitor
+  Ptr<FlowProbe> m_probe;     //!< The reporting probe
+};
+
+FlowMonitorTrackingTestCase::FlowMonitorTrackingTestCase ()
+  : TestCase ("FlowMonitor FastPacketTracking")
+{
+}
+
+void
+FlowMonitorTrackingTestCase::Report (uint32_t type, FlowId flowId, FlowPacketId packetId)
+{
+  switch (type)
+    {
+    case FIRST_TX:
+      m_monitor->ReportFirstTx (m_probe, flowId, packetId, 1000);
+      break;
+    case FORWARD:
+      m_monitor->ReportForwarding (m_probe, flowId, packetId, 1000);
+      break;
+    case LAST_RX:
+      m_monitor->ReportLastRx (m_probe, flowId, packetId, 1000);
+      break;
+    case DROP:
+      m_monitor->ReportDrop (m_probe, flowId, packetId, 1000, 0);
+      break;
+    }
+}
+
+FlowMonitor::FlowStatsContainer
+FlowMonitorTrackingTestCase::RunOne (bool fast)
+{
+  m_monitor = CreateObjectWithAttributes<FlowMonitor> ("FastPacketTracking", BooleanValue (fast),
+                                                       "MaxPerHopDelay", TimeValue (Seconds (5)));
+  m_probe = Create<TestFlowProbe> (m_monitor);
+
+  for (FlowId flowId = 1; flowId <= 50; flowId++)
+    {
+      for (FlowPacketId packetId = 0; packetId < 200; packetId++)
+        {
+          Time sent = MilliSeconds (100 * packetId + flowId);
+          Simulator::Schedule (sent, &FlowMonitorTrackingTestCase::Report, this, FIRST_TX, flowId, packetId);
+          if ((flowId + packetId) % 7 == 0)
+            {
+              Simulator::Schedule (sent + MilliSeconds (5), &FlowMonitorTrackingTestCase::Report,
+                                   this, DROP, flowId, packetId);
+            }
+          else if ((flowId + packetId) % 11 == 0)
+            {
+              // each hop takes less than the MaxPerHopDelay
+              Simulator::Schedule (sent + Seconds (4), &FlowMonitorTrackingTestCase::Report,
+                                   this, FORWARD, flowId, packetId);
+              Simulator::Schedule (sent + Seconds (8), &FlowMonitorTrackingTestCase::Report,
+                                   this, LAST_RX, flowId, packetId);
+            }
+          else if ((flowId + packetId) % 5 != 0)
+            {
+              Simulator::Schedule (sent + MilliSeconds (2), &FlowMonitorTrackingTestCase::Report,
+                                   this, FORWARD, flowId, packetId);
+              Simulator::Schedule (sent + MilliSeconds (3 + packetId % 4), &FlowMonitorTrackingTestCase::Report,
+                                   this, LAST_RX, flowId, packetId);
+            }
+          // otherwise the packet is lost
+        }
+    }
+  Simulator::Stop (Seconds (40));
+  Simulator::Run ();
+  m_monitor->CheckForLostPackets ();
+  FlowMonitor::FlowStatsContainer stats = m_monitor->GetFlowStats ();
+  m_monitor->Dispose ();
+  m_monitor = 0;
+  m_probe = 0;
+  Simulator::Destroy ();
+  return stats;
+}
+
+void
+FlowMonitorTrackingTestCase::DoRun (void)
+{
+  FlowMonitor::FlowStatsContainer stats = RunOne (false);
+  FlowMonitor::FlowStatsContainer fastStats = RunOne (true);
+
+  NS_TEST_ASSERT_MSG_EQ (stats.size (), 50, "Unexpected number of flows");
+  NS_TEST_ASSERT_MSG_EQ (fastStats.size (), stats.size (), "Different number of flows");
+  uint32_t lostPackets = 0;
+  for (FlowMonitor::FlowStatsContainerCI iter = stats.begin (); iter != stats.end (); iter++)
+    {
+      FlowMonitor::FlowStatsContainerCI fast = fastStats.find (iter->first);
+      NS_TEST_ASSERT_MSG_EQ ((fast != fastStats.end ()), true, "Missing flow " << iter->first);
+      NS_TEST_EXPECT_MSG_EQ (fast->second.txPackets, iter->second.txPackets, "Flow " << iter->first);
+      NS_TEST_EXPECT_MSG_EQ (fast->second.rxPackets, iter->second.rxPackets, "Flow " << iter->first);
+      NS_TEST_EXPECT_MSG_EQ (fast->second.lostPackets, iter->second.lostPackets, "Flow " << iter->first);
+      NS_TEST_EXPECT_MSG_EQ (fast->second.timesForwarded, iter->second.timesForwarded, "Flow " << iter->first);
+      NS_TEST_EXPECT_MSG_EQ (fast->second.delaySum, iter->second.delaySum, "Flow " << iter->first);
+      NS_TEST_EXPECT_MSG_EQ (fast->second.jitterSum, iter->second.jitterSum, "Flow " << iter->first);
+      lostPackets += fast->second.lostPackets;
+    }
+
+  // the dropped packets, and the packets which are never received
+  uint32_t expected = 0;
+  for (FlowId flowId = 1; flowId <= 50; flowId++)
+    {
+      for (FlowPacketId packetId = 0; packetId < 200; packetId++)
+        {
+          uint32_t n = flowId + packetId;
+          if (n % 7 == 0 || (n % 11 != 0 && n % 5 == 0))
+            {
+              expected++;
+            }
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (lostPackets, expected, "Unexpected number of lost packets");
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief Check the hash table of the FlowPacketTable
+ */
+class FlowPacketTableTestCase : public TestCase
+{
+public:
+  FlowPacketTableTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FlowPacketTableTestCase::FlowPacketTableTestCase ()
+  : TestCase ("FlowPacketTable")
+{
+}
+
+void
+FlowPacketTableTestCase::DoRun (void)
+{
+  FlowPacketTable table (MilliSeconds (10));
+  for (uint32_t i = 0; i < 5000; i++)
+    {
+      table.Insert (i % 13, i, MilliSeconds (i));
+    }
+  NS_TEST_ASSERT_MSG_EQ (table.GetSize (), 5000, "Packets missing after growing the table");
+
+  // erase every other packet, which shifts back the clusters
+  for (uint32_t i = 0; i < 5000; i += 2)
+    {
+      FlowPacketTable::Entry *entry = table.Find (i % 13, i);
+      NS_TEST_ASSERT_MSG_NE (entry, 0, "Packet " << i << " not found");
+      table.Erase (entry);
+    }
+  NS_TEST_ASSERT_MSG_EQ (table.GetSize (), 2500, "Unexpected size after the erasures");
+  for (uint32_t i = 0; i < 5000; i++)
+    {
+      FlowPacketTable::Entry *entry = table.Find (i % 13, i);
+      NS_TEST_EXPECT_MSG_EQ ((entry != 0), (i % 2 == 1), "Packet " << i);
+    }
+
+  // packets seen again are not expired by their first wheel entry
+  table.Touch (table.Find (1 % 13, 1), MilliSeconds (4000));
+  std::vector<FlowId> lostFlows;
+  table.Expire (MilliSeconds (2999), lostFlows);
+  NS_TEST_EXPECT_MSG_EQ (lostFlows.size (), 1499, "Unexpected number of expired packets");
+  NS_TEST_EXPECT_MSG_EQ (table.GetSize (), 1001, "Unexpected size after the expiry");
+  NS_TEST_EXPECT_MSG_NE (table.Find (1 % 13, 1), 0, "The packet seen again was expired");
+  NS_TEST_EXPECT_MSG_EQ (table.Find (2999 % 13, 2999), 0, "The packet seen at the deadline was not expired");
+  NS_TEST_EXPECT_MSG_NE (table.Find (3001 % 13, 3001), 0, "A packet seen after the deadline was expired");
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief Check the flows of the Ipv4FlowClassifier
+ */
+class Ipv4FlowClassifierTestCase : public TestCase
+{
+public:
+  Ipv4FlowClassifierTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv4FlowClassifierTestCase::Ipv4FlowClassifierTestCase ()
+  : TestCase ("Ipv4FlowClassifier")
+{
+}
+
+void
+Ipv4FlowClassifierTestCase::DoRun (void)
+{
+  Ptr<Ipv4FlowClassifier> classifier = Create<Ipv4FlowClassifier> ();
+  // source port 1000, destination port 80
+  uint8_t ports[4] = { 0x03, 0xe8, 0x00, 0x50 };
+  Ptr<Packet> payload = Create<Packet> (ports, 4);
+
+  Ipv4Header header;
+  header.SetSource (Ipv4Address ("10.0.0.1"));
+  header.SetDestination (Ipv4Address ("10.0.0.2"));
+  header.SetProtocol (6);
+  header.SetDscp (Ipv4Header::DSCP_AF11);
+
+  uint32_t flowId;
+  uint32_t packetId;
+  NS_TEST_ASSERT_MSG_EQ (classifier->Classify (header, payload, &flowId, &packetId), true, "TCP not classified");
+  NS_TEST_EXPECT_MSG_EQ (flowId, 1, "Unexpected flow");
+  NS_TEST_EXPECT_MSG_EQ (packetId, 0, "Unexpected packet");
+
+  Ipv4Header other = header;
+  other.SetSource (Ipv4Address ("10.0.0.3"));
+  classifier->Classify (other, payload, &flowId, &packetId);
+  NS_TEST_EXPECT_MSG_EQ (flowId, 2, "Unexpected flow");
+  NS_TEST_EXPECT_MSG_EQ (packetId, 0, "Unexpected packet");
+
+  header.SetDscp (Ipv4Header::DSCP_EF);
+  classifier->Classify (header, payload, &flowId, &packetId);
+  classifier->Classify (header, payload, &flowId, &packetId);
+  NS_TEST_EXPECT_MSG_EQ (flowId, 1, "Unexpected flow");
+  NS_TEST_EXPECT_MSG_EQ (packetId, 2, "Unexpected packet");
+
+  header.SetProtocol (1);
+  NS_TEST_EXPECT_MSG_EQ (classifier->Classify (header, payload, &flowId, &packetId), false, "ICMP classified");
+
+  Ipv4FlowClassifier::FiveTuple tuple = classifier->FindFlow (2);
+  NS_TEST_EXPECT_MSG_EQ (tuple.sourceAddress, Ipv4Address ("10.0.0.3"), "Unexpected source");
+  NS_TEST_EXPECT_MSG_EQ (tuple.sourcePort, 1000, "Unexpected source port");
+  NS_TEST_EXPECT_MSG_EQ (tuple.destinationPort, 80, "Unexpected destination port");
+
+  std::vector<std::pair<Ipv4Header::DscpType, uint32_t> > dscps = classifier->GetDscpCounts (1);
+  NS_TEST_ASSERT_MSG_EQ (dscps.size (), 2, "Unexpected number of DSCP values");
+  NS_TEST_EXPECT_MSG_EQ (dscps[0].first, Ipv4Header::DSCP_EF, "DSCP values not sorted by count");
+  NS_TEST_EXPECT_MSG_EQ (dscps[0].second, 2, "Unexpected DSCP count");
+  NS_TEST_EXPECT_MSG_EQ (dscps[1].first, Ipv4Header::DSCP_AF11, "Unexpected DSCP value");
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowMonitor TestSuite
+ */
+class FlowMonitorTestSuite : public TestSuite
+{
+public:
+  FlowMonitorTestSuite ();
+};
+
+FlowMonitorTestSuite::FlowMonitorTestSuite ()
+  : TestSuite ("flow-monitor", UNIT)
+{
+  AddTestCase (new FlowPacketTableTestCase, TestCase::QUICK);
+  AddTestCase (new FlowMonitorTrackingTestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4FlowClassifierTestCase, TestCase::QUICK);
+}
+
+static FlowMonitorTestSuite g_flowMonitorTestSuite; //!< Static variable for test initialization
@@ -20,6 +20,7 @@
 
 #include "ns3/histogram.h"
 #include "ns3/test.h"
+#include <cmath>
 
 using namespace ns3;
 
@@ -78,6 +79,32 @@ HistogramTestCase::DoRun (void)
     NS_TEST_EXPECT_MSG_EQ (h0.GetNBins (), 22, "");
     NS_TEST_EXPECT_MSG_EQ (h0.GetBinCount (21), 1, "");
   }
+
+  Histogram h1;
+  h1.SetLogScale (0.001, 10, 32);
+  // Testing log scale bins
+  {
+    h1.AddValue (0.0005);
+    h1.AddValue (0.0015);
+    h1.AddValue (0.0015);
+    h1.AddValue (0.05);
+
+    NS_TEST_EXPECT_MSG_EQ (h1.GetNBins (), 18, "");
+    NS_TEST_EXPECT_MSG_EQ (h1.GetBinCount (0), 1, "");
+    NS_TEST_EXPECT_MSG_EQ (h1.GetBinCount (2), 2, "");
+    NS_TEST_EXPECT_MSG_EQ (h1.GetBinCount (17), 1, "");
+    NS_TEST_EXPECT_MSG_EQ_TOL (h1.GetBinStart (0), 0, 1e-12, "");
+    NS_TEST_EXPECT_MSG_EQ_TOL (h1.GetBinStart (1), 0.001, 1e-12, "");
+    NS_TEST_EXPECT_MSG_EQ_TOL (h1.GetBinEnd (10), 0.01, 1e-12, "");
+    NS_TEST_EXPECT_MSG_EQ_TOL (h1.GetBinWidth (11), 0.01 * (std::pow (10, 0.1) - 1), 1e-12, "");
+  }
+
+  {
+    // Testing the bound on the number of bins
+    h1.AddValue (1e9);
+    NS_TEST_EXPECT_MSG_EQ (h1.GetNBins (), 32, "");
+    NS_TEST_EXPECT_MSG_EQ (h1.GetBinCount (31), 1, "");
+  }
 }
 
 /**
@@ -71,5 +71,31 @@ Ipv4GlobalRoutingHelper::RecomputeRoutingTables (void)
   GlobalRouteManager::InitializeRoutes ();
 }
 
+void
+Ipv4GlobalRoutingHelper::SetIncrementalUpdates (bool enable)
+{
+  GlobalRouteManager::SetIncremental (enable);
+}
+
+void
+Ipv4GlobalRoutingHelper::UpdateRoutingTables (NodeContainer nodes)
+{
+  GlobalRouteManager::UpdateRoutes (nodes);
+}
+
+void
+Ipv4GlobalRoutingHelper::SetInterfaceUp (Ptr<Node> node, uint32_t interface)
+{
+  node->GetObject<Ipv4> ()->SetUp (interface);
+  GlobalRouteManager::UpdateRoutes (NodeContainer (node));
+}
+
+void
+Ipv4GlobalRoutingHelper::SetInterfaceDown (Ptr<Node> node, uint32_t interface)
+{
+  node->GetObject<Ipv4> ()->SetDown (interface);
+  GlobalRouteManager::UpdateRoutes (NodeContainer (node));
+}
+
 
 } // namespace ns3
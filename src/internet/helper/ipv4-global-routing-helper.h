@@ -84,6 +84,44 @@ public:
    *
    */
   static void RecomputeRoutingTables (void);
+
+  /**
+   * \brief Keep the shortest path tree of every router, so that
+   * UpdateRoutingTables only recomputes the routers a change affects.
+   *
+   * Must be called before PopulateRoutingTables().  Costs one tree per
+   * router in memory.
+   *
+   * \param enable true to keep the trees
+   */
+  static void SetIncrementalUpdates (bool enable);
+
+  /**
+   * \brief Update the routing tables after interfaces of some nodes went
+   * up or down.
+   *
+   * Without SetIncrementalUpdates (true), or when the change involves a
+   * broadcast network, this is the same as RecomputeRoutingTables().
+   *
+   * \param nodes the nodes whose interfaces changed state
+   */
+  static void UpdateRoutingTables (NodeContainer nodes);
+
+  /**
+   * \brief Bring an interface up and update the routing tables.
+   *
+   * \param node the node
+   * \param interface the Ipv4 interface index
+   */
+  static void SetInterfaceUp (Ptr<Node> node, uint32_t interface);
+
+  /**
+   * \brief Take an interface down and update the routing tables.
+   *
+   * \param node the node
+   * \param interface the Ipv4 interface index
+   */
+  static void SetInterfaceDown (Ptr<Node> node, uint32_t interface);
 private:
   /**
    * \brief Assignment operator declared private and not implemented to disallow
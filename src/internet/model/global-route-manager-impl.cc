@@ -22,12 +22,14 @@
  * of the quagga 0.99.7/src/ospfd/ospf_spf.c code which was ported here
  */
 
+#include <set>
 #include <utility>
 #include <vector>
 #include <queue>
 #include <algorithm>
 #include <iostream>
 #include "ns3/assert.h"
+#include "ns3/channel.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
 #include "ns3/node-list.h"
@@ -35,6 +37,7 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/mpi-interface.h"
+#include "ns3/net-device.h"
 #include "global-router-interface.h"
 #include "global-route-manager-impl.h"
 #include "candidate-queue.h"
@@ -495,13 +498,10 @@ GlobalRouteManagerLSDB::GetLSA (Ipv4Address addr) const
 //
 // Look up an LSA by its address.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  LSDBMap_t::const_iterator i = m_database.find (addr);
+  if (i != m_database.end ())
     {
-      if (i->first == addr)
-        {
-          return i->second;
-        }
+      return i->second;
     }
   return 0;
 }
@@ -539,7 +539,8 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 
 GlobalRouteManagerImpl::GlobalRouteManagerImpl () 
   :
-    m_spfroot (0)
+    m_spfroot (0),
+    m_incremental (false)
 {
   NS_LOG_FUNCTION (this);
   m_lsdb = new GlobalRouteManagerLSDB ();
@@ -548,6 +549,7 @@ GlobalRouteManagerImpl::GlobalRouteManagerImpl ()
 GlobalRouteManagerImpl::~GlobalRouteManagerImpl ()
 {
   NS_LOG_FUNCTION (this);
+  ClearSPFTrees ();
   if (m_lsdb)
     {
       delete m_lsdb;
@@ -569,6 +571,7 @@ void
 GlobalRouteManagerImpl::DeleteGlobalRoutes ()
 {
   NS_LOG_FUNCTION (this);
+  ClearSPFTrees ();
   NodeList::Iterator listEnd = NodeList::End ();
   for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
     {
@@ -711,9 +714,8 @@ GlobalRouteManagerImpl::InitializeRoutes ()
       Ptr<GlobalRouter> rtr = 
         node->GetObject<GlobalRouter> ();
 
-      uint32_t systemId = MpiInterface::GetSystemId ();
-      // Ignore nodes that are not assigned to our systemId (distributed sim)
-      if (node->GetSystemId () != systemId) 
+      // Ignore nodes that are not simulated by this process (distributed sim)
+      if (!MpiInterface::IsLocal (node->GetSystemId ()))
         {
           continue;
         }
@@ -1250,6 +1252,559 @@ GlobalRouteManagerImpl::DebugSPFCalculate (Ipv4Address root)
   SPFCalculate (root);
 }
 
+void
+GlobalRouteManagerImpl::SetIncremental (bool enable)
+{
+  NS_LOG_FUNCTION (this << enable);
+  m_incremental = enable;
+  if (!m_incremental)
+    {
+      ClearSPFTrees ();
+    }
+}
+
+void
+GlobalRouteManagerImpl::ClearSPFTrees (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (SPFTrees_t::iterator i = m_spfTrees.begin (); i != m_spfTrees.end (); i++)
+    {
+      delete i->second.root;
+    }
+  m_spfTrees.clear ();
+}
+
+void
+GlobalRouteManagerImpl::KeepSPFTree (Ipv4Address root)
+{
+  NS_LOG_FUNCTION (this << root);
+  SPFTrees_t::iterator i = m_spfTrees.find (root);
+  if (i != m_spfTrees.end ())
+    {
+      delete i->second.root;
+      m_spfTrees.erase (i);
+    }
+  SPFTree &tree = m_spfTrees[root];
+  tree.root = m_spfroot;
+//
+// Index the vertices.  A vertex with equal cost parents is a child of each
+// of them, so it is only visited once.
+//
+  std::vector<SPFVertex *> stack;
+  if (m_spfroot)
+    {
+      stack.push_back (m_spfroot);
+    }
+  while (!stack.empty ())
+    {
+      SPFVertex *v = stack.back ();
+      stack.pop_back ();
+      if (!tree.vertices.insert (std::make_pair (v->GetVertexId (), v)).second)
+        {
+          continue;
+        }
+      for (uint32_t i = 0; i < v->GetNChildren (); i++)
+        {
+          stack.push_back (v->GetChild (i));
+        }
+    }
+}
+
+void
+GlobalRouteManagerImpl::RecalculateRoutes (Ipv4Address root)
+{
+  NS_LOG_FUNCTION (this << root);
+  SPFTrees_t::iterator i = m_spfTrees.find (root);
+  if (i != m_spfTrees.end ())
+    {
+      delete i->second.root;
+      m_spfTrees.erase (i);
+    }
+  GlobalRoutingLSA *lsa = m_lsdb->GetLSA (root);
+  NS_ASSERT_MSG (lsa, "GlobalRouteManagerImpl::RecalculateRoutes (): no LSA for router " << root);
+  Ptr<Ipv4GlobalRouting> gr = lsa->GetNode ()->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+  while (gr->GetNRoutes () > 0)
+    {
+      gr->RemoveRoute (0);
+    }
+  SPFCalculate (root);
+}
+
+void
+GlobalRouteManagerImpl::AddRoutesVia (Ptr<Ipv4GlobalRouting> gr, SPFVertex *v, Ipv4Address dest,
+                                      Ipv4Mask mask, bool host)
+{
+  NS_LOG_FUNCTION (this << gr << v << dest << mask << host);
+  for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+    {
+      SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+      if (exit.second < 0)
+        {
+          continue;
+        }
+      if (host)
+        {
+          gr->AddHostRouteTo (dest, exit.first, exit.second);
+        }
+      else
+        {
+          gr->AddNetworkRouteTo (dest, mask, exit.first, exit.second);
+        }
+    }
+}
+
+namespace {
+
+/// Link records a router stopped and started advertising
+struct LinkChange
+{
+  std::vector<GlobalRoutingLinkRecord> removed; //!< records no longer advertised
+  std::vector<GlobalRoutingLinkRecord> added;   //!< records newly advertised
+};
+
+/// Destination of a stub network record (network, mask)
+typedef std::pair<uint32_t, uint32_t> StubKey;
+
+/**
+ * \param l a stub network record
+ * \return the destination of the record
+ */
+StubKey
+GetStubKey (const GlobalRoutingLinkRecord &l)
+{
+  Ipv4Mask mask (l.GetLinkData ().Get ());
+  return StubKey (l.GetLinkId ().CombineMask (mask).Get (), mask.Get ());
+}
+
+/**
+ * \param a a link record
+ * \param b another link record
+ * \return true if the records describe the same link
+ */
+bool
+SameLinkRecord (const GlobalRoutingLinkRecord *a, const GlobalRoutingLinkRecord *b)
+{
+  return a->GetLinkType () == b->GetLinkType ()
+         && a->GetLinkId () == b->GetLinkId ()
+         && a->GetLinkData () == b->GetLinkData ()
+         && a->GetMetric () == b->GetMetric ();
+}
+
+/**
+ * \brief Collect the link records of an LSA that another LSA does not have
+ * \param lsa the LSA
+ * \param other the LSA to compare with, 0 for none
+ * \param records where to append the records
+ */
+void
+DiffLinkRecords (const GlobalRoutingLSA *lsa, const GlobalRoutingLSA *other,
+                 std::vector<GlobalRoutingLinkRecord> &records)
+{
+  uint32_t nOther = other ? other->GetNLinkRecords () : 0;
+  std::vector<bool> matched (nOther, false);
+  for (uint32_t i = 0; i < lsa->GetNLinkRecords (); i++)
+    {
+      GlobalRoutingLinkRecord *l = lsa->GetLinkRecord (i);
+      bool found = false;
+      for (uint32_t j = 0; j < nOther && !found; j++)
+        {
+          if (!matched[j] && SameLinkRecord (l, other->GetLinkRecord (j)))
+            {
+              matched[j] = found = true;
+            }
+        }
+      if (!found)
+        {
+          records.push_back (*l);
+        }
+    }
+}
+
+/**
+ * \param records link records
+ * \return true if one of the records is a link to a transit network
+ */
+bool
+HasTransitRecord (const std::vector<GlobalRoutingLinkRecord> &records)
+{
+  for (std::size_t i = 0; i < records.size (); i++)
+    {
+      if (records[i].GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+/**
+ * \param a a network LSA
+ * \param b another network LSA
+ * \return true if the LSAs describe the same network
+ */
+bool
+SameNetworkLSA (const GlobalRoutingLSA *a, const GlobalRoutingLSA *b)
+{
+  if (a->GetNetworkLSANetworkMask () != b->GetNetworkLSANetworkMask ()
+      || a->GetNAttachedRouters () != b->GetNAttachedRouters ())
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < a->GetNAttachedRouters (); i++)
+    {
+      if (a->GetAttachedRouter (i) != b->GetAttachedRouter (i))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+/**
+ * \param v a vertex
+ * \param parent another vertex
+ * \return true if parent is one of the parents of v
+ */
+bool
+HasParent (const SPFVertex *v, const SPFVertex *parent)
+{
+  for (uint32_t i = 0; v->GetParent (i) != 0; i++)
+    {
+      if (v->GetParent (i) == parent)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+} // anonymous namespace
+
+//
+// Incremental counterpart of DeleteGlobalRoutes, BuildGlobalRoutingDatabase
+// and InitializeRoutes, for links going up and down at run time.
+//
+// The trees of the routers are kept by SPFCalculate.  A tree stays a valid
+// shortest path tree as long as none of its edges disappeared or got more
+// expensive, and no new edge gives a path shorter than, or as short as, the
+// one the tree has to a vertex.  Such a router only needs its routes to the
+// addresses of the changed links rewritten, and new leaves grafted on its
+// tree when a router became reachable through a single new edge.  The other
+// routers run SPF again.
+//
+void
+GlobalRouteManagerImpl::UpdateRoutes (NodeContainer nodes)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_incremental || m_spfTrees.empty ())
+    {
+      NS_LOG_LOGIC ("No SPF trees kept, rebuilding all the routes");
+      DeleteGlobalRoutes ();
+      BuildGlobalRoutingDatabase ();
+      InitializeRoutes ();
+      return;
+    }
+//
+// A link going up or down changes the LSAs of the routers at both of its
+// ends, so the neighbors of the nodes are discovered again too.
+//
+  std::set<uint32_t> nodeIds;
+  for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); i++)
+    {
+      nodeIds.insert ((*i)->GetId ());
+      for (uint32_t j = 0; j < (*i)->GetNDevices (); j++)
+        {
+          Ptr<Channel> channel = (*i)->GetDevice (j)->GetChannel ();
+          if (channel == 0)
+            {
+              continue;
+            }
+          for (std::size_t k = 0; k < channel->GetNDevices (); k++)
+            {
+              nodeIds.insert (channel->GetDevice (k)->GetNode ()->GetId ());
+            }
+        }
+    }
+//
+// Update the LSDB in place, the kept trees point to its LSAs.
+//
+  std::map<Ipv4Address, LinkChange> changes;
+  bool rebuild = false;
+  for (std::set<uint32_t>::const_iterator i = nodeIds.begin (); i != nodeIds.end () && !rebuild; i++)
+    {
+      Ptr<GlobalRouter> rtr = NodeList::GetNode (*i)->GetObject<GlobalRouter> ();
+      if (!rtr)
+        {
+          continue;
+        }
+      uint32_t numLSAs = rtr->DiscoverLSAs ();
+      for (uint32_t j = 0; j < numLSAs && !rebuild; j++)
+        {
+          GlobalRoutingLSA lsa;
+          rtr->GetLSA (j, lsa);
+          GlobalRoutingLSA *old = m_lsdb->GetLSA (lsa.GetLinkStateId ());
+          if (lsa.GetLSType () == GlobalRoutingLSA::RouterLSA)
+            {
+              LinkChange change;
+              DiffLinkRecords (&lsa, old, change.added);
+              if (old)
+                {
+                  DiffLinkRecords (old, &lsa, change.removed);
+                  *old = lsa;
+                }
+              else
+                {
+                  m_lsdb->Insert (lsa.GetLinkStateId (), new GlobalRoutingLSA (lsa));
+                }
+              rebuild = HasTransitRecord (change.removed) || HasTransitRecord (change.added);
+              if (!change.removed.empty () || !change.added.empty ())
+                {
+                  changes[lsa.GetLinkStateId ()] = change;
+                }
+            }
+          else if (lsa.GetLSType () == GlobalRoutingLSA::NetworkLSA)
+            {
+              rebuild = !old || !SameNetworkLSA (old, &lsa);
+            }
+          else
+            {
+              rebuild = true;
+            }
+        }
+    }
+  if (rebuild)
+    {
+      NS_LOG_LOGIC ("Transit network or external route changed, rebuilding all the routes");
+      DeleteGlobalRoutes ();
+      BuildGlobalRoutingDatabase ();
+      InitializeRoutes ();
+      return;
+    }
+  if (changes.empty ())
+    {
+      return;
+    }
+//
+// Advertisers of every host and stub destination, in the order SPF finds them.
+//
+  std::map<uint32_t, std::vector<Ipv4Address> > hostAdvertisers;
+  std::map<StubKey, std::vector<Ipv4Address> > stubAdvertisers;
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); i++)
+    {
+      Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter> ();
+      GlobalRoutingLSA *lsa = rtr ? m_lsdb->GetLSA (rtr->GetRouterId ()) : 0;
+      if (!lsa)
+        {
+          continue;
+        }
+      for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *l = lsa->GetLinkRecord (j);
+          if (l->GetLinkType () == GlobalRoutingLinkRecord::PointToPoint)
+            {
+              hostAdvertisers[l->GetLinkData ().Get ()].push_back (rtr->GetRouterId ());
+            }
+          else if (l->GetLinkType () == GlobalRoutingLinkRecord::StubNetwork)
+            {
+              stubAdvertisers[GetStubKey (*l)].push_back (rtr->GetRouterId ());
+            }
+        }
+    }
+
+  std::set<Ipv4Address> recalculate;
+  for (std::map<Ipv4Address, LinkChange>::const_iterator c = changes.begin (); c != changes.end (); c++)
+    {
+      if (MpiInterface::IsLocal (m_lsdb->GetLSA (c->first)->GetNode ()->GetSystemId ()))
+        {
+          recalculate.insert (c->first);
+        }
+    }
+
+  for (SPFTrees_t::iterator t = m_spfTrees.begin (); t != m_spfTrees.end (); t++)
+    {
+      Ipv4Address root = t->first;
+      SPFTree &tree = t->second;
+      if (recalculate.count (root))
+        {
+          continue;
+        }
+      bool affected = false;
+      std::map<Ipv4Address, std::pair<SPFVertex *, uint32_t> > grafts;
+      for (std::map<Ipv4Address, LinkChange>::const_iterator c = changes.begin (); c != changes.end () && !affected; c++)
+        {
+          // a stub router only has a default route through its neighbor
+          if (tree.root == 0)
+            {
+              for (std::size_t k = 0; k < c->second.removed.size () + c->second.added.size (); k++)
+                {
+                  const GlobalRoutingLinkRecord &l = k < c->second.removed.size () ?
+                    c->second.removed[k] : c->second.added[k - c->second.removed.size ()];
+                  affected |= l.GetLinkType () == GlobalRoutingLinkRecord::PointToPoint
+                    && l.GetLinkId () == root;
+                }
+              continue;
+            }
+          std::map<Ipv4Address, SPFVertex *>::const_iterator u = tree.vertices.find (c->first);
+          if (u == tree.vertices.end ())
+            {
+              continue;
+            }
+          for (std::size_t k = 0; k < c->second.removed.size () && !affected; k++)
+            {
+              const GlobalRoutingLinkRecord &l = c->second.removed[k];
+              if (l.GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
+                {
+                  continue;
+                }
+              std::map<Ipv4Address, SPFVertex *>::const_iterator w = tree.vertices.find (l.GetLinkId ());
+              affected = w != tree.vertices.end () && HasParent (w->second, u->second);
+            }
+          for (std::size_t k = 0; k < c->second.added.size () && !affected; k++)
+            {
+              const GlobalRoutingLinkRecord &l = c->second.added[k];
+              if (l.GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
+                {
+                  continue;
+                }
+              uint32_t distance = u->second->GetDistanceFromRoot () + l.GetMetric ();
+              std::map<Ipv4Address, SPFVertex *>::const_iterator w = tree.vertices.find (l.GetLinkId ());
+              if (w != tree.vertices.end ())
+                {
+                  affected = distance <= w->second->GetDistanceFromRoot ();
+                  continue;
+                }
+              // the router was not reachable, it may become a new leaf
+              std::map<Ipv4Address, std::pair<SPFVertex *, uint32_t> >::iterator g = grafts.find (l.GetLinkId ());
+              if (g == grafts.end () || distance < g->second.second)
+                {
+                  grafts[l.GetLinkId ()] = std::make_pair (u->second, distance);
+                }
+              else
+                {
+                  affected = distance == g->second.second;
+                }
+            }
+        }
+//
+// A new leaf must be a router whose other links all lead to vertices of
+// the tree that it does not bring closer to the root.
+//
+      for (std::map<Ipv4Address, std::pair<SPFVertex *, uint32_t> >::const_iterator g = grafts.begin ();
+           g != grafts.end () && !affected; g++)
+        {
+          GlobalRoutingLSA *lsa = m_lsdb->GetLSA (g->first);
+          affected = !lsa || lsa->GetLSType () != GlobalRoutingLSA::RouterLSA;
+          for (uint32_t j = 0; !affected && j < lsa->GetNLinkRecords (); j++)
+            {
+              GlobalRoutingLinkRecord *l = lsa->GetLinkRecord (j);
+              if (l->GetLinkType () == GlobalRoutingLinkRecord::StubNetwork)
+                {
+                  continue;
+                }
+              std::map<Ipv4Address, SPFVertex *>::const_iterator y = tree.vertices.find (l->GetLinkId ());
+              affected = l->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint
+                || y == tree.vertices.end ()
+                || g->second.second + l->GetMetric () <= y->second->GetDistanceFromRoot ();
+            }
+        }
+      if (affected)
+        {
+          recalculate.insert (root);
+          continue;
+        }
+      if (tree.root == 0)
+        {
+          continue;
+        }
+      NS_LOG_LOGIC ("Patching the routes of router " << root);
+//
+// Collect the destinations whose routes may have changed, then install
+// the routes of their advertisers again, as SPF would.
+//
+      std::set<uint32_t> hosts;
+      std::set<StubKey> stubs;
+      for (std::map<Ipv4Address, LinkChange>::const_iterator c = changes.begin (); c != changes.end (); c++)
+        {
+          if (tree.vertices.find (c->first) == tree.vertices.end ())
+            {
+              continue;
+            }
+          for (std::size_t k = 0; k < c->second.removed.size () + c->second.added.size (); k++)
+            {
+              const GlobalRoutingLinkRecord &l = k < c->second.removed.size () ?
+                c->second.removed[k] : c->second.added[k - c->second.removed.size ()];
+              if (l.GetLinkType () == GlobalRoutingLinkRecord::PointToPoint)
+                {
+                  hosts.insert (l.GetLinkData ().Get ());
+                }
+              else if (l.GetLinkType () == GlobalRoutingLinkRecord::StubNetwork)
+                {
+                  stubs.insert (GetStubKey (l));
+                }
+            }
+        }
+      for (std::map<Ipv4Address, std::pair<SPFVertex *, uint32_t> >::const_iterator g = grafts.begin ();
+           g != grafts.end (); g++)
+        {
+          GlobalRoutingLSA *lsa = m_lsdb->GetLSA (g->first);
+          SPFVertex *w = new SPFVertex (lsa);
+          w->SetDistanceFromRoot (g->second.second);
+          w->SetParent (g->second.first);
+          w->InheritAllRootExitDirections (g->second.first);
+          SPFVertexAddParent (w);
+          tree.vertices[g->first] = w;
+          for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+            {
+              GlobalRoutingLinkRecord *l = lsa->GetLinkRecord (j);
+              if (l->GetLinkType () == GlobalRoutingLinkRecord::PointToPoint)
+                {
+                  hosts.insert (l->GetLinkData ().Get ());
+                }
+              else if (l->GetLinkType () == GlobalRoutingLinkRecord::StubNetwork)
+                {
+                  stubs.insert (GetStubKey (*l));
+                }
+            }
+        }
+
+      Ptr<Ipv4GlobalRouting> gr = tree.root->GetLSA ()->GetNode ()->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      for (std::set<uint32_t>::const_iterator h = hosts.begin (); h != hosts.end (); h++)
+        {
+          gr->RemoveHostRoutesTo (Ipv4Address (*h));
+          const std::vector<Ipv4Address> &advertisers = hostAdvertisers[*h];
+          for (std::size_t k = 0; k < advertisers.size (); k++)
+            {
+              std::map<Ipv4Address, SPFVertex *>::const_iterator v = tree.vertices.find (advertisers[k]);
+              if (v != tree.vertices.end () && v->second != tree.root)
+                {
+                  AddRoutesVia (gr, v->second, Ipv4Address (*h), Ipv4Mask::GetOnes (), true);
+                }
+            }
+        }
+      for (std::set<StubKey>::const_iterator s = stubs.begin (); s != stubs.end (); s++)
+        {
+          Ipv4Address network (s->first);
+          Ipv4Mask mask (s->second);
+          gr->RemoveNetworkRoutesTo (network, mask);
+          const std::vector<Ipv4Address> &advertisers = stubAdvertisers[*s];
+          for (std::size_t k = 0; k < advertisers.size (); k++)
+            {
+              std::map<Ipv4Address, SPFVertex *>::const_iterator v = tree.vertices.find (advertisers[k]);
+              if (v != tree.vertices.end () && v->second != tree.root)
+                {
+                  AddRoutesVia (gr, v->second, network, mask, false);
+                }
+            }
+        }
+    }
+
+  NS_LOG_LOGIC ("Running SPF again for " << recalculate.size () << " of " << m_spfTrees.size () << " routers");
+  for (std::set<Ipv4Address>::const_iterator r = recalculate.begin (); r != recalculate.end (); r++)
+    {
+      RecalculateRoutes (*r);
+    }
+}
+
 //
 // Used to test if a node is a stub, from an OSPF sense.
 // If there is only one link of type 1 or 2, then a default route
@@ -1381,6 +1936,11 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
     {
       NS_LOG_LOGIC ("SPFCalculate truncated for stub node " << root);
       delete m_spfroot;
+      m_spfroot = 0;
+      if (m_incremental)
+        {
+          KeepSPFTree (root);
+        }
       return;
     }
 
@@ -1498,9 +2058,17 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 //
 // We're all done setting the routing information for the node at the root of
 // the SPF tree.  Delete all of the vertices and corresponding resources.  Go
-// possibly do it again for the next router.
+// possibly do it again for the next router.  In incremental mode the tree
+// is kept for UpdateRoutes instead.
 //
-  delete m_spfroot;
+  if (m_incremental)
+    {
+      KeepSPFTree (root);
+    }
+  else
+    {
+      delete m_spfroot;
+    }
   m_spfroot = 0;
 }
 
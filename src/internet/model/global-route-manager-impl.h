@@ -30,6 +30,7 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/ipv4-address.h"
+#include "ns3/node-container.h"
 #include "global-router-interface.h"
 
 namespace ns3 {
@@ -746,6 +747,32 @@ public:
  */
   void DebugSPFCalculate (Ipv4Address root);
 
+/**
+ * @brief Keep the shortest path trees computed by InitializeRoutes, so
+ * that UpdateRoutes can patch the forwarding tables after a link change.
+ *
+ * This costs one SPF tree per router in memory, and must be enabled
+ * before the routes are first computed.
+ *
+ * @param enable true to keep the trees
+ */
+  void SetIncremental (bool enable);
+
+/**
+ * @brief Update the routes after links of some nodes went up or down
+ *
+ * The LSAs of the nodes and of their neighbors are discovered again and
+ * compared with the LSDB.  Only the routers whose shortest path tree
+ * uses a removed adjacency, or could be shortened by an added one, run
+ * SPF again.  The others keep their tree and only get their routes to
+ * the changed links rewritten.  Changes of transit networks or external
+ * routes, or an update while the trees are not kept, fall back to a
+ * full rebuild.
+ *
+ * @param nodes the nodes whose interfaces changed state
+ */
+  void UpdateRoutes (NodeContainer nodes);
+
 private:
 /**
  * @brief GlobalRouteManagerImpl copy construction is disallowed.
@@ -769,6 +796,50 @@ private:
   SPFVertex* m_spfroot; //!< the root node
   GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
 
+  /// Shortest path tree of a router, kept for incremental updates
+  struct SPFTree
+  {
+    SPFVertex *root;                             //!< tree root, 0 for a stub router
+    std::map<Ipv4Address, SPFVertex *> vertices; //!< vertices of the tree by vertex ID
+  };
+  /// SPF trees by router ID of their root
+  typedef std::map<Ipv4Address, SPFTree> SPFTrees_t;
+
+  bool m_incremental;      //!< keep the SPF trees after InitializeRoutes
+  SPFTrees_t m_spfTrees;   //!< the kept SPF trees
+
+  /**
+   * \brief Delete the kept SPF trees
+   */
+  void ClearSPFTrees (void);
+
+  /**
+   * \brief Store the tree rooted at m_spfroot in m_spfTrees
+   * \param root the router ID of the root
+   */
+  void KeepSPFTree (Ipv4Address root);
+
+  /**
+   * \brief Remove all the routes of a router and run SPF again for it
+   * \param root the router ID
+   */
+  void RecalculateRoutes (Ipv4Address root);
+
+  /**
+   * \brief Add the routes to a destination advertised by a vertex of a tree
+   *
+   * The routes use the root exit directions of the vertex, as
+   * SPFIntraAddRouter and SPFIntraAddStub do.
+   *
+   * \param gr the routing protocol of the tree root
+   * \param v the advertising vertex
+   * \param dest the destination
+   * \param mask the destination mask, for a network route
+   * \param host true for a host route
+   */
+  void AddRoutesVia (Ptr<Ipv4GlobalRouting> gr, SPFVertex *v, Ipv4Address dest,
+                     Ipv4Mask mask, bool host);
+
   /**
    * \brief Test if a node is a stub, from an OSPF sense.
    *
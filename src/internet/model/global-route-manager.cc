@@ -58,6 +58,22 @@ GlobalRouteManager::InitializeRoutes (void)
   InitializeRoutes ();
 }
 
+void
+GlobalRouteManager::SetIncremental (bool enable)
+{
+  NS_LOG_FUNCTION (enable);
+  SimulationSingleton<GlobalRouteManagerImpl>::Get ()->
+  SetIncremental (enable);
+}
+
+void
+GlobalRouteManager::UpdateRoutes (NodeContainer nodes)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  SimulationSingleton<GlobalRouteManagerImpl>::Get ()->
+  UpdateRoutes (nodes);
+}
+
 uint32_t
 GlobalRouteManager::AllocateRouterId (void)
 {
@@ -22,6 +22,8 @@
 #ifndef GLOBAL_ROUTE_MANAGER_H
 #define GLOBAL_ROUTE_MANAGER_H
 
+#include "ns3/node-container.h"
+
 namespace ns3 {
 
 /**
@@ -65,6 +67,20 @@ public:
  */
   static void InitializeRoutes ();
 
+/**
+ * @brief Keep the shortest path trees of the routers, so that
+ * UpdateRoutes does not need to recompute all of them.  Must be called
+ * before the routes are first computed.
+ * @param enable true to keep the trees
+ */
+  static void SetIncremental (bool enable);
+
+/**
+ * @brief Update the routes after interfaces of some nodes went up or down
+ * @param nodes the nodes whose interfaces changed state
+ */
+  static void UpdateRoutes (NodeContainer nodes);
+
 private:
 /**
  * @brief Global Route Manager copy construction is disallowed.  There's no 
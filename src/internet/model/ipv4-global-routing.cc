@@ -59,7 +59,8 @@ Ipv4GlobalRouting::GetTypeId (void)
 
 Ipv4GlobalRouting::Ipv4GlobalRouting () 
   : m_randomEcmpRouting (false),
-    m_respondToInterfaceEvents (false)
+    m_respondToInterfaceEvents (false),
+    m_lookupValid (true)
 {
   NS_LOG_FUNCTION (this);
 
@@ -80,6 +81,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
   m_hostRoutes.push_back (route);
+  m_lookupValid = false;
 }
 
 void 
@@ -90,6 +92,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
   m_hostRoutes.push_back (route);
+  m_lookupValid = false;
 }
 
 void 
@@ -105,6 +108,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_lookupValid = false;
 }
 
 void 
@@ -118,6 +122,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_lookupValid = false;
 }
 
 void 
@@ -133,6 +138,7 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_ASexternalRoutes.push_back (route);
+  m_lookupValid = false;
 }
 
 
@@ -146,14 +152,20 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
   typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
   RouteVec_t allRoutes;
 
+  if (!m_lookupValid)
+    {
+      RebuildLookup ();
+    }
+
   NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
-  for (HostRoutesCI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
-       i++) 
+  HostIndex::const_iterator host = m_hostIndex.find (dest.Get ());
+  if (host != m_hostIndex.end ())
     {
-      NS_ASSERT ((*i)->IsHost ());
-      if ((*i)->GetDest ().IsEqual (dest)) 
+      for (std::vector<Ipv4RoutingTableEntry *>::const_iterator i = host->second.begin ();
+           i != host->second.end ();
+           i++)
         {
+          NS_ASSERT ((*i)->IsHost ());
           if (oif != 0)
             {
               if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
@@ -169,13 +181,14 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
   if (allRoutes.size () == 0) // if no host route is found
     {
       NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
-      for (NetworkRoutesI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end (); 
-           j++) 
+      // all the routes of the longest matching prefix usable on oif
+      const Ipv4RouteTrie::Routes *matches[33];
+      uint32_t nMatches = m_networkTrie.Lookup (dest, matches);
+      for (uint32_t m = nMatches; m > 0 && allRoutes.size () == 0; m--)
         {
-          Ipv4Mask mask = (*j)->GetDestNetworkMask ();
-          Ipv4Address entry = (*j)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry)) 
+          for (Ipv4RouteTrie::Routes::const_iterator j = matches[m - 1]->begin ();
+               j != matches[m - 1]->end ();
+               j++)
             {
               if (oif != 0)
                 {
@@ -192,13 +205,14 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
     }
   if (allRoutes.size () == 0)  // consider external if no host/network found
     {
-      for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
-           k != m_ASexternalRoutes.end ();
-           k++)
+      // the first route of the longest matching prefix usable on oif
+      const Ipv4RouteTrie::Routes *matches[33];
+      uint32_t nMatches = m_ASexternalTrie.Lookup (dest, matches);
+      for (uint32_t m = nMatches; m > 0 && allRoutes.size () == 0; m--)
         {
-          Ipv4Mask mask = (*k)->GetDestNetworkMask ();
-          Ipv4Address entry = (*k)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry))
+          for (Ipv4RouteTrie::Routes::const_iterator k = matches[m - 1]->begin ();
+               k != matches[m - 1]->end ();
+               k++)
             {
               NS_LOG_LOGIC ("Found external route" << *k);
               if (oif != 0)
@@ -245,6 +259,28 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
     }
 }
 
+void
+Ipv4GlobalRouting::RebuildLookup (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_hostIndex.clear ();
+  for (HostRoutesCI i = m_hostRoutes.begin (); i != m_hostRoutes.end (); i++)
+    {
+      m_hostIndex[(*i)->GetDest ().Get ()].push_back (*i);
+    }
+  m_networkTrie.Clear ();
+  for (NetworkRoutesCI j = m_networkRoutes.begin (); j != m_networkRoutes.end (); j++)
+    {
+      m_networkTrie.Insert (*j);
+    }
+  m_ASexternalTrie.Clear ();
+  for (ASExternalRoutesCI k = m_ASexternalRoutes.begin (); k != m_ASexternalRoutes.end (); k++)
+    {
+      m_ASexternalTrie.Insert (*k);
+    }
+  m_lookupValid = true;
+}
+
 uint32_t 
 Ipv4GlobalRouting::GetNRoutes (void) const
 {
@@ -309,6 +345,7 @@ void
 Ipv4GlobalRouting::RemoveRoute (uint32_t index)
 {
   NS_LOG_FUNCTION (this << index);
+  m_lookupValid = false;
   if (index < m_hostRoutes.size ())
     {
       uint32_t tmp = 0;
@@ -362,6 +399,46 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
   NS_ASSERT (false);
 }
 
+void
+Ipv4GlobalRouting::RemoveHostRoutesTo (Ipv4Address dest)
+{
+  NS_LOG_FUNCTION (this << dest);
+  HostRoutesI i = m_hostRoutes.begin ();
+  while (i != m_hostRoutes.end ())
+    {
+      if ((*i)->GetDest () == dest)
+        {
+          delete *i;
+          i = m_hostRoutes.erase (i);
+          m_lookupValid = false;
+        }
+      else
+        {
+          i++;
+        }
+    }
+}
+
+void
+Ipv4GlobalRouting::RemoveNetworkRoutesTo (Ipv4Address network, Ipv4Mask networkMask)
+{
+  NS_LOG_FUNCTION (this << network << networkMask);
+  NetworkRoutesI j = m_networkRoutes.begin ();
+  while (j != m_networkRoutes.end ())
+    {
+      if ((*j)->GetDestNetwork () == network && (*j)->GetDestNetworkMask () == networkMask)
+        {
+          delete *j;
+          j = m_networkRoutes.erase (j);
+          m_lookupValid = false;
+        }
+      else
+        {
+          j++;
+        }
+    }
+}
+
 int64_t
 Ipv4GlobalRouting::AssignStreams (int64_t stream)
 {
@@ -392,6 +469,10 @@ Ipv4GlobalRouting::DoDispose (void)
     {
       delete (*l);
     }
+  m_hostIndex.clear ();
+  m_networkTrie.Clear ();
+  m_ASexternalTrie.Clear ();
+  m_lookupValid = true;
 
   Ipv4RoutingProtocol::DoDispose ();
 }
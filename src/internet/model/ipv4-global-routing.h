@@ -21,6 +21,8 @@
 #define IPV4_GLOBAL_ROUTING_H
 
 #include <list>
+#include <vector>
+#include <unordered_map>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
@@ -28,6 +30,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/ipv4-route-trie.h"
 
 namespace ns3 {
 
@@ -218,6 +221,25 @@ public:
    */
   void RemoveRoute (uint32_t i);
 
+  /**
+   * \brief Remove all the host routes to a destination.
+   *
+   * \param dest The Ipv4Address destination of the routes.
+   *
+   * \see Ipv4GlobalRouting::AddHostRouteTo
+   */
+  void RemoveHostRoutesTo (Ipv4Address dest);
+
+  /**
+   * \brief Remove all the network routes to a network.
+   *
+   * \param network The Ipv4Address network of the routes.
+   * \param networkMask The Ipv4Mask of the network.
+   *
+   * \see Ipv4GlobalRouting::AddNetworkRouteTo
+   */
+  void RemoveNetworkRoutesTo (Ipv4Address network, Ipv4Mask networkMask);
+
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model.  Return the number of streams (possibly zero) that
@@ -268,10 +290,26 @@ private:
    */
   Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
 
+  /**
+   * \brief Rebuild the lookup structures from the route lists.
+   *
+   * Called by LookupGlobal after the routes changed, so that a burst of
+   * route additions or removals costs a single rebuild.
+   */
+  void RebuildLookup (void);
+
   HostRoutes m_hostRoutes;             //!< Routes to hosts
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  /// host routes by destination address, in list order
+  typedef std::unordered_map<uint32_t, std::vector<Ipv4RoutingTableEntry *> > HostIndex;
+
+  HostIndex m_hostIndex;               //!< m_hostRoutes indexed for lookup
+  Ipv4RouteTrie m_networkTrie;         //!< m_networkRoutes indexed for longest prefix match
+  Ipv4RouteTrie m_ASexternalTrie;      //!< m_ASexternalRoutes indexed for longest prefix match
+  bool m_lookupValid;                  //!< the lookup structures match the route lists
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
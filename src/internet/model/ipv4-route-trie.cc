@@ -0,0 +1,94 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv4-route-trie.h"
+#include "ns3/ipv4-routing-table-entry.h"
+
+namespace ns3 {
+
+Ipv4RouteTrie::Ipv4RouteTrie ()
+{
+  Clear ();
+}
+
+void
+Ipv4RouteTrie::Clear (void)
+{
+  m_nodes.clear ();
+  m_nodes.push_back (Node ());
+  m_nodes[0].child[0] = 0;
+  m_nodes[0].child[1] = 0;
+  m_nRoutes = 0;
+}
+
+void
+Ipv4RouteTrie::Insert (Ipv4RoutingTableEntry *route)
+{
+  uint32_t prefix = route->GetDestNetwork ().Get ();
+  uint16_t length = route->GetDestNetworkMask ().GetPrefixLength ();
+
+  uint32_t node = 0;
+  for (uint16_t depth = 0; depth < length; depth++)
+    {
+      uint32_t bit = (prefix >> (31 - depth)) & 1;
+      if (m_nodes[node].child[bit] == 0)
+        {
+          Node child;
+          child.child[0] = 0;
+          child.child[1] = 0;
+          m_nodes.push_back (child);
+          // m_nodes may have moved, index it again
+          m_nodes[node].child[bit] = m_nodes.size () - 1;
+        }
+      node = m_nodes[node].child[bit];
+    }
+  m_nodes[node].routes.push_back (route);
+  m_nRoutes++;
+}
+
+uint32_t
+Ipv4RouteTrie::Lookup (Ipv4Address dest, const Routes *matches[33]) const
+{
+  uint32_t address = dest.Get ();
+  uint32_t n = 0;
+  uint32_t node = 0;
+  for (uint32_t depth = 0; ; depth++)
+    {
+      const Node &current = m_nodes[node];
+      if (!current.routes.empty ())
+        {
+          matches[n++] = &current.routes;
+        }
+      if (depth == 32)
+        {
+          break;
+        }
+      node = current.child[(address >> (31 - depth)) & 1];
+      if (node == 0)
+        {
+          break;
+        }
+    }
+  return n;
+}
+
+bool
+Ipv4RouteTrie::IsEmpty (void) const
+{
+  return m_nRoutes == 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef IPV4_ROUTE_TRIE_H
+#define IPV4_ROUTE_TRIE_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "ns3/ipv4-address.h"
+
+namespace ns3 {
+
+class Ipv4RoutingTableEntry;
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief Binary trie of IPv4 network routes, for longest prefix match.
+ *
+ * Every prefix is a trie node holding its routes in insertion order, so
+ * equal-cost routes to the same prefix stay together. A lookup walks at
+ * most 32 nodes, whatever the number of routes. The trie does not own the
+ * routes: it only indexes a routing table and must be cleared and refilled
+ * when that table changes.
+ */
+class Ipv4RouteTrie
+{
+public:
+  /// Routes of one prefix
+  typedef std::vector<Ipv4RoutingTableEntry *> Routes;
+
+  Ipv4RouteTrie ();
+
+  /**
+   * \brief Remove every route
+   */
+  void Clear (void);
+
+  /**
+   * \brief Index a network route under its destination network and mask
+   * \param route the route
+   */
+  void Insert (Ipv4RoutingTableEntry *route);
+
+  /**
+   * \brief Find the prefixes matching an address
+   * \param dest the address
+   * \param matches receives the routes of the matching prefixes, shortest prefix first
+   * \return the number of matching prefixes
+   */
+  uint32_t Lookup (Ipv4Address dest, const Routes *matches[33]) const;
+
+  /**
+   * \return true if the trie holds no route
+   */
+  bool IsEmpty (void) const;
+
+private:
+  /// A trie node, children are indexes in m_nodes (0 for none, the root is never a child)
+  struct Node
+  {
+    uint32_t child[2];  //!< children for bit 0 and bit 1
+    Routes routes;      //!< routes of the prefix ending here
+  };
+
+  std::vector<Node> m_nodes;  //!< m_nodes[0] is the root (prefix length 0)
+  uint32_t m_nRoutes;         //!< number of routes indexed
+};
+
+} // namespace ns3
+
+#endif /* IPV4_ROUTE_TRIE_H */
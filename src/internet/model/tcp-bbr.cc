@@ -0,0 +1,551 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-bbr.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpBbr");
+NS_OBJECT_ENSURE_REGISTERED (TcpBbr);
+
+/// Number of phases of the PROBE_BW gain cycle
+static const uint32_t GAIN_CYCLE_LENGTH = 8;
+/// Pacing gains of the PROBE_BW phases
+static const double PACING_GAIN_CYCLE[GAIN_CYCLE_LENGTH] = {
+  1.25, 0.75, 1, 1, 1, 1, 1, 1
+};
+/// cWnd gain in PROBE_BW, to absorb delayed and stretched ACKs
+static const double PROBE_BW_CWND_GAIN = 2.0;
+/// Growth of the bandwidth, over a round, which means the pipe is not full yet
+static const double FULL_BW_THRESHOLD = 1.25;
+/// Rounds without growth after which the pipe is full
+static const uint32_t FULL_BW_COUNT = 3;
+
+const char* const
+TcpBbr::BbrModeName[BBR_PROBE_RTT + 1] =
+{
+  "BBR_STARTUP", "BBR_DRAIN", "BBR_PROBE_BW", "BBR_PROBE_RTT"
+};
+
+TypeId
+TcpBbr::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpBbr")
+    .SetParent<TcpCongestionOps> ()
+    .AddConstructor<TcpBbr> ()
+    .SetGroupName ("Internet")
+    .AddAttribute ("HighGain", "Pacing and cWnd gain of STARTUP (2/ln2)",
+                   DoubleValue (2.885),
+                   MakeDoubleAccessor (&TcpBbr::m_highGain),
+                   MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("BwWindowLength", "Length of the windowed max filter "
+                   "of the bandwidth, in rounds",
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&TcpBbr::m_bwWindowLength),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("RttWindowLength", "Length of the windowed min filter "
+                   "of the RTT",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&TcpBbr::m_rttWindowLength),
+                   MakeTimeChecker ())
+    .AddAttribute ("ProbeRttDuration", "Time to keep the minimum window "
+                   "in flight in PROBE_RTT",
+                   TimeValue (MilliSeconds (200)),
+                   MakeTimeAccessor (&TcpBbr::m_probeRttDuration),
+                   MakeTimeChecker ())
+    .AddAttribute ("MinCwnd", "Window in PROBE_RTT, and minimum window (segments)",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&TcpBbr::m_minCwndSegments),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+TcpBbr::TcpBbr ()
+  : TcpCongestionOps (),
+    m_state (BBR_STARTUP),
+    m_pacingGain (2.885),
+    m_cWndGain (2.885),
+    m_minRtt (Time::Max ()),
+    m_minRttStamp (Seconds (0)),
+    m_delivered (0),
+    m_roundCount (0),
+    m_roundStart (false),
+    m_nextRoundSeq (0),
+    m_roundDelivered (0),
+    m_roundStartStamp (Seconds (0)),
+    m_fullBwReached (false),
+    m_fullBw (0),
+    m_fullBwCount (0),
+    m_cycleIndex (0),
+    m_cycleStamp (Seconds (0)),
+    m_probeRttDoneStamp (Seconds (0)),
+    m_probeRttRoundDone (false),
+    m_priorCwnd (0),
+    m_idleRestart (false),
+    m_lossInPhase (false)
+{
+  NS_LOG_FUNCTION (this);
+  m_uv = CreateObject<UniformRandomVariable> ();
+}
+
+TcpBbr::TcpBbr (const TcpBbr &sock)
+  : TcpCongestionOps (sock),
+    m_highGain (sock.m_highGain),
+    m_bwWindowLength (sock.m_bwWindowLength),
+    m_rttWindowLength (sock.m_rttWindowLength),
+    m_probeRttDuration (sock.m_probeRttDuration),
+    m_minCwndSegments (sock.m_minCwndSegments),
+    m_state (sock.m_state),
+    m_pacingGain (sock.m_pacingGain),
+    m_cWndGain (sock.m_cWndGain),
+    m_maxBwFilter (sock.m_maxBwFilter),
+    m_minRtt (sock.m_minRtt),
+    m_minRttStamp (sock.m_minRttStamp),
+    m_delivered (sock.m_delivered),
+    m_roundCount (sock.m_roundCount),
+    m_roundStart (sock.m_roundStart),
+    m_nextRoundSeq (sock.m_nextRoundSeq),
+    m_roundDelivered (sock.m_roundDelivered),
+    m_roundStartStamp (sock.m_roundStartStamp),
+    m_fullBwReached (sock.m_fullBwReached),
+    m_fullBw (sock.m_fullBw),
+    m_fullBwCount (sock.m_fullBwCount),
+    m_cycleIndex (sock.m_cycleIndex),
+    m_cycleStamp (sock.m_cycleStamp),
+    m_probeRttDoneStamp (sock.m_probeRttDoneStamp),
+    m_probeRttRoundDone (sock.m_probeRttRoundDone),
+    m_priorCwnd (sock.m_priorCwnd),
+    m_idleRestart (sock.m_idleRestart),
+    m_lossInPhase (sock.m_lossInPhase),
+    m_uv (sock.m_uv)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+int64_t
+TcpBbr::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_uv->SetStream (stream);
+  return 1;
+}
+
+std::string
+TcpBbr::GetName () const
+{
+  return "TcpBbr";
+}
+
+DataRate
+TcpBbr::GetMaxBw () const
+{
+  return m_maxBwFilter.empty () ? DataRate (0) : m_maxBwFilter.front ().m_bw;
+}
+
+uint32_t
+TcpBbr::InFlight (Ptr<const TcpSocketState> tcb, double gain) const
+{
+  DataRate bw = GetMaxBw ();
+  if (m_minRtt == Time::Max () || bw.GetBitRate () == 0)
+    {
+      return tcb->m_initialCWnd * tcb->m_segmentSize;
+    }
+
+  double bdp = bw * m_minRtt / 8.0;
+  return static_cast<uint32_t> (gain * bdp);
+}
+
+void
+TcpBbr::UpdateMaxBw (const DataRate &bw)
+{
+  NS_LOG_FUNCTION (this << bw);
+
+  // The queue holds decreasing rates: a sample hides the older and smaller
+  // ones, and the front is the maximum of the window
+  while (!m_maxBwFilter.empty () && m_maxBwFilter.back ().m_bw <= bw)
+    {
+      m_maxBwFilter.pop_back ();
+    }
+  BwSample sample;
+  sample.m_round = m_roundCount;
+  sample.m_bw = bw;
+  m_maxBwFilter.push_back (sample);
+
+  while (m_maxBwFilter.front ().m_round + m_bwWindowLength <= m_roundCount)
+    {
+      m_maxBwFilter.pop_front ();
+    }
+}
+
+void
+TcpBbr::UpdateRound (Ptr<const TcpSocketState> tcb)
+{
+  NS_LOG_FUNCTION (this << tcb);
+
+  m_roundStart = false;
+  if (tcb->m_lastAckedSeq < m_nextRoundSeq)
+    {
+      return;
+    }
+
+  Time now = Simulator::Now ();
+  // A zero stamp means that no round is running: first ACK of the
+  // connection, or first ACK after an idle period, which would bias
+  // the sample low
+  if (!m_roundStartStamp.IsZero () && now > m_roundStartStamp)
+    {
+      double bytes = static_cast<double> (m_delivered - m_roundDelivered);
+      DataRate bw (static_cast<uint64_t> (bytes * 8 / (now - m_roundStartStamp).GetSeconds ()));
+
+      ++m_roundCount;
+      m_roundStart = true;
+      UpdateMaxBw (bw);
+      NS_LOG_DEBUG ("Round " << m_roundCount << " delivered " << bytes <<
+                    " bytes, bw " << bw << " max bw " << GetMaxBw ());
+    }
+
+  m_nextRoundSeq = tcb->m_highTxMark;
+  m_roundDelivered = m_delivered;
+  m_roundStartStamp = now;
+}
+
+void
+TcpBbr::EnterProbeBw ()
+{
+  NS_LOG_FUNCTION (this);
+
+  m_state = BBR_PROBE_BW;
+  m_cWndGain = PROBE_BW_CWND_GAIN;
+  // As in Linux, never start with the draining phase: there is no queue
+  // to drain yet
+  m_cycleIndex = GAIN_CYCLE_LENGTH - 1 - m_uv->GetInteger (0, GAIN_CYCLE_LENGTH - 2);
+  m_cycleIndex = (m_cycleIndex + 1) % GAIN_CYCLE_LENGTH;
+  m_pacingGain = PACING_GAIN_CYCLE[m_cycleIndex];
+  m_cycleStamp = Simulator::Now ();
+  m_lossInPhase = false;
+}
+
+void
+TcpBbr::UpdateCyclePhase (Ptr<const TcpSocketState> tcb)
+{
+  NS_LOG_FUNCTION (this << tcb);
+
+  if (m_state != BBR_PROBE_BW)
+    {
+      return;
+    }
+
+  Time now = Simulator::Now ();
+  uint32_t inFlight = tcb->m_bytesInFlight;
+  bool fullLength = now - m_cycleStamp > m_minRtt;
+  bool next;
+
+  if (m_pacingGain > 1.0)
+    {
+      // Probe until the extra data is in flight, or a loss says there is
+      // no more bandwidth
+      next = fullLength && (m_lossInPhase || inFlight >= InFlight (tcb, m_pacingGain));
+    }
+  else if (m_pacingGain < 1.0)
+    {
+      // Drain until the queue is empty, at most a min RTT
+      next = fullLength || inFlight <= InFlight (tcb, 1.0);
+    }
+  else
+    {
+      next = fullLength;
+    }
+
+  if (next)
+    {
+      m_cycleIndex = (m_cycleIndex + 1) % GAIN_CYCLE_LENGTH;
+      m_pacingGain = PACING_GAIN_CYCLE[m_cycleIndex];
+      m_cycleStamp = now;
+      m_lossInPhase = false;
+      NS_LOG_DEBUG ("PROBE_BW phase " << m_cycleIndex << " gain " << m_pacingGain);
+    }
+}
+
+void
+TcpBbr::CheckFullPipe ()
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_fullBwReached || !m_roundStart)
+    {
+      return;
+    }
+
+  DataRate bw = GetMaxBw ();
+  if (bw.GetBitRate () >= FULL_BW_THRESHOLD * m_fullBw.GetBitRate ())
+    {
+      m_fullBw = bw;
+      m_fullBwCount = 0;
+      return;
+    }
+
+  if (++m_fullBwCount >= FULL_BW_COUNT)
+    {
+      m_fullBwReached = true;
+      NS_LOG_DEBUG ("Pipe full at " << m_fullBw);
+    }
+}
+
+void
+TcpBbr::CheckDrain (Ptr<const TcpSocketState> tcb)
+{
+  NS_LOG_FUNCTION (this << tcb);
+
+  if (m_state == BBR_STARTUP && m_fullBwReached)
+    {
+      m_state = BBR_DRAIN;
+      m_pacingGain = 1.0 / m_highGain;
+      m_cWndGain = m_highGain;
+      NS_LOG_DEBUG ("Enter " << BbrModeName[m_state]);
+    }
+
+  if (m_state == BBR_DRAIN && tcb->m_bytesInFlight <= InFlight (tcb, 1.0))
+    {
+      EnterProbeBw ();
+      NS_LOG_DEBUG ("Enter " << BbrModeName[m_state]);
+    }
+}
+
+void
+TcpBbr::UpdateMinRtt (Ptr<TcpSocketState> tcb, const Time &rtt)
+{
+  NS_LOG_FUNCTION (this << tcb << rtt);
+
+  Time now = Simulator::Now ();
+  bool expired = m_minRtt != Time::Max () && now > m_minRttStamp + m_rttWindowLength;
+
+  if (!rtt.IsZero () && (rtt <= m_minRtt || expired))
+    {
+      m_minRtt = rtt;
+      m_minRttStamp = now;
+    }
+
+  if (expired && !m_idleRestart && m_state != BBR_PROBE_RTT)
+    {
+      m_state = BBR_PROBE_RTT;
+      m_pacingGain = 1.0;
+      m_cWndGain = 1.0;
+      m_priorCwnd = tcb->m_cWnd;
+      m_probeRttDoneStamp = Seconds (0);
+      NS_LOG_DEBUG ("Enter " << BbrModeName[m_state]);
+    }
+
+  if (m_state != BBR_PROBE_RTT)
+    {
+      return;
+    }
+
+  if (m_probeRttDoneStamp.IsZero ())
+    {
+      if (tcb->m_bytesInFlight <= m_minCwndSegments * tcb->m_segmentSize)
+        {
+          // The queue is drained: wait ProbeRttDuration and a round
+          m_probeRttDoneStamp = now + m_probeRttDuration;
+          m_probeRttRoundDone = false;
+          m_nextRoundSeq = tcb->m_highTxMark;
+        }
+      return;
+    }
+
+  if (m_roundStart)
+    {
+      m_probeRttRoundDone = true;
+    }
+
+  if (m_probeRttRoundDone && now > m_probeRttDoneStamp)
+    {
+      m_minRttStamp = now;
+      tcb->m_cWnd = std::max (tcb->m_cWnd.Get (), m_priorCwnd);
+      if (m_fullBwReached)
+        {
+          EnterProbeBw ();
+        }
+      else
+        {
+          m_state = BBR_STARTUP;
+          m_pacingGain = m_highGain;
+          m_cWndGain = m_highGain;
+        }
+      NS_LOG_DEBUG ("Leave PROBE_RTT, enter " << BbrModeName[m_state]);
+    }
+}
+
+void
+TcpBbr::SetPacingRate (Ptr<TcpSocketState> tcb, double gain)
+{
+  NS_LOG_FUNCTION (this << tcb << gain);
+
+  double rate;
+  DataRate bw = GetMaxBw ();
+  if (bw.GetBitRate () > 0)
+    {
+      rate = gain * bw.GetBitRate ();
+    }
+  else
+    {
+      // No bandwidth sample yet: pace the window over the RTT
+      Time rtt = m_minRtt != Time::Max () ? m_minRtt : tcb->m_lastRtt.Get ();
+      if (rtt.IsZero ())
+        {
+          return;
+        }
+      rate = m_highGain * tcb->m_cWnd * 8 / rtt.GetSeconds ();
+    }
+
+  rate = std::min (rate, static_cast<double> (tcb->m_maxPacingRate.GetBitRate ()));
+  if (rate < 1)
+    {
+      return;
+    }
+
+  // Do not slow down before the pipe is full, as an early sample can be
+  // lower than the rate of the initial window
+  DataRate pacingRate (static_cast<uint64_t> (rate));
+  if (!tcb->m_pacing || m_fullBwReached || pacingRate > tcb->m_currentPacingRate)
+    {
+      tcb->m_pacing = true;
+      tcb->m_currentPacingRate = pacingRate;
+    }
+}
+
+void
+TcpBbr::PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked,
+                   const Time &rtt)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked << rtt);
+
+  if (m_state == BBR_STARTUP)
+    {
+      // HighGain may be set after the construction
+      m_pacingGain = m_highGain;
+      m_cWndGain = m_highGain;
+    }
+  m_delivered += static_cast<uint64_t> (segmentsAcked) * tcb->m_segmentSize;
+
+  UpdateRound (tcb);
+  UpdateCyclePhase (tcb);
+  CheckFullPipe ();
+  CheckDrain (tcb);
+  UpdateMinRtt (tcb, rtt);
+  SetPacingRate (tcb, m_pacingGain);
+
+  m_idleRestart = false;
+}
+
+void
+TcpBbr::IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked);
+
+  uint32_t acked = segmentsAcked * tcb->m_segmentSize;
+  uint32_t cWnd = tcb->m_cWnd;
+
+  if (GetMaxBw ().GetBitRate () == 0)
+    {
+      // No model of the path yet: grow as in slow start
+      cWnd += acked;
+    }
+  else
+    {
+      // Linux adds three TSO bursts, here three segments, so that the pipe
+      // stays full despite the delayed ACKs
+      uint32_t target = InFlight (tcb, m_cWndGain) + 3 * tcb->m_segmentSize;
+      if (m_fullBwReached)
+        {
+          cWnd = std::min (cWnd + acked, target);
+        }
+      else if (cWnd < target || m_delivered < tcb->m_initialCWnd * tcb->m_segmentSize)
+        {
+          cWnd += acked;
+        }
+    }
+
+  cWnd = std::max (cWnd, m_minCwndSegments * tcb->m_segmentSize);
+  if (m_state == BBR_PROBE_RTT)
+    {
+      cWnd = std::min (cWnd, m_minCwndSegments * tcb->m_segmentSize);
+    }
+
+  tcb->m_cWnd = cWnd;
+  NS_LOG_INFO ("In " << BbrModeName[m_state] << ", updated to cwnd " << tcb->m_cWnd);
+}
+
+uint32_t
+TcpBbr::GetSsThresh (Ptr<const TcpSocketState> tcb,
+                     uint32_t bytesInFlight)
+{
+  NS_LOG_FUNCTION (this << tcb << bytesInFlight);
+
+  if (m_state != BBR_PROBE_RTT)
+    {
+      m_priorCwnd = tcb->m_cWnd;
+    }
+  m_lossInPhase = true;
+
+  // Packet conservation: the window left after the recovery is what was in
+  // flight, then it grows back to the target of the model
+  return std::max (bytesInFlight, 2 * tcb->m_segmentSize);
+}
+
+void
+TcpBbr::CongestionStateSet (Ptr<TcpSocketState> tcb,
+                            const TcpSocketState::TcpCongState_t newState)
+{
+  NS_LOG_FUNCTION (this << tcb << newState);
+
+  if (newState == TcpSocketState::CA_LOSS)
+    {
+      // After a timeout, detect the full pipe from scratch
+      m_fullBw = DataRate (0);
+      m_fullBwCount = 0;
+    }
+}
+
+void
+TcpBbr::CwndEvent (Ptr<TcpSocketState> tcb,
+                   const TcpSocketState::TcpCAEvent_t event)
+{
+  NS_LOG_FUNCTION (this << tcb << event);
+
+  if (event == TcpSocketState::CA_EVENT_TX_START)
+    {
+      // Restart after idle: the next round starts with the first ACK, and
+      // the data already queued is sent at the estimated bandwidth
+      m_idleRestart = true;
+      m_roundStartStamp = Seconds (0);
+      if (m_state == BBR_PROBE_BW)
+        {
+          SetPacingRate (tcb, 1.0);
+        }
+    }
+}
+
+Ptr<TcpCongestionOps>
+TcpBbr::Fork (void)
+{
+  return CopyObject<TcpBbr> (this);
+}
+
+} // namespace ns3
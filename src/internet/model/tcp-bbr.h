@@ -0,0 +1,245 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef TCPBBR_H
+#define TCPBBR_H
+
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/sequence-number.h"
+#include "ns3/data-rate.h"
+#include "ns3/random-variable-stream.h"
+
+#include <deque>
+
+class TcpBbrTest;
+class TcpBbrSsThreshTest;
+
+namespace ns3 {
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief BBR (Bottleneck Bandwidth and Round-trip propagation time)
+ *
+ * BBR does not react to losses: it builds a model of the path, made of
+ * the bottleneck bandwidth (the maximum delivery rate measured over the
+ * last BwWindowLength rounds) and of the round-trip propagation time (the
+ * minimum RTT measured over the last RttWindowLength). The sender paces
+ * at pacing_gain * bandwidth, and keeps at most cwnd_gain times the
+ * bandwidth-delay product in flight.
+ *
+ * The gains are set by a state machine (BBR v1):
+ *
+ * - STARTUP doubles the sending rate each round (gain 2/ln2), until the
+ *   bandwidth did not grow by 25% for three rounds (the pipe is full);
+ * - DRAIN paces at the inverse gain, until the queue built during
+ *   STARTUP is drained (in flight <= BDP);
+ * - PROBE_BW cycles the pacing gain over 1.25, 0.75 and six times 1, each
+ *   phase lasting a minimum RTT, to probe for more bandwidth and drain
+ *   the queue it built;
+ * - PROBE_RTT, entered when the minimum RTT was not refreshed during
+ *   RttWindowLength, keeps 4 segments in flight during ProbeRttDuration
+ *   and at least a round, to measure the propagation delay again.
+ *
+ * TcpSocketBase does not sample the delivery rate of each packet, so the
+ * bandwidth samples are taken once per round: the bytes acknowledged
+ * during a round divided by its duration. A round ends when the data
+ * sent at its beginning is acknowledged.
+ *
+ * Pacing is enabled on the socket by the algorithm itself, through the
+ * pacing support of TcpSocketBase; the rate is capped by the
+ * MaxPacingRate attribute of TcpSocketState. During fast recovery the
+ * window is managed by the socket, as for the other congestion controls,
+ * and GetSsThresh conserves the packets in flight.
+ *
+ * Reference: N. Cardwell, Y. Cheng, C. S. Gunn, S. H. Yeganeh and
+ * V. Jacobson, "BBR: Congestion-Based Congestion Control", ACM Queue,
+ * 2016, and Linux (tcp_bbr.c).
+ */
+class TcpBbr : public TcpCongestionOps
+{
+public:
+  /**
+   * \brief The states of the BBR state machine
+   */
+  enum BbrMode_t
+  {
+    BBR_STARTUP,   //!< Ramp up sending rate rapidly to fill pipe
+    BBR_DRAIN,     //!< Drain any queue created during startup
+    BBR_PROBE_BW,  //!< Discover, share bandwidth: pace around estimated bandwidth
+    BBR_PROBE_RTT, //!< Cut inflight to min to probe min_rtt
+  };
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TcpBbr ();
+
+  /**
+   * Copy constructor
+   * \param sock Socket to copy
+   */
+  TcpBbr (const TcpBbr& sock);
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+  virtual std::string GetName () const;
+  virtual void PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked,
+                          const Time &rtt);
+  virtual void IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked);
+  virtual uint32_t GetSsThresh (Ptr<const TcpSocketState> tcb,
+                                uint32_t bytesInFlight);
+  virtual void CongestionStateSet (Ptr<TcpSocketState> tcb,
+                                   const TcpSocketState::TcpCongState_t newState);
+  virtual void CwndEvent (Ptr<TcpSocketState> tcb,
+                          const TcpSocketState::TcpCAEvent_t event);
+
+  virtual Ptr<TcpCongestionOps> Fork ();
+
+  /**
+   * \brief Literal names of BBR mode for use in log messages
+   */
+  static const char* const BbrModeName[BBR_PROBE_RTT + 1];
+
+private:
+  /**
+   * \brief TcpBbrTest friend class (for tests).
+   * \relates TcpBbrTest
+   */
+  friend class ::TcpBbrTest;
+  /**
+   * \brief TcpBbrSsThreshTest friend class (for tests).
+   * \relates TcpBbrSsThreshTest
+   */
+  friend class ::TcpBbrSsThreshTest;
+
+  /**
+   * \brief Detect the end of a round, and take a bandwidth sample at its end
+   * \param tcb Transmission Control Block of the connection
+   */
+  void UpdateRound (Ptr<const TcpSocketState> tcb);
+
+  /**
+   * \brief Add a bandwidth sample to the windowed max filter
+   * \param bw the delivery rate measured during the last round
+   */
+  void UpdateMaxBw (const DataRate &bw);
+
+  /**
+   * \brief Advance the PROBE_BW gain cycle when the phase is over
+   * \param tcb Transmission Control Block of the connection
+   */
+  void UpdateCyclePhase (Ptr<const TcpSocketState> tcb);
+
+  /**
+   * \brief Check if the bandwidth stopped growing during STARTUP
+   */
+  void CheckFullPipe ();
+
+  /**
+   * \brief Move from STARTUP to DRAIN, and from DRAIN to PROBE_BW
+   * \param tcb Transmission Control Block of the connection
+   */
+  void CheckDrain (Ptr<const TcpSocketState> tcb);
+
+  /**
+   * \brief Update the minimum RTT, and enter or leave PROBE_RTT
+   * \param tcb Transmission Control Block of the connection
+   * \param rtt the RTT sample of the ACK
+   */
+  void UpdateMinRtt (Ptr<TcpSocketState> tcb, const Time &rtt);
+
+  /**
+   * \brief Set the pacing rate of the socket to gain * bandwidth
+   * \param tcb Transmission Control Block of the connection
+   * \param gain the pacing gain
+   */
+  void SetPacingRate (Ptr<TcpSocketState> tcb, double gain);
+
+  /**
+   * \brief Enter PROBE_BW, at a random phase of the cycle other than 0.75
+   */
+  void EnterProbeBw ();
+
+  /**
+   * \brief The bytes in flight for a given gain
+   * \param tcb Transmission Control Block of the connection
+   * \param gain the gain to apply to the bandwidth-delay product
+   * \return gain * BDP, or the initial window when there is no model yet
+   */
+  uint32_t InFlight (Ptr<const TcpSocketState> tcb, double gain) const;
+
+  /**
+   * \return the current estimate of the bottleneck bandwidth
+   */
+  DataRate GetMaxBw () const;
+
+  /**
+   * \brief A sample of the windowed max filter
+   */
+  struct BwSample
+  {
+    uint64_t m_round;  //!< Round in which the sample was taken
+    DataRate m_bw;     //!< Delivery rate of the round
+  };
+
+  // Parameters
+  double   m_highGain;               //!< Gain of STARTUP
+  uint32_t m_bwWindowLength;         //!< Length of the bandwidth filter (rounds)
+  Time     m_rttWindowLength;        //!< Length of the min RTT filter
+  Time     m_probeRttDuration;       //!< Time spent in PROBE_RTT
+  uint32_t m_minCwndSegments;        //!< cWnd in PROBE_RTT, and minimum cWnd (segments)
+
+  // State
+  BbrMode_t m_state;                 //!< Current state of the state machine
+  double   m_pacingGain;             //!< Current pacing gain
+  double   m_cWndGain;               //!< Current cWnd gain
+  std::deque<BwSample> m_maxBwFilter; //!< Monotonic queue of the bandwidth samples
+  Time     m_minRtt;                 //!< Estimated round-trip propagation time
+  Time     m_minRttStamp;            //!< When m_minRtt was measured
+  uint64_t m_delivered;              //!< Bytes delivered since the first ACK
+  uint64_t m_roundCount;             //!< Number of rounds elapsed
+  bool     m_roundStart;             //!< True on the ACK which starts a round
+  SequenceNumber32 m_nextRoundSeq;   //!< ACK of this sequence ends the round
+  uint64_t m_roundDelivered;         //!< m_delivered at the start of the round
+  Time     m_roundStartStamp;        //!< Start of the round
+  bool     m_fullBwReached;          //!< True when the pipe is full
+  DataRate m_fullBw;                 //!< Bandwidth reference for the full pipe detection
+  uint32_t m_fullBwCount;            //!< Rounds without enough bandwidth growth
+  uint32_t m_cycleIndex;             //!< Current phase of the PROBE_BW cycle
+  Time     m_cycleStamp;             //!< Start of the current phase
+  Time     m_probeRttDoneStamp;      //!< End of PROBE_RTT, zero if not yet scheduled
+  bool     m_probeRttRoundDone;      //!< True when a round elapsed in PROBE_RTT
+  uint32_t m_priorCwnd;              //!< cWnd before PROBE_RTT
+  bool     m_idleRestart;            //!< True after an idle period, until the next ACK
+  bool     m_lossInPhase;            //!< True when a loss occurred in the current phase
+  Ptr<UniformRandomVariable> m_uv;   //!< Random variable for the first PROBE_BW phase
+};
+
+} // namespace ns3
+
+#endif // TCPBBR_H
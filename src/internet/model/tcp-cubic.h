@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef TCPCUBIC_H
+#define TCPCUBIC_H
+
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/sequence-number.h"
+
+class TcpCubicIncrementTest;
+class TcpCubicDecrementTest;
+class TcpCubicGrowthTest;
+
+namespace ns3 {
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief The Cubic Congestion Control Algorithm
+ *
+ * TCP Cubic replaces the binary search of TCP Bic with a cubic function of
+ * the time elapsed since the last congestion event. The window grows fast
+ * when it is far from the window at which the last loss happened (W_max),
+ * slowly around it, and fast again when probing beyond it. The growth thus
+ * depends on time rather than on the RTT, which makes flows of different
+ * RTTs fair to each other, and lets long-RTT flows fill a large BDP.
+ *
+ * The window is never smaller than the one a standard TCP would have in
+ * the same conditions (TCP-friendly region).
+ *
+ * With fast convergence, a flow which loses before reaching its previous
+ * W_max lowers W_max further, to release bandwidth to newer flows.
+ *
+ * Slow start uses HyStart: it ends before the first loss when the ACKs of
+ * a train sent back to back span half of the minimum RTT (ACK train), or
+ * when the RTT of the first segments of a round grows by more than
+ * HyStartDelayMin...HyStartDelayMax over the minimum RTT (delay increase).
+ *
+ * The implementation follows Linux (tcp_cubic.c) and the reference paper:
+ * S. Ha, I. Rhee and L. Xu, "CUBIC: a new TCP-friendly high-speed TCP
+ * variant", ACM SIGOPS Operating Systems Review, 2008.
+ */
+class TcpCubic : public TcpCongestionOps
+{
+public:
+  /**
+   * \brief Values to detect the Slow Start mode of HyStart
+   */
+  enum HybridSSDetectionMode
+  {
+    PACKET_TRAIN = 1, //!< Detection by trains of packet
+    DELAY        = 2, //!< Detection by delay value
+    BOTH         = 3, //!< Detection by both
+  };
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TcpCubic ();
+
+  /**
+   * Copy constructor
+   * \param sock Socket to copy
+   */
+  TcpCubic (const TcpCubic& sock);
+
+  virtual std::string GetName () const;
+  virtual void PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked,
+                          const Time &rtt);
+  virtual void IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked);
+  virtual uint32_t GetSsThresh (Ptr<const TcpSocketState> tcb,
+                                uint32_t bytesInFlight);
+  virtual void CongestionStateSet (Ptr<TcpSocketState> tcb,
+                                   const TcpSocketState::TcpCongState_t newState);
+  virtual void CwndEvent (Ptr<TcpSocketState> tcb,
+                          const TcpSocketState::TcpCAEvent_t event);
+
+  virtual Ptr<TcpCongestionOps> Fork ();
+
+private:
+  /**
+   * \brief TcpCubicIncrementTest friend class (for tests).
+   * \relates TcpCubicIncrementTest
+   */
+  friend class ::TcpCubicIncrementTest;
+  /**
+   * \brief TcpCubicDecrementTest friend class (for tests).
+   * \relates TcpCubicDecrementTest
+   */
+  friend class ::TcpCubicDecrementTest;
+  /**
+   * \brief TcpCubicGrowthTest friend class (for tests).
+   * \relates TcpCubicGrowthTest
+   */
+  friend class ::TcpCubicGrowthTest;
+
+  bool     m_fastConvergence;  //!< Enable or disable fast convergence algorithm
+  double   m_beta;             //!< Beta for cubic multiplicative decrease
+
+  bool     m_hystart;          //!< Enable or disable HyStart algorithm
+  HybridSSDetectionMode m_hystartDetect; //!< Detect way for HyStart algorithm
+  uint32_t m_hystartLowWindow; //!< Lower bound cWnd for hybrid slow start (segments)
+  Time     m_hystartAckDelta;  //!< Spacing between ack's indicating train
+  Time     m_hystartDelayMin;  //!< Minimum time for hystart algorithm
+  Time     m_hystartDelayMax;  //!< Maximum time for hystart algorithm
+  uint8_t  m_hystartMinSamples; //!< Number of delay samples for detecting the increase of delay
+
+  uint8_t  m_cntClamp;         //!< Modulo of the (avoided) float division for cWnd
+
+  double   m_c;                //!< Cubic Scaling factor
+
+  // Cubic parameters
+  uint32_t     m_cWndCnt;         //!<  cWnd integer-to-float counter
+  uint32_t     m_lastMaxCwnd;     //!<  Last maximum cWnd
+  uint32_t     m_bicOriginPoint;  //!<  Origin point of bic function
+  double       m_bicK;            //!<  Time to origin point from the beginning of the current epoch (in s)
+  Time         m_delayMin;        //!<  Min delay
+  Time         m_epochStart;      //!<  Beginning of an epoch
+  uint8_t      m_found;           //!<  The exit condition of HyStart found
+  Time         m_roundStart;      //!<  Beginning of each round
+  SequenceNumber32 m_endSeq;      //!<  End sequence of the round
+  Time         m_lastAck;         //!<  Last time when the ACK spacing is close
+  Time         m_cubicDelta;      //!<  Time to wait after recovery before update
+  Time         m_currRtt;         //!<  Current Rtt
+  uint32_t     m_sampleCnt;       //!<  Count of samples for HyStart
+  uint32_t     m_ackCnt;          //!<  Number of acked segments, for the TCP-friendly region
+  uint32_t     m_tcpCwnd;         //!<  Estimated cWnd of a standard TCP (in segments)
+  Time         m_lastActivity;    //!<  Time of the last ACK, to measure the idle periods
+
+  /**
+   * \brief Reset HyStart parameters
+   * \param tcb Transmission Control Block of the connection
+   */
+  void HystartReset (Ptr<const TcpSocketState> tcb);
+
+  /**
+   * \brief Reset Cubic parameters
+   * \param tcb Transmission Control Block of the connection
+   */
+  void CubicReset (Ptr<const TcpSocketState> tcb);
+
+  /**
+   * \brief Cubic window update after a new ack received
+   * \param tcb Transmission Control Block of the connection
+   * \param segmentsAcked Segments acked by the ACK
+   * \returns the number of ACKs after which the window grows by one segment
+   */
+  uint32_t Update (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked);
+
+  /**
+   * \brief Update HyStart parameters
+   *
+   * \param tcb Transmission Control Block of the connection
+   * \param delay Delay for HyStart algorithm
+   */
+  void HystartUpdate (Ptr<TcpSocketState> tcb, const Time &delay);
+
+  /**
+   * \brief Clamp time value in a range
+   *
+   * The returned value is t, clamped in a range specified
+   * by attributes (HystartDelayMin < t < HystartDelayMax)
+   *
+   * \param t Time value to clamp
+   * \return t itself if it is in range, otherwise the min or max
+   * value
+   */
+  Time HystartDelayThresh (const Time &t) const;
+};
+
+} // namespace ns3
+
+#endif // TCPCUBIC_H
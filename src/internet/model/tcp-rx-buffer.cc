@@ -22,12 +22,26 @@
 #include "ns3/log.h"
 #include "tcp-rx-buffer.h"
 
+#include <algorithm>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TcpRxBuffer");
 
 NS_OBJECT_ENSURE_REGISTERED (TcpRxBuffer);
 
+/**
+ * \brief Order a received block before a sequence number
+ * \param block the block
+ * \param seq the sequence number
+ * \returns true if the block ends before seq, without touching it
+ */
+static bool
+EndsBefore (const TcpOptionSack::SackBlock &block, const SequenceNumber32 &seq)
+{
+  return block.second < seq;
+}
+
 TypeId
 TcpRxBuffer::GetTypeId (void)
 {
@@ -51,7 +65,8 @@ TcpRxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpRxBuffer::TcpRxBuffer (uint32_t n)
-  : m_nextRxSeq (n), m_gotFin (false), m_size (0), m_maxBuffer (32768), m_availBytes (0)
+  : m_nextRxSeq (n), m_gotFin (false), m_size (0), m_maxBuffer (32768), m_availBytes (0),
+    m_virtualPayload (false)
 {
 }
 
@@ -113,9 +128,9 @@ TcpRxBuffer::MaxRxSequence (void) const
     { // No data allowed beyond FIN
       return m_finSeq;
     }
-  else if (m_data.size () && m_nextRxSeq > m_data.begin ()->first)
+  else if (m_availBytes > 0)
     { // No data allowed beyond Rx window allowed
-      return m_data.begin ()->first + SequenceNumber32 (m_maxBuffer);
+      return m_nextRxSeq.Get () - static_cast<int32_t> (m_availBytes) + SequenceNumber32 (m_maxBuffer);
     }
   return m_nextRxSeq + SequenceNumber32 (m_maxBuffer);
 }
@@ -136,6 +151,14 @@ TcpRxBuffer::Finished (void)
   return (m_gotFin && m_finSeq < m_nextRxSeq);
 }
 
+void
+TcpRxBuffer::SetVirtualPayload (bool virtualPayload)
+{
+  NS_LOG_FUNCTION (this << virtualPayload);
+  NS_ASSERT_MSG (m_size == 0, "Changing the payload mode of a non-empty buffer");
+  m_virtualPayload = virtualPayload;
+}
+
 bool
 TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
 {
@@ -149,74 +172,70 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
 
   // Trim packet to fit Rx window specification
   if (headSeq < m_nextRxSeq) headSeq = m_nextRxSeq;
-  if (m_data.size ())
+  if (m_size)
     {
-      SequenceNumber32 maxSeq = m_data.begin ()->first + SequenceNumber32 (m_maxBuffer);
+      // The window starts at the first byte not extracted yet
+      SequenceNumber32 firstSeq = m_availBytes ? m_nextRxSeq.Get () - static_cast<int32_t> (m_availBytes)
+                                                : m_blocks.front ().first;
+      SequenceNumber32 maxSeq = firstSeq + SequenceNumber32 (m_maxBuffer);
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end () && i->first <= tailSeq)
-    {
-      SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      if (lastByteSeq > headSeq)
-        {
-          if (i->first > headSeq && lastByteSeq < tailSeq)
-            { // Rare case: Existing packet is embedded fully in the new packet
-              m_size -= i->second->GetSize ();
-              m_data.erase (i++);
-              continue;
-            }
-          if (i->first <= headSeq)
-            { // Incoming head is overlapped
-              headSeq = lastByteSeq;
-            }
-          if (lastByteSeq >= tailSeq)
-            { // Incoming tail is overlapped
-              tailSeq = i->first;
-            }
-        }
-      ++i;
-    }
-  // We now know how much we are going to store, trim the packet
   if (headSeq >= tailSeq)
     {
       NS_LOG_LOGIC ("Nothing to buffer");
       return false; // Nothing to buffer anyway
     }
-  else
+
+  // Find the holes of the buffer the packet fills
+  std::vector<TcpOptionSack::SackBlock> holes;
+  SequenceNumber32 seq = headSeq;
+  std::vector<TcpOptionSack::SackBlock>::iterator it;
+  for (it = std::lower_bound (m_blocks.begin (), m_blocks.end (), headSeq, &EndsBefore);
+       it != m_blocks.end () && it->first < tailSeq; ++it)
     {
-      uint32_t start = static_cast<uint32_t> (headSeq - tcph.GetSequenceNumber ());
-      uint32_t length = static_cast<uint32_t> (tailSeq - headSeq);
-      p = p->CreateFragment (start, length);
-      NS_ASSERT (length == p->GetSize ());
+      if (seq < it->first)
+        {
+          holes.push_back (TcpOptionSack::SackBlock (seq, it->first));
+        }
+      seq = std::max (seq, it->second);
     }
-  // Insert packet into buffer
-  NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
-  m_data [ headSeq ] = p;
-
-  if (headSeq > m_nextRxSeq)
+  if (seq < tailSeq)
     {
-      // Generate a new SACK block
-      UpdateSackList (headSeq, tailSeq);
+      holes.push_back (TcpOptionSack::SackBlock (seq, tailSeq));
+    }
+  if (holes.empty ())
+    {
+      NS_LOG_LOGIC ("Duplicate data, nothing to buffer");
+      return false;
     }
 
-  NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
-  // Update variables
-  m_size += p->GetSize ();      // Occupancy
-  for (i = m_data.begin (); i != m_data.end (); ++i)
+  // Store the new bytes only
+  for (std::size_t k = 0; k < holes.size (); ++k)
     {
-      if (i->first < m_nextRxSeq)
+      uint32_t length = static_cast<uint32_t> (holes[k].second - holes[k].first);
+      if (!m_virtualPayload)
         {
-          continue;
+          uint32_t start = static_cast<uint32_t> (holes[k].first - tcph.GetSequenceNumber ());
+          NS_ASSERT (m_data.find (holes[k].first) == m_data.end ()); // Shouldn't be there yet
+          m_data [ holes[k].first ] = p->CreateFragment (start, length);
         }
-      else if (i->first > m_nextRxSeq)
-        {
-          break;
-        };
-      m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      m_availBytes += i->second->GetSize ();
+      NS_LOG_LOGIC ("Buffered data of seqno=" << holes[k].first << " len=" << length);
+      m_size += length;      // Occupancy
+    }
+
+  TcpOptionSack::SackBlock block = InsertBlock (headSeq, tailSeq);
+  if (block.first > m_nextRxSeq)
+    {
+      // Generate a new SACK block
+      UpdateSackList (block.first, block.second);
+    }
+  else
+    {
+      // The hole at the head is filled, up to the end of the block
+      m_availBytes += static_cast<uint32_t> (block.second - m_nextRxSeq);
+      m_nextRxSeq = block.second;
+      m_blocks.erase (m_blocks.begin ());
       ClearSackList (m_nextRxSeq);
     }
   NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
@@ -227,6 +246,32 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   return true;
 }
 
+TcpOptionSack::SackBlock
+TcpRxBuffer::InsertBlock (const SequenceNumber32 &head, const SequenceNumber32 &tail)
+{
+  NS_LOG_FUNCTION (this << head << tail);
+
+  // The blocks overlapping or touching the range are merged into the first
+  std::vector<TcpOptionSack::SackBlock>::iterator first, last;
+  first = std::lower_bound (m_blocks.begin (), m_blocks.end (), head, &EndsBefore);
+  TcpOptionSack::SackBlock merged (head, tail);
+  for (last = first; last != m_blocks.end () && last->first <= tail; ++last)
+    {
+      merged.first = std::min (merged.first, last->first);
+      merged.second = std::max (merged.second, last->second);
+    }
+  if (first == last)
+    {
+      m_blocks.insert (first, merged);
+    }
+  else
+    {
+      *first = merged;
+      m_blocks.erase (first + 1, last);
+    }
+  return merged;
+}
+
 uint32_t
 TcpRxBuffer::GetSackListSize () const
 {
@@ -273,50 +318,19 @@ TcpRxBuffer::UpdateSackList (const SequenceNumber32 &head, const SequenceNumber3
 
   m_sackList.push_front (current);
 
-  // We have inserted the block at the beginning of the list. Now, we should
-  // check if any existing blocks overlap with that.
-  bool updated = false;
+  // The block is a whole block of the buffer: the blocks already in the
+  // list which were merged into it are inside it, and are removed.
   TcpOptionSack::SackList::iterator it = m_sackList.begin ();
-  TcpOptionSack::SackBlock begin = *it;
-  TcpOptionSack::SackBlock merged;
-  ++it;
-
-  // Iterates until we examined all blocks in the list (maximum 4)
-  while (it != m_sackList.end ())
+  for (++it; it != m_sackList.end (); )
     {
-      current = *it;
-
-      // This is a left merge:
-      // [current_first; current_second] [beg_first; beg_second]
-      if (begin.first == current.second)
+      if (it->first >= head && it->second <= tail)
         {
-          NS_ASSERT (current.first < begin.second);
-          merged = TcpOptionSack::SackBlock (current.first, begin.second);
-          updated = true;
-        }
-      // while this is a right merge
-      // [begin_first; begin_second] [current_first; current_second]
-      else if (begin.second == current.first)
-        {
-          NS_ASSERT (begin.first < current.second);
-          merged = TcpOptionSack::SackBlock (begin.first, current.second);
-          updated = true;
+          it = m_sackList.erase (it);
         }
-
-      // If we have merged the blocks (and the result is in merged) we should
-      // delete the current block (it), the first block, and insert the merged
-      // one at the beginning.
-      if (updated)
+      else
         {
-          m_sackList.erase (it);
-          m_sackList.pop_front ();
-          m_sackList.push_front (merged);
-          it = m_sackList.begin ();
-          begin = *it;
-          updated = false;
+          ++it;
         }
-
-      ++it;
     }
 
   // Since the maximum blocks that fits into a TCP header are 4, there's no
@@ -325,11 +339,6 @@ TcpRxBuffer::UpdateSackList (const SequenceNumber32 &head, const SequenceNumber3
     {
       m_sackList.pop_back ();
     }
-
-  // Please note that, if a block b is discarded and then a block contiguous
-  // to b is received, only that new block (without the b part) is reported.
-  // This is perfectly fine for the RFC point (a), given that we do not report any
-  // overlapping blocks shortly after.
 }
 
 void
@@ -368,6 +377,13 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   uint32_t extractSize = std::min (maxSize, m_availBytes);
   NS_LOG_LOGIC ("Requested to extract " << extractSize << " bytes from TcpRxBuffer of size=" << m_size);
   if (extractSize == 0) return nullptr;  // No contiguous block to return
+  if (m_virtualPayload)
+    {
+      m_size -= extractSize;
+      m_availBytes -= extractSize;
+      NS_LOG_LOGIC ("Extracted " << extractSize << " virtual bytes, bufsize=" << m_size);
+      return Create<Packet> (extractSize);
+    }
   NS_ASSERT (m_data.size ()); // At least we have something to extract
   Ptr<Packet> outPkt = Create<Packet> (); // The packet that contains all the data to return
   BufIterator i;
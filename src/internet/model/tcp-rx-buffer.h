@@ -22,6 +22,7 @@
 #define TCP_RX_BUFFER_H
 
 #include <map>
+#include <vector>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/sequence-number.h"
@@ -67,6 +68,16 @@ class Packet;
  * For more information about the SACK list, please check the documentation of
  * the method GetSackList.
  *
+ * Reassembly
+ * ----------
+ *
+ * The ranges of data received beyond NextRxSequence are kept, coalesced, in a
+ * sorted vector of blocks. Finding the new bytes of a segment, advancing
+ * NextRxSequence and finding the block to report first in the SACK list are
+ * binary searches in it, and its size is the number of holes in the
+ * received data, not the number of segments. Only the new bytes of a
+ * segment are stored.
+ *
  * \see GetSackList
  * \see UpdateSackList
  */
@@ -136,12 +147,22 @@ public:
    */
   bool Finished (void);
 
+  /**
+   * \brief Enable or disable the virtual payload mode
+   *
+   * In virtual payload mode the content of the received segments is not
+   * kept: only the received ranges are, and Extract () returns zero-filled
+   * packets of the right size. It must be set while the buffer is empty.
+   *
+   * \param virtualPayload true to enable the mode
+   */
+  void SetVirtualPayload (bool virtualPayload);
+
   /**
    * Insert a packet into the buffer and update the availBytes counter to
    * reflect the number of bytes ready to send to the application. This
-   * function handles overlap by triming the head of the inputted packet and
-   * removing data from the buffer that overlaps the tail of the inputted
-   * packet
+   * function handles overlap by storing only the parts of the inputted
+   * packet which fill holes of the buffer
    *
    * \param p packet
    * \param tcph packet's TCP header
@@ -182,6 +203,17 @@ public:
   bool GotFin () const { return m_gotFin; }
 
 private:
+  /**
+   * \brief Add a range to the set of received blocks beyond NextRxSequence
+   *
+   * The range is merged with the blocks it overlaps or touches.
+   *
+   * \param head first sequence number of the range
+   * \param tail sequence number following the range
+   * \return the block that contains the range, after the merge
+   */
+  TcpOptionSack::SackBlock InsertBlock (const SequenceNumber32 &head, const SequenceNumber32 &tail);
+
   /**
    * \brief Update the sack list, with the block seq starting at the beginning
    *
@@ -199,6 +231,9 @@ private:
    *
    * \param head sequence number of the block at the beginning
    * \param tail sequence number of the block at the end
+   *
+   * The block must be a whole block of received data, as returned by
+   * InsertBlock: blocks of the list inside it are then dropped.
    */
   void UpdateSackList (const SequenceNumber32 &head, const SequenceNumber32 &tail);
 
@@ -225,7 +260,9 @@ private:
   uint32_t m_size;                           //!< Number of total data bytes in the buffer, not necessarily contiguous
   uint32_t m_maxBuffer;                      //!< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //!< Number of bytes available to read, i.e. contiguous block at head
-  std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null)
+  bool m_virtualPayload;                     //!< Keep block sizes instead of the received data
+  std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null), empty in virtual payload mode
+  std::vector<TcpOptionSack::SackBlock> m_blocks;   //!< Sorted, disjoint ranges received beyond m_nextRxSeq
 };
 
 } //namespace ns3
@@ -132,6 +132,14 @@ TcpSocketBase::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&TcpSocketBase::GetRxBuffer),
                    MakePointerChecker<TcpRxBuffer> ())
+    .AddAttribute ("VirtualPayload",
+                   "Count the stream bytes instead of storing them; the data "
+                   "received by the application is zero-filled. Only for "
+                   "applications that do not read the content of the stream",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::SetVirtualPayload,
+                                        &TcpSocketBase::GetVirtualPayload),
+                   MakeBooleanChecker ())
     .AddAttribute ("ReTxThreshold", "Threshold for fast retransmit",
                    UintegerValue (3),
                    MakeUintegerAccessor (&TcpSocketBase::SetRetxThresh,
@@ -4129,6 +4137,20 @@ TcpSocketBase::GetRxBuffer (void) const
   return m_rxBuffer;
 }
 
+void
+TcpSocketBase::SetVirtualPayload (bool virtualPayload)
+{
+  NS_LOG_FUNCTION (this << virtualPayload);
+  m_txBuffer->SetVirtualPayload (virtualPayload);
+  m_rxBuffer->SetVirtualPayload (virtualPayload);
+}
+
+bool
+TcpSocketBase::GetVirtualPayload (void) const
+{
+  return m_txBuffer->IsVirtualPayload ();
+}
+
 void
 TcpSocketBase::SetRetxThresh (uint32_t retxThresh)
 {
@@ -304,6 +304,23 @@ public:
    */
   Ptr<TcpRxBuffer> GetRxBuffer (void) const;
 
+  /**
+   * \brief Enable or disable the virtual payload mode of the Tx and Rx buffers
+   *
+   * For applications that do not look at the content of the stream: the
+   * buffers only count bytes, and the data sent and received are
+   * zero-filled packets of the right size.
+   *
+   * \param virtualPayload true to enable the mode
+   */
+  void SetVirtualPayload (bool virtualPayload);
+
+  /**
+   * \brief Check the virtual payload mode
+   * \return true if the buffers do not keep the data
+   */
+  bool GetVirtualPayload (void) const;
+
   /**
    * \brief Set the retransmission threshold (dup ack threshold for a fast retransmit)
    * \param retxThresh the threshold
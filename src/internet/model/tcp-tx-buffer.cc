@@ -155,6 +155,20 @@ TcpTxBuffer::Available (void) const
   return m_maxBuffer - m_size;
 }
 
+void
+TcpTxBuffer::SetVirtualPayload (bool virtualPayload)
+{
+  NS_LOG_FUNCTION (this << virtualPayload);
+  NS_ASSERT_MSG (m_size == 0, "Changing the payload mode of a non-empty buffer");
+  m_virtualPayload = virtualPayload;
+}
+
+bool
+TcpTxBuffer::IsVirtualPayload (void) const
+{
+  return m_virtualPayload;
+}
+
 void
 TcpTxBuffer::SetHeadSequence (const SequenceNumber32& seq)
 {
@@ -179,7 +193,12 @@ TcpTxBuffer::Add (Ptr<Packet> p)
                                 << m_firstByteSeq << ", availSize=" << Available ());
   if (p->GetSize () <= Available ())
     {
-      if (p->GetSize () > 0)
+      if (p->GetSize () > 0 && m_virtualPayload)
+        {
+          // the unsent bytes are only a count, m_size - m_sentSize
+          m_size += p->GetSize ();
+        }
+      else if (p->GetSize () > 0)
         {
           TcpTxItem *item = new TcpTxItem ();
           item->m_packet = p->Copy ();
@@ -285,6 +304,17 @@ TcpTxBuffer::GetNewSegment (uint32_t numBytes)
   NS_LOG_INFO ("AppList start at " << startOfAppList << ", sentSize = " <<
                m_sentSize << " firstByte: " << m_firstByteSeq);
 
+  if (m_virtualPayload)
+    {
+      NS_ASSERT (numBytes <= m_size - m_sentSize);
+      TcpTxItem *item = new TcpTxItem ();
+      item->m_packet = Create<Packet> (numBytes);
+      item->m_startSeq = startOfAppList;
+      m_sentList.insert (m_sentList.end (), item);
+      m_sentSize += numBytes;
+      return item;
+    }
+
   TcpTxItem *item = GetPacketFromList (m_appList, startOfAppList,
                                        numBytes, startOfAppList);
   item->m_startSeq = startOfAppList;
@@ -381,8 +411,16 @@ TcpTxBuffer::SplitItems (TcpTxItem *t1, TcpTxItem *t2, uint32_t size) const
   NS_ASSERT (t1 != nullptr && t2 != nullptr);
   NS_LOG_FUNCTION (this << *t2 << size);
 
-  t1->m_packet = t2->m_packet->CreateFragment (0, size);
-  t2->m_packet->RemoveAtStart (size);
+  if (m_virtualPayload)
+    {
+      t1->m_packet = Create<Packet> (size);
+      t2->m_packet = Create<Packet> (t2->m_packet->GetSize () - size);
+    }
+  else
+    {
+      t1->m_packet = t2->m_packet->CreateFragment (0, size);
+      t2->m_packet->RemoveAtStart (size);
+    }
 
   t1->m_startSeq = t2->m_startSeq;
   t1->m_sacked = t2->m_sacked;
@@ -622,7 +660,14 @@ TcpTxBuffer::MergeItems (TcpTxItem *t1, TcpTxItem *t2) const
       t1->m_lastSent = t2->m_lastSent;
     }
 
-  t1->m_packet->AddAtEnd (t2->m_packet);
+  if (m_virtualPayload)
+    {
+      t1->m_packet = Create<Packet> (t1->m_packet->GetSize () + t2->m_packet->GetSize ());
+    }
+  else
+    {
+      t1->m_packet->AddAtEnd (t2->m_packet);
+    }
 
   NS_LOG_INFO ("Situation after the merge: " << *t1);
 }
@@ -704,7 +749,8 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
           pktSize -= offset;
           NS_LOG_INFO (*item);
           // PacketTags are preserved when fragmenting
-          item->m_packet = item->m_packet->CreateFragment (offset, pktSize);
+          item->m_packet = m_virtualPayload ? Create<Packet> (pktSize)
+            : item->m_packet->CreateFragment (offset, pktSize);
           item->m_startSeq += offset;
           m_size -= offset;
           m_sentSize -= offset;
@@ -1199,7 +1245,14 @@ TcpTxBuffer::ResetSentList ()
     {
       item = m_sentList.back ();
       item->m_retrans = item->m_sacked = item->m_lost = false;
-      m_appList.push_front (item);
+      if (m_virtualPayload)
+        {
+          delete item;
+        }
+      else
+        {
+          m_appList.push_front (item);
+        }
       m_sentList.pop_back ();
     }
 
@@ -1224,7 +1277,14 @@ TcpTxBuffer::ResetLastSegmentSent ()
         {
           m_retrans -= item->m_packet->GetSize ();
         }
-      m_appList.insert (m_appList.begin (), item);
+      if (m_virtualPayload)
+        {
+          delete item;
+        }
+      else
+        {
+          m_appList.insert (m_appList.begin (), item);
+        }
     }
   ConsistencyCheck ();
 }
@@ -1448,7 +1508,7 @@ operator<< (std::ostream & os, TcpTxBuffer const & tcpTxBuf)
     " m_sackedOut = " << tcpTxBuf.m_sackedOut;
 
   NS_ASSERT (sentSize == tcpTxBuf.m_sentSize);
-  NS_ASSERT (tcpTxBuf.m_size - tcpTxBuf.m_sentSize == appSize);
+  NS_ASSERT (tcpTxBuf.m_virtualPayload || tcpTxBuf.m_size - tcpTxBuf.m_sentSize == appSize);
   return os;
 }
 
@@ -204,6 +204,24 @@ public:
    */
   uint32_t Available (void) const;
 
+  /**
+   * \brief Enable or disable the virtual payload mode
+   *
+   * In virtual payload mode the content of the application data is not
+   * kept: Add () only counts the bytes, and the segments are zero-filled
+   * packets of the requested size. Only the scoreboard of the sent
+   * segments is stored. It must be set while the buffer is empty.
+   *
+   * \param virtualPayload true to enable the mode
+   */
+  void SetVirtualPayload (bool virtualPayload);
+
+  /**
+   * \brief Check the virtual payload mode
+   * \returns true if the buffer does not keep the application data
+   */
+  bool IsVirtualPayload (void) const;
+
   /**
    * \brief Set the DupAckThresh
    * \param dupAckThresh the threshold
@@ -615,6 +633,7 @@ private:
   uint32_t m_dupAckThresh {0}; //!< Duplicate Ack threshold from TcpSocketBase
   uint32_t m_segmentSize {0}; //!< Segment size from TcpSocketBase
   bool     m_renoSack {false}; //!< Indicates if AddRenoSack was called
+  bool     m_virtualPayload {false}; //!< Count the application bytes instead of storing them
 
 };
 
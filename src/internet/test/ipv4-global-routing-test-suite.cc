@@ -14,7 +14,9 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include <vector>
+#include <sstream>
 #include "ns3/boolean.h"
 #include "ns3/config.h"
 #include "ns3/inet-socket-address.h"
@@ -41,6 +43,7 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/ipv4-global-routing.h"
+#include "ns3/global-router-interface.h"
 #include "ns3/bridge-helper.h"
 
 using namespace ns3;
@@ -1244,6 +1247,195 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief IPv4 GlobalRouting longest prefix match test
+ */
+class Ipv4GlobalRoutingLongestPrefixTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingLongestPrefixTestCase ();
+
+private:
+  /**
+   * \brief Look up a destination
+   * \param routing The routing protocol.
+   * \param dest The destination.
+   * \param oif The requested output device, if any.
+   * \return The output device of the route, or 0 if there is no route.
+   */
+  Ptr<NetDevice> Lookup (Ptr<Ipv4GlobalRouting> routing, std::string dest, Ptr<NetDevice> oif = 0);
+
+  virtual void DoRun (void);
+};
+
+Ipv4GlobalRoutingLongestPrefixTestCase::Ipv4GlobalRoutingLongestPrefixTestCase ()
+  : TestCase ("Global routing longest prefix match")
+{
+}
+
+Ptr<NetDevice>
+Ipv4GlobalRoutingLongestPrefixTestCase::Lookup (Ptr<Ipv4GlobalRouting> routing, std::string dest, Ptr<NetDevice> oif)
+{
+  Ipv4Header header;
+  header.SetDestination (Ipv4Address (dest.c_str ()));
+  Socket::SocketErrno err;
+  Ptr<Ipv4Route> route = routing->RouteOutput (Create<Packet> (), header, oif, err);
+  return route ? route->GetOutputDevice () : 0;
+}
+
+void
+Ipv4GlobalRoutingLongestPrefixTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (node);
+
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  Ptr<SimpleNetDevice> dev[3];
+  for (uint32_t i = 1; i <= 2; i++)
+    {
+      dev[i] = CreateObject<SimpleNetDevice> ();
+      dev[i]->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (dev[i]);
+      int32_t ifIndex = ipv4->AddInterface (dev[i]);
+      std::ostringstream addr;
+      addr << "192.168." << i << ".1";
+      ipv4->AddAddress (ifIndex, Ipv4InterfaceAddress (Ipv4Address (addr.str ().c_str ()), Ipv4Mask ("/24")));
+      ipv4->SetUp (ifIndex);
+    }
+
+  Ptr<Ipv4GlobalRouting> routing = CreateObject<Ipv4GlobalRouting> ();
+  routing->SetIpv4 (ipv4);
+  routing->AddNetworkRouteTo (Ipv4Address ("10.0.0.0"), Ipv4Mask ("/8"), Ipv4Address ("192.168.1.2"), 1);
+  routing->AddNetworkRouteTo (Ipv4Address ("10.1.0.0"), Ipv4Mask ("/16"), Ipv4Address ("192.168.2.2"), 2);
+  routing->AddHostRouteTo (Ipv4Address ("10.1.2.3"), Ipv4Address ("192.168.1.2"), 1);
+  routing->AddASExternalRouteTo (Ipv4Address ("0.0.0.0"), Ipv4Mask ("/0"), Ipv4Address ("192.168.2.2"), 2);
+
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "10.2.0.1"), dev[1], "/8 route not used");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "10.1.9.9"), dev[2], "/16 route does not win over /8");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "10.1.2.3"), dev[1], "host route does not win over /16");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "11.0.0.1"), dev[2], "external route not used");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "10.1.9.9", dev[1]), dev[1], "/8 route not used for its output device");
+
+  // routes 0 (host) and 2 (/16) removed, the lookup must follow
+  routing->RemoveRoute (2);
+  routing->RemoveRoute (0);
+  NS_TEST_EXPECT_MSG_EQ (routing->GetNRoutes (), 2, "routes not removed");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "10.1.9.9"), dev[1], "removed /16 route still used");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "10.1.2.3"), dev[1], "removed host route still used");
+
+  // equal cost routes to a prefix: the first one is used without random ECMP
+  routing->AddNetworkRouteTo (Ipv4Address ("10.3.0.0"), Ipv4Mask ("/16"), Ipv4Address ("192.168.2.2"), 2);
+  routing->AddNetworkRouteTo (Ipv4Address ("10.3.0.0"), Ipv4Mask ("/16"), Ipv4Address ("192.168.1.2"), 1);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "10.3.0.1"), dev[2], "first equal cost route not used");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Incremental route updates give the same routes as a full recomputation
+ *
+ * A ring of five routers n0..n4 with a host n5 on n2.  The n0-n1 link goes
+ * down and up again; after each change the routes from UpdateRoutingTables
+ * are compared with the ones of RecomputeRoutingTables.
+ */
+class Ipv4GlobalRoutingIncrementalTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingIncrementalTestCase ();
+
+private:
+  /**
+   * \brief Print the global routes of all the nodes
+   * \return one sorted line per route
+   */
+  std::string GetRoutes (void);
+
+  virtual void DoRun (void);
+
+  NodeContainer m_nodes; //!< the nodes
+};
+
+Ipv4GlobalRoutingIncrementalTestCase::Ipv4GlobalRoutingIncrementalTestCase ()
+  : TestCase ("Global routing incremental updates after link changes")
+{
+}
+
+std::string
+Ipv4GlobalRoutingIncrementalTestCase::GetRoutes (void)
+{
+  std::vector<std::string> lines;
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> routing = m_nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      for (uint32_t j = 0; j < routing->GetNRoutes (); j++)
+        {
+          std::ostringstream line;
+          line << "n" << i << " " << *routing->GetRoute (j);
+          lines.push_back (line.str ());
+        }
+    }
+  std::sort (lines.begin (), lines.end ());
+  std::ostringstream routes;
+  for (std::size_t i = 0; i < lines.size (); i++)
+    {
+      routes << lines[i] << std::endl;
+    }
+  return routes.str ();
+}
+
+void
+Ipv4GlobalRoutingIncrementalTestCase::DoRun (void)
+{
+  m_nodes.Create (6);
+  InternetStackHelper internet;
+  Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+  internet.SetRoutingHelper (ipv4RoutingHelper);
+  internet.Install (m_nodes);
+
+  SimpleNetDeviceHelper simpleHelper;
+  simpleHelper.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.252");
+  Ipv4InterfaceContainer link01;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      NodeContainer pair (m_nodes.Get (i < 5 ? i : 2), m_nodes.Get (i < 5 ? (i + 1) % 5 : 5));
+      Ipv4InterfaceContainer interfaces = ipv4.Assign (simpleHelper.Install (pair));
+      ipv4.NewNetwork ();
+      if (i == 0)
+        {
+          link01 = interfaces;
+        }
+    }
+
+  Ipv4GlobalRoutingHelper::SetIncrementalUpdates (true);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  std::string initial = GetRoutes ();
+
+  Ptr<Node> n0 = m_nodes.Get (0);
+  uint32_t interface = link01.Get (0).second;
+  Ipv4GlobalRoutingHelper::SetInterfaceDown (n0, interface);
+  std::string incremental = GetRoutes ();
+  NS_TEST_ASSERT_MSG_NE (incremental, initial, "Routes did not change when the link went down");
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  NS_TEST_ASSERT_MSG_EQ (incremental, GetRoutes (), "Incremental update differs from recomputation after link down");
+
+  Ipv4GlobalRoutingHelper::SetInterfaceUp (n0, interface);
+  incremental = GetRoutes ();
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  NS_TEST_ASSERT_MSG_EQ (incremental, GetRoutes (), "Incremental update differs from recomputation after link up");
+  NS_TEST_ASSERT_MSG_EQ (incremental, initial, "Routes not restored when the link came back");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -1267,6 +1459,8 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite ()
     AddTestCase (new TwoBridgeTest, TestCase::QUICK);
     AddTestCase (new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase (new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingLongestPrefixTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingIncrementalTestCase, TestCase::QUICK);
   }
 
 static Ipv4GlobalRoutingTestSuite g_globalRoutingTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,284 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-bbr.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpBbrTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Testing the model and the state machine of TcpBbr
+ *
+ * The path is a bottleneck of a given rate and a propagation delay. Each
+ * round is acknowledged by a single ACK: the sender puts in flight what
+ * the window and the pacing rate allow, the bottleneck delivers at most
+ * the BDP and queues the rest, which delays the ACK.
+ *
+ * After the given number of rounds, BBR must be in the expected state,
+ * with an estimate of the bandwidth close to the rate of the bottleneck.
+ */
+class TcpBbrTest : public TestCase
+{
+public:
+  /**
+   * \brief Constructor.
+   * \param rate Rate of the bottleneck.
+   * \param rtt Propagation RTT.
+   * \param rounds Number of rounds.
+   * \param rttIncrease Increase of the RTT after the first rounds.
+   * \param state Expected state after the rounds.
+   * \param name Test description.
+   */
+  TcpBbrTest (DataRate rate, Time rtt, uint32_t rounds, Time rttIncrease,
+              TcpBbr::BbrMode_t state, const std::string &name);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Receive the ACK of a round, and send the next one.
+   */
+  void Ack (void);
+
+  /**
+   * \brief Check the state of BBR.
+   */
+  void Check (void);
+
+  DataRate m_rate;        //!< Rate of the bottleneck.
+  Time m_rtt;             //!< Propagation RTT.
+  uint32_t m_rounds;      //!< Number of rounds.
+  Time m_rttIncrease;     //!< Increase of the RTT after the first rounds.
+  TcpBbr::BbrMode_t m_expectedState; //!< Expected state after the rounds.
+  uint32_t m_round;       //!< Current round.
+  uint32_t m_inFlight;    //!< Bytes sent in the current round.
+  Time m_currentRtt;      //!< RTT of the current round.
+  Ptr<TcpSocketState> m_state;  //!< TCP socket state.
+  Ptr<TcpBbr> m_cong;     //!< The congestion control under test.
+  bool m_probeRttSeen;    //!< True if PROBE_RTT was entered.
+  uint32_t m_probeRttCwnd; //!< Max cWnd while in PROBE_RTT.
+};
+
+TcpBbrTest::TcpBbrTest (DataRate rate, Time rtt, uint32_t rounds, Time rttIncrease,
+                        TcpBbr::BbrMode_t state, const std::string &name)
+  : TestCase (name),
+    m_rate (rate),
+    m_rtt (rtt),
+    m_rounds (rounds),
+    m_rttIncrease (rttIncrease),
+    m_expectedState (state),
+    m_round (0),
+    m_inFlight (0),
+    m_probeRttSeen (false),
+    m_probeRttCwnd (0)
+{
+}
+
+void
+TcpBbrTest::DoRun ()
+{
+  m_state = CreateObject<TcpSocketState> ();
+  m_state->m_segmentSize = 1000;
+  m_state->m_initialCWnd = 10;
+  m_state->m_cWnd = 10 * 1000;
+  m_state->m_ssThresh = UINT32_MAX;
+  m_state->m_lastAckedSeq = SequenceNumber32 (1);
+  m_state->m_highTxMark = SequenceNumber32 (1 + m_state->m_cWnd);
+
+  m_cong = CreateObject <TcpBbr> ();
+  m_cong->AssignStreams (1);
+
+  m_inFlight = m_state->m_cWnd;
+  m_currentRtt = m_rtt;
+  m_state->m_bytesInFlight = m_inFlight;
+
+  Simulator::Schedule (m_rtt, &TcpBbrTest::Ack, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+TcpBbrTest::Ack ()
+{
+  // The propagation delay increases after the first rounds
+  Time propagation = m_round > 20 ? m_rtt + m_rttIncrease : m_rtt;
+  uint32_t bdp = static_cast<uint32_t> (m_rate * propagation / 8);
+  uint32_t segmentSize = m_state->m_segmentSize;
+
+  // The bottleneck delivers at most its BDP in a round
+  uint32_t delivered = std::min (m_inFlight, std::max (bdp, segmentSize));
+  uint32_t segmentsAcked = std::max (delivered / segmentSize, 1U);
+  m_state->m_lastAckedSeq = m_state->m_highTxMark;
+
+  m_cong->PktsAcked (m_state, segmentsAcked, m_currentRtt);
+  m_cong->IncreaseWindow (m_state, segmentsAcked);
+
+  if (m_cong->m_state == TcpBbr::BBR_PROBE_RTT)
+    {
+      m_probeRttSeen = true;
+      m_probeRttCwnd = std::max (m_probeRttCwnd, m_state->m_cWnd.Get ());
+    }
+
+  // Send what the window and the pacing rate allow, in whole segments
+  uint32_t paced = UINT32_MAX;
+  if (m_state->m_pacing)
+    {
+      paced = static_cast<uint32_t> (m_state->m_currentPacingRate * propagation / 8);
+      paced = (paced + segmentSize - 1) / segmentSize * segmentSize;
+    }
+  m_inFlight = std::min (m_state->m_cWnd.Get (), paced);
+  m_state->m_bytesInFlight = m_inFlight;
+  m_state->m_highTxMark = m_state->m_lastAckedSeq + m_inFlight;
+
+  // What exceeds the BDP waits in the queue of the bottleneck
+  m_currentRtt = propagation;
+  if (m_inFlight > bdp)
+    {
+      m_currentRtt = propagation + propagation * (static_cast<double> (m_inFlight - bdp) / bdp);
+    }
+
+  if (++m_round < m_rounds)
+    {
+      Simulator::Schedule (m_currentRtt, &TcpBbrTest::Ack, this);
+    }
+  else
+    {
+      Check ();
+    }
+}
+
+void
+TcpBbrTest::Check ()
+{
+  NS_TEST_ASSERT_MSG_EQ (m_cong->m_state, m_expectedState,
+                         "BBR is in " << TcpBbr::BbrModeName[m_cong->m_state]);
+  NS_TEST_ASSERT_MSG_EQ (m_cong->m_fullBwReached, true, "BBR has not filled the pipe");
+
+  double maxBw = m_cong->GetMaxBw ().GetBitRate ();
+  NS_TEST_ASSERT_MSG_EQ_TOL (maxBw, m_rate.GetBitRate (), m_rate.GetBitRate () * 0.05,
+                             "BBR has a wrong estimate of the bandwidth");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_cong->m_minRtt, m_rtt + m_rttIncrease, MilliSeconds (1),
+                             "BBR has a wrong estimate of the propagation delay");
+
+  NS_TEST_ASSERT_MSG_EQ (m_state->m_pacing, true, "BBR has not enabled pacing");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_state->m_currentPacingRate.GetBitRate (), 0.75 * maxBw,
+                               "BBR paces too slowly");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_state->m_currentPacingRate.GetBitRate (), 1.25 * maxBw,
+                               "BBR paces too fast");
+
+  uint32_t bdp = static_cast<uint32_t> (m_rate * (m_rtt + m_rttIncrease) / 8);
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_state->m_cWnd.Get (), 2 * bdp + 4 * m_state->m_segmentSize,
+                               "BBR has a window larger than twice the BDP");
+
+  if (!m_rttIncrease.IsZero ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_probeRttSeen, true, "BBR has not probed the RTT");
+      NS_TEST_ASSERT_MSG_EQ (m_probeRttCwnd, 4 * m_state->m_segmentSize,
+                             "BBR has not reduced the window in PROBE_RTT");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Testing the slow start threshold of TcpBbr on a loss
+ */
+class TcpBbrSsThreshTest : public TestCase
+{
+public:
+  /**
+   * \brief Constructor.
+   * \param cWnd Congestion window.
+   * \param bytesInFlight Bytes in flight at the loss.
+   * \param name Test description.
+   */
+  TcpBbrSsThreshTest (uint32_t cWnd, uint32_t bytesInFlight,
+                      const std::string &name);
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_cWnd;          //!< Congestion window.
+  uint32_t m_bytesInFlight; //!< Bytes in flight at the loss.
+};
+
+TcpBbrSsThreshTest::TcpBbrSsThreshTest (uint32_t cWnd, uint32_t bytesInFlight,
+                                        const std::string &name)
+  : TestCase (name),
+    m_cWnd (cWnd),
+    m_bytesInFlight (bytesInFlight)
+{
+}
+
+void
+TcpBbrSsThreshTest::DoRun ()
+{
+  Ptr<TcpSocketState> state = CreateObject<TcpSocketState> ();
+  state->m_segmentSize = 1000;
+  state->m_cWnd = m_cWnd;
+
+  Ptr<TcpBbr> cong = CreateObject <TcpBbr> ();
+  uint32_t ssThresh = cong->GetSsThresh (state, m_bytesInFlight);
+
+  NS_TEST_ASSERT_MSG_EQ (ssThresh, std::max (m_bytesInFlight, 2000U),
+                         "BBR does not conserve the packets in flight");
+  NS_TEST_ASSERT_MSG_EQ (cong->m_priorCwnd, m_cWnd, "BBR has not saved the window");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP Bbr TestSuite
+ */
+class TcpBbrTestSuite : public TestSuite
+{
+public:
+  TcpBbrTestSuite () : TestSuite ("tcp-bbr-test", UNIT)
+  {
+    AddTestCase (new TcpBbrTest (DataRate ("10Mbps"), MilliSeconds (100), 60, Time (0),
+                                 TcpBbr::BBR_PROBE_BW,
+                                 "Bbr test: 10 Mbps, 100 ms, startup to probe bandwidth"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpBbrTest (DataRate ("100Mbps"), MilliSeconds (20), 60, Time (0),
+                                 TcpBbr::BBR_PROBE_BW,
+                                 "Bbr test: 100 Mbps, 20 ms, startup to probe bandwidth"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpBbrTest (DataRate ("10Mbps"), MilliSeconds (100), 140, MilliSeconds (20),
+                                 TcpBbr::BBR_PROBE_BW,
+                                 "Bbr test: RTT increase, probe the RTT"),
+                 TestCase::QUICK);
+
+    AddTestCase (new TcpBbrSsThreshTest (20000, 15000,
+                                         "Bbr ssThresh test: packets in flight"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpBbrSsThreshTest (20000, 500,
+                                         "Bbr ssThresh test: minimum of two segments"),
+                 TestCase::QUICK);
+  }
+};
+
+static TcpBbrTestSuite g_tcpBbrTest; //!< Static variable for test initialization
@@ -0,0 +1,556 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-cubic.h"
+
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpCubicTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Testing the window increment on TcpCubic, at the start of an epoch
+ */
+class TcpCubicIncrementTest : public TestCase
+{
+public:
+  /**
+   * \brief Constructor.
+   * \param cWnd Congestion window.
+   * \param segmentSize Segment size.
+   * \param ssThresh Slow Start Threshold.
+   * \param segmentsAcked Number of segments acked.
+   * \param lastMaxCwnd Last max Cwnd.
+   * \param name Test description.
+   */
+  TcpCubicIncrementTest (uint32_t cWnd,
+                         uint32_t segmentSize,
+                         uint32_t ssThresh,
+                         uint32_t segmentsAcked,
+                         uint32_t lastMaxCwnd,
+                         const std::string &name);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Compute the number of ACKs needed to increment the window.
+   * \param cong The congestion control.
+   * \returns The ack counter.
+   */
+  uint32_t ExpectedCnt (Ptr<TcpCubic> cong);
+
+  /**
+   * \brief Execute the test.
+   */
+  void ExecuteTest (void);
+
+  uint32_t m_cWnd;        //!< Congestion window.
+  uint32_t m_segmentSize; //!< Segment size.
+  uint32_t m_ssThresh;    //!< Slow Start Threshold.
+  uint32_t m_segmentsAcked; //!< Number of segments acked.
+  uint32_t m_lastMaxCwnd;   //!< Last max Cwnd.
+  Ptr<TcpSocketState> m_state;  //!< TCP socket state.
+};
+
+TcpCubicIncrementTest::TcpCubicIncrementTest (uint32_t cWnd,
+                                              uint32_t segmentSize,
+                                              uint32_t ssThresh,
+                                              uint32_t segmentsAcked,
+                                              uint32_t lastMaxCwnd,
+                                              const std::string &name)
+  : TestCase (name),
+    m_cWnd (cWnd),
+    m_segmentSize (segmentSize),
+    m_ssThresh (ssThresh),
+    m_segmentsAcked (segmentsAcked),
+    m_lastMaxCwnd (lastMaxCwnd)
+{
+}
+
+void
+TcpCubicIncrementTest::DoRun ()
+{
+  m_state = CreateObject<TcpSocketState> ();
+
+  m_state->m_cWnd = m_cWnd;
+  m_state->m_segmentSize = m_segmentSize;
+  m_state->m_ssThresh = m_ssThresh;
+
+  Simulator::Schedule (Seconds (0.0), &TcpCubicIncrementTest::ExecuteTest, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+TcpCubicIncrementTest::ExecuteTest ()
+{
+  Ptr<TcpCubic> cong = CreateObject <TcpCubic> ();
+  cong->m_lastMaxCwnd = m_lastMaxCwnd;
+
+  uint32_t segCwnd = m_cWnd / m_segmentSize;
+
+  if (m_cWnd < m_ssThresh)
+    {
+      cong->IncreaseWindow (m_state, m_segmentsAcked);
+      NS_TEST_ASSERT_MSG_EQ (m_state->m_cWnd.Get (), (segCwnd + 1) * m_segmentSize,
+                             "Cubic has not increment cWnd by one segment in slow start");
+      return;
+    }
+
+  uint32_t cnt = ExpectedCnt (cong);
+  cong->IncreaseWindow (m_state, m_segmentsAcked);
+
+  if (m_segmentsAcked >= cnt)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_state->m_cWnd.Get (), segCwnd * m_segmentSize + m_segmentSize,
+                             "Cubic has not increment cWnd");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_state->m_cWnd.Get (), segCwnd * m_segmentSize,
+                             "Cubic has modified cWnd");
+    }
+}
+
+uint32_t
+TcpCubicIncrementTest::ExpectedCnt (Ptr<TcpCubic> cong)
+{
+  uint32_t segCwnd = m_cWnd / m_segmentSize;
+  DoubleValue c, beta;
+  UintegerValue cntClamp;
+  cong->GetAttribute ("C", c);
+  cong->GetAttribute ("Beta", beta);
+  cong->GetAttribute ("CntClamp", cntClamp);
+
+  // The epoch starts now, and no RTT was measured: t = 0
+  uint32_t bicTarget = segCwnd;
+  if (m_lastMaxCwnd > segCwnd)
+    {
+      double k = std::pow ((m_lastMaxCwnd - segCwnd) / c.Get (), 1 / 3.);
+      uint32_t delta = c.Get () * std::pow (k, 3);
+      bicTarget = m_lastMaxCwnd > delta ? m_lastMaxCwnd - delta : 0;
+    }
+
+  uint32_t cnt = 100 * segCwnd;
+  if (bicTarget > segCwnd)
+    {
+      cnt = segCwnd / (bicTarget - segCwnd);
+    }
+  if (m_lastMaxCwnd == 0 && cnt > cntClamp.Get ())
+    {
+      cnt = cntClamp.Get ();
+    }
+
+  uint32_t renoCnt = std::max<uint32_t> (segCwnd * (1 + beta.Get ()) / (3 * (1 - beta.Get ())), 1);
+  uint32_t ackCnt = m_segmentsAcked;
+  uint32_t tcpCwnd = segCwnd;
+  while (ackCnt > renoCnt)
+    {
+      ackCnt -= renoCnt;
+      tcpCwnd++;
+    }
+  if (tcpCwnd > segCwnd)
+    {
+      cnt = std::min (cnt, segCwnd / (tcpCwnd - segCwnd));
+    }
+
+  return std::max (cnt, 2U);
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Testing the cubic growth of the window of TcpCubic over time
+ *
+ * The window starts below W_max, after a loss: it must stay under W_max
+ * until K seconds, then probe beyond it.
+ */
+class TcpCubicGrowthTest : public TestCase
+{
+public:
+  /**
+   * \brief Constructor.
+   * \param segCwnd Congestion window, in segments.
+   * \param lastMaxCwnd Last max Cwnd, in segments.
+   * \param name Test description.
+   */
+  TcpCubicGrowthTest (uint32_t segCwnd, uint32_t lastMaxCwnd,
+                      const std::string &name);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Receive an ACK of one segment.
+   */
+  void Ack (void);
+
+  /**
+   * \brief Check the window against W_max.
+   * \param above True if the window must be above W_max.
+   */
+  void Check (bool above);
+
+  uint32_t m_segCwnd;     //!< Initial congestion window, in segments.
+  uint32_t m_lastMaxCwnd; //!< Last max Cwnd.
+  Ptr<TcpSocketState> m_state;  //!< TCP socket state.
+  Ptr<TcpCubic> m_cong;   //!< The congestion control under test.
+};
+
+TcpCubicGrowthTest::TcpCubicGrowthTest (uint32_t segCwnd, uint32_t lastMaxCwnd,
+                                        const std::string &name)
+  : TestCase (name),
+    m_segCwnd (segCwnd),
+    m_lastMaxCwnd (lastMaxCwnd)
+{
+}
+
+void
+TcpCubicGrowthTest::DoRun ()
+{
+  m_state = CreateObject<TcpSocketState> ();
+  m_state->m_segmentSize = 1000;
+  m_state->m_cWnd = m_segCwnd * 1000;
+  m_state->m_ssThresh = m_segCwnd * 1000;
+
+  m_cong = CreateObject <TcpCubic> ();
+  m_cong->m_lastMaxCwnd = m_lastMaxCwnd;
+
+  DoubleValue c;
+  m_cong->GetAttribute ("C", c);
+  double k = std::pow ((m_lastMaxCwnd - m_segCwnd) / c.Get (), 1 / 3.);
+
+  // One ACK every 10 ms
+  for (Time t = Seconds (0); t < Seconds (k + 3); t += MilliSeconds (10))
+    {
+      Simulator::Schedule (t, &TcpCubicGrowthTest::Ack, this);
+    }
+  Simulator::Schedule (Seconds (k - 1), &TcpCubicGrowthTest::Check, this, false);
+  Simulator::Schedule (Seconds (k + 3), &TcpCubicGrowthTest::Check, this, true);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+TcpCubicGrowthTest::Ack ()
+{
+  m_cong->IncreaseWindow (m_state, 1);
+}
+
+void
+TcpCubicGrowthTest::Check (bool above)
+{
+  uint32_t segCwnd = m_state->m_cWnd / m_state->m_segmentSize;
+  NS_TEST_ASSERT_MSG_GT (segCwnd, m_segCwnd, "Cubic has not grown cWnd");
+  if (above)
+    {
+      NS_TEST_ASSERT_MSG_GT (segCwnd, m_lastMaxCwnd,
+                             "Cubic has not probed beyond W_max after K");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (segCwnd, m_lastMaxCwnd,
+                                   "Cubic has grown beyond W_max before K");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Testing the congestion avoidance decrement on TcpCubic
+ */
+class TcpCubicDecrementTest : public TestCase
+{
+public:
+  /**
+   * \brief Constructor.
+   * \param cWnd Congestion window.
+   * \param segmentSize Segment size.
+   * \param fastConvergence Fast convergence.
+   * \param lastMaxCwnd Last max Cwnd.
+   * \param name Test description.
+   */
+  TcpCubicDecrementTest (uint32_t cWnd,
+                         uint32_t segmentSize,
+                         BooleanValue fastConvergence,
+                         uint32_t lastMaxCwnd,
+                         const std::string &name);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Execute the test.
+   */
+  void ExecuteTest (void);
+
+  uint32_t m_cWnd;        //!< Congestion window.
+  uint32_t m_segmentSize; //!< Segment size.
+  BooleanValue m_fastConvergence;   //!< Fast convergence.
+  uint32_t m_lastMaxCwnd;   //!< Last max Cwnd.
+  Ptr<TcpSocketState> m_state;  //!< TCP socket state.
+};
+
+TcpCubicDecrementTest::TcpCubicDecrementTest (uint32_t cWnd,
+                                              uint32_t segmentSize,
+                                              BooleanValue fastConvergence,
+                                              uint32_t lastMaxCwnd,
+                                              const std::string &name)
+  : TestCase (name),
+    m_cWnd (cWnd),
+    m_segmentSize (segmentSize),
+    m_fastConvergence (fastConvergence),
+    m_lastMaxCwnd (lastMaxCwnd)
+{
+}
+
+void
+TcpCubicDecrementTest::DoRun ()
+{
+  m_state = CreateObject<TcpSocketState> ();
+
+  m_state->m_cWnd = m_cWnd;
+  m_state->m_segmentSize = m_segmentSize;
+
+  Simulator::Schedule (Seconds (0.0), &TcpCubicDecrementTest::ExecuteTest, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+TcpCubicDecrementTest::ExecuteTest ()
+{
+  Ptr<TcpCubic> cong = CreateObject <TcpCubic> ();
+  cong->m_lastMaxCwnd = m_lastMaxCwnd;
+  cong->SetAttribute ("FastConvergence", m_fastConvergence);
+
+  uint32_t segCwnd = m_cWnd / m_segmentSize;
+  uint32_t retSsThresh = cong->GetSsThresh (m_state, m_state->m_cWnd);
+  uint32_t retLastMaxCwnd = cong->m_lastMaxCwnd;
+
+  DoubleValue beta;
+  cong->GetAttribute ("Beta", beta);
+
+  uint32_t lastMaxCwnd;
+
+  if (segCwnd < m_lastMaxCwnd && m_fastConvergence.Get ())
+    {
+      lastMaxCwnd = (segCwnd * (1 + beta.Get ())) / 2;
+      NS_TEST_ASSERT_MSG_EQ (retLastMaxCwnd, lastMaxCwnd,
+                             "Cubic has not updated lastMaxCwnd during fast convergence");
+    }
+  else
+    {
+      lastMaxCwnd = segCwnd;
+      NS_TEST_ASSERT_MSG_EQ (retLastMaxCwnd, lastMaxCwnd,
+                             "Cubic has not reset lastMaxCwnd to current cwnd (in segments)");
+    }
+
+  uint32_t ssThresh = std::max (static_cast<uint32_t> (segCwnd * beta.Get ()), 2U) * m_segmentSize;
+  NS_TEST_ASSERT_MSG_EQ (retSsThresh, ssThresh,
+                         "Cubic has not updated ssThresh");
+  NS_TEST_ASSERT_MSG_EQ (cong->m_epochStart, Time::Min (),
+                         "Cubic has not ended the epoch");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Testing the exit from slow start of HyStart in TcpCubic
+ *
+ * A first round measures the minimum RTT, the ACKs of a second round have
+ * another RTT and spacing.
+ */
+class TcpCubicHystartTest : public TestCase
+{
+public:
+  /**
+   * \brief Constructor.
+   * \param rtt RTT of the second round.
+   * \param ackSpacing Spacing of the ACKs of the second round.
+   * \param exit True if HyStart must end the slow start.
+   * \param name Test description.
+   */
+  TcpCubicHystartTest (Time rtt, Time ackSpacing, bool exit,
+                       const std::string &name);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Start a round.
+   * \param lastAckedSeq Sequence acked by the first ACK of the round.
+   */
+  void StartRound (uint32_t lastAckedSeq);
+
+  /**
+   * \brief Receive an ACK.
+   * \param rtt RTT sample of the ACK.
+   */
+  void Ack (Time rtt);
+
+  /**
+   * \brief Check the slow start threshold.
+   */
+  void Check (void);
+
+  Time m_rtt;             //!< RTT of the second round.
+  Time m_ackSpacing;      //!< Spacing of the ACKs of the second round.
+  bool m_exit;            //!< True if HyStart must end the slow start.
+  Ptr<TcpSocketState> m_state;  //!< TCP socket state.
+  Ptr<TcpCubic> m_cong;   //!< The congestion control under test.
+};
+
+TcpCubicHystartTest::TcpCubicHystartTest (Time rtt, Time ackSpacing, bool exit,
+                                          const std::string &name)
+  : TestCase (name),
+    m_rtt (rtt),
+    m_ackSpacing (ackSpacing),
+    m_exit (exit)
+{
+}
+
+void
+TcpCubicHystartTest::DoRun ()
+{
+  m_state = CreateObject<TcpSocketState> ();
+  m_state->m_segmentSize = 1000;
+  m_state->m_cWnd = 20 * 1000;
+  m_state->m_ssThresh = UINT32_MAX;
+
+  m_cong = CreateObject <TcpCubic> ();
+
+  // First round: 10 ACKs, 10 ms apart, with an RTT of 100 ms
+  Simulator::Schedule (Seconds (0), &TcpCubicHystartTest::StartRound, this, 1);
+  for (uint32_t i = 1; i <= 10; ++i)
+    {
+      Simulator::Schedule (MilliSeconds (10 * i), &TcpCubicHystartTest::Ack,
+                           this, MilliSeconds (100));
+    }
+
+  // Second round: 60 ACKs with the RTT and spacing under test
+  Time start = MilliSeconds (200);
+  Simulator::Schedule (start, &TcpCubicHystartTest::StartRound, this, 100000);
+  for (uint32_t i = 1; i <= 60; ++i)
+    {
+      Simulator::Schedule (start + m_ackSpacing * i, &TcpCubicHystartTest::Ack,
+                           this, m_rtt);
+    }
+  Simulator::Schedule (start + m_ackSpacing * 61, &TcpCubicHystartTest::Check, this);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+TcpCubicHystartTest::StartRound (uint32_t lastAckedSeq)
+{
+  m_state->m_lastAckedSeq = SequenceNumber32 (lastAckedSeq);
+  m_state->m_highTxMark = SequenceNumber32 (lastAckedSeq + 50000);
+  // Keep the window constant, only the threshold matters
+  uint32_t cWnd = m_state->m_cWnd;
+  m_cong->IncreaseWindow (m_state, 1);
+  m_state->m_cWnd = cWnd;
+}
+
+void
+TcpCubicHystartTest::Ack (Time rtt)
+{
+  m_cong->PktsAcked (m_state, 1, rtt);
+}
+
+void
+TcpCubicHystartTest::Check ()
+{
+  if (m_exit)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_state->m_ssThresh.Get (), m_state->m_cWnd.Get (),
+                             "HyStart has not ended the slow start");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_state->m_ssThresh.Get (), UINT32_MAX,
+                             "HyStart has ended the slow start");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP Cubic TestSuite
+ */
+class TcpCubicTestSuite : public TestSuite
+{
+public:
+  TcpCubicTestSuite () : TestSuite ("tcp-cubic-test", UNIT)
+  {
+    AddTestCase (new TcpCubicIncrementTest (10 * 536, 536, 20 * 536, 1, 0,
+                                            "Cubic increment test: slow start"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpCubicIncrementTest (10 * 536, 536, 9 * 536, 30, 0,
+                                            "Cubic increment test: no loss yet & enough ACKs received"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpCubicIncrementTest (10 * 536, 536, 9 * 536, 5, 0,
+                                            "Cubic increment test: no loss yet & not enough ACKs received"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpCubicIncrementTest (20 * 1446, 1446, 15 * 1446, 5, 100,
+                                            "Cubic increment test: concave region & not enough ACKs received"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpCubicIncrementTest (20 * 1446, 1446, 15 * 1446, 40, 20,
+                                            "Cubic increment test: TCP-friendly region & enough ACKs received"),
+                 TestCase::QUICK);
+
+    AddTestCase (new TcpCubicGrowthTest (50, 100,
+                                         "Cubic growth test: concave then convex"),
+                 TestCase::QUICK);
+
+    AddTestCase (new TcpCubicDecrementTest (5 * 1446, 1446, true, 10,
+                                            "Cubic decrement test: fast convergence & cwnd less than lastMaxCwnd"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpCubicDecrementTest (5 * 1446, 1446, false, 10,
+                                            "Cubic decrement test: not in fast convergence"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpCubicDecrementTest (15 * 1446, 1446, true, 10,
+                                            "Cubic decrement test: fast convergence & cwnd greater than lastMaxCwnd"),
+                 TestCase::QUICK);
+
+    AddTestCase (new TcpCubicHystartTest (MilliSeconds (100), MilliSeconds (10), false,
+                                          "Cubic HyStart test: no delay increase, no ACK train"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpCubicHystartTest (MilliSeconds (120), MilliSeconds (10), true,
+                                          "Cubic HyStart test: delay increase"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpCubicHystartTest (MilliSeconds (100), MilliSeconds (1), true,
+                                          "Cubic HyStart test: ACK train"),
+                 TestCase::QUICK);
+  }
+};
+
+static TcpCubicTestSuite g_tcpCubicTest; //!< Static variable for test initialization
@@ -44,6 +44,14 @@ private:
    * \brief Test the SACK list update.
    */
   void TestUpdateSACKList ();
+  /**
+   * \brief Test a segment which fills several holes at once.
+   */
+  void TestFillHoles ();
+  /**
+   * \brief Test the reassembly of a buffer which tracks byte counts only.
+   */
+  void TestVirtualPayload ();
 };
 
 TcpRxBufferTestCase::TcpRxBufferTestCase ()
@@ -55,6 +63,8 @@ void
 TcpRxBufferTestCase::DoRun ()
 {
   TestUpdateSACKList ();
+  TestFillHoles ();
+  TestVirtualPayload ();
 }
 
 void
@@ -338,6 +348,131 @@ TcpRxBufferTestCase::TestUpdateSACKList ()
                          "SACK list should contain no element");
 }
 
+/**
+ * \brief Create a segment whose bytes are a function of their sequence number
+ * \param seq sequence number of the first byte
+ * \param size size of the segment
+ * \return the segment
+ */
+static Ptr<Packet>
+CreateSegment (uint32_t seq, uint32_t size)
+{
+  std::vector<uint8_t> data (size);
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      data[i] = (seq + i) % 251;
+    }
+  return Create<Packet> (data.data (), size);
+}
+
+void
+TcpRxBufferTestCase::TestFillHoles ()
+{
+  TcpRxBuffer rxBuf;
+  rxBuf.SetNextRxSequence (SequenceNumber32 (1));
+  TcpHeader h;
+
+  h.SetSequenceNumber (SequenceNumber32 (1));
+  rxBuf.Add (CreateSegment (1, 100), h);
+  for (uint32_t seq = 201; seq < 700; seq += 200)
+    {
+      h.SetSequenceNumber (SequenceNumber32 (seq));
+      rxBuf.Add (CreateSegment (seq, 100), h);
+    }
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.GetSackList ().size (), 3,
+                         "SACK list should contain three elements");
+
+  // Covers three blocks and fills the four holes around them, but not the
+  // one after NextRxSequence
+  h.SetSequenceNumber (SequenceNumber32 (151));
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Add (CreateSegment (151, 600), h), true,
+                         "New data not buffered");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 700, "Buffer occupancy differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), SequenceNumber32 (101),
+                         "Sequence number differs from expected");
+  TcpOptionSack::SackList sackList = rxBuf.GetSackList ();
+  NS_TEST_ASSERT_MSG_EQ (sackList.size (), 1,
+                         "SACK list should contain one element");
+  NS_TEST_ASSERT_MSG_EQ (sackList.begin ()->first, SequenceNumber32 (151),
+                         "SACK block different than expected");
+  NS_TEST_ASSERT_MSG_EQ (sackList.begin ()->second, SequenceNumber32 (751),
+                         "SACK block different than expected");
+
+  // Nothing new
+  h.SetSequenceNumber (SequenceNumber32 (201));
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Add (CreateSegment (201, 300), h), false,
+                         "Duplicate data buffered");
+
+  h.SetSequenceNumber (SequenceNumber32 (101));
+  rxBuf.Add (CreateSegment (101, 50), h);
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), SequenceNumber32 (751),
+                         "Sequence number differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), 750, "Available bytes differ from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.GetSackList ().size (), 0,
+                         "SACK list should contain no element");
+
+  Ptr<Packet> out = rxBuf.Extract (750);
+  NS_TEST_ASSERT_MSG_EQ (out->GetSize (), 750, "Extracted size differs from expected");
+  std::vector<uint8_t> data (750);
+  out->CopyData (data.data (), 750);
+  for (uint32_t i = 0; i < 750; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (data[i]), (1 + i) % 251,
+                             "Data not extracted in sequence order");
+    }
+}
+
+void
+TcpRxBufferTestCase::TestVirtualPayload ()
+{
+  TcpRxBuffer rxBuf;
+  rxBuf.SetVirtualPayload (true);
+  rxBuf.SetNextRxSequence (SequenceNumber32 (1));
+  Ptr<Packet> p = Create<Packet> (100);
+  TcpHeader h;
+
+  // Two out of order segments, one block
+  h.SetSequenceNumber (SequenceNumber32 (301));
+  rxBuf.Add (p, h);
+  h.SetSequenceNumber (SequenceNumber32 (201));
+  rxBuf.Add (p, h);
+
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 200, "Buffer occupancy differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), 0, "Nothing should be available");
+  TcpOptionSack::SackList sackList = rxBuf.GetSackList ();
+  NS_TEST_ASSERT_MSG_EQ (sackList.size (), 1,
+                         "SACK list should contain one element");
+  NS_TEST_ASSERT_MSG_EQ (sackList.begin ()->first, SequenceNumber32 (201),
+                         "SACK block different than expected");
+  NS_TEST_ASSERT_MSG_EQ (sackList.begin ()->second, SequenceNumber32 (401),
+                         "SACK block different than expected");
+
+  // In order, partly overlapping a duplicate
+  h.SetSequenceNumber (SequenceNumber32 (1));
+  rxBuf.Add (p, h);
+  h.SetSequenceNumber (SequenceNumber32 (51));
+  rxBuf.Add (Create<Packet> (150), h);
+
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), SequenceNumber32 (401),
+                         "Sequence number differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 400, "Buffer occupancy differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), 400, "Available bytes differ from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.GetSackList ().size (), 0,
+                         "SACK list should contain no element");
+
+  // Partial extraction, then a new in order segment after the remainder
+  Ptr<Packet> out = rxBuf.Extract (150);
+  NS_TEST_ASSERT_MSG_EQ (out->GetSize (), 150, "Extracted size differs from expected");
+  h.SetSequenceNumber (SequenceNumber32 (401));
+  rxBuf.Add (p, h);
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Available (), 350, "Available bytes differ from expected");
+  out = rxBuf.Extract (1000);
+  NS_TEST_ASSERT_MSG_EQ (out->GetSize (), 350, "Extracted size differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 0, "Buffer occupancy differs from expected");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), SequenceNumber32 (501),
+                         "Sequence number differs from expected");
+}
+
 void
 TcpRxBufferTestCase::DoTeardown ()
 {
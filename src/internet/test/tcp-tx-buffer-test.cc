@@ -49,6 +49,8 @@ private:
   void TestTransmittedBlock ();
   /** \brief Test the generation of the "next" block */
   void TestNextSeg ();
+  /** \brief Test a buffer which tracks byte counts only */
+  void TestVirtualPayload ();
 };
 
 TcpTxBufferTestCase::TcpTxBufferTestCase ()
@@ -81,6 +83,8 @@ TcpTxBufferTestCase::DoRun ()
                        &TcpTxBufferTestCase::TestTransmittedBlock, this);
   Simulator::Schedule (Seconds (0.0),
                        &TcpTxBufferTestCase::TestNextSeg, this);
+  Simulator::Schedule (Seconds (0.0),
+                       &TcpTxBufferTestCase::TestVirtualPayload, this);
 
   Simulator::Run ();
   Simulator::Destroy ();
@@ -342,6 +346,58 @@ TcpTxBufferTestCase::TestTransmittedBlock ()
 {
 }
 
+void
+TcpTxBufferTestCase::TestVirtualPayload ()
+{
+  // The same operations on a buffer which keeps the data and on one which
+  // does not must give segments of the same size
+  TcpTxBuffer txBuf[2];
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      txBuf[i].SetVirtualPayload (i == 1);
+      txBuf[i].SetHeadSequence (SequenceNumber32 (1));
+      txBuf[i].SetSegmentSize (100);
+      txBuf[i].Add (Create<Packet> (250));
+      txBuf[i].Add (Create<Packet> (250));
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf[1].Size (), 500, "TxBuf miscalculates size");
+  NS_TEST_ASSERT_MSG_EQ (txBuf[1].SizeFromSequence (SequenceNumber32 (1)), 500,
+                         "TxBuf miscalculates size");
+
+  // new data across the boundary of the two Add, a partial retransmission
+  // which splits a segment, a retransmission which merges them, and a
+  // request capped to what the application gave
+  uint32_t numBytes[] = { 100, 300, 50, 400, 300 };
+  uint32_t seq[] = { 1, 101, 151, 1, 401 };
+  for (uint32_t k = 0; k < 5; ++k)
+    {
+      Ptr<Packet> ret = txBuf[0].CopyFromSequence (numBytes[k], SequenceNumber32 (seq[k]));
+      Ptr<Packet> virt = txBuf[1].CopyFromSequence (numBytes[k], SequenceNumber32 (seq[k]));
+      NS_TEST_ASSERT_MSG_EQ (virt->GetSize (), ret->GetSize (),
+                             "Returned packet has different size than in the normal mode");
+      NS_TEST_ASSERT_MSG_EQ (txBuf[1].BytesInFlight (), txBuf[0].BytesInFlight (),
+                             "TxBuf miscalculates size of in flight segments");
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf[1].SizeFromSequence (SequenceNumber32 (501)), 0,
+                         "TxBuf miscalculates size");
+
+  // partial and total acknowledgment
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      txBuf[i].DiscardUpTo (SequenceNumber32 (151));
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf[1].Size (), 350, "TxBuf miscalculates size");
+  NS_TEST_ASSERT_MSG_EQ (txBuf[1].BytesInFlight (), txBuf[0].BytesInFlight (),
+                         "TxBuf miscalculates size of in flight segments");
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      txBuf[i].DiscardUpTo (SequenceNumber32 (501));
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf[1].Size (), 0, "TxBuf miscalculates size");
+  NS_TEST_ASSERT_MSG_EQ (txBuf[1].BytesInFlight (), 0,
+                         "TxBuf miscalculates size of in flight segments");
+}
+
 void
 TcpTxBufferTestCase::DoTeardown ()
 {
@@ -25,6 +25,7 @@
 #include "ns3/packet-socket-address.h"
 #include "ns3/point-to-point-helper.h"
 #include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-static-routing-helper.h"
 #include "ns3/ipv6-static-routing-helper.h"
 #include "ns3/icmpv6-l4-protocol.h"
 #include "ns3/epc-enb-application.h"
@@ -68,6 +69,7 @@ NoBackhaulEpcHelper::NoBackhaulEpcHelper ()
   m_x2Ipv4AddressHelper.SetBase ("12.0.0.0", "255.255.255.252");
   m_s11Ipv4AddressHelper.SetBase ("13.0.0.0", "255.255.255.252");
   m_s5Ipv4AddressHelper.SetBase ("14.0.0.0", "255.255.255.252");
+  m_mecIpv4AddressHelper.SetBase ("15.0.0.0", "255.255.255.252");
 
   // we use a /8 net for all UEs
   m_uePgwAddressHelper.SetBase ("7.0.0.0", "255.0.0.0");
@@ -271,6 +273,21 @@ NoBackhaulEpcHelper::GetTypeId (void)
                    UintegerValue (3000),
                    MakeUintegerAccessor (&NoBackhaulEpcHelper::m_x2LinkMtu),
                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("MecLinkDataRate",
+                   "The data rate to be used for the next link between an eNB and a MEC node to be created",
+                   DataRateValue (DataRate ("10Gb/s")),
+                   MakeDataRateAccessor (&NoBackhaulEpcHelper::m_mecLinkDataRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("MecLinkDelay",
+                   "The delay to be used for the next link between an eNB and a MEC node to be created",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&NoBackhaulEpcHelper::m_mecLinkDelay),
+                   MakeTimeChecker ())
+    .AddAttribute ("MecLinkMtu",
+                   "The MTU of the next link between an eNB and a MEC node to be created",
+                   UintegerValue (1500),
+                   MakeUintegerAccessor (&NoBackhaulEpcHelper::m_mecLinkMtu),
+                   MakeUintegerChecker<uint16_t> ())
     .AddAttribute ("X2LinkPcapPrefix",
                    "Prefix for Pcap generated by X2 link",
                    StringValue ("x2"),
@@ -567,4 +584,54 @@ NoBackhaulEpcHelper::AddS1Interface (Ptr<Node> enb, Ipv4Address enbAddress, Ipv4
   enbApp->SetS1apSapMme (m_mmeApp->GetS1apSapMme ());
 }
 
+Ipv4Address
+NoBackhaulEpcHelper::AddMecNode (Ptr<Node> enb, Ptr<Node> mec)
+{
+  NS_LOG_FUNCTION (this << enb << mec);
+
+  Ptr<EpcEnbApplication> enbApp = enb->GetApplication (0)->GetObject<EpcEnbApplication> ();
+  NS_ASSERT_MSG (enbApp != 0, "EpcEnbApplication not available");
+  NS_ASSERT_MSG (mec->GetObject<Ipv4> () != 0, "the MEC node needs an IPv4 stack");
+
+  PointToPointHelper p2ph;
+  p2ph.SetDeviceAttribute ("DataRate", DataRateValue (m_mecLinkDataRate));
+  p2ph.SetDeviceAttribute ("Mtu", UintegerValue (m_mecLinkMtu));
+  p2ph.SetChannelAttribute ("Delay", TimeValue (m_mecLinkDelay));
+  NetDeviceContainer enbMecDevices = p2ph.Install (enb, mec);
+  Ptr<NetDevice> enbDev = enbMecDevices.Get (0);
+  Ptr<NetDevice> mecDev = enbMecDevices.Get (1);
+
+  // only the MEC side gets an address: the eNB side is not an IPv4
+  // interface, its packets are bridged by the EpcEnbApplication as the
+  // ones of the LTE radio interface
+  m_mecIpv4AddressHelper.NewNetwork ();
+  Ipv4InterfaceContainer mecIpIfaces = m_mecIpv4AddressHelper.Assign (NetDeviceContainer (mecDev));
+  Ipv4Address mecAddress = mecIpIfaces.GetAddress (0);
+  Ipv4Mask mecMask = mec->GetObject<Ipv4> ()->GetAddress (mecIpIfaces.Get (0).second, 0).GetMask ();
+
+  // the UEs, on the network of the TUN device, are reached through the eNB
+  Ipv4InterfaceAddress tunAddress = m_pgw->GetObject<Ipv4> ()->GetAddress (1, 0);
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> mecStaticRouting = ipv4RoutingHelper.GetStaticRouting (mec->GetObject<Ipv4> ());
+  mecStaticRouting->AddNetworkRouteTo (tunAddress.GetLocal ().CombineMask (tunAddress.GetMask ()),
+                                       tunAddress.GetMask (), mecIpIfaces.Get (0).second);
+
+  // create the MEC socket for the ENB
+  Ptr<Socket> enbMecSocket = Socket::CreateSocket (enb, TypeId::LookupByName ("ns3::PacketSocketFactory"));
+  PacketSocketAddress enbMecSocketBindAddress;
+  enbMecSocketBindAddress.SetSingleDevice (enbDev->GetIfIndex ());
+  enbMecSocketBindAddress.SetProtocol (Ipv4L3Protocol::PROT_NUMBER);
+  int retval = enbMecSocket->Bind (enbMecSocketBindAddress);
+  NS_ASSERT (retval == 0);
+  PacketSocketAddress enbMecSocketConnectAddress;
+  enbMecSocketConnectAddress.SetPhysicalAddress (enbDev->GetBroadcast ());
+  enbMecSocketConnectAddress.SetSingleDevice (enbDev->GetIfIndex ());
+  enbMecSocketConnectAddress.SetProtocol (Ipv4L3Protocol::PROT_NUMBER);
+  retval = enbMecSocket->Connect (enbMecSocketConnectAddress);
+  NS_ASSERT (retval == 0);
+
+  enbApp->AddLocalBreakout (enbMecSocket, mecAddress, mecMask);
+  return mecAddress;
+}
+
 } // namespace ns3
@@ -78,6 +78,20 @@ public:
   virtual Ipv4Address GetUeDefaultGatewayAddress ();
   virtual Ipv6Address GetUeDefaultGatewayAddress6 ();
 
+  /**
+   * \brief Attach a MEC node to an eNB, with a local breakout
+   *
+   * A PointToPoint link is created between the eNB and the MEC node,
+   * which must have an IPv4 stack. The packets of the UEs addressed to
+   * the MEC node are served by the eNB through this link, without the
+   * GTP-U tunnel and the backhaul towards the SGW/PGW.
+   *
+   * \param enb the eNB
+   * \param mec the MEC node
+   * \return the IPv4 address of the MEC node
+   */
+  virtual Ipv4Address AddMecNode (Ptr<Node> enb, Ptr<Node> mec);
+
 protected:
   /**
    * \brief DoAddX2Interface: Call AddX2Interface on top of the Enb device pointers
@@ -230,6 +244,26 @@ private:
    */
   uint16_t m_x2LinkMtu;
 
+  /**
+   * helper to assign addresses to the NetDevices of the MEC nodes
+   */
+  Ipv4AddressHelper m_mecIpv4AddressHelper;
+
+  /**
+   * The data rate to be used for the next MEC link to be created
+   */
+  DataRate m_mecLinkDataRate;
+
+  /**
+   * The delay to be used for the next MEC link to be created
+   */
+  Time     m_mecLinkDelay;
+
+  /**
+   * The MTU of the next MEC link to be created
+   */
+  uint16_t m_mecLinkMtu;
+
   /**
    * Enable PCAP generation for X2 link
    */
@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "video-aware-scheduler-helper.h"
+
+#include <ns3/log.h>
+#include <ns3/config.h>
+#include <ns3/node.h>
+#include <ns3/lte-ue-net-device.h>
+#include <ns3/lte-ue-rrc.h>
+#include <ns3/lte-enb-net-device.h>
+#include <ns3/component-carrier-enb.h>
+#include <ns3/video-aware-ff-mac-scheduler.h>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VideoAwareSchedulerHelper");
+
+NS_OBJECT_ENSURE_REGISTERED (VideoAwareSchedulerHelper);
+
+VideoAwareSchedulerHelper::VideoAwareSchedulerHelper ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+VideoAwareSchedulerHelper::~VideoAwareSchedulerHelper ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+VideoAwareSchedulerHelper::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VideoAwareSchedulerHelper")
+    .SetParent<Object> ()
+    .SetGroupName ("Lte")
+    .AddConstructor<VideoAwareSchedulerHelper> ()
+  ;
+  return tid;
+}
+
+void
+VideoAwareSchedulerHelper::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_schedulers.clear ();
+  Object::DoDispose ();
+}
+
+void
+VideoAwareSchedulerHelper::Install (NetDeviceContainer ueDevices, NetDeviceContainer enbDevices)
+{
+  NS_LOG_FUNCTION (this);
+
+  for (NetDeviceContainer::Iterator i = enbDevices.Begin (); i != enbDevices.End (); ++i)
+    {
+      Ptr<LteEnbNetDevice> enbDevice = DynamicCast<LteEnbNetDevice> (*i);
+      NS_ABORT_MSG_IF (enbDevice == 0, "VideoAwareSchedulerHelper: not an LteEnbNetDevice");
+      std::map<uint8_t, Ptr<ComponentCarrierBaseStation> > ccMap = enbDevice->GetCcMap ();
+      for (std::map<uint8_t, Ptr<ComponentCarrierBaseStation> >::iterator cc = ccMap.begin (); cc != ccMap.end (); ++cc)
+        {
+          Ptr<ComponentCarrierEnb> ccEnb = DynamicCast<ComponentCarrierEnb> (cc->second);
+          Ptr<VideoAwareFfMacScheduler> scheduler = DynamicCast<VideoAwareFfMacScheduler> (ccEnb->GetFfMacScheduler ());
+          if (scheduler == 0)
+            {
+              NS_LOG_WARN ("cell " << cc->second->GetCellId () << " does not use the VideoAwareFfMacScheduler");
+              continue;
+            }
+          m_schedulers[cc->second->GetCellId ()] = scheduler;
+        }
+    }
+
+  for (NetDeviceContainer::Iterator i = ueDevices.Begin (); i != ueDevices.End (); ++i)
+    {
+      Ptr<LteUeNetDevice> ueDevice = DynamicCast<LteUeNetDevice> (*i);
+      NS_ABORT_MSG_IF (ueDevice == 0, "VideoAwareSchedulerHelper: not an LteUeNetDevice");
+      // the trace is found by name, the lte module does not depend on the DASH client
+      std::ostringstream path;
+      path << "/NodeList/" << ueDevice->GetNode ()->GetId ()
+           << "/ApplicationList/*/$ns3::HttpClientDashApplication::MultimediaConsumer/BufferLevel";
+      Config::ConnectWithoutContext (path.str (),
+                                     MakeBoundCallback (&VideoAwareSchedulerHelper::BufferLevelCallback,
+                                                        Ptr<VideoAwareSchedulerHelper> (this), ueDevice));
+    }
+}
+
+void
+VideoAwareSchedulerHelper::BufferLevelCallback (Ptr<VideoAwareSchedulerHelper> helper, Ptr<LteUeNetDevice> ueDevice,
+                                                double bufferLevel, uint64_t bitrate)
+{
+  Ptr<LteUeRrc> rrc = ueDevice->GetRrc ();
+  if (rrc->GetState () != LteUeRrc::CONNECTED_NORMALLY)
+    {
+      // the next report will reach the cell of the UE
+      return;
+    }
+  std::map<uint16_t, Ptr<VideoAwareFfMacScheduler> >::iterator it = helper->m_schedulers.find (rrc->GetCellId ());
+  if (it != helper->m_schedulers.end ())
+    {
+      NS_LOG_LOGIC ("IMSI " << ueDevice->GetImsi () << " RNTI " << rrc->GetRnti () << " buffer " << bufferLevel << " s, bitrate " << bitrate);
+      it->second->SetUeVideoState (rrc->GetRnti (), Seconds (bufferLevel), bitrate);
+    }
+}
+
+} // namespace ns3
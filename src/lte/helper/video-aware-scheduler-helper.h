@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef VIDEO_AWARE_SCHEDULER_HELPER_H
+#define VIDEO_AWARE_SCHEDULER_HELPER_H
+
+#include <ns3/object.h>
+#include <ns3/net-device-container.h>
+#include <map>
+
+namespace ns3 {
+
+class LteUeNetDevice;
+class VideoAwareFfMacScheduler;
+
+/**
+ * \ingroup lte
+ *
+ * Feeds the VideoAwareFfMacScheduler of the eNBs with the buffer levels
+ * of the DASH players of the UEs.
+ *
+ * The BufferLevel trace of the MultimediaConsumer of each UE is
+ * connected to the scheduler of the cell serving the UE at the time of
+ * the report, under the current RNTI of the UE. The eNBs must use the
+ * VideoAwareFfMacScheduler (see LteHelper::SetSchedulerType), and the
+ * DASH clients must be installed before.
+ */
+class VideoAwareSchedulerHelper : public Object
+{
+public:
+  VideoAwareSchedulerHelper ();
+  virtual ~VideoAwareSchedulerHelper ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Report the buffer levels of the players of some UEs to the schedulers of some eNBs
+   *
+   * \param ueDevices the LteUeNetDevices of the UEs
+   * \param enbDevices the LteEnbNetDevices of the eNBs
+   */
+  void Install (NetDeviceContainer ueDevices, NetDeviceContainer enbDevices);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * Trace sink of the BufferLevel of a DASH player
+   *
+   * \param helper the helper
+   * \param ueDevice the device of the UE of the player
+   * \param bufferLevel the buffer level, in seconds
+   * \param bitrate the bitrate of the requested representation, in bit/s
+   */
+  static void BufferLevelCallback (Ptr<VideoAwareSchedulerHelper> helper, Ptr<LteUeNetDevice> ueDevice,
+                                   double bufferLevel, uint64_t bitrate);
+
+  std::map<uint16_t, Ptr<VideoAwareFfMacScheduler> > m_schedulers; ///< the schedulers, by cell ID
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_AWARE_SCHEDULER_HELPER_H */
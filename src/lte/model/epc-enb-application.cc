@@ -24,6 +24,7 @@
 #include "ns3/log.h"
 #include "ns3/mac48-address.h"
 #include "ns3/ipv4.h"
+#include "ns3/ipv4-header.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/uinteger.h"
 
@@ -72,6 +73,10 @@ EpcEnbApplication::GetTypeId (void)
                      "Receive data packets from S1-U Net Device",
                      MakeTraceSourceAccessor (&EpcEnbApplication::m_rxS1uSocketPktTrace),
                      "ns3::EpcEnbApplication::RxTracedCallback")
+    .AddTraceSource ("RxFromMec",
+                     "Receive data packets from the MEC node of the local breakout",
+                     MakeTraceSourceAccessor (&EpcEnbApplication::m_rxMecSocketPktTrace),
+                     "ns3::EpcEnbApplication::RxTracedCallback")
     ;
   return tid;
 }
@@ -83,6 +88,7 @@ EpcEnbApplication::DoDispose (void)
   m_lteSocket = 0;
   m_lteSocket6 = 0;
   m_s1uSocket = 0;
+  m_mecSocket = 0;
   delete m_s1SapProvider;
   delete m_s1apSapEnb;
 }
@@ -116,6 +122,18 @@ EpcEnbApplication::AddS1Interface (Ptr<Socket> s1uSocket, Ipv4Address enbAddress
 }
 
 
+void
+EpcEnbApplication::AddLocalBreakout (Ptr<Socket> mecSocket, Ipv4Address mecAddress, Ipv4Mask mecMask)
+{
+  NS_LOG_FUNCTION (this << mecSocket << mecAddress << mecMask);
+
+  m_mecSocket = mecSocket;
+  m_mecSocket->SetRecvCallback (MakeCallback (&EpcEnbApplication::RecvFromMecSocket, this));
+  m_mecAddress = mecAddress.CombineMask (mecMask);
+  m_mecMask = mecMask;
+}
+
+
 EpcEnbApplication::~EpcEnbApplication (void)
 {
   NS_LOG_FUNCTION (this);
@@ -211,6 +229,18 @@ EpcEnbApplication::DoUeContextRelease (uint16_t rnti)
       m_rbidTeidMap.erase (rntiIt);
       NS_LOG_INFO ("RNTI: " << rntiIt->first << " erased");
     }
+  for (std::map<Ipv4Address, EpsFlowId_t>::iterator ueIt = m_ueAddressRbidMap.begin ();
+       ueIt != m_ueAddressRbidMap.end (); )
+    {
+      if (ueIt->second.m_rnti == rnti)
+        {
+          m_ueAddressRbidMap.erase (ueIt++);
+        }
+      else
+        {
+          ++ueIt;
+        }
+    }
 }
 
 void 
@@ -292,10 +322,58 @@ EpcEnbApplication::RecvFromLteSocket (Ptr<Socket> socket)
       NS_ASSERT (bidIt != rntiIt->second.end ());
       uint32_t teid = bidIt->second;
       m_rxLteSocketPktTrace (packet->Copy ());
+      if (m_mecSocket && SendToMecSocket (packet, rnti, bid))
+        {
+          return;
+        }
       SendToS1uSocket (packet, teid);
     }
 }
 
+bool
+EpcEnbApplication::SendToMecSocket (Ptr<Packet> packet, uint16_t rnti, uint8_t bid)
+{
+  uint8_t ipType;
+  packet->CopyData (&ipType, 1);
+  if (((ipType >> 4) & 0x0f) != 0x04)
+    {
+      return false;
+    }
+  Ipv4Header ipv4Header;
+  packet->PeekHeader (ipv4Header);
+  if (!m_mecMask.IsMatch (ipv4Header.GetDestination (), m_mecAddress))
+    {
+      return false;
+    }
+  NS_LOG_LOGIC ("local breakout of packet from " << ipv4Header.GetSource () << " to " << ipv4Header.GetDestination ());
+  // the downlink packets of the MEC node carry no TEID: remember the
+  // bearer of the UE to send them back on
+  m_ueAddressRbidMap[ipv4Header.GetSource ()] = EpsFlowId_t (rnti, bid);
+  int sentBytes = m_mecSocket->Send (packet);
+  NS_ASSERT (sentBytes > 0);
+  return true;
+}
+
+void 
+EpcEnbApplication::RecvFromMecSocket (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);  
+  NS_ASSERT (socket == m_mecSocket);
+  Ptr<Packet> packet = socket->Recv ();
+  Ipv4Header ipv4Header;
+  packet->PeekHeader (ipv4Header);
+  std::map<Ipv4Address, EpsFlowId_t>::iterator it = m_ueAddressRbidMap.find (ipv4Header.GetDestination ());
+  if (it == m_ueAddressRbidMap.end ())
+    {
+      NS_LOG_WARN ("UE " << ipv4Header.GetDestination () << " unknown to the local breakout at cell id " << m_cellId << ", discarding packet");
+    }
+  else
+    {
+      m_rxMecSocketPktTrace (packet->Copy ());
+      SendToLteSocket (packet, it->second.m_rnti, it->second.m_bid);
+    }
+}
+
 void 
 EpcEnbApplication::RecvFromS1uSocket (Ptr<Socket> socket)
 {
@@ -23,6 +23,7 @@
 #define EPC_ENB_APPLICATION_H
 
 #include <ns3/address.h>
+#include <ns3/ipv4-address.h>
 #include <ns3/socket.h>
 #include <ns3/virtual-net-device.h>
 #include <ns3/traced-callback.h>
@@ -86,6 +87,20 @@ public:
    */
   void AddS1Interface (Ptr<Socket> s1uSocket, Ipv4Address enbAddress, Ipv4Address sgwAddress);
 
+  /**
+   * Add a local breakout towards a MEC node attached to the eNB
+   *
+   * The IPv4 packets of the UEs addressed to the MEC network are sent
+   * to the MEC node as they are, instead of through the S1-U tunnel, and
+   * the packets of the MEC node are sent back to the radio bearer that
+   * last carried a packet of the UE to the MEC node.
+   *
+   * \param mecSocket the socket to be used to send/receive IPv4 packets to/from the MEC node
+   * \param mecAddress the network of the MEC node
+   * \param mecMask the mask of the network of the MEC node
+   */
+  void AddLocalBreakout (Ptr<Socket> mecSocket, Ipv4Address mecAddress, Ipv4Mask mecMask);
+
 
   /**
    * Destructor
@@ -135,6 +150,13 @@ public:
    */
   void RecvFromS1uSocket (Ptr<Socket> socket);
 
+  /** 
+   * Method to be assigned to the recv callback of the MEC socket. It is called when the eNB receives a data packet from the MEC node that is to be forwarded to the UE.
+   * 
+   * \param socket pointer to the MEC socket
+   */
+  void RecvFromMecSocket (Ptr<Socket> socket);
+
   /**
    * TracedCallback signature for data Packet reception event.
    *
@@ -245,6 +267,16 @@ private:
    */
   void SendToS1uSocket (Ptr<Packet> packet, uint32_t teid);
 
+  /** 
+   * Send a packet to the MEC node if it is addressed to its network
+   * 
+   * \param packet packet to be sent
+   * \param rnti maps to enbUeS1Id
+   * \param bid the EPS Bearer IDentifier
+   * \return true if the packet was sent to the MEC node
+   */
+  bool SendToMecSocket (Ptr<Packet> packet, uint16_t rnti, uint8_t bid);
+
 
   /** 
    * internal method used for the actual setup of the S1 Bearer
@@ -280,6 +312,26 @@ private:
    */
   Ipv4Address m_sgwS1uAddress;
 
+  /**
+   * raw packet socket to send and receive the packets to and from the MEC node, if any
+   */
+  Ptr<Socket> m_mecSocket;
+
+  /**
+   * network of the MEC node, served through the local breakout
+   */
+  Ipv4Address m_mecAddress;
+
+  /**
+   * mask of the network of the MEC node
+   */
+  Ipv4Mask m_mecMask;
+
+  /**
+   * map telling for each UE address the RNTI,BID which last carried a packet to the MEC node
+   */
+  std::map<Ipv4Address, EpsFlowId_t> m_ueAddressRbidMap;
+
   /**
    * map of maps telling for each RNTI and BID the corresponding  S1-U TEID
    * 
@@ -336,6 +388,11 @@ private:
    * \brief Callback to trace RX (reception) data packets from S1-U Socket.
    */ 
   TracedCallback<Ptr<Packet> > m_rxS1uSocketPktTrace;
+
+  /**
+   * \brief Callback to trace RX (reception) data packets from the MEC Socket.
+   */ 
+  TracedCallback<Ptr<Packet> > m_rxMecSocketPktTrace;
 };
 
 } //namespace ns3
@@ -152,6 +152,9 @@ private:
 
   Ptr<const SpectrumValue> m_noise; ///< the noise value
 
+  SpectrumValue m_interf; ///< interference plus noise of the last chunk, reused to avoid allocations
+  SpectrumValue m_sinr; ///< SINR of the last chunk, reused to avoid allocations
+
   Time m_lastChangeTime;     /**< the time of the last change in
                                 m_TotalPower */
 
@@ -289,10 +289,22 @@ PfFfMacScheduler::DoCschedUeReleaseReq (const struct FfMacCschedSapProvider::Csc
     {
       m_nextRntiUl = 0;
     }
+  NotifyUeRelease (params.m_rnti);
 
   return;
 }
 
+double
+PfFfMacScheduler::GetDlMetricWeight (uint16_t rnti, double averagedThroughput) const
+{
+  return 1.0;
+}
+
+void
+PfFfMacScheduler::NotifyUeRelease (uint16_t rnti)
+{
+}
+
 
 void
 PfFfMacScheduler::DoSchedDlRlcBufferReq (const struct FfMacSchedSapProvider::SchedDlRlcBufferReqParameters& params)
@@ -996,7 +1008,8 @@ PfFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
                           achievableRate += ((m_amc->GetDlTbSizeFromMcs (mcs, rbgSize) / 8) / 0.001);   // = TB size / TTI
                         }
 
-                      double rcqi = achievableRate / (*it).second.lastAveragedThroughput;
+                      double rcqi = GetDlMetricWeight ((*it).first, (*it).second.lastAveragedThroughput)
+                        * achievableRate / (*it).second.lastAveragedThroughput;
                       NS_LOG_INFO (this << " RNTI " << (*it).first << " MCS " << (uint32_t)mcs << " achievableRate " << achievableRate << " avgThr " << (*it).second.lastAveragedThroughput << " RCQI " << rcqi);
 
                       if (rcqi > rcqiMax)
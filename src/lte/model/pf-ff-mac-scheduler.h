@@ -115,6 +115,26 @@ public:
    */
   void TransmissionModeConfigurationUpdate (uint16_t rnti, uint8_t txMode);
 
+protected:
+  /**
+   * \brief Weight of the PF metric of a UE in the downlink
+   *
+   * Derived schedulers can favour some UEs over the proportional fair
+   * share. The default weight is 1.
+   *
+   * \param rnti the RNTI of the UE
+   * \param averagedThroughput the averaged throughput of the UE, in bytes/s
+   * \return the weight of the metric
+   */
+  virtual double GetDlMetricWeight (uint16_t rnti, double averagedThroughput) const;
+
+  /**
+   * \brief Notify that a UE was released, to derived schedulers keeping a state per UE
+   *
+   * \param rnti the RNTI of the UE
+   */
+  virtual void NotifyUeRelease (uint16_t rnti);
+
 private:
   //
   // Implementation of the CSCHED API primitives
@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/double.h>
+#include <ns3/video-aware-ff-mac-scheduler.h>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VideoAwareFfMacScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (VideoAwareFfMacScheduler);
+
+VideoAwareFfMacScheduler::VideoAwareFfMacScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+VideoAwareFfMacScheduler::~VideoAwareFfMacScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+VideoAwareFfMacScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VideoAwareFfMacScheduler")
+    .SetParent<PfFfMacScheduler> ()
+    .SetGroupName ("Lte")
+    .AddConstructor<VideoAwareFfMacScheduler> ()
+    .AddAttribute ("BufferThreshold",
+                   "The buffer level below which a video player gets priority over the PF share",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&VideoAwareFfMacScheduler::m_bufferThreshold),
+                   MakeTimeChecker ())
+    .AddAttribute ("StallWeight",
+                   "The additional weight of the PF metric of a video player with an empty buffer",
+                   DoubleValue (4.0),
+                   MakeDoubleAccessor (&VideoAwareFfMacScheduler::m_stallWeight),
+                   MakeDoubleChecker<double> (0.0))
+  ;
+  return tid;
+}
+
+void
+VideoAwareFfMacScheduler::SetUeVideoState (uint16_t rnti, Time bufferLevel, uint64_t bitrate)
+{
+  NS_LOG_FUNCTION (this << rnti << bufferLevel.GetSeconds () << bitrate);
+  VideoState state;
+  state.bufferLevel = bufferLevel;
+  state.bitrate = bitrate;
+  m_videoState[rnti] = state;
+}
+
+double
+VideoAwareFfMacScheduler::GetDlMetricWeight (uint16_t rnti, double averagedThroughput) const
+{
+  std::map<uint16_t, VideoState>::const_iterator it = m_videoState.find (rnti);
+  if (it == m_videoState.end () || it->second.bufferLevel >= m_bufferThreshold)
+    {
+      return 1.0;
+    }
+  double urgency = 1.0 - it->second.bufferLevel.GetSeconds () / m_bufferThreshold.GetSeconds ();
+  // the averaged throughput is in bytes/s
+  double deficit = (it->second.bitrate / 8.0) / averagedThroughput;
+  return 1.0 + m_stallWeight * urgency * std::max (1.0, deficit);
+}
+
+void
+VideoAwareFfMacScheduler::NotifyUeRelease (uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+  m_videoState.erase (rnti);
+}
+
+} // namespace ns3
@@ -0,0 +1,86 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef VIDEO_AWARE_FF_MAC_SCHEDULER_H
+#define VIDEO_AWARE_FF_MAC_SCHEDULER_H
+
+#include <ns3/pf-ff-mac-scheduler.h>
+#include <ns3/nstime.h>
+#include <map>
+
+namespace ns3 {
+
+/**
+ * \ingroup ff-api
+ * \brief A Proportional Fair scheduler which favours the video players close to a stall
+ *
+ * The downlink PF metric of a UE which reported the state of its video
+ * player with SetUeVideoState is weighted by
+ *
+ *   1 + StallWeight * u * max (1, r / T)
+ *
+ * where u = max (0, 1 - b / BufferThreshold) is the urgency of the
+ * player with b seconds of video in its buffer, r is the bitrate of the
+ * representation it downloads and T the averaged throughput of the UE.
+ * A player with a full buffer is scheduled as by the PF scheduler, and
+ * an empty one gets StallWeight times more resources, or more if its
+ * throughput is below the bitrate of its video.
+ *
+ * The UEs which did not report their video state are scheduled as by
+ * the PF scheduler.
+ */
+class VideoAwareFfMacScheduler : public PfFfMacScheduler
+{
+public:
+  VideoAwareFfMacScheduler ();
+  virtual ~VideoAwareFfMacScheduler ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Report the state of the video player of a UE
+   *
+   * \param rnti the RNTI of the UE
+   * \param bufferLevel the buffer level of the player
+   * \param bitrate the bitrate of the representation being downloaded, in bit/s
+   */
+  void SetUeVideoState (uint16_t rnti, Time bufferLevel, uint64_t bitrate);
+
+protected:
+  // inherited from PfFfMacScheduler
+  virtual double GetDlMetricWeight (uint16_t rnti, double averagedThroughput) const;
+  virtual void NotifyUeRelease (uint16_t rnti);
+
+private:
+  /// The last reported state of a video player
+  struct VideoState
+  {
+    Time bufferLevel;  ///< buffer level of the player
+    uint64_t bitrate;  ///< bitrate of the representation, in bit/s
+  };
+
+  std::map<uint16_t, VideoState> m_videoState; ///< state of the players, by RNTI
+  Time m_bufferThreshold; ///< buffer level below which a player gets priority
+  double m_stallWeight;   ///< additional weight of an empty buffer
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_AWARE_FF_MAC_SCHEDULER_H */
@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *
+ * SimpleMultithreaded builds a chain of routers, each with its own leaf
+ * nodes, and places every router with its leaves in its own partition.
+ * The partitions are run by the threads of this process with the
+ * MultithreadedSimulatorImpl; no MPI installation is needed.
+ *
+ *        PARTITION 0   |   PARTITION 1   |   PARTITION n-1
+ *                      |                 |
+ *   l0 ---\            |                 |            /--- l2n-2
+ *          r0 ---------|------ r1 -------|----- rn-1
+ *   l1 ---/            |     /    \      |            \--- l2n-1
+ *                      |   l2      l3    |
+ *
+ * Each left leaf of a router sends to the right leaf of the router at
+ * the other end of the chain, so every flow crosses the partitions.
+ * The packets moved between two partitions are serialized, as in a
+ * distributed simulation, and rescheduled in the thread of the receiver.
+ *
+ * Run with --parallel=0 to simulate the same partitioned topology with
+ * the default sequential simulator: the sinks receive the same packets.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/on-off-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("SimpleMultithreaded");
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t threads = 4;
+  bool parallel = true;
+  bool tracing = false;
+
+  // Parse command line
+  CommandLine cmd;
+  cmd.AddValue ("threads", "Number of partitions, each run by a thread", threads);
+  cmd.AddValue ("parallel", "Run the partitions in parallel", parallel);
+  cmd.AddValue ("tracing", "Enable pcap tracing", tracing);
+  cmd.Parse (argc, argv);
+
+  if (threads < 1)
+    {
+      std::cout << "This simulation requires at least 1 thread." << std::endl;
+      return 1;
+    }
+
+  // The interface must be enabled before the links are created, so that
+  // the point-to-point helper puts remote channels between the partitions.
+  if (parallel)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::MultithreadedSimulatorImpl"));
+      MpiInterface::Enable (&argc, &argv);
+    }
+
+  // Some default values
+  Config::SetDefault ("ns3::OnOffApplication::PacketSize", UintegerValue (512));
+  Config::SetDefault ("ns3::OnOffApplication::DataRate", StringValue ("1Mbps"));
+
+  // One router and two leaves in each partition
+  NodeContainer routerNodes;
+  NodeContainer leftLeafNodes;
+  NodeContainer rightLeafNodes;
+  for (uint32_t i = 0; i < threads; ++i)
+    {
+      routerNodes.Create (1, i);
+      leftLeafNodes.Create (1, i);
+      rightLeafNodes.Create (1, i);
+    }
+
+  PointToPointHelper routerLink;
+  routerLink.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  routerLink.SetChannelAttribute ("Delay", StringValue ("5ms"));
+
+  PointToPointHelper leafLink;
+  leafLink.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  leafLink.SetChannelAttribute ("Delay", StringValue ("2ms"));
+
+  NetDeviceContainer routerDevices;
+  for (uint32_t i = 0; i + 1 < threads; ++i)
+    {
+      routerDevices.Add (routerLink.Install (routerNodes.Get (i), routerNodes.Get (i + 1)));
+    }
+
+  NetDeviceContainer leftLeafDevices;
+  NetDeviceContainer rightLeafDevices;
+  for (uint32_t i = 0; i < threads; ++i)
+    {
+      leftLeafDevices.Add (leafLink.Install (leftLeafNodes.Get (i), routerNodes.Get (i)));
+      rightLeafDevices.Add (leafLink.Install (rightLeafNodes.Get (i), routerNodes.Get (i)));
+    }
+
+  InternetStackHelper stack;
+  stack.InstallAll ();
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  for (uint32_t i = 0; i < routerDevices.GetN (); i += 2)
+    {
+      NetDeviceContainer ndc;
+      ndc.Add (routerDevices.Get (i));
+      ndc.Add (routerDevices.Get (i + 1));
+      address.Assign (ndc);
+      address.NewNetwork ();
+    }
+
+  Ipv4InterfaceContainer rightLeafInterfaces;
+  for (uint32_t i = 0; i < leftLeafDevices.GetN (); i += 2)
+    {
+      NetDeviceContainer ndc;
+      ndc.Add (leftLeafDevices.Get (i));
+      ndc.Add (leftLeafDevices.Get (i + 1));
+      address.Assign (ndc);
+      address.NewNetwork ();
+
+      ndc = NetDeviceContainer ();
+      ndc.Add (rightLeafDevices.Get (i));
+      ndc.Add (rightLeafDevices.Get (i + 1));
+      rightLeafInterfaces.Add (address.Assign (ndc).Get (0));
+      address.NewNetwork ();
+    }
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  if (tracing == true)
+    {
+      routerLink.EnablePcap ("simple-multithreaded-router", routerDevices, true);
+    }
+
+  // A packet sink on each right leaf
+  uint16_t port = 50000;
+  Address sinkLocalAddress (InetSocketAddress (Ipv4Address::GetAny (), port));
+  PacketSinkHelper sinkHelper ("ns3::UdpSocketFactory", sinkLocalAddress);
+  ApplicationContainer sinkApps = sinkHelper.Install (rightLeafNodes);
+  sinkApps.Start (Seconds (1.0));
+  sinkApps.Stop (Seconds (5));
+
+  // Each left leaf sends to the right leaf at the other end of the chain
+  OnOffHelper clientHelper ("ns3::UdpSocketFactory", Address ());
+  clientHelper.SetAttribute
+    ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+  clientHelper.SetAttribute
+    ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
+
+  ApplicationContainer clientApps;
+  for (uint32_t i = 0; i < threads; ++i)
+    {
+      AddressValue remoteAddress
+        (InetSocketAddress (rightLeafInterfaces.GetAddress (threads - 1 - i), port));
+      clientHelper.SetAttribute ("Remote", remoteAddress);
+      clientApps.Add (clientHelper.Install (leftLeafNodes.Get (i)));
+    }
+  clientApps.Start (Seconds (1.0));
+  clientApps.Stop (Seconds (5));
+
+  Simulator::Stop (Seconds (5));
+  Simulator::Run ();
+
+  for (uint32_t i = 0; i < threads; ++i)
+    {
+      Ptr<PacketSink> sink = DynamicCast<PacketSink> (sinkApps.Get (i));
+      std::cout << "Sink " << i << " received " << sink->GetTotalRx ()
+                << " bytes" << std::endl;
+    }
+
+  Simulator::Destroy ();
+  if (parallel)
+    {
+      MpiInterface::Disable ();
+    }
+  return 0;
+}
@@ -66,6 +66,13 @@ public:
    * When running a sequential simulation this will return a size of 1.
    */
   static uint32_t GetSize ();
+  /**
+   * \param systemId system identification of a node
+   * \return true if the nodes of this system are simulated in this process
+   *
+   * When running a sequential simulation all the nodes are local.
+   */
+  static bool IsLocal (uint32_t systemId);
   /**
    * \return true if parallel communication is enabled
    */
@@ -0,0 +1,669 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "multithreaded-simulator-impl.h"
+#include "shared-memory-interface.h"
+#include "mpi-receiver.h"
+
+#include "ns3/simulator.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/channel.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+/** Time of the next event of a partition without events. */
+static const uint64_t NO_EVENT = std::numeric_limits<uint64_t>::max ();
+
+thread_local MultithreadedSimulatorImpl::Partition *MultithreadedSimulatorImpl::g_current = 0;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Mpi")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_nextThread (1),
+    m_lookAhead (NO_EVENT),
+    m_stopTs (NO_EVENT),
+    m_stop (false),
+    m_running (false),
+    m_barrierCount (0),
+    m_barrierGeneration (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<std::vector<RemoteEvent> >::iterator i = m_mailboxes.begin ();
+       i != m_mailboxes.end (); ++i)
+    {
+      for (std::vector<RemoteEvent>::iterator j = i->begin (); j != i->end (); ++j)
+        {
+          j->impl->Unref ();
+        }
+    }
+  m_mailboxes.clear ();
+  for (std::vector<Partition>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      while (!i->events->IsEmpty ())
+        {
+          Scheduler::Event next = i->events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      i->events = 0;
+    }
+  m_partitions.clear ();
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (true)
+    {
+      Ptr<EventImpl> ev;
+      {
+        CriticalSection cs (m_destroyMutex);
+        if (m_destroyEvents.empty ())
+          {
+            break;
+          }
+        ev = m_destroyEvents.front ().PeekEventImpl ();
+        m_destroyEvents.pop_front ();
+      }
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  NS_ASSERT_MSG (!m_running, "Can't change the scheduler while running");
+  m_schedulerFactory = schedulerFactory;
+  for (std::vector<Partition>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+      while (!i->events->IsEmpty ())
+        {
+          scheduler->Insert (i->events->RemoveNext ());
+        }
+      i->events = scheduler;
+    }
+}
+
+MultithreadedSimulatorImpl::Partition &
+MultithreadedSimulatorImpl::GetCurrent (void) const
+{
+  if (g_current != 0)
+    {
+      return *g_current;
+    }
+  NS_ASSERT_MSG (!m_running, "Simulator called from a thread which runs no partition");
+  return const_cast<MultithreadedSimulatorImpl *> (this)->GetPartition (0);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionId (uint32_t context) const
+{
+  // The table of the last Run also serves at Simulator::Destroy, when
+  // the node list may already be disposed of.
+  if (context < m_nodePartition.size ())
+    {
+      return m_nodePartition[context];
+    }
+  if (m_running)
+    {
+      return g_current != 0 ? g_current->id : 0;
+    }
+  if (context < NodeList::GetNNodes ())
+    {
+      return NodeList::GetNode (context)->GetSystemId ();
+    }
+  return 0;
+}
+
+MultithreadedSimulatorImpl::Partition &
+MultithreadedSimulatorImpl::GetPartition (uint32_t id)
+{
+  while (id >= m_partitions.size ())
+    {
+      NS_ASSERT_MSG (!m_running, "Can't add a partition while running");
+      Partition partition;
+      partition.id = m_partitions.size ();
+      partition.events = m_schedulerFactory.Create<Scheduler> ();
+      // uids are allocated from 4.
+      // uid 0 is "invalid" events
+      // uid 1 is "now" events
+      // uid 2 is "destroy" events
+      partition.uid = 4;
+      // before ::Run is entered, the currentUid will be zero
+      partition.currentUid = 0;
+      partition.currentTs = 0;
+      partition.currentContext = Simulator::NO_CONTEXT;
+      partition.eventCount = 0;
+      partition.unscheduledEvents = 0;
+      partition.nextTs = NO_EVENT;
+      m_partitions.push_back (partition);
+    }
+  return m_partitions[id];
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::FindPartition (const EventId &id) const
+{
+  // While running, the events of a partition are only handled by the
+  // thread of this partition.
+  uint32_t partition = g_current != 0 ? g_current->id : GetPartitionId (id.GetContext ());
+  if (partition >= m_partitions.size ())
+    {
+      return 0;
+    }
+  return const_cast<Partition *> (&m_partitions[partition]);
+}
+
+Scheduler::EventKey
+MultithreadedSimulatorImpl::Insert (Partition &partition, uint64_t ts,
+                                    uint32_t context, EventImpl *event)
+{
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  ev.key.m_uid = partition.uid;
+  partition.uid++;
+  partition.unscheduledEvents++;
+  partition.events->Insert (ev);
+  return ev.key;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return g_current != 0 ? g_current->id : 0;
+}
+
+void
+MultithreadedSimulatorImpl::CalculateLookAhead (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t size = std::max<uint32_t> (m_partitions.size (), 1);
+  m_nodePartition.assign (NodeList::GetNNodes (), 0);
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      m_nodePartition[(*i)->GetId ()] = (*i)->GetSystemId ();
+      size = std::max (size, (*i)->GetSystemId () + 1);
+    }
+
+  m_lookAhead = NO_EVENT;
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+        {
+          Ptr<NetDevice> localNetDevice = node->GetDevice (j);
+          Ptr<Channel> channel = localNetDevice->GetChannel ();
+          if (channel == 0)
+            {
+              continue;
+            }
+          for (std::size_t k = 0; k < channel->GetNDevices (); ++k)
+            {
+              Ptr<Node> remoteNode = channel->GetDevice (k)->GetNode ();
+              if (remoteNode->GetSystemId () == node->GetSystemId ())
+                {
+                  continue;
+                }
+              // only works for p2p links currently, and the devices must
+              // not reach the devices of the other partition directly
+              if (!localNetDevice->IsPointToPoint ()
+                  || localNetDevice->GetObject<MpiReceiver> () == 0)
+                {
+                  NS_FATAL_ERROR ("Node " << node->GetId () << " (partition " << node->GetSystemId ()
+                                  << ") is linked to node " << remoteNode->GetId () << " (partition "
+                                  << remoteNode->GetSystemId () << ") by a channel which is not a "
+                                  "point-to-point remote channel; enable the MpiInterface before "
+                                  "building the topology");
+                }
+              TimeValue delay;
+              channel->GetAttribute ("Delay", delay);
+              NS_ABORT_MSG_IF (!delay.Get ().IsStrictlyPositive (),
+                               "Links between partitions need a positive delay");
+              m_lookAhead = std::min (m_lookAhead, static_cast<uint64_t> (delay.Get ().GetTimeStep ()));
+            }
+        }
+    }
+
+  GetPartition (size - 1);
+  m_mailboxes.assign (m_partitions.size () * m_partitions.size (), std::vector<RemoteEvent> ());
+  NS_LOG_INFO (m_partitions.size () << " partitions, lookahead " << GetLookAhead ());
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookAhead (void) const
+{
+  return m_lookAhead == NO_EVENT ? GetMaximumSimulationTime () : TimeStep (m_lookAhead);
+}
+
+void
+MultithreadedSimulatorImpl::Barrier (void)
+{
+  uint32_t generation = m_barrierGeneration.load ();
+  if (++m_barrierCount == m_partitions.size ())
+    {
+      m_barrierCount = 0;
+      ++m_barrierGeneration;
+      return;
+    }
+  while (m_barrierGeneration.load () == generation)
+    {
+      std::this_thread::yield ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::DrainMailboxes (Partition &partition)
+{
+  // The events are inserted in the order of the source partitions, so
+  // that their uids do not depend on the interleaving of the threads.
+  uint32_t size = m_partitions.size ();
+  for (uint32_t source = 0; source < size; ++source)
+    {
+      std::vector<RemoteEvent> &mailbox = m_mailboxes[source * size + partition.id];
+      for (std::vector<RemoteEvent>::iterator i = mailbox.begin (); i != mailbox.end (); ++i)
+        {
+          NS_ASSERT (i->ts >= partition.currentTs);
+          Insert (partition, i->ts, i->context, i->impl);
+        }
+      mailbox.clear ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent (Partition &partition)
+{
+  Scheduler::Event next = partition.events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= partition.currentTs);
+  partition.unscheduledEvents--;
+  partition.eventCount++;
+
+  partition.currentTs = next.key.m_ts;
+  partition.currentContext = next.key.m_context;
+  partition.currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::RunPartition (Partition &partition)
+{
+  NS_LOG_FUNCTION (this << partition.id);
+  g_current = &partition;
+
+  while (true)
+    {
+      DrainMailboxes (partition);
+      partition.nextTs = partition.events->IsEmpty () ? NO_EVENT
+        : partition.events->PeekNext ().key.m_ts;
+      // Nobody stops the simulation between the two barriers, so all the
+      // partitions take the same decision.
+      bool stop = m_stop;
+      uint64_t stopTs = m_stopTs;
+      Barrier ();
+
+      uint64_t start = NO_EVENT;
+      for (std::vector<Partition>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+        {
+          start = std::min (start, i->nextTs);
+        }
+      if (stop || start == NO_EVENT || start >= stopTs)
+        {
+          break;
+        }
+      uint64_t end = m_lookAhead > stopTs - start ? stopTs : start + m_lookAhead;
+
+      while (!m_stop && !partition.events->IsEmpty ()
+             && partition.events->PeekNext ().key.m_ts < end)
+        {
+          ProcessOneEvent (partition);
+        }
+      Barrier ();
+    }
+
+  g_current = 0;
+}
+
+void
+MultithreadedSimulatorImpl::RunThread (void)
+{
+  RunPartition (m_partitions[m_nextThread++]);
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  CalculateLookAhead ();
+  SharedMemoryInterface::CollectReceivers ();
+
+  m_stop = false;
+  m_running = true;
+  m_barrierCount = 0;
+  m_barrierGeneration = 0;
+  m_nextThread = 1;
+  for (uint32_t i = 1; i < m_partitions.size (); ++i)
+    {
+      Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&MultithreadedSimulatorImpl::RunThread, this));
+      m_threads.push_back (thread);
+      thread->Start ();
+    }
+  RunPartition (m_partitions[0]);
+  for (std::vector<Ptr<SystemThread> >::iterator i = m_threads.begin (); i != m_threads.end (); ++i)
+    {
+      (*i)->Join ();
+    }
+  m_threads.clear ();
+  m_running = false;
+
+  uint64_t next = NO_EVENT;
+  for (std::vector<Partition>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      next = std::min (next, i->events->IsEmpty () ? NO_EVENT : i->events->PeekNext ().key.m_ts);
+      // If the simulator stopped naturally by lack of events, make a
+      // consistency test to check that we didn't lose any events along the way.
+      NS_ASSERT (!i->events->IsEmpty () || i->unscheduledEvents == 0);
+    }
+  if (!m_stop && m_stopTs != NO_EVENT && next >= m_stopTs)
+    {
+      // As if the stop event had been processed by all the partitions
+      for (std::vector<Partition>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+        {
+          i->currentTs = m_stopTs;
+        }
+      m_stopTs = NO_EVENT;
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stop)
+    {
+      return true;
+    }
+  for (std::vector<Partition>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      if (!i->events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (const Time &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::Stop(): Negative delay");
+  // The partitions stop at the end of the window which reaches this
+  // time, instead of running a Stop event in one of them.
+  uint64_t ts = GetCurrent ().currentTs + delay.GetTimeStep ();
+  uint64_t current = m_stopTs;
+  while (ts < current && !m_stopTs.compare_exchange_weak (current, ts))
+    {
+    }
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule (const Time &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+
+  Partition &partition = GetCurrent ();
+  Scheduler::EventKey key = Insert (partition, partition.currentTs + delay.GetTimeStep (),
+                                    partition.currentContext, event);
+  return EventId (event, key.m_ts, key.m_context, key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::ScheduleWithContext(): Negative delay");
+
+  uint32_t target = GetPartitionId (context);
+  if (!m_running)
+    {
+      Partition &partition = GetPartition (target);
+      Insert (partition, partition.currentTs + delay.GetTimeStep (), context, event);
+      return;
+    }
+
+  Partition &current = GetCurrent ();
+  uint64_t ts = current.currentTs + delay.GetTimeStep ();
+  if (target == current.id)
+    {
+      Insert (current, ts, context, event);
+      return;
+    }
+  NS_ABORT_MSG_IF (static_cast<uint64_t> (delay.GetTimeStep ()) < m_lookAhead,
+                   "Event for node " << context << " of partition " << target
+                   << " scheduled by partition " << current.id << " with a delay of " << delay
+                   << ", smaller than the lookahead " << GetLookAhead ());
+  RemoteEvent remote;
+  remote.ts = ts;
+  remote.context = context;
+  remote.impl = event;
+  m_mailboxes[current.id * m_partitions.size () + target].push_back (remote);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  Partition &partition = GetCurrent ();
+  Scheduler::EventKey key = Insert (partition, partition.currentTs,
+                                    partition.currentContext, event);
+  return EventId (event, key.m_ts, key.m_context, key.m_uid);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), GetCurrent ().currentTs, 0xffffffff, 2);
+  CriticalSection cs (m_destroyMutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  return TimeStep (GetCurrent ().currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - FindPartition (id)->currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      CriticalSection cs (m_destroyMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Partition *partition = FindPartition (id);
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  partition->events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  partition->unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0
+          || id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (m_destroyMutex);
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  Partition *partition = FindPartition (id);
+  if (partition == 0
+      || id.PeekEventImpl () == 0
+      || id.GetTs () < partition->currentTs
+      || (id.GetTs () == partition->currentTs && id.GetUid () <= partition->currentUid)
+      || id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  return GetCurrent ().currentContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount (void) const
+{
+  uint64_t count = 0;
+  for (std::vector<Partition>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      count += i->eventCount;
+    }
+  return count;
+}
+
+} // namespace ns3
@@ -0,0 +1,252 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef NS3_MULTITHREADED_SIMULATOR_IMPL_H
+#define NS3_MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/simulator-impl.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/ptr.h"
+
+#include <atomic>
+#include <list>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \ingroup mpi
+ *
+ * \brief Conservative parallel simulator using the threads of one host
+ *
+ * The nodes are partitioned by their system id, as for the distributed
+ * simulators, but all the partitions run in this process, one thread
+ * per partition: partition 0 runs in the thread which calls Run, and
+ * the others in SystemThreads.  Each partition has its own scheduler,
+ * its own current time and context.
+ *
+ * The partitions advance in windows of the lookahead, the smallest
+ * delay of the point-to-point links between two partitions.  At the
+ * start of a window, every partition publishes the time of its next
+ * event; the window starts at the smallest of them, and each partition
+ * processes its events earlier than the start plus the lookahead.  No
+ * event scheduled by another partition during the window can be
+ * earlier than its end, so the partitions need no synchronization
+ * until the end of the window, where they meet at a barrier.
+ *
+ * An event scheduled with the context of a node of another partition
+ * goes to a single-producer, single-consumer mailbox between the two
+ * partitions.  The producer only appends during a window and the
+ * consumer only drains between two windows, so the mailboxes need no
+ * lock.  Such an event must be at least the lookahead in the future.
+ *
+ * The links between partitions must be point-to-point links with a
+ * PointToPointRemoteChannel: enable the MpiInterface with this
+ * simulator before building the topology, and the PointToPointHelper
+ * creates a remote channel between nodes of different system ids.  The
+ * packets are serialized by the SharedMemoryInterface.
+ *
+ * Random variables created while running get their stream index in
+ * the order the threads ask for it, which is not reproducible; assign
+ * the streams before Run for a deterministic simulation.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   * Register this type.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
+
+  /**
+   * \return the lookahead computed by the last Run
+   */
+  Time GetLookAhead (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** An event scheduled by another partition. */
+  struct RemoteEvent
+  {
+    uint64_t ts;       //!< Absolute time of the event
+    uint32_t context;  //!< Context of the event
+    EventImpl *impl;   //!< The event
+  };
+
+  /** The state of a partition, only accessed by its thread while running. */
+  struct Partition
+  {
+    uint32_t id;                //!< The system id of the partition
+    Ptr<Scheduler> events;      //!< The events of the partition
+    uint32_t uid;               //!< Next event unique id
+    uint32_t currentUid;        //!< Unique id of the current event
+    uint64_t currentTs;         //!< Timestamp of the current event
+    uint32_t currentContext;    //!< Context of the current event
+    uint64_t eventCount;        //!< Number of events processed
+    /**
+     * Number of events that have been inserted but not yet
+     * scheduled, not counting the "destroy" events; this is used for
+     * validation.
+     */
+    int unscheduledEvents;
+    uint64_t nextTs;            //!< Next event time, published at the barrier
+  };
+
+  /**
+   * \brief Get the partition of the calling thread
+   * \return the partition running in this thread, or partition 0
+   * outside of Run
+   */
+  Partition & GetCurrent (void) const;
+
+  /**
+   * \brief Get the partition of an event context
+   * \param context the context of an event
+   * \return the system id of the node, or the partition of the calling
+   * thread for an event without node
+   */
+  uint32_t GetPartitionId (uint32_t context) const;
+
+  /**
+   * \brief Get a partition, creating it if needed
+   * \param id the system id of the partition
+   * \return the partition
+   */
+  Partition & GetPartition (uint32_t id);
+
+  /**
+   * \brief Find the partition which owns an event
+   * \param id the event
+   * \return the partition in which the event is scheduled, or null if
+   * there is no such partition
+   */
+  Partition * FindPartition (const EventId &id) const;
+
+  /**
+   * \brief Insert an event in a partition
+   * \param partition the partition
+   * \param ts the absolute time of the event
+   * \param context the context of the event
+   * \param event the event
+   * \return the key of the inserted event
+   */
+  Scheduler::EventKey Insert (Partition &partition, uint64_t ts,
+                              uint32_t context, EventImpl *event);
+
+  /**
+   * \brief Compute the partitions of the nodes and the lookahead
+   *
+   * Also checks that only point-to-point remote channels cross the
+   * partitions.
+   */
+  void CalculateLookAhead (void);
+
+  /** \brief Run a partition in a new thread. */
+  void RunThread (void);
+
+  /**
+   * \brief Run a partition until the end of the simulation
+   * \param partition the partition to run
+   */
+  void RunPartition (Partition &partition);
+
+  /**
+   * \brief Move the events of the mailboxes of a partition to its scheduler
+   * \param partition the partition
+   */
+  void DrainMailboxes (Partition &partition);
+
+  /**
+   * \brief Process the next event of a partition
+   * \param partition the partition
+   */
+  void ProcessOneEvent (Partition &partition);
+
+  /** \brief Wait until all the partitions reach the barrier. */
+  void Barrier (void);
+
+  /** The partition run by the calling thread, null outside of Run. */
+  static thread_local Partition *g_current;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+
+  /** The events to run at Simulator::Destroy(), protected by m_destroyMutex. */
+  DestroyEvents m_destroyEvents;
+  /** Mutex of m_destroyEvents. */
+  mutable SystemMutex m_destroyMutex;
+  /** The scheduler factory of the partitions. */
+  ObjectFactory m_schedulerFactory;
+  /** The partitions. */
+  std::vector<Partition> m_partitions;
+  /** The mailboxes, from partition i to partition j at i * size + j. */
+  std::vector<std::vector<RemoteEvent> > m_mailboxes;
+  /** The partition of each node, while running. */
+  std::vector<uint32_t> m_nodePartition;
+  /** The worker threads. */
+  std::vector<Ptr<SystemThread> > m_threads;
+  /** Next partition to be claimed by a worker thread. */
+  std::atomic<uint32_t> m_nextThread;
+  /** Smallest delay between two partitions. */
+  uint64_t m_lookAhead;
+  /** Time of the event which stops the simulation. */
+  std::atomic<uint64_t> m_stopTs;
+  /** Has Stop() been called? */
+  std::atomic<bool> m_stop;
+  /** Is the simulator running? */
+  bool m_running;
+  /** Number of partitions at the barrier. */
+  std::atomic<uint32_t> m_barrierCount;
+  /** Incremented each time all the partitions reached the barrier. */
+  std::atomic<uint32_t> m_barrierGeneration;
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_SIMULATOR_IMPL_H */
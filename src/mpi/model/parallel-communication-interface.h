@@ -65,6 +65,17 @@ public:
    * \return number of parallel tasks
    */
   virtual uint32_t GetSize () = 0;
+  /**
+   * \param systemId system identification of a node
+   * \return true if the nodes of this system are simulated in this process
+   *
+   * By default only the nodes of this system are local; a shared memory
+   * implementation simulates all the nodes in the same process.
+   */
+  virtual bool IsLocal (uint32_t systemId)
+  {
+    return systemId == GetSystemId ();
+  }
   /**
    * \return true if parallel communication is enabled
    */
@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "shared-memory-interface.h"
+#include "mpi-receiver.h"
+
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SharedMemoryInterface");
+
+std::vector<std::vector<MpiReceiver *> > SharedMemoryInterface::g_receivers;
+
+SharedMemoryInterface::SharedMemoryInterface ()
+  : m_enabled (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SharedMemoryInterface::~SharedMemoryInterface ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SharedMemoryInterface::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  g_receivers.clear ();
+}
+
+uint32_t
+SharedMemoryInterface::GetSystemId ()
+{
+  return Simulator::GetSystemId ();
+}
+
+uint32_t
+SharedMemoryInterface::GetSize ()
+{
+  uint32_t size = 1;
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      size = std::max (size, (*i)->GetSystemId () + 1);
+    }
+  return size;
+}
+
+bool
+SharedMemoryInterface::IsLocal (uint32_t systemId)
+{
+  return true;
+}
+
+bool
+SharedMemoryInterface::IsEnabled ()
+{
+  return m_enabled;
+}
+
+void
+SharedMemoryInterface::Enable (int* pargc, char*** pargv)
+{
+  NS_LOG_FUNCTION (this << pargc << pargv);
+  m_enabled = true;
+}
+
+void
+SharedMemoryInterface::Disable ()
+{
+  NS_LOG_FUNCTION (this);
+  m_enabled = false;
+}
+
+void
+SharedMemoryInterface::CollectReceivers (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_receivers.assign (NodeList::GetNNodes (), std::vector<MpiReceiver *> ());
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      std::vector<MpiReceiver *> &receivers = g_receivers[node->GetId ()];
+      receivers.resize (node->GetNDevices (), 0);
+      for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+        {
+          receivers[j] = PeekPointer (node->GetDevice (j)->GetObject<MpiReceiver> ());
+        }
+    }
+}
+
+void
+SharedMemoryInterface::SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev)
+{
+  NS_LOG_FUNCTION (this << p << rxTime.GetTimeStep () << node << dev);
+
+  uint32_t serializedSize = p->GetSerializedSize ();
+  uint8_t *buffer = new uint8_t[serializedSize];
+  p->Serialize (buffer, serializedSize);
+  Simulator::ScheduleWithContext (node, rxTime - Simulator::Now (),
+                                  &SharedMemoryInterface::ReceivePacket,
+                                  buffer, serializedSize, dev);
+}
+
+void
+SharedMemoryInterface::ReceivePacket (uint8_t *buffer, uint32_t size, uint32_t dev)
+{
+  NS_LOG_FUNCTION (static_cast<void *> (buffer) << size << dev);
+
+  Ptr<Packet> p = Create<Packet> (buffer, size, true);
+  delete [] buffer;
+
+  uint32_t node = Simulator::GetContext ();
+  NS_ASSERT_MSG (node < g_receivers.size () && dev < g_receivers[node].size ()
+                 && g_receivers[node][dev] != 0,
+                 "No remote channel receiver for node " << node << " device " << dev);
+  g_receivers[node][dev]->Receive (p);
+}
+
+} // namespace ns3
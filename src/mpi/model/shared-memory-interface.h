@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+// This object moves packets between the partitions of a multi-threaded
+// simulation running in a single process.
+
+#ifndef NS3_SHARED_MEMORY_INTERFACE_H
+#define NS3_SHARED_MEMORY_INTERFACE_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+
+#include "parallel-communication-interface.h"
+
+namespace ns3 {
+
+class MpiReceiver;
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Interface between the partitions of a MultithreadedSimulatorImpl
+ *
+ * All the nodes are simulated in this process, each partition (system
+ * id) by its own thread.  A packet crossing a PointToPointRemoteChannel
+ * is serialized by the thread of the sender and scheduled with the
+ * context of the destination node, so that it is deserialized by the
+ * thread of the receiver: the packets, their buffers and the reference
+ * counts are never shared by two threads.
+ */
+class SharedMemoryInterface : public ParallelCommunicationInterface
+{
+public:
+  SharedMemoryInterface ();
+  virtual ~SharedMemoryInterface ();
+
+  virtual void Destroy ();
+  /**
+   * \return the partition of the calling thread
+   */
+  virtual uint32_t GetSystemId ();
+  /**
+   * \return the number of partitions, one more than the highest system
+   * id of the nodes
+   */
+  virtual uint32_t GetSize ();
+  /**
+   * \param systemId system identification of a node
+   * \return true, as all the nodes are simulated in this process
+   */
+  virtual bool IsLocal (uint32_t systemId);
+  virtual bool IsEnabled ();
+  virtual void Enable (int* pargc, char*** pargv);
+  virtual void Disable ();
+  virtual void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+
+  /**
+   * \brief Find the receivers of the remote channels of all the nodes
+   *
+   * Called by the simulator before the partitions start, so that the
+   * threads do not look up the node list concurrently.
+   */
+  static void CollectReceivers (void);
+
+private:
+  /**
+   * \brief Deliver a packet, in the partition of the destination node
+   * \param buffer the serialized packet, deleted by this method
+   * \param size the size of the serialized packet
+   * \param dev the index of the destination device
+   */
+  static void ReceivePacket (uint8_t *buffer, uint32_t size, uint32_t dev);
+
+  bool m_enabled; //!< Has this interface been enabled
+
+  /** The receivers of the remote channels, by node and device index. */
+  static std::vector<std::vector<MpiReceiver *> > g_receivers;
+};
+
+} // namespace ns3
+
+#endif /* NS3_SHARED_MEMORY_INTERFACE_H */
@@ -33,6 +33,7 @@
 #include <string>
 #include <iomanip>
 #include <map>
+#include <algorithm>
 
 // ns3 includes
 #include "ns3/animation-interface.h"
@@ -68,12 +69,31 @@ NS_LOG_COMPONENT_DEFINE ("AnimationInterface");
 
 static bool initialized = false; //!< Initialization flag
 
+static const char BINARY_MAGIC[] = "NS3ANIMB"; //!< Magic of the binary output file
+static const uint32_t BINARY_VERSION = 2; //!< Version of the binary output file
+static const uint8_t BINARY_P2P_PACKET = 1; //!< Type of a point-to-point packet record
+static const uint8_t BINARY_LINK_SAMPLE = 2; //!< Type of a link sample record
+static const uint8_t BINARY_NODE_SAMPLE = 3; //!< Type of a wireless node sample record
+
+/**
+ * Append a value to a binary record
+ * \param record the record
+ * \param value the value
+ */
+template <typename T>
+static void
+AppendBinary (std::string &record, T value)
+{
+  record.append (reinterpret_cast<const char *> (&value), sizeof (T));
+}
+
 
 // Public methods
 
 AnimationInterface::AnimationInterface (const std::string fn)
   : m_f (0),
     m_routingF (0),
+    m_binaryF (0),
     m_mobilityPollInterval (Seconds (0.25)), 
     m_outputFileName (fn),
     gAnimUid (0), 
@@ -87,7 +107,11 @@ AnimationInterface::AnimationInterface (const std::string fn)
     m_routingStopTime (Seconds (0)), 
     m_routingFileName (""),
     m_routingPollInterval (Seconds (5)), 
-    m_trackPackets (true)
+    m_trackPackets (true),
+    m_linkSampling (false),
+    m_linkSamplingPollInterval (Seconds (1)),
+    m_wirelessTxCounterId (0),
+    m_wirelessRxCounterId (0)
 {
   initialized = true;
   StartAnimation ();
@@ -104,6 +128,47 @@ AnimationInterface::SkipPacketTracing ()
   m_trackPackets = false;
 }
 
+void
+AnimationInterface::EnableLinkSampling (Time pollInterval)
+{
+  NS_ASSERT_MSG (pollInterval.IsStrictlyPositive (), "The link sampling interval must be positive");
+  m_linkSamplingPollInterval = pollInterval;
+  if (!m_linkSampling)
+    {
+      m_linkSampling = true;
+      Simulator::Schedule (pollInterval, &AnimationInterface::SampleLinks, this);
+    }
+}
+
+void
+AnimationInterface::EnableBinaryOutput (bool enable)
+{
+  if (!enable)
+    {
+      if (m_binaryF)
+        {
+          std::fclose (m_binaryF);
+          m_binaryF = 0;
+        }
+      return;
+    }
+  if (m_binaryF)
+    {
+      return;
+    }
+  std::string fn = m_originalFileName + ".bin";
+  NS_LOG_INFO ("Creating new binary trace file:" << fn.c_str ());
+  m_binaryF = std::fopen (fn.c_str (), "wb");
+  if (!m_binaryF)
+    {
+      NS_FATAL_ERROR ("Unable to open output file:" << fn.c_str ());
+      return;
+    }
+  std::string header (BINARY_MAGIC, sizeof (BINARY_MAGIC) - 1);
+  AppendBinary (header, BINARY_VERSION);
+  WriteN (header.c_str (), header.size (), m_binaryF);
+}
+
 void
 AnimationInterface::EnableWifiPhyCounters (Time startTime, Time stopTime, Time pollInterval)
 {
@@ -783,6 +848,30 @@ AnimationInterface::DevTxTrace (std::string context,
                                      Time rxTime)
 {
   NS_LOG_FUNCTION (this);
+  if (m_linkSampling)
+    {
+      if (!m_started || !IsInTimeWindow ())
+        {
+          return;
+        }
+      uint32_t fromId = tx->GetNode ()->GetId ();
+      uint32_t toId = rx->GetNode ()->GetId ();
+      LinkSampleKey key (std::min (fromId, toId), std::max (fromId, toId));
+      LinkSampleMap::iterator it = m_linkSamples.find (key);
+      if (it == m_linkSamples.end ())
+        {
+          LinkSample sample;
+          sample.fromNode = fromId;
+          sample.toNode = toId;
+          sample.bytes[0] = sample.bytes[1] = 0;
+          sample.active = false;
+          it = m_linkSamples.insert (std::make_pair (key, sample)).first;
+        }
+      uint32_t direction = it->second.fromNode == fromId ? 0 : 1;
+      it->second.bytes[direction] += p->GetSize ();
+      it->second.busy[direction] += txTime;
+      return;
+    }
   CHECK_STARTED_INTIMEWINDOW_TRACKPACKETS;
   NS_ASSERT (tx);
   NS_ASSERT (rx);
@@ -791,6 +880,11 @@ AnimationInterface::DevTxTrace (std::string context,
   double lbTx = (now + txTime).GetSeconds ();
   double fbRx = (now + rxTime - txTime).GetSeconds ();
   double lbRx = (now + rxTime).GetSeconds ();
+  if (m_binaryF)
+    {
+      WriteBinaryP (tx->GetNode ()->GetId (), fbTx, lbTx, rx->GetNode ()->GetId (), fbRx, lbRx);
+      return;
+    }
   CheckMaxPktsPerTraceFile ();
   WriteXmlP ("p", 
              tx->GetNode ()->GetId (), 
@@ -1217,7 +1311,6 @@ AnimationInterface::CsmaMacRxTrace (std::string context,
 void
 AnimationInterface::OutputWirelessPacketTxInfo (Ptr<const Packet> p, AnimPacketInfo &pktInfo, uint64_t animUid)
 {
-  CheckMaxPktsPerTraceFile ();
   uint32_t nodeId = 0;
   if (pktInfo.m_txnd)
     {
@@ -1227,14 +1320,25 @@ AnimationInterface::OutputWirelessPacketTxInfo (Ptr<const Packet> p, AnimPacketI
     {
       nodeId = pktInfo.m_txNodeId;
     }
+  if (m_linkSampling)
+    {
+      SampleWirelessPacket (nodeId, 0, p);
+      return;
+    }
+  CheckMaxPktsPerTraceFile ();
   WriteXmlPRef (animUid, nodeId, pktInfo.m_fbTx, m_enablePacketMetadata? GetPacketMetadata (p):"");
 }
 
 void 
 AnimationInterface::OutputWirelessPacketRxInfo (Ptr<const Packet> p, AnimPacketInfo & pktInfo, uint64_t animUid)
 {
-  CheckMaxPktsPerTraceFile ();
   uint32_t rxId = pktInfo.m_rxnd->GetNode ()->GetId ();
+  if (m_linkSampling)
+    {
+      SampleWirelessPacket (rxId, 1, p);
+      return;
+    }
+  CheckMaxPktsPerTraceFile ();
   WriteXmlP (animUid, "wpr", rxId, pktInfo.m_fbRx, pktInfo.m_lbRx);
 }
 
@@ -1448,6 +1552,11 @@ AnimationInterface::StopAnimation (bool onlyAnimation)
     {
       return;
     }
+  if (m_binaryF)
+    {
+      std::fclose (m_binaryF);
+      m_binaryF = 0;
+    }
   if (m_routingF)
     {
       WriteXmlClose ("anim", true);
@@ -2131,6 +2240,41 @@ AnimationInterface::TrackQueueCounters ()
   Simulator::Schedule (m_queueCountersPollInterval, &AnimationInterface::TrackQueueCounters, this);
 }
 
+void
+AnimationInterface::SampleLinks ()
+{
+  for (LinkSampleMap::iterator i = m_linkSamples.begin (); i != m_linkSamples.end (); ++i)
+    {
+      LinkSample &sample = i->second;
+      bool active = sample.bytes[0] > 0 || sample.bytes[1] > 0;
+      // an idle link is only written when it becomes idle
+      if (m_started && (active || sample.active))
+        {
+          WriteLinkSample (sample);
+          sample.active = active;
+        }
+      sample.bytes[0] = sample.bytes[1] = 0;
+      sample.busy[0] = sample.busy[1] = Seconds (0);
+    }
+  for (NodeSampleMap::iterator i = m_nodeSamples.begin (); i != m_nodeSamples.end (); ++i)
+    {
+      NodeSample &sample = i->second;
+      bool active = sample.bytes[0] > 0 || sample.bytes[1] > 0;
+      if (m_started && (active || sample.active))
+        {
+          WriteNodeSample (i->first, sample);
+          sample.active = active;
+        }
+      sample.bytes[0] = sample.bytes[1] = 0;
+    }
+  if (Simulator::Now () > m_stopTime)
+    {
+      NS_LOG_INFO ("SampleLinks Completed");
+      return;
+    }
+  Simulator::Schedule (m_linkSamplingPollInterval, &AnimationInterface::SampleLinks, this);
+}
+
 void
 AnimationInterface::TrackWifiMacCounters ()
 {
@@ -2439,6 +2583,99 @@ AnimationInterface::WriteXmlUpdateLink (uint32_t fromId, uint32_t toId, std::str
   WriteN (element.ToString (), m_f);
 }
 
+void
+AnimationInterface::WriteLinkSample (const LinkSample &sample)
+{
+  double interval = m_linkSamplingPollInterval.GetSeconds ();
+  if (m_binaryF)
+    {
+      std::string record;
+      AppendBinary (record, BINARY_LINK_SAMPLE);
+      AppendBinary (record, Simulator::Now ().GetSeconds ());
+      AppendBinary (record, sample.fromNode);
+      AppendBinary (record, sample.toNode);
+      AppendBinary (record, interval);
+      for (uint32_t direction = 0; direction < 2; ++direction)
+        {
+          AppendBinary (record, sample.bytes[direction]);
+          AppendBinary (record, sample.busy[direction].GetSeconds ());
+        }
+      WriteN (record.c_str (), record.size (), m_binaryF);
+      return;
+    }
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision (2);
+  for (uint32_t direction = 0; direction < 2; ++direction)
+    {
+      uint32_t from = direction == 0 ? sample.fromNode : sample.toNode;
+      uint32_t to = direction == 0 ? sample.toNode : sample.fromNode;
+      double utilization = std::min (1.0, sample.busy[direction].GetSeconds () / interval);
+      oss << (direction == 0 ? "" : " ") << from << "->" << to << ": "
+          << sample.bytes[direction] * 8 / interval / 1e6 << " Mb/s "
+          << utilization * 100 << "%";
+    }
+  WriteXmlUpdateLink (sample.fromNode, sample.toNode, oss.str ());
+}
+
+void
+AnimationInterface::SampleWirelessPacket (uint32_t nodeId, uint32_t direction, Ptr<const Packet> p)
+{
+  if (m_nodeSamples.empty ())
+    {
+      m_wirelessTxCounterId = AddNodeCounter ("Wireless Tx Mb/s", AnimationInterface::DOUBLE_COUNTER);
+      m_wirelessRxCounterId = AddNodeCounter ("Wireless Rx Mb/s", AnimationInterface::DOUBLE_COUNTER);
+    }
+  NodeSampleMap::iterator it = m_nodeSamples.find (nodeId);
+  if (it == m_nodeSamples.end ())
+    {
+      NodeSample sample;
+      sample.bytes[0] = sample.bytes[1] = 0;
+      sample.active = false;
+      it = m_nodeSamples.insert (std::make_pair (nodeId, sample)).first;
+    }
+  it->second.bytes[direction] += p->GetSize ();
+}
+
+void
+AnimationInterface::WriteNodeSample (uint32_t nodeId, const NodeSample &sample)
+{
+  double interval = m_linkSamplingPollInterval.GetSeconds ();
+  uint32_t counterIds[2] = { m_wirelessTxCounterId, m_wirelessRxCounterId };
+  if (m_binaryF)
+    {
+      std::string record;
+      AppendBinary (record, BINARY_NODE_SAMPLE);
+      AppendBinary (record, Simulator::Now ().GetSeconds ());
+      AppendBinary (record, nodeId);
+      AppendBinary (record, interval);
+      for (uint32_t direction = 0; direction < 2; ++direction)
+        {
+          AppendBinary (record, counterIds[direction]);
+          AppendBinary (record, sample.bytes[direction]);
+        }
+      WriteN (record.c_str (), record.size (), m_binaryF);
+      return;
+    }
+  for (uint32_t direction = 0; direction < 2; ++direction)
+    {
+      WriteXmlUpdateNodeCounter (counterIds[direction], nodeId, sample.bytes[direction] * 8 / interval / 1e6);
+    }
+}
+
+void
+AnimationInterface::WriteBinaryP (uint32_t fId, double fbTx, double lbTx, uint32_t tId, double fbRx, double lbRx)
+{
+  std::string record;
+  AppendBinary (record, BINARY_P2P_PACKET);
+  AppendBinary (record, fId);
+  AppendBinary (record, tId);
+  AppendBinary (record, fbTx);
+  AppendBinary (record, lbTx);
+  AppendBinary (record, fbRx);
+  AppendBinary (record, lbRx);
+  WriteN (record.c_str (), record.size (), m_binaryF);
+}
+
 void 
 AnimationInterface::WriteXmlLink (uint32_t fromId, uint32_t toLp, uint32_t toId)
 {
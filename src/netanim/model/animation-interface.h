@@ -387,6 +387,53 @@ public:
    */
   void EnablePacketMetadata (bool enable = true);
 
+  /**
+   * \brief Sample the point-to-point links instead of tracing their packets
+   *
+   * The bytes and the busy time of each direction of the point-to-point
+   * links are summed over each poll interval, then written as a link
+   * description update ("linkupdate") with the throughput and the
+   * utilization of the link.  Idle links are only written once, when they
+   * become idle.  The samples respect the start and stop times of the
+   * capture.  This keeps the trace file of long runs with many flows
+   * small, at the cost of the animation of the individual packets.
+   *
+   * The wireless packets have no link: the bytes sent and received by
+   * each node are summed instead, and written as the "Wireless Tx Mb/s"
+   * and "Wireless Rx Mb/s" node counters of the node.
+   *
+   * \param pollInterval The periodic interval at which the links are sampled
+   *        Default: 1s
+   * \returns none
+   */
+  void EnableLinkSampling (Time pollInterval = Seconds (1));
+
+  /**
+   * \brief Write the packets and the link samples in a compact binary file
+   *
+   * The records are written to the file named after the trace file with
+   * a ".bin" suffix, instead of XML elements in the trace file.  The
+   * topology, the nodes and the other updates stay in the XML trace file.
+   * utils/netanim-bin2xml.py merges the binary records back into the XML
+   * trace file for NetAnim.  The binary packets are not counted by
+   * SetMaxPktsPerTraceFile.
+   *
+   * The file starts with the magic "NS3ANIMB" and a uint32 version,
+   * followed by records of a uint8 type, in the byte order of the host:
+   * - 1, a point-to-point packet: uint32 fId, uint32 tId, double fbTx,
+   *   lbTx, fbRx, lbRx
+   * - 2, a link sample: double t, uint32 fromId, uint32 toId, double
+   *   interval, then uint64 bytes and double busy seconds of the fromId
+   *   to toId direction and of the reverse direction
+   * - 3, a wireless node sample: double t, uint32 nodeId, double
+   *   interval, then uint32 counter ID and uint64 bytes of the sent and
+   *   of the received bytes
+   *
+   * \param enable if true writes the binary file
+   * \returns none
+   */
+  void EnableBinaryOutput (bool enable = true);
+
   /**
    *
    * \brief Get trace file packet count (This used only for testing)
@@ -544,7 +591,26 @@ private:
       double width; ///< width
       double height; ///< height
     } NodeSize; ///< node size
+  /// Traffic of a point-to-point link during a sampling interval
+  typedef struct
+  {
+    uint32_t fromNode; ///< from node, the forward direction starts there
+    uint32_t toNode; ///< to node
+    uint64_t bytes[2]; ///< bytes sent forward and in reverse
+    Time busy[2]; ///< transmission time forward and in reverse
+    bool active; ///< true if the last sample written had traffic
+  } LinkSample; ///< link sample
+  /// Wireless traffic of a node during a sampling interval
+  typedef struct
+  {
+    uint64_t bytes[2]; ///< bytes sent and received
+    bool active; ///< true if the last sample written had traffic
+  } NodeSample; ///< node sample
   typedef std::map <P2pLinkNodeIdPair, LinkProperties, LinkPairCompare> LinkPropertiesMap; ///< LinkPropertiesMap typedef
+  /// Lower and higher node IDs of a link, the same for both directions
+  typedef std::pair <uint32_t, uint32_t> LinkSampleKey;
+  typedef std::map <LinkSampleKey, LinkSample> LinkSampleMap; ///< LinkSampleMap typedef
+  typedef std::map <uint32_t, NodeSample> NodeSampleMap; ///< NodeSampleMap typedef
   typedef std::map <uint32_t, std::string> NodeDescriptionsMap; ///< NodeDescriptionsMap typedef
   typedef std::map <uint32_t, Rgb> NodeColorsMap; ///< NodeColorsMap typedef
   typedef std::map<uint64_t, AnimPacketInfo> AnimUidPacketInfoMap; ///< AnimUidPacketInfoMap typedef
@@ -610,6 +676,7 @@ private:
 
   FILE * m_f; ///< File handle for output (0 if none)
   FILE * m_routingF; ///< File handle for routing table output (0 if None);
+  FILE * m_binaryF; ///< File handle for binary output (0 if None)
   Time m_mobilityPollInterval; ///< mobility poll interval
   std::string m_outputFileName; ///< output file name
   uint64_t gAnimUid ;    ///< Packet unique identifier used by AnimationInterface
@@ -634,6 +701,12 @@ private:
   Time m_wifiPhyCountersPollInterval; ///< wifi Phy counters poll interval
   static Rectangle * userBoundary; ///< user boundary
   bool m_trackPackets; ///< track packets
+  bool m_linkSampling; ///< sample the point-to-point links
+  Time m_linkSamplingPollInterval; ///< link sampling poll interval
+  LinkSampleMap m_linkSamples; ///< link samples of the current interval
+  NodeSampleMap m_nodeSamples; ///< wireless node samples of the current interval
+  uint32_t m_wirelessTxCounterId; ///< wireless sent throughput counter ID, added with the first node sample
+  uint32_t m_wirelessRxCounterId; ///< wireless received throughput counter ID
 
   // Counter ID
   uint32_t m_remainingEnergyCounterId; ///< remaining energy counter ID
@@ -884,6 +957,8 @@ private:
   void TrackIpv4L3ProtocolCounters ();
   /// Track queue counters function
   void TrackQueueCounters ();
+  /// Write the link and wireless node samples of the interval and start the next one
+  void SampleLinks ();
   // ##### Routing #####
   /// Track IPv4 router function
   void TrackIpv4Route ();
@@ -1393,6 +1468,34 @@ private:
    * \param linkDescription the link description
    */
   void WriteXmlUpdateLink (uint32_t fromId, uint32_t toId, std::string linkDescription);
+  /**
+   * Write a link sample, as an XML link update or a binary record
+   * \param sample the link sample
+   */
+  void WriteLinkSample (const LinkSample &sample);
+  /**
+   * Add a wireless packet to the sample of its node
+   * \param nodeId the node ID
+   * \param direction 0 if the node sent the packet, 1 if it received it
+   * \param p the packet
+   */
+  void SampleWirelessPacket (uint32_t nodeId, uint32_t direction, Ptr<const Packet> p);
+  /**
+   * Write a wireless node sample, as XML node counter updates or a binary record
+   * \param nodeId the node ID
+   * \param sample the node sample
+   */
+  void WriteNodeSample (uint32_t nodeId, const NodeSample &sample);
+  /**
+   * Write a binary point-to-point packet record
+   * \param fId the from node ID
+   * \param fbTx the first bit transmit time
+   * \param lbTx the last bit transmit time
+   * \param tId the to node ID
+   * \param fbRx the first bit receive time
+   * \param lbRx the last bit receive time
+   */
+  void WriteBinaryP (uint32_t fId, double fbTx, double lbTx, uint32_t tId, double fbRx, double lbRx);
   /**
    * Write XMLP function
    * \param pktType the packet type
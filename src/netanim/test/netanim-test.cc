@@ -18,6 +18,8 @@
  */
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include "unistd.h"
 
 #include "ns3/core-module.h"
@@ -253,6 +255,93 @@ AnimationRemainingEnergyTestCase::CheckLogic (void)
                             "Wrong remaining energy value was traced");
 }
 
+/**
+ * \ingroup netanim-test
+ * \ingroup tests
+ *
+ * \brief Animation Link Sampling Test Case
+ */
+class AnimationLinkSamplingTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor.
+   */
+  AnimationLinkSamplingTestCase ();
+
+private:
+  virtual void
+  DoRun (void);
+};
+
+AnimationLinkSamplingTestCase::AnimationLinkSamplingTestCase () :
+  TestCase ("Verify the sampling of the links")
+{
+}
+
+void
+AnimationLinkSamplingTestCase::DoRun (void)
+{
+  const char* traceFileName = "netanim-sampling-test.xml";
+  NodeContainer nodes;
+  nodes.Create (2);
+  AnimationInterface::SetConstantPosition (nodes.Get (0), 0 , 10);
+  AnimationInterface::SetConstantPosition (nodes.Get (1), 1 , 10);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  UdpEchoServerHelper echoServer (9);
+  ApplicationContainer serverApps = echoServer.Install (nodes.Get (1));
+  serverApps.Start (Seconds (1.0));
+  serverApps.Stop (Seconds (10.0));
+
+  // one echo per second, from 2 s to 9 s
+  UdpEchoClientHelper echoClient (interfaces.GetAddress (1), 9);
+  echoClient.SetAttribute ("MaxPackets", UintegerValue (100));
+  echoClient.SetAttribute ("Interval", TimeValue (Seconds (1.0)));
+  echoClient.SetAttribute ("PacketSize", UintegerValue (1024));
+  ApplicationContainer clientApps = echoClient.Install (nodes.Get (0));
+  clientApps.Start (Seconds (2.0));
+  clientApps.Stop (Seconds (10.0));
+
+  AnimationInterface* anim = new AnimationInterface (traceFileName);
+  anim->EnableLinkSampling (Seconds (1));
+  Simulator::Stop (Seconds (12));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (anim->GetTracePktCount (), 0, "No packet should be traced");
+  delete anim;
+  Simulator::Destroy ();
+
+  std::ifstream is (traceFileName);
+  NS_TEST_ASSERT_MSG_EQ (is.is_open (), true, "Trace file was not created");
+  std::ostringstream trace;
+  trace << is.rdbuf ();
+  is.close ();
+  unlink (traceFileName);
+
+  uint32_t updates = 0;
+  for (std::string::size_type i = trace.str ().find ("<linkupdate"); i != std::string::npos;
+       i = trace.str ().find ("<linkupdate", i + 1))
+    {
+      ++updates;
+    }
+  // 8 samples with an echo, then one when the link becomes idle
+  NS_TEST_ASSERT_MSG_EQ (updates, 9, "Wrong number of link samples");
+  NS_TEST_ASSERT_MSG_EQ (trace.str ().find ("<p "), std::string::npos, "Packets were written");
+  // 1054 bytes each way, 1.6864 ms at 5 Mb/s
+  NS_TEST_ASSERT_MSG_NE (trace.str ().find ("0-&gt;1: 0.01 Mb/s 0.17% 1-&gt;0: 0.01 Mb/s 0.17%"), std::string::npos,
+                         "Wrong link sample");
+}
+
 /**
  * \ingroup netanim-test
  * \ingroup tests
@@ -267,5 +356,6 @@ public:
   {
     AddTestCase (new AnimationInterfaceTestCase (), TestCase::QUICK);
     AddTestCase (new AnimationRemainingEnergyTestCase (), TestCase::QUICK);
+    AddTestCase (new AnimationLinkSamplingTestCase (), TestCase::QUICK);
   }
 } g_animationInterfaceTestSuite; ///< the test suite
@@ -767,7 +767,7 @@ private:
    * writing data. i.e., m_start should be initialized to this 
    * value.
    */
-  static uint32_t g_recommendedStart;
+  static thread_local uint32_t g_recommendedStart;
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -791,6 +791,10 @@ private:
   uint32_t m_end;
 
 #ifdef BUFFER_FREE_LIST
+  /*
+   * The free list and the size hints are per thread: the partitions of
+   * a multi-threaded simulation recycle their buffers independently.
+   */
   /// Container for buffer data
   typedef std::vector<struct Buffer::Data*> FreeList;
   /// Local static destructor structure
@@ -798,9 +802,13 @@ private:
   {
     ~LocalStaticDestructor ();
   };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
-  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
+  /**
+   * \brief Create the free list of the calling thread
+   */
+  static void CreateFreeList (void);
+  static thread_local uint32_t g_maxSize; //!< Max observed data size
+  static thread_local FreeList *g_freeList; //!< Buffer data container
+  static thread_local struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
 #endif
 };
 
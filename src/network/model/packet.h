@@ -787,7 +787,12 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-  static uint32_t m_globalUid; //!< Global counter of packets Uid
+  /**
+   * Counter of packets Uid. It is per thread, and combined with the
+   * system id, so that the partitions of a multi-threaded simulation
+   * allocate unique Uids without synchronization.
+   */
+  static thread_local uint32_t m_globalUid;
 };
 
 /**
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/queue.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/mac48-address.h"
+#include "ns3/trace-driven-net-device.h"
+#include "ns3/trace-driven-channel.h"
+#include "trace-driven-helper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TraceDrivenHelper");
+
+TraceDrivenHelper::TraceDrivenHelper ()
+{
+  m_queueFactory.SetTypeId ("ns3::DropTailQueue<Packet>");
+  m_deviceFactory.SetTypeId ("ns3::TraceDrivenNetDevice");
+  m_channelFactory.SetTypeId ("ns3::TraceDrivenChannel");
+}
+
+void
+TraceDrivenHelper::SetQueue (std::string type,
+                             std::string n1, const AttributeValue &v1,
+                             std::string n2, const AttributeValue &v2,
+                             std::string n3, const AttributeValue &v3,
+                             std::string n4, const AttributeValue &v4)
+{
+  QueueBase::AppendItemTypeIfNotPresent (type, "Packet");
+
+  m_queueFactory.SetTypeId (type);
+  m_queueFactory.Set (n1, v1);
+  m_queueFactory.Set (n2, v2);
+  m_queueFactory.Set (n3, v3);
+  m_queueFactory.Set (n4, v4);
+}
+
+void
+TraceDrivenHelper::SetDeviceAttribute (std::string name, const AttributeValue &value)
+{
+  m_deviceFactory.Set (name, value);
+}
+
+void
+TraceDrivenHelper::SetChannelAttribute (std::string name, const AttributeValue &value)
+{
+  m_channelFactory.Set (name, value);
+}
+
+Ptr<const CapacityTrace>
+TraceDrivenHelper::GetCapacityTrace (std::string filename)
+{
+  std::map<std::string, Ptr<const CapacityTrace> >::const_iterator it = m_traces.find (filename);
+  if (it != m_traces.end ())
+    {
+      return it->second;
+    }
+  NS_LOG_INFO ("Loading capacity trace " << filename);
+  Ptr<CapacityTrace> trace = Create<CapacityTrace> ();
+  trace->Load (filename);
+  m_traces[filename] = trace;
+  return trace;
+}
+
+Ptr<TraceDrivenNetDevice>
+TraceDrivenHelper::InstallDevice (Ptr<Node> node, std::string trace)
+{
+  Ptr<TraceDrivenNetDevice> dev = m_deviceFactory.Create<TraceDrivenNetDevice> ();
+  dev->SetAddress (Mac48Address::Allocate ());
+  dev->SetCapacityTrace (GetCapacityTrace (trace));
+  node->AddDevice (dev);
+  Ptr<Queue<Packet> > queue = m_queueFactory.Create<Queue<Packet> > ();
+  dev->SetQueue (queue);
+  Ptr<NetDeviceQueueInterface> ndqi = CreateObject<NetDeviceQueueInterface> ();
+  ndqi->GetTxQueue (0)->ConnectQueueTraces (queue);
+  dev->AggregateObject (ndqi);
+  return dev;
+}
+
+NetDeviceContainer
+TraceDrivenHelper::Install (Ptr<Node> a, Ptr<Node> b, std::string traceAToB, std::string traceBToA)
+{
+  NetDeviceContainer container;
+  Ptr<TraceDrivenNetDevice> devA = InstallDevice (a, traceAToB);
+  Ptr<TraceDrivenNetDevice> devB = InstallDevice (b, traceBToA);
+  Ptr<TraceDrivenChannel> channel = m_channelFactory.Create<TraceDrivenChannel> ();
+  devA->Attach (channel);
+  devB->Attach (channel);
+  container.Add (devA);
+  container.Add (devB);
+  return container;
+}
+
+} // namespace ns3
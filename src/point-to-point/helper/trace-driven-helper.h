@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRACE_DRIVEN_HELPER_H
+#define TRACE_DRIVEN_HELPER_H
+
+#include <string>
+#include <map>
+
+#include "ns3/object-factory.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node.h"
+#include "ns3/trace-driven-net-device.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup point-to-point
+ * \brief Build links whose capacity is replayed from trace files
+ *
+ * Each direction of a link is a TraceDrivenNetDevice replaying its own
+ * trace file over a TraceDrivenChannel.  A trace file is only loaded
+ * once by a helper, and shared by all the devices replaying it.
+ *
+ * The devices are PointToPointNetDevice, so that the pcap and ascii
+ * traces of the PointToPointHelper can be enabled on them.
+ */
+class TraceDrivenHelper
+{
+public:
+  TraceDrivenHelper ();
+
+  /**
+   * \brief Set the type of the transmit queue of the devices
+   *
+   * \param type the type of queue
+   * \param n1 the name of the attribute to set on the queue
+   * \param v1 the value of the attribute to set on the queue
+   * \param n2 the name of the attribute to set on the queue
+   * \param v2 the value of the attribute to set on the queue
+   * \param n3 the name of the attribute to set on the queue
+   * \param v3 the value of the attribute to set on the queue
+   * \param n4 the name of the attribute to set on the queue
+   * \param v4 the value of the attribute to set on the queue
+   */
+  void SetQueue (std::string type,
+                 std::string n1 = "", const AttributeValue &v1 = EmptyAttributeValue (),
+                 std::string n2 = "", const AttributeValue &v2 = EmptyAttributeValue (),
+                 std::string n3 = "", const AttributeValue &v3 = EmptyAttributeValue (),
+                 std::string n4 = "", const AttributeValue &v4 = EmptyAttributeValue ());
+
+  /**
+   * \brief Set an attribute of the TraceDrivenNetDevice created by the helper
+   *
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set
+   */
+  void SetDeviceAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * \brief Set an attribute of the TraceDrivenChannel created by the helper
+   *
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set
+   */
+  void SetChannelAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * \brief Get a trace file, loading it the first time
+   * \param filename the name of the trace file
+   * \returns the capacity trace of the file
+   */
+  Ptr<const CapacityTrace> GetCapacityTrace (std::string filename);
+
+  /**
+   * \brief Link two nodes
+   *
+   * \param a the first node
+   * \param b the second node
+   * \param traceAToB the trace file of the capacity from a to b
+   * \param traceBToA the trace file of the capacity from b to a
+   * \returns the devices of a and b
+   */
+  NetDeviceContainer Install (Ptr<Node> a, Ptr<Node> b, std::string traceAToB, std::string traceBToA);
+
+private:
+  /**
+   * \brief Create a device replaying a trace on a node
+   * \param node the node
+   * \param trace the trace file
+   * \returns the device
+   */
+  Ptr<TraceDrivenNetDevice> InstallDevice (Ptr<Node> node, std::string trace);
+
+  ObjectFactory m_queueFactory;   //!< Queue Factory
+  ObjectFactory m_deviceFactory;  //!< Device Factory
+  ObjectFactory m_channelFactory; //!< Channel Factory
+  std::map<std::string, Ptr<const CapacityTrace> > m_traces;  //!< Loaded trace files
+};
+
+} // namespace ns3
+
+#endif /* TRACE_DRIVEN_HELPER_H */
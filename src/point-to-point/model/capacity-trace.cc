@@ -0,0 +1,233 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include "capacity-trace.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CapacityTrace");
+
+/// Size of a delivery opportunity of a Mahimahi trace
+static const uint32_t MAHIMAHI_MTU = 1500;
+
+CapacityTrace::Cursor::Cursor ()
+  : piece (0),
+    cycle (0)
+{
+}
+
+CapacityTrace::CapacityTrace ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CapacityTrace::Load (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ifstream is (filename.c_str ());
+  NS_ABORT_MSG_UNLESS (is.is_open (), "Cannot open capacity trace " << filename);
+  Load (is);
+  NS_ABORT_MSG_IF (m_rate.empty () || m_bytes.back () <= 0,
+                   "Capacity trace " << filename << " has no capacity");
+}
+
+void
+CapacityTrace::Load (std::istream &is)
+{
+  NS_LOG_FUNCTION (this);
+  m_start.clear ();
+  m_bytes.clear ();
+  m_rate.clear ();
+  m_delay.clear ();
+
+  std::vector<double> times;
+  std::vector<double> rates;
+  std::vector<double> delays;
+  bool csv = false;
+  std::string line;
+  while (std::getline (is, line))
+    {
+      line = line.substr (0, line.find ('#'));
+      if (line.find_first_not_of (" \t\r") == std::string::npos)
+        {
+          continue;
+        }
+      if (times.empty ())
+        {
+          csv = line.find (',') != std::string::npos;
+        }
+      std::replace (line.begin (), line.end (), ',', ' ');
+      std::istringstream fields (line);
+      double time;
+      double rate = 0;
+      double delay = 0;
+      fields >> time;
+      if (csv)
+        {
+          fields >> rate;
+        }
+      NS_ABORT_MSG_IF (fields.fail (), "Malformed capacity trace line: " << line);
+      if (csv && !(fields >> delay))
+        {
+          delay = 0;
+        }
+      NS_ABORT_MSG_IF (!times.empty () && time < times.back (), "Capacity trace going back in time at: " << line);
+      times.push_back (time);
+      rates.push_back (rate);
+      delays.push_back (delay);
+    }
+  if (times.empty ())
+    {
+      return;
+    }
+  if (!csv)
+    {
+      LoadMahimahi (times);
+      return;
+    }
+  for (uint32_t i = 0; i < times.size (); ++i)
+    {
+      double duration;
+      if (i + 1 < times.size ())
+        {
+          duration = times[i + 1] - times[i];
+        }
+      else
+        {
+          duration = i > 0 ? times[i] - times[i - 1] : 1.0;
+        }
+      if (duration > 0)
+        {
+          AddPiece (Seconds (duration), DataRate (static_cast<uint64_t> (rates[i])), Seconds (delays[i] / 1000));
+        }
+    }
+}
+
+void
+CapacityTrace::LoadMahimahi (const std::vector<double> &samples)
+{
+  NS_LOG_FUNCTION (this << samples.size ());
+  // count the opportunities of each millisecond, the first one ending at 1 ms
+  int64_t end = std::max<int64_t> (static_cast<int64_t> (samples.back ()), 1);
+  std::vector<double>::const_iterator sample = samples.begin ();
+  for (int64_t ms = 1; ms <= end; ++ms)
+    {
+      uint64_t count = 0;
+      while (sample != samples.end () && *sample <= ms)
+        {
+          ++count;
+          ++sample;
+        }
+      AddPiece (MilliSeconds (1), DataRate (count * MAHIMAHI_MTU * 8 * 1000));
+    }
+}
+
+void
+CapacityTrace::AddPiece (Time duration, DataRate rate, Time delay)
+{
+  NS_LOG_FUNCTION (this << duration << rate << delay);
+  NS_ABORT_MSG_IF (duration.IsStrictlyNegative () || duration.IsZero (), "Empty piece in a capacity trace");
+  int64_t steps = duration.GetTimeStep ();
+  double bytesPerStep = rate.GetBitRate () / 8.0 / Seconds (1).GetTimeStep ();
+  if (m_start.empty ())
+    {
+      m_start.push_back (0);
+      m_bytes.push_back (0);
+    }
+  if (!m_rate.empty () && m_rate.back () == bytesPerStep && m_delay.back () == delay)
+    {
+      m_start.back () += steps;
+      m_bytes.back () += bytesPerStep * steps;
+      return;
+    }
+  m_rate.push_back (bytesPerStep);
+  m_delay.push_back (delay);
+  m_start.push_back (m_start.back () + steps);
+  m_bytes.push_back (m_bytes.back () + bytesPerStep * steps);
+}
+
+Time
+CapacityTrace::GetPeriod (void) const
+{
+  return m_start.empty () ? Seconds (0) : TimeStep (m_start.back ());
+}
+
+uint32_t
+CapacityTrace::GetNPieces (void) const
+{
+  return m_rate.size ();
+}
+
+void
+CapacityTrace::Seek (Cursor &cursor, int64_t time) const
+{
+  int64_t period = m_start.back ();
+  int64_t offset = time - cursor.cycle * period;
+  if (offset < m_start[cursor.piece] || offset >= period)
+    {
+      // idle for a whole cycle, or a new cursor
+      cursor.cycle = time / period;
+      offset = time - cursor.cycle * period;
+      cursor.piece = std::upper_bound (m_start.begin (), m_start.end (), offset) - m_start.begin () - 1;
+    }
+  else if (offset >= m_start[cursor.piece + 1])
+    {
+      cursor.piece = std::upper_bound (m_start.begin () + cursor.piece + 1, m_start.end (), offset) - m_start.begin () - 1;
+    }
+}
+
+Time
+CapacityTrace::Transmit (Cursor &cursor, Time start, uint32_t bytes) const
+{
+  NS_ASSERT_MSG (!m_rate.empty () && m_bytes.back () > 0, "No capacity in the trace");
+  int64_t period = m_start.back ();
+  Seek (cursor, start.GetTimeStep ());
+  if (bytes == 0)
+    {
+      return start;
+    }
+  uint32_t i = cursor.piece;
+  int64_t offset = start.GetTimeStep () - cursor.cycle * period;
+  double target = m_bytes[i] + m_rate[i] * (offset - m_start[i]) + bytes;
+  // the pieces without enough capacity left, and the outages, are skipped
+  while (target > m_bytes[i + 1])
+    {
+      if (++i == m_rate.size ())
+        {
+          i = 0;
+          cursor.cycle++;
+          target -= m_bytes.back ();
+        }
+    }
+  cursor.piece = i;
+  double end = m_start[i] + (target - m_bytes[i]) / m_rate[i];
+  return TimeStep (cursor.cycle * period + static_cast<int64_t> (std::ceil (end)));
+}
+
+Time
+CapacityTrace::GetDelay (const Cursor &cursor) const
+{
+  return m_delay[cursor.piece];
+}
+
+} // namespace ns3
@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CAPACITY_TRACE_H
+#define CAPACITY_TRACE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <istream>
+#include "ns3/simple-ref-count.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup point-to-point
+ * \brief The capacity of a link over time, replayed in a loop
+ *
+ * The trace is a piecewise constant data rate, with an optional extra
+ * delay per piece.  It is stored as a schedule of breakpoints: the
+ * start time of each piece, the bytes which can be sent from the start
+ * of the trace to that time, and the rate of the piece.  The end of a
+ * transmission is found by walking this curve from a Cursor kept by the
+ * transmitter, so that consecutive packets only look at the next
+ * breakpoints instead of searching the trace.
+ *
+ * Two text formats are read, one sample per line, '#' starting a comment:
+ * - the Mahimahi format: the time in milliseconds of each delivery
+ *   opportunity of an MTU (1500 bytes), the trace lasting until the last
+ *   opportunity.  An opportunity at t delivers its bytes during the
+ *   millisecond before t.
+ * - the CSV format: "time,rate[,delay]", the start time of a piece in
+ *   seconds, its rate in bit/s and its extra delay in milliseconds.  The
+ *   last piece lasts as long as the one before it, or one second if it
+ *   is alone.
+ *
+ * A trace is shared by all the devices replaying it; each one keeps its
+ * own Cursor.
+ */
+class CapacityTrace : public SimpleRefCount<CapacityTrace>
+{
+public:
+  /// The position of a transmitter in the trace
+  struct Cursor
+  {
+    Cursor ();
+    uint32_t piece;   //!< the current piece
+    int64_t cycle;    //!< the number of times the trace was replayed
+  };
+
+  CapacityTrace ();
+
+  /**
+   * \brief Load a trace file
+   * \param filename the name of the file
+   *
+   * The format is detected from the first sample.  Fails if the file
+   * cannot be read or holds no capacity.
+   */
+  void Load (std::string filename);
+
+  /**
+   * \brief Load a trace
+   * \param is the stream to read the trace from
+   */
+  void Load (std::istream &is);
+
+  /**
+   * \brief Append a piece to the trace
+   * \param duration the duration of the piece
+   * \param rate the data rate of the piece
+   * \param delay the extra delay of the packets sent during the piece
+   */
+  void AddPiece (Time duration, DataRate rate, Time delay = Seconds (0));
+
+  /**
+   * \returns the duration of one replay of the trace
+   */
+  Time GetPeriod (void) const;
+
+  /**
+   * \returns the number of pieces of the trace, after merging the
+   * consecutive pieces of equal rate and delay
+   */
+  uint32_t GetNPieces (void) const;
+
+  /**
+   * \brief Compute the end of a transmission
+   * \param cursor the position of the transmitter, moved to the end of
+   * the transmission
+   * \param start the absolute time when the transmission starts, not
+   * before the end of the previous transmission with this cursor
+   * \param bytes the size of the transmitted packet
+   * \returns the absolute time when the transmission ends
+   */
+  Time Transmit (Cursor &cursor, Time start, uint32_t bytes) const;
+
+  /**
+   * \param cursor the position of a transmitter
+   * \returns the extra delay of the piece of the cursor
+   */
+  Time GetDelay (const Cursor &cursor) const;
+
+private:
+  /**
+   * \brief Load a trace in the Mahimahi format
+   * \param samples the delivery opportunities, in milliseconds
+   */
+  void LoadMahimahi (const std::vector<double> &samples);
+
+  /**
+   * \brief Move a cursor to the piece of a time
+   * \param cursor the cursor
+   * \param time the time, in time steps
+   */
+  void Seek (Cursor &cursor, int64_t time) const;
+
+  std::vector<int64_t> m_start;  //!< Start of each piece and end of the trace, in time steps
+  std::vector<double> m_bytes;   //!< Bytes sent before the start of each piece and the end of the trace
+  std::vector<double> m_rate;    //!< Rate of each piece, in bytes per time step
+  std::vector<Time> m_delay;     //!< Extra delay of each piece
+};
+
+} // namespace ns3
+
+#endif /* CAPACITY_TRACE_H */
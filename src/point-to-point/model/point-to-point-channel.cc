@@ -96,13 +96,14 @@ PointToPointChannel::TransmitStart (
   NS_ASSERT (m_link[1].m_state != INITIALIZING);
 
   uint32_t wire = src == m_link[0].m_src ? 0 : 1;
+  Time delay = GetPropagationDelay (src, txTime);
 
   Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
-                                  txTime + m_delay, &PointToPointNetDevice::Receive,
+                                  txTime + delay, &PointToPointNetDevice::Receive,
                                   m_link[wire].m_dst, p->Copy ());
 
   // Call the tx anim callback on the net device
-  m_txrxPointToPoint (p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
+  m_txrxPointToPoint (p, src, m_link[wire].m_dst, txTime, txTime + delay);
   return true;
 }
 
@@ -146,6 +147,12 @@ PointToPointChannel::GetDestination (uint32_t i) const
   return m_link[i].m_dst;
 }
 
+Time
+PointToPointChannel::GetPropagationDelay (Ptr<PointToPointNetDevice> src, Time txTime)
+{
+  return m_delay;
+}
+
 bool
 PointToPointChannel::IsInitialized (void) const
 {
@@ -69,7 +69,7 @@ public:
    * \brief Attach a given netdevice to this channel
    * \param device pointer to the netdevice to attach to the channel
    */
-  void Attach (Ptr<PointToPointNetDevice> device);
+  virtual void Attach (Ptr<PointToPointNetDevice> device);
 
   /**
    * \brief Transmit a packet over this channel
@@ -129,6 +129,19 @@ protected:
    */
   Ptr<PointToPointNetDevice> GetDestination (uint32_t i) const;
 
+  /**
+   * \brief Get the propagation delay of a packet
+   *
+   * Called once per packet by TransmitStart.  By default, this is the
+   * Delay attribute of the channel.
+   *
+   * \param src the device transmitting the packet
+   * \param txTime the transmission time of the packet
+   * \returns the time between the end of the transmission and the
+   * reception of the last bit
+   */
+  virtual Time GetPropagationDelay (Ptr<PointToPointNetDevice> src, Time txTime);
+
   /**
    * TracedCallback signature for packet transmission animation events.
    *
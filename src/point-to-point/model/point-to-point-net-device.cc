@@ -248,7 +248,7 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   m_currentPkt = p;
   m_phyTxBeginTrace (m_currentPkt);
 
-  Time txTime = m_bps.CalculateBytesTxTime (p->GetSize ());
+  Time txTime = CalculateTxTime (p);
   Time txCompleteTime = txTime + m_tInterframeGap;
 
   NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.GetSeconds () << "sec");
@@ -262,6 +262,12 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   return result;
 }
 
+Time
+PointToPointNetDevice::CalculateTxTime (Ptr<const Packet> p)
+{
+  return m_bps.CalculateBytesTxTime (p->GetSize ());
+}
+
 void
 PointToPointNetDevice::TransmitComplete (void)
 {
@@ -198,6 +198,17 @@ protected:
    */
   void DoMpiReceive (Ptr<Packet> p);
 
+  /**
+   * \brief Compute the time needed to put a packet on the wire
+   *
+   * Called once per packet when its transmission starts.  By default
+   * the packet is sent at the DataRate of the device.
+   *
+   * \param p the packet to transmit
+   * \returns the transmission time of the packet
+   */
+  virtual Time CalculateTxTime (Ptr<const Packet> p);
+
 private:
 
   /**
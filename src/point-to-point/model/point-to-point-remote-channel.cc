@@ -23,6 +23,7 @@
 #include "point-to-point-remote-channel.h"
 #include "point-to-point-net-device.h"
 #include "ns3/packet.h"
+#include "ns3/node.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/mpi-interface.h"
@@ -45,7 +46,8 @@ PointToPointRemoteChannel::GetTypeId (void)
 }
 
 PointToPointRemoteChannel::PointToPointRemoteChannel ()
-  : PointToPointChannel ()
+  : PointToPointChannel (),
+    m_nDevices (0)
 {
 }
 
@@ -53,6 +55,16 @@ PointToPointRemoteChannel::~PointToPointRemoteChannel ()
 {
 }
 
+void
+PointToPointRemoteChannel::Attach (Ptr<PointToPointNetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  PointToPointChannel::Attach (device);
+  m_nodeId[m_nDevices] = device->GetNode ()->GetId ();
+  m_ifIndex[m_nDevices] = device->GetIfIndex ();
+  m_nDevices++;
+}
+
 bool
 PointToPointRemoteChannel::TransmitStart (
   Ptr<const Packet> p,
@@ -64,16 +76,10 @@ PointToPointRemoteChannel::TransmitStart (
 
   IsInitialized ();
 
-  uint32_t wire = src == GetSource (0) ? 0 : 1;
-  Ptr<PointToPointNetDevice> dst = GetDestination (wire);
-
-#ifdef NS3_MPI
+  uint32_t wire = src->GetNode ()->GetId () == m_nodeId[0] && src->GetIfIndex () == m_ifIndex[0] ? 0 : 1;
   // Calculate the rxTime (absolute)
   Time rxTime = Simulator::Now () + txTime + GetDelay ();
-  MpiInterface::SendPacket (p->Copy (), rxTime, dst->GetNode ()->GetId (), dst->GetIfIndex ());
-#else
-  NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
-#endif
+  MpiInterface::SendPacket (p->Copy (), rxTime, m_nodeId[1 - wire], m_ifIndex[1 - wire]);
   return true;
 }
 
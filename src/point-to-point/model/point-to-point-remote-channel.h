@@ -37,6 +37,10 @@ namespace ns3 {
  * This object connects two point-to-point net devices where at least one
  * is not local to this simulator object. It simply override the transmit
  * method and uses an MPI Send operation instead.
+ *
+ * With a MultithreadedSimulatorImpl, both devices are local but they
+ * belong to partitions simulated by different threads; the packet is
+ * then handed over by the SharedMemoryInterface.
  */
 class PointToPointRemoteChannel : public PointToPointChannel
 {
@@ -58,6 +62,17 @@ public:
    */
   ~PointToPointRemoteChannel ();
 
+  /**
+   * \brief Attach a given netdevice to this channel
+   *
+   * The node and interface index of the device are remembered, so that
+   * a transmission does not touch the device at the other end, which
+   * may be simulated by another thread.
+   *
+   * \param device pointer to the netdevice to attach to the channel
+   */
+  virtual void Attach (Ptr<PointToPointNetDevice> device);
+
   /**
    * \brief Transmit the packet
    *
@@ -68,6 +83,11 @@ public:
    */
   virtual bool TransmitStart (Ptr<const Packet> p, Ptr<PointToPointNetDevice> src,
                               Time txTime);
+
+private:
+  uint32_t m_nDevices;                //!< Number of attached devices
+  uint32_t m_nodeId[2];               //!< Node of each attached device
+  uint32_t m_ifIndex[2];              //!< Interface index of each attached device
 };
 
 } // namespace ns3
@@ -0,0 +1,68 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "trace-driven-channel.h"
+#include "trace-driven-net-device.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TraceDrivenChannel");
+
+NS_OBJECT_ENSURE_REGISTERED (TraceDrivenChannel);
+
+TypeId
+TraceDrivenChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TraceDrivenChannel")
+    .SetParent<PointToPointChannel> ()
+    .SetGroupName ("PointToPoint")
+    .AddConstructor<TraceDrivenChannel> ()
+  ;
+  return tid;
+}
+
+TraceDrivenChannel::TraceDrivenChannel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TraceDrivenChannel::Attach (Ptr<PointToPointNetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  NS_ASSERT_MSG (DynamicCast<TraceDrivenNetDevice> (device) != 0,
+                 "Only a TraceDrivenNetDevice can be attached to a TraceDrivenChannel");
+  PointToPointChannel::Attach (device);
+}
+
+Time
+TraceDrivenChannel::GetPropagationDelay (Ptr<PointToPointNetDevice> src, Time txTime)
+{
+  uint32_t wire = src == GetSource (0) ? 0 : 1;
+  Time delay = GetDelay () + StaticCast<TraceDrivenNetDevice> (src)->GetTraceDelay ();
+  Time rx = Simulator::Now () + txTime + delay;
+  if (rx < m_lastRx[wire])
+    {
+      rx = m_lastRx[wire];
+      delay = rx - Simulator::Now () - txTime;
+    }
+  m_lastRx[wire] = rx;
+  return delay;
+}
+
+} // namespace ns3
@@ -0,0 +1,61 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRACE_DRIVEN_CHANNEL_H
+#define TRACE_DRIVEN_CHANNEL_H
+
+#include "point-to-point-channel.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup point-to-point
+ * \brief A PointToPointChannel between two TraceDrivenNetDevice
+ *
+ * The propagation delay of a packet is the Delay attribute of the
+ * channel plus the extra delay of the capacity trace of its transmitter
+ * when its transmission ends.  A packet is never received before the
+ * packets sent before it in the same direction, even when the extra
+ * delay decreases.
+ */
+class TraceDrivenChannel : public PointToPointChannel
+{
+public:
+  /**
+   * \brief Get the TypeId
+   *
+   * \return The TypeId for this class
+   */
+  static TypeId GetTypeId (void);
+
+  TraceDrivenChannel ();
+
+  /**
+   * \brief Attach a TraceDrivenNetDevice to this channel
+   * \param device the device to attach to the channel
+   */
+  virtual void Attach (Ptr<PointToPointNetDevice> device);
+
+protected:
+  virtual Time GetPropagationDelay (Ptr<PointToPointNetDevice> src, Time txTime);
+
+private:
+  Time m_lastRx[2];   //!< Reception of the last packet in each direction
+};
+
+} // namespace ns3
+
+#endif /* TRACE_DRIVEN_CHANNEL_H */
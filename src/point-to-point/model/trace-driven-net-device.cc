@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "trace-driven-net-device.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/string.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TraceDrivenNetDevice");
+
+NS_OBJECT_ENSURE_REGISTERED (TraceDrivenNetDevice);
+
+TypeId
+TraceDrivenNetDevice::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TraceDrivenNetDevice")
+    .SetParent<PointToPointNetDevice> ()
+    .SetGroupName ("PointToPoint")
+    .AddConstructor<TraceDrivenNetDevice> ()
+    .AddAttribute ("TraceFile",
+                   "The file of the capacity trace of the transmissions, "
+                   "in the Mahimahi or in the CSV format (see CapacityTrace)",
+                   StringValue (""),
+                   MakeStringAccessor (&TraceDrivenNetDevice::SetTraceFile,
+                                       &TraceDrivenNetDevice::GetTraceFile),
+                   MakeStringChecker ())
+    .AddAttribute ("TraceOffset",
+                   "The position in the capacity trace at the start of the simulation",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&TraceDrivenNetDevice::m_traceOffset),
+                   MakeTimeChecker (Seconds (0)))
+  ;
+  return tid;
+}
+
+TraceDrivenNetDevice::TraceDrivenNetDevice ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TraceDrivenNetDevice::~TraceDrivenNetDevice ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TraceDrivenNetDevice::SetCapacityTrace (Ptr<const CapacityTrace> trace)
+{
+  NS_LOG_FUNCTION (this << trace);
+  m_trace = trace;
+  m_cursor = CapacityTrace::Cursor ();
+}
+
+Ptr<const CapacityTrace>
+TraceDrivenNetDevice::GetCapacityTrace (void) const
+{
+  return m_trace;
+}
+
+void
+TraceDrivenNetDevice::SetTraceFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_traceFile = filename;
+  if (filename.empty ())
+    {
+      return;
+    }
+  Ptr<CapacityTrace> trace = Create<CapacityTrace> ();
+  trace->Load (filename);
+  SetCapacityTrace (trace);
+}
+
+std::string
+TraceDrivenNetDevice::GetTraceFile (void) const
+{
+  return m_traceFile;
+}
+
+Time
+TraceDrivenNetDevice::GetTraceDelay (void) const
+{
+  return m_trace ? m_trace->GetDelay (m_cursor) : Seconds (0);
+}
+
+Time
+TraceDrivenNetDevice::CalculateTxTime (Ptr<const Packet> p)
+{
+  if (!m_trace)
+    {
+      return PointToPointNetDevice::CalculateTxTime (p);
+    }
+  Time start = Simulator::Now () + m_traceOffset;
+  return m_trace->Transmit (m_cursor, start, p->GetSize ()) - start;
+}
+
+} // namespace ns3
@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRACE_DRIVEN_NET_DEVICE_H
+#define TRACE_DRIVEN_NET_DEVICE_H
+
+#include <string>
+#include "ns3/nstime.h"
+#include "point-to-point-net-device.h"
+#include "capacity-trace.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup point-to-point
+ * \brief A PointToPointNetDevice whose data rate follows a CapacityTrace
+ *
+ * The transmission time of each packet is the time needed to send its
+ * bytes at the capacity of the trace from the start of the
+ * transmission, so that a link of a cellular network can be replayed
+ * without simulating its radio stack.  The trace is replayed in a loop,
+ * from the TraceOffset attribute at the start of the simulation.
+ * Without a trace, the device sends at its DataRate.
+ *
+ * The extra delay of the trace is added by a TraceDrivenChannel.
+ */
+class TraceDrivenNetDevice : public PointToPointNetDevice
+{
+public:
+  /**
+   * \brief Get the TypeId
+   *
+   * \return The TypeId for this class
+   */
+  static TypeId GetTypeId (void);
+
+  TraceDrivenNetDevice ();
+  virtual ~TraceDrivenNetDevice ();
+
+  /**
+   * \brief Set the capacity of the transmissions of this device
+   * \param trace the trace, which may be shared with other devices
+   */
+  void SetCapacityTrace (Ptr<const CapacityTrace> trace);
+
+  /**
+   * \returns the capacity of the transmissions of this device
+   */
+  Ptr<const CapacityTrace> GetCapacityTrace (void) const;
+
+  /**
+   * \returns the extra delay of the trace at the end of the last
+   * transmission
+   */
+  Time GetTraceDelay (void) const;
+
+protected:
+  virtual Time CalculateTxTime (Ptr<const Packet> p);
+
+private:
+  /**
+   * \brief Load the capacity trace from a file
+   * \param filename the name of the file, nothing is loaded if empty
+   */
+  void SetTraceFile (std::string filename);
+
+  /**
+   * \returns the name of the file of the capacity trace
+   */
+  std::string GetTraceFile (void) const;
+
+  Ptr<const CapacityTrace> m_trace;   //!< Capacity of the transmissions
+  CapacityTrace::Cursor m_cursor;     //!< Position of the last transmission in the trace
+  std::string m_traceFile;            //!< File of the trace, if loaded by the TraceFile attribute
+  Time m_traceOffset;                 //!< Position in the trace at the start of the simulation
+};
+
+} // namespace ns3
+
+#endif /* TRACE_DRIVEN_NET_DEVICE_H */
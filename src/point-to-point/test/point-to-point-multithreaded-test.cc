@@ -0,0 +1,219 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/point-to-point-remote-channel.h"
+
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \brief Compare a multi-threaded run of a partitioned chain with the
+ * same run on the default simulator
+ *
+ * Every node of a chain of point-to-point links is in its own
+ * partition.  The two ends send packets of distinct sizes to each other
+ * and the nodes in between forward them, so the links queue and every
+ * packet crosses all the partitions.  Each node records the time and
+ * size of the packets it receives: the MultithreadedSimulatorImpl must
+ * give the same records as the DefaultSimulatorImpl.
+ */
+class PointToPointMultithreadedTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointMultithreadedTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /** The time and size of a received packet. */
+  typedef std::pair<int64_t, uint32_t> Record;
+
+  /**
+   * \brief Run the scenario with a simulator
+   *
+   * \param simulatorType the SimulatorImplementationType
+   * \return the packets received by each node
+   */
+  std::vector<std::vector<Record> > RunChain (const std::string &simulatorType);
+
+  /**
+   * \brief Send a packet
+   *
+   * \param device the sending device
+   * \param size the size of the packet
+   */
+  void SendPacket (Ptr<NetDevice> device, uint32_t size);
+
+  /**
+   * \brief Record a packet and forward it to the next link of the chain
+   *
+   * \param device the receiving device
+   * \param packet the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \param to the destination address
+   * \param packetType the type of the packet
+   */
+  void Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                const Address &from, const Address &to, NetDevice::PacketType packetType);
+
+  /** The packets received by each node, only accessed by its partition. */
+  std::vector<std::vector<Record> > m_received;
+};
+
+/** Number of nodes, and of partitions, of the chain. */
+static const uint32_t N_NODES = 4;
+/** Number of packets sent by each end of the chain. */
+static const uint32_t N_PACKETS = 50;
+
+PointToPointMultithreadedTest::PointToPointMultithreadedTest ()
+  : TestCase ("Multi-threaded run of a partitioned point-to-point chain")
+{
+}
+
+void
+PointToPointMultithreadedTest::SendPacket (Ptr<NetDevice> device, uint32_t size)
+{
+  device->Send (Create<Packet> (size), device->GetBroadcast (), 0x800);
+}
+
+void
+PointToPointMultithreadedTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                                        const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  Ptr<Node> node = device->GetNode ();
+  m_received[node->GetId ()].push_back (std::make_pair (Simulator::Now ().GetTimeStep (), packet->GetSize ()));
+  if (node->GetNDevices () == 2)
+    {
+      Ptr<NetDevice> next = node->GetDevice (node->GetDevice (0) == device ? 1 : 0);
+      next->Send (packet->Copy (), next->GetBroadcast (), protocol);
+    }
+}
+
+std::vector<std::vector<PointToPointMultithreadedTest::Record> >
+PointToPointMultithreadedTest::RunChain (const std::string &simulatorType)
+{
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue (simulatorType));
+  bool parallel = simulatorType == "ns3::MultithreadedSimulatorImpl";
+  if (parallel)
+    {
+      MpiInterface::Enable (0, 0);
+    }
+
+  NodeContainer nodes;
+  for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+      nodes.Create (1, i);
+    }
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer devices;
+  for (uint32_t i = 0; i + 1 < N_NODES; ++i)
+    {
+      NetDeviceContainer link = p2p.Install (nodes.Get (i), nodes.Get (i + 1));
+      NS_TEST_EXPECT_MSG_EQ ((DynamicCast<PointToPointRemoteChannel> (link.Get (0)->GetChannel ()) != 0), parallel,
+                             "Unexpected channel between two partitions");
+      devices.Add (link);
+    }
+
+  m_received.assign (N_NODES, std::vector<Record> ());
+  for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+      nodes.Get (i)->RegisterProtocolHandler (MakeCallback (&PointToPointMultithreadedTest::Receive, this),
+                                              0, 0, false);
+    }
+
+  // a packet every millisecond from both ends, faster than the links
+  // serve them
+  Ptr<NetDevice> first = devices.Get (0);
+  Ptr<NetDevice> last = devices.Get (devices.GetN () - 1);
+  for (uint32_t i = 0; i < N_PACKETS; ++i)
+    {
+      Simulator::ScheduleWithContext (first->GetNode ()->GetId (), MilliSeconds (i),
+                                      &PointToPointMultithreadedTest::SendPacket, this, first, 100 + i);
+      Simulator::ScheduleWithContext (last->GetNode ()->GetId (), MilliSeconds (i),
+                                      &PointToPointMultithreadedTest::SendPacket, this, last, 200 + i);
+    }
+
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  if (parallel)
+    {
+      MpiInterface::Disable ();
+    }
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  return m_received;
+}
+
+void
+PointToPointMultithreadedTest::DoRun (void)
+{
+  std::vector<std::vector<Record> > expected = RunChain ("ns3::DefaultSimulatorImpl");
+  NS_TEST_ASSERT_MSG_EQ (expected[0].size (), N_PACKETS, "The first node did not receive all the packets");
+  NS_TEST_ASSERT_MSG_EQ (expected[N_NODES - 1].size (), N_PACKETS, "The last node did not receive all the packets");
+
+  std::vector<std::vector<Record> > received = RunChain ("ns3::MultithreadedSimulatorImpl");
+  for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (received[i].size (), expected[i].size (), "Node " << i << " received a different number of packets");
+      for (std::size_t j = 0; j < expected[i].size (); ++j)
+        {
+          NS_TEST_ASSERT_MSG_EQ (received[i][j].first, expected[i][j].first, "Packet " << j << " of node " << i << " received at another time");
+          NS_TEST_ASSERT_MSG_EQ (received[i][j].second, expected[i][j].second, "Packet " << j << " of node " << i << " has another size");
+        }
+    }
+}
+
+/**
+ * \brief TestSuite for the multi-threaded simulation of point-to-point links
+ */
+class PointToPointMultithreadedTestSuite : public TestSuite
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  PointToPointMultithreadedTestSuite ();
+};
+
+PointToPointMultithreadedTestSuite::PointToPointMultithreadedTestSuite ()
+  : TestSuite ("devices-point-to-point-multithreaded", SYSTEM)
+{
+  AddTestCase (new PointToPointMultithreadedTest, TestCase::QUICK);
+}
+
+static PointToPointMultithreadedTestSuite g_pointToPointMultithreadedTestSuite; //!< The testsuite
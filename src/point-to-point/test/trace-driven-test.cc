@@ -0,0 +1,217 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/simulator.h"
+#include "ns3/capacity-trace.h"
+#include "ns3/trace-driven-net-device.h"
+#include "ns3/trace-driven-channel.h"
+
+using namespace ns3;
+
+/**
+ * \brief Test the loading and the replay of a CapacityTrace
+ */
+class CapacityTraceTest : public TestCase
+{
+public:
+  CapacityTraceTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Transmit on a trace with a new cursor
+   * \param trace the trace
+   * \param start the start of the transmission
+   * \param bytes the size of the packet
+   * \returns the end of the transmission
+   */
+  Time TransmitOnce (Ptr<const CapacityTrace> trace, Time start, uint32_t bytes);
+};
+
+CapacityTraceTest::CapacityTraceTest ()
+  : TestCase ("Capacity trace")
+{
+}
+
+Time
+CapacityTraceTest::TransmitOnce (Ptr<const CapacityTrace> trace, Time start, uint32_t bytes)
+{
+  CapacityTrace::Cursor cursor;
+  return trace->Transmit (cursor, start, bytes);
+}
+
+void
+CapacityTraceTest::DoRun (void)
+{
+  // 1 MB/s during 1 s, an outage of 1 s, then 2 MB/s during 1 s
+  std::istringstream csv ("# time,rate,delay\n"
+                          "0,8000000,20\n"
+                          "1,0\n"
+                          "2,16000000,5\n");
+  Ptr<CapacityTrace> trace = Create<CapacityTrace> ();
+  trace->Load (csv);
+  NS_TEST_ASSERT_MSG_EQ (trace->GetNPieces (), 3, "Wrong number of pieces");
+  NS_TEST_ASSERT_MSG_EQ (trace->GetPeriod (), Seconds (3), "The last piece lasts as long as the one before it");
+
+  NS_TEST_ASSERT_MSG_EQ (TransmitOnce (trace, Seconds (0), 1000), MilliSeconds (1), "Wrong time at 1 MB/s");
+  NS_TEST_ASSERT_MSG_EQ (TransmitOnce (trace, MicroSeconds (999500), 1000), MicroSeconds (2000250),
+                         "The outage should be skipped");
+  NS_TEST_ASSERT_MSG_EQ (TransmitOnce (trace, Seconds (3), 1000), MilliSeconds (3001), "The trace should loop");
+  NS_TEST_ASSERT_MSG_EQ (TransmitOnce (trace, Seconds (10.5), 1000), MicroSeconds (11000500),
+                         "Wrong time from an outage of a later cycle");
+
+  // consecutive transmissions move the cursor forward, across the cycles
+  CapacityTrace::Cursor cursor;
+  Time end = Seconds (0);
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      end = trace->Transmit (cursor, end, 1000000);
+    }
+  // 1 MB in the first cycle, 3 MB per cycle, the last 1 MB from 2 s to 2.5 s
+  NS_TEST_ASSERT_MSG_EQ (end, Seconds (3 + 2.5), "Wrong end of consecutive transmissions");
+  NS_TEST_ASSERT_MSG_EQ (trace->GetDelay (cursor), MilliSeconds (5), "Wrong delay of the last piece");
+  end = trace->Transmit (cursor, Seconds (6.5), 1000);
+  NS_TEST_ASSERT_MSG_EQ (end, MilliSeconds (6501), "Wrong time after going back to the first piece");
+  NS_TEST_ASSERT_MSG_EQ (trace->GetDelay (cursor), MilliSeconds (20), "Wrong delay of the first piece");
+
+  // two MTUs at 1 ms, none at 2 ms and one at 3 ms
+  std::istringstream mahimahi ("1\n1\n3\n");
+  trace->Load (mahimahi);
+  NS_TEST_ASSERT_MSG_EQ (trace->GetNPieces (), 3, "Wrong number of Mahimahi pieces");
+  NS_TEST_ASSERT_MSG_EQ (trace->GetPeriod (), MilliSeconds (3), "The Mahimahi trace ends at its last opportunity");
+  NS_TEST_ASSERT_MSG_EQ (TransmitOnce (trace, Seconds (0), 1500), MicroSeconds (500), "Wrong time in a Mahimahi trace");
+  NS_TEST_ASSERT_MSG_EQ (TransmitOnce (trace, Seconds (0), 4500), MilliSeconds (3), "Wrong time of a whole Mahimahi trace");
+
+  std::istringstream constant ("1\n2\n3\n4\n");
+  trace->Load (constant);
+  NS_TEST_ASSERT_MSG_EQ (trace->GetNPieces (), 1, "The pieces of equal rate should be merged");
+}
+
+/**
+ * \brief Test the transmission and the delay of TraceDrivenNetDevice over
+ * a TraceDrivenChannel
+ */
+class TraceDrivenDeviceTest : public TestCase
+{
+public:
+  TraceDrivenDeviceTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Send a packet
+   * \param device the transmitting device
+   * \param size the size of the packet, PPP header excluded
+   */
+  void Send (Ptr<TraceDrivenNetDevice> device, uint32_t size);
+
+  /**
+   * \brief Record the reception of a packet
+   * \param device the receiving device
+   * \param packet the packet
+   * \param protocol the protocol of the packet
+   * \param from the sender of the packet
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  std::vector<Time> m_rx;   //!< Receptions
+};
+
+TraceDrivenDeviceTest::TraceDrivenDeviceTest ()
+  : TestCase ("Trace driven device")
+{
+}
+
+void
+TraceDrivenDeviceTest::Send (Ptr<TraceDrivenNetDevice> device, uint32_t size)
+{
+  device->Send (Create<Packet> (size), device->GetBroadcast (), 0x800);
+}
+
+bool
+TraceDrivenDeviceTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  m_rx.push_back (Simulator::Now ());
+  return true;
+}
+
+void
+TraceDrivenDeviceTest::DoRun (void)
+{
+  // 1 MB/s with an extra delay of 20 ms, then 100 kB/s without extra delay
+  Ptr<CapacityTrace> trace = Create<CapacityTrace> ();
+  trace->AddPiece (Seconds (1), DataRate ("8Mb/s"), MilliSeconds (20));
+  trace->AddPiece (Seconds (1), DataRate ("800kb/s"));
+
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<TraceDrivenNetDevice> devA = CreateObject<TraceDrivenNetDevice> ();
+  Ptr<TraceDrivenNetDevice> devB = CreateObject<TraceDrivenNetDevice> ();
+  Ptr<TraceDrivenChannel> channel = CreateObject<TraceDrivenChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (1)));
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+  devA->SetCapacityTrace (trace);
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  devB->SetReceiveCallback (MakeCallback (&TraceDrivenDeviceTest::Receive, this));
+
+  // 1000 bytes with the PPP header
+  Simulator::Schedule (Seconds (0), &TraceDrivenDeviceTest::Send, this, devA, 998);
+  // the first packet ends with the first piece, the second one would
+  // overtake it without its extra delay
+  Simulator::Schedule (MilliSeconds (999), &TraceDrivenDeviceTest::Send, this, devA, 998);
+  Simulator::Schedule (MilliSeconds (999), &TraceDrivenDeviceTest::Send, this, devA, 998);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rx.size (), 3, "Packets were lost");
+  NS_TEST_ASSERT_MSG_EQ (m_rx[0], MilliSeconds (1 + 20 + 1), "Wrong reception in the first piece");
+  NS_TEST_ASSERT_MSG_EQ (m_rx[1], MilliSeconds (1000 + 20 + 1), "Wrong reception at the end of the first piece");
+  NS_TEST_ASSERT_MSG_EQ (m_rx[2], m_rx[1], "A packet overtook the one sent before it");
+}
+
+/**
+ * \brief TestSuite for the trace driven devices
+ */
+class TraceDrivenTestSuite : public TestSuite
+{
+public:
+  TraceDrivenTestSuite ();
+};
+
+TraceDrivenTestSuite::TraceDrivenTestSuite ()
+  : TestSuite ("devices-trace-driven", UNIT)
+{
+  AddTestCase (new CapacityTraceTest, TestCase::QUICK);
+  AddTestCase (new TraceDrivenDeviceTest, TestCase::QUICK);
+}
+
+static TraceDrivenTestSuite g_traceDrivenTestSuite; //!< The testsuite
@@ -100,5 +100,11 @@ ConstantSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const Sp
   return rxPsd;
 }
 
+bool
+ConstantSpectrumPropagationLossModel::DoIsTimeInvariant (void) const
+{
+  return true;
+}
+
 
 }  // namespace ns3
@@ -60,6 +60,7 @@ protected:
   double m_lossDb;      //!< Propagation loss [dB]
   double m_lossLinear;  //!< Propagation loss (linear)
 private:
+  virtual bool DoIsTimeInvariant (void) const;
 };
 
 
@@ -103,6 +103,11 @@ FriisSpectrumPropagationLossModel::CalculateLoss (double f, double d) const
 
 
 
+bool
+FriisSpectrumPropagationLossModel::DoIsTimeInvariant (void) const
+{
+  return true;
+}
 
 
 }  // namespace ns3
@@ -71,6 +71,9 @@ public:
    * @return if Prx < Ptx then return Prx; else return Ptx
    */
   double CalculateLoss (double f, double d) const;
+
+private:
+  virtual bool DoIsTimeInvariant (void) const;
 };
 
 
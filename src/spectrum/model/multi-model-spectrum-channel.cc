@@ -29,6 +29,7 @@
 #include <ns3/net-device.h>
 #include <ns3/node.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
 #include <ns3/mobility-model.h>
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-converter.h>
@@ -78,8 +79,20 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 {
 }
 
+/**
+ * \param mobility a mobility model
+ * \return true if the mobility model does not move
+ */
+static bool
+IsStatic (Ptr<const MobilityModel> mobility)
+{
+  Vector velocity = mobility->GetVelocity ();
+  return velocity.x == 0 && velocity.y == 0 && velocity.z == 0;
+}
+
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
-  : m_numDevices {0}
+  : m_numDevices {0},
+    m_cacheEnabled (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -90,6 +103,12 @@ MultiModelSpectrumChannel::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_txSpectrumModelInfoMap.clear ();
   m_rxSpectrumModelInfoMap.clear ();
+  for (MobilityCacheInfoMap_t::iterator it = m_cacheMobility.begin (); it != m_cacheMobility.end (); ++it)
+    {
+      it->first->TraceDisconnectWithoutContext ("CourseChange", it->second.courseChange);
+    }
+  m_cacheMobility.clear ();
+  ClearCache ();
   SpectrumChannel::DoDispose ();
 }
 
@@ -100,11 +119,95 @@ MultiModelSpectrumChannel::GetTypeId (void)
     .SetParent<SpectrumChannel> ()
     .SetGroupName ("Spectrum")
     .AddConstructor<MultiModelSpectrumChannel> ()
-
+    .AddAttribute ("PropagationCache",
+                   "Cache the propagation loss and delay between the mobility models which do not move. "
+                   "Only valid with deterministic propagation loss and delay models.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MultiModelSpectrumChannel::m_cacheEnabled),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
+void
+MultiModelSpectrumChannel::ClearCache (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_linkCache.clear ();
+  m_cachedLoss = 0;
+  m_cachedDelay = 0;
+  m_cachedSpectrumLoss = 0;
+}
+
+uint32_t
+MultiModelSpectrumChannel::WatchMobility (Ptr<MobilityModel> mobility)
+{
+  MobilityCacheInfoMap_t::iterator it = m_cacheMobility.find (mobility);
+  if (it == m_cacheMobility.end ())
+    {
+      NS_LOG_LOGIC ("watching the CourseChange of " << mobility);
+      MobilityCacheInfo info;
+      info.generation = 0;
+      info.courseChange = MakeCallback (&MultiModelSpectrumChannel::CourseChanged, this).Bind (PeekPointer (mobility));
+      mobility->TraceConnectWithoutContext ("CourseChange", info.courseChange);
+      it = m_cacheMobility.insert (std::make_pair (mobility, info)).first;
+    }
+  return it->second.generation;
+}
+
+void
+MultiModelSpectrumChannel::CourseChanged (MobilityModel *mobility, Ptr<const MobilityModel> model)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  MobilityCacheInfoMap_t::iterator it = m_cacheMobility.find (Ptr<MobilityModel> (mobility));
+  NS_ASSERT (it != m_cacheMobility.end ());
+  it->second.generation++;
+}
+
+MultiModelSpectrumChannel::LinkCacheEntry *
+MultiModelSpectrumChannel::LookupLink (Ptr<MobilityModel> txMobility, Ptr<MobilityModel> rxMobility)
+{
+  if (m_cachedLoss != m_propagationLoss
+      || m_cachedDelay != m_propagationDelay
+      || m_cachedSpectrumLoss != m_spectrumPropagationLoss)
+    {
+      // a model was set or chained since the entries were filled
+      ClearCache ();
+      m_cachedLoss = m_propagationLoss;
+      m_cachedDelay = m_propagationDelay;
+      m_cachedSpectrumLoss = m_spectrumPropagationLoss;
+    }
+
+  uint32_t txGeneration = WatchMobility (txMobility);
+  uint32_t rxGeneration = WatchMobility (rxMobility);
+  if (!IsStatic (txMobility) || !IsStatic (rxMobility))
+    {
+      return 0;
+    }
+
+  std::pair<LinkCache_t::iterator, bool> inserted =
+    m_linkCache.insert (std::make_pair (std::make_pair (txMobility, rxMobility), LinkCacheEntry ()));
+  LinkCacheEntry &entry = inserted.first->second;
+  if (inserted.second || entry.txGeneration != txGeneration || entry.rxGeneration != rxGeneration)
+    {
+      NS_LOG_LOGIC ("filling the cache entry of " << txMobility << " to " << rxMobility);
+      entry.txGeneration = txGeneration;
+      entry.rxGeneration = rxGeneration;
+      entry.propagationGainDb = 0;
+      if (m_propagationLoss)
+        {
+          entry.propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, rxMobility);
+        }
+      entry.delay = Seconds (0);
+      if (m_propagationDelay)
+        {
+          entry.delay = m_propagationDelay->GetDelay (txMobility, rxMobility);
+        }
+      entry.spectrumGain = 0;
+    }
+  return &entry;
+}
+
 void
 MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
 {
@@ -269,23 +372,23 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
           if ((*rxPhyIterator) != txParams->txPhy)
             {
-              NS_LOG_LOGIC ("copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
-              Time delay = MicroSeconds (0);
-
               Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+              double pathLossDb = 0;
+              LinkCacheEntry *link = 0;
 
               if (txMobility && receiverMobility)
                 {
+                  if (m_cacheEnabled)
+                    {
+                      link = LookupLink (txMobility, receiverMobility);
+                    }
                   double txAntennaGain = 0;
                   double rxAntennaGain = 0;
                   double propagationGainDb = 0;
-                  double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
+                  if (txParams->txAntenna != 0)
                     {
                       Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+                      txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
                       NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
                       pathLossDb -= txAntennaGain;
                     }
@@ -297,7 +400,13 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                       NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
                       pathLossDb -= rxAntennaGain;
                     }
-                  if (m_propagationLoss)
+                  if (link != 0)
+                    {
+                      propagationGainDb = link->propagationGainDb;
+                      NS_LOG_LOGIC ("cached propagationGainDb = " << propagationGainDb << " dB");
+                      pathLossDb -= propagationGainDb;
+                    }
+                  else if (m_propagationLoss)
                     {
                       propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
                       NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
@@ -310,18 +419,48 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                   m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
                   if (pathLossDb > m_maxLossDb)
                     {
-                      // beyond range
+                      // beyond range: do not copy the signal parameters
                       continue;
                     }
+                }
+
+              NS_LOG_LOGIC ("copying signal parameters " << txParams);
+              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+              if (convertedTxPowerSpectrum != txParams->psd)
+                {
+                  // Copy () already made a copy of the unconverted psd
+                  rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
+                }
+              Time delay = MicroSeconds (0);
+
+              if (txMobility && receiverMobility)
+                {
                   double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
                   *(rxParams->psd) *= pathGainLinear;              
 
-                  if (m_spectrumPropagationLoss)
+                  if (m_spectrumPropagationLoss && link != 0
+                      && m_spectrumPropagationLoss->IsTimeInvariant ())
+                    {
+                      if (link->spectrumGain == 0
+                          || link->spectrumGain->GetSpectrumModelUid () != rxParams->psd->GetSpectrumModelUid ())
+                        {
+                          // the gain in each band is the received PSD of a unit PSD
+                          Ptr<SpectrumValue> unit = Create<SpectrumValue> (rxParams->psd->GetSpectrumModel ());
+                          *unit = 1.0;
+                          link->spectrumGain = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (unit, txMobility, receiverMobility);
+                        }
+                      *(rxParams->psd) *= *(link->spectrumGain);
+                    }
+                  else if (m_spectrumPropagationLoss)
                     {
                       rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
                     }
 
-                  if (m_propagationDelay)
+                  if (link != 0)
+                    {
+                      delay = link->delay;
+                    }
+                  else if (m_propagationDelay)
                     {
                       delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
                     }
@@ -27,8 +27,11 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/nstime.h>
+#include <ns3/callback.h>
 #include <map>
 #include <set>
+#include <utility>
 
 namespace ns3 {
 
@@ -102,6 +105,18 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
  * called again passing the pointer to that SpectrumPhy.
+ *
+ * With the PropagationCache attribute, the channel keeps, for each pair
+ * of transmitter and receiver mobility models which do not move, the
+ * gain of the PropagationLossModel and the delay of the
+ * PropagationDelayModel, and, if the SpectrumPropagationLossModel is
+ * time invariant, its gain in each band.  An entry is invalidated by the
+ * CourseChange of either mobility model, and nothing is cached for a
+ * mobility model with a non-zero velocity, so that the cost of a
+ * transmission grows with the number of moving receivers only.  The
+ * antenna gains are always computed.  The cache assumes that the loss
+ * and delay models are deterministic; call ClearCache after changing
+ * their attributes.
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -124,6 +139,11 @@ public:
   virtual std::size_t GetNDevices (void) const;
   virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
 
+  /**
+   * \brief Drop the cached propagation of all the pairs of mobility models
+   */
+  void ClearCache (void);
+
 
 protected:
   void DoDispose ();
@@ -169,6 +189,62 @@ private:
    */
   std::size_t m_numDevices;
 
+  /** The propagation between two mobility models, see PropagationCache. */
+  struct LinkCacheEntry
+  {
+    uint32_t txGeneration;            //!< Generation of the TX mobility model
+    uint32_t rxGeneration;            //!< Generation of the RX mobility model
+    double propagationGainDb;         //!< Gain of the PropagationLossModel
+    Time delay;                       //!< Delay of the PropagationDelayModel
+    Ptr<SpectrumValue> spectrumGain;  //!< Gain of the SpectrumPropagationLossModel, or null
+  };
+
+  /** A mobility model watched by the cache. */
+  struct MobilityCacheInfo
+  {
+    uint32_t generation;  //!< Incremented at each CourseChange
+    Callback<void, Ptr<const MobilityModel> > courseChange;  //!< Connected to the CourseChange trace
+  };
+
+  /**
+   * \brief Get the cache entry of a pair of mobility models
+   *
+   * The entry is refreshed if either mobility model changed course since
+   * it was filled.
+   *
+   * \param txMobility the mobility model of the transmitter
+   * \param rxMobility the mobility model of the receiver
+   * \return the entry, or null if one of the two is moving
+   */
+  LinkCacheEntry * LookupLink (Ptr<MobilityModel> txMobility, Ptr<MobilityModel> rxMobility);
+
+  /**
+   * \brief Get the generation of a mobility model, watching its
+   * CourseChange on first use
+   * \param mobility the mobility model
+   * \return the generation of the mobility model
+   */
+  uint32_t WatchMobility (Ptr<MobilityModel> mobility);
+
+  /**
+   * \brief Invalidate the entries of a mobility model
+   * \param mobility the mobility model, as a raw pointer to find its info
+   * \param model the mobility model which changed course
+   */
+  void CourseChanged (MobilityModel *mobility, Ptr<const MobilityModel> model);
+
+  /// Container: pair of TX and RX mobility models, LinkCacheEntry
+  typedef std::map<std::pair<Ptr<MobilityModel>, Ptr<MobilityModel> >, LinkCacheEntry> LinkCache_t;
+  /// Container: mobility model, MobilityCacheInfo
+  typedef std::map<Ptr<MobilityModel>, MobilityCacheInfo> MobilityCacheInfoMap_t;
+
+  bool m_cacheEnabled;                    //!< Is the propagation cached
+  LinkCache_t m_linkCache;                //!< Cached propagation of the pairs of mobility models
+  MobilityCacheInfoMap_t m_cacheMobility; //!< Mobility models watched by the cache
+  Ptr<PropagationLossModel> m_cachedLoss;                  //!< Loss model of the cached gains
+  Ptr<PropagationDelayModel> m_cachedDelay;                //!< Delay model of the cached delays
+  Ptr<SpectrumPropagationLossModel> m_cachedSpectrumLoss;  //!< Spectrum loss model of the cached gains
+
 };
 
 
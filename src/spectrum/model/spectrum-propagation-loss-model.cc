@@ -73,4 +73,16 @@ SpectrumPropagationLossModel::CalcRxPowerSpectralDensity (Ptr<const SpectrumValu
   return rxPsd;
 }
 
+bool
+SpectrumPropagationLossModel::IsTimeInvariant (void) const
+{
+  return DoIsTimeInvariant () && (m_next == 0 || m_next->IsTimeInvariant ());
+}
+
+bool
+SpectrumPropagationLossModel::DoIsTimeInvariant (void) const
+{
+  return false;
+}
+
 } // namespace ns3
@@ -78,6 +78,13 @@ public:
                                                  Ptr<const MobilityModel> a,
                                                  Ptr<const MobilityModel> b) const;
 
+  /**
+   * \return true if, for a given pair of positions, the loss of this
+   * model and of the models chained to it does not change over time, so
+   * that a channel may cache it
+   */
+  bool IsTimeInvariant (void) const;
+
 protected:
   virtual void DoDispose ();
 
@@ -97,6 +104,12 @@ private:
                                                            Ptr<const MobilityModel> a,
                                                            Ptr<const MobilityModel> b) const = 0;
 
+  /**
+   * \return true if, for a given pair of positions, the loss of this
+   * model does not change over time.  The default is false.
+   */
+  virtual bool DoIsTimeInvariant (void) const;
+
   Ptr<SpectrumPropagationLossModel> m_next; //!< SpectrumPropagationLossModel chained to this one.
 };
 
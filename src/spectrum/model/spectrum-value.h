@@ -54,6 +54,12 @@ typedef std::vector<double> Values;
  * The intended use of this class is to represent frequency-dependent
  * things, such as power spectral densities, frequency-dependent
  * propagation losses, spectral masks, etc.
+ *
+ * The binary operators return a new SpectrumValue.  In code which runs
+ * for every signal, prefer the compound assignment operators and
+ * AddScaled on a SpectrumValue kept across calls, which allocate
+ * nothing.  The component loops are written over contiguous arrays so
+ * that the compiler vectorizes them.
  */
 class SpectrumValue : public SimpleRefCount<SpectrumValue>
 {
@@ -420,6 +426,15 @@ public:
    */
   SpectrumValue& operator= (double rhs);
 
+  /**
+   * Add the Right Hand Side multiplied by a scalar to *this, component
+   * by component, without the temporary of *this += x * s
+   *
+   * @param x the SpectrumValue to add
+   * @param s the scalar x is multiplied by
+   */
+  void AddScaled (const SpectrumValue& x, double s);
+
 
 
   /**
@@ -631,6 +646,31 @@ SpectrumValue Log2 (const SpectrumValue& arg);
 SpectrumValue Log (const SpectrumValue& arg);
 double Integral (const SpectrumValue& arg);
 
+/**
+ * \name Operators on temporaries
+ *
+ * These overloads compute the result in the storage of a temporary
+ * operand instead of allocating a new one, so that an expression such
+ * as a * b + c allocates a single SpectrumValue.  They give the same
+ * values as the operators on const references.
+ */
+//\{
+SpectrumValue operator+ (SpectrumValue&& lhs, const SpectrumValue& rhs);
+SpectrumValue operator+ (const SpectrumValue& lhs, SpectrumValue&& rhs);
+SpectrumValue operator+ (SpectrumValue&& lhs, SpectrumValue&& rhs);
+SpectrumValue operator+ (SpectrumValue&& lhs, double rhs);
+SpectrumValue operator+ (double lhs, SpectrumValue&& rhs);
+SpectrumValue operator- (SpectrumValue&& lhs, const SpectrumValue& rhs);
+SpectrumValue operator- (SpectrumValue&& lhs, double rhs);
+SpectrumValue operator* (SpectrumValue&& lhs, const SpectrumValue& rhs);
+SpectrumValue operator* (const SpectrumValue& lhs, SpectrumValue&& rhs);
+SpectrumValue operator* (SpectrumValue&& lhs, SpectrumValue&& rhs);
+SpectrumValue operator* (SpectrumValue&& lhs, double rhs);
+SpectrumValue operator* (double lhs, SpectrumValue&& rhs);
+SpectrumValue operator/ (SpectrumValue&& lhs, const SpectrumValue& rhs);
+SpectrumValue operator/ (SpectrumValue&& lhs, double rhs);
+//\}
+
 
 } // namespace ns3
 
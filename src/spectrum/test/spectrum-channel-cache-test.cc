@@ -0,0 +1,270 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/object.h>
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/boolean.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/net-device.h>
+#include <ns3/antenna-model.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/friis-spectrum-propagation-loss.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/propagation-delay-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/constant-velocity-mobility-model.h>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumChannelCacheTest");
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * A SpectrumPhy which records the total power of the signals it receives.
+ */
+class CacheTestPhy : public SpectrumPhy
+{
+public:
+  /**
+   * Constructor
+   * \param model the RX spectrum model
+   * \param mobility the mobility model
+   */
+  CacheTestPhy (Ptr<const SpectrumModel> model, Ptr<MobilityModel> mobility)
+    : m_model (model),
+      m_mobility (mobility)
+  {
+  }
+
+  // inherited from SpectrumPhy
+  virtual void SetDevice (Ptr<NetDevice> d)
+  {
+  }
+  virtual Ptr<NetDevice> GetDevice () const
+  {
+    return 0;
+  }
+  virtual void SetMobility (Ptr<MobilityModel> m)
+  {
+    m_mobility = m;
+  }
+  virtual Ptr<MobilityModel> GetMobility ()
+  {
+    return m_mobility;
+  }
+  virtual void SetChannel (Ptr<SpectrumChannel> c)
+  {
+  }
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const
+  {
+    return m_model;
+  }
+  virtual Ptr<AntennaModel> GetRxAntenna ()
+  {
+    return 0;
+  }
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params)
+  {
+    m_rxPower.push_back (Integral (*params->psd));
+  }
+
+  std::vector<double> m_rxPower; //!< Power of each received signal
+
+private:
+  Ptr<const SpectrumModel> m_model; //!< RX spectrum model
+  Ptr<MobilityModel> m_mobility;    //!< Mobility model
+};
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * A PropagationLossModel which counts how many times it is evaluated.
+ */
+class CountingPropagationLossModel : public PropagationLossModel
+{
+public:
+  CountingPropagationLossModel ()
+    : m_count (0),
+      m_loss (CreateObject<LogDistancePropagationLossModel> ())
+  {
+  }
+
+  uint32_t m_count; //!< Number of evaluations
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const
+  {
+    const_cast<CountingPropagationLossModel *> (this)->m_count++;
+    return m_loss->CalcRxPower (txPowerDbm, a, b);
+  }
+  virtual int64_t DoAssignStreams (int64_t stream)
+  {
+    return 0;
+  }
+
+  Ptr<PropagationLossModel> m_loss; //!< The evaluated model
+};
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Check that the PropagationCache of the MultiModelSpectrumChannel only
+ * evaluates the loss of the pairs of static nodes once until one of them
+ * changes course, and that the received signals do not change.
+ */
+class SpectrumChannelCacheTestCase : public TestCase
+{
+public:
+  SpectrumChannelCacheTestCase ();
+  virtual ~SpectrumChannelCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario
+   * \param cache enable the PropagationCache
+   * \param staticPower receives the power received by the static receiver
+   * \param movingPower receives the power received by the moving receiver
+   * \return the number of evaluations of the propagation loss model
+   */
+  uint32_t RunOne (bool cache, std::vector<double> &staticPower, std::vector<double> &movingPower);
+};
+
+SpectrumChannelCacheTestCase::SpectrumChannelCacheTestCase ()
+  : TestCase ("Propagation cache of the MultiModelSpectrumChannel")
+{
+}
+
+SpectrumChannelCacheTestCase::~SpectrumChannelCacheTestCase ()
+{
+}
+
+uint32_t
+SpectrumChannelCacheTestCase::RunOne (bool cache, std::vector<double> &staticPower, std::vector<double> &movingPower)
+{
+  Bands bands;
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      BandInfo band;
+      band.fl = 2.1e9 + i * 180e3;
+      band.fc = band.fl + 90e3;
+      band.fh = band.fl + 180e3;
+      bands.push_back (band);
+    }
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (bands);
+
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->SetAttribute ("PropagationCache", BooleanValue (cache));
+  Ptr<CountingPropagationLossModel> loss = CreateObject<CountingPropagationLossModel> ();
+  channel->AddPropagationLossModel (loss);
+  channel->AddSpectrumPropagationLossModel (CreateObject<FriisSpectrumPropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+
+  Ptr<MobilityModel> txMobility = CreateObject<ConstantPositionMobilityModel> ();
+  txMobility->SetPosition (Vector (0, 0, 0));
+  Ptr<MobilityModel> staticMobility = CreateObject<ConstantPositionMobilityModel> ();
+  staticMobility->SetPosition (Vector (100, 0, 0));
+  Ptr<ConstantVelocityMobilityModel> movingMobility = CreateObject<ConstantVelocityMobilityModel> ();
+  movingMobility->SetPosition (Vector (0, 200, 0));
+  movingMobility->SetVelocity (Vector (10, 0, 0));
+
+  Ptr<CacheTestPhy> txPhy = Create<CacheTestPhy> (model, txMobility);
+  Ptr<CacheTestPhy> staticPhy = Create<CacheTestPhy> (model, staticMobility);
+  Ptr<CacheTestPhy> movingPhy = Create<CacheTestPhy> (model, movingMobility);
+  channel->AddRx (txPhy);
+  channel->AddRx (staticPhy);
+  channel->AddRx (movingPhy);
+
+  Ptr<SpectrumValue> txPsd = Create<SpectrumValue> (model);
+  for (uint32_t i = 0; i < bands.size (); ++i)
+    {
+      (*txPsd)[i] = 1e-8 * (1 + i);
+    }
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->psd = txPsd;
+  params->duration = MilliSeconds (1);
+  params->txPhy = txPhy;
+
+  for (uint32_t i = 1; i <= 4; ++i)
+    {
+      Simulator::Schedule (Seconds (i), &MultiModelSpectrumChannel::StartTx, channel, params);
+    }
+  // move the static receiver between the third and the last transmission
+  Simulator::Schedule (Seconds (3.5), &MobilityModel::SetPosition, staticMobility, Vector (50, 0, 0));
+  Simulator::Stop (Seconds (5));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  staticPower = staticPhy->m_rxPower;
+  movingPower = movingPhy->m_rxPower;
+  return loss->m_count;
+}
+
+void
+SpectrumChannelCacheTestCase::DoRun (void)
+{
+  std::vector<double> staticPower;
+  std::vector<double> movingPower;
+  uint32_t count = RunOne (false, staticPower, movingPower);
+  NS_TEST_ASSERT_MSG_EQ (count, 8, "Without cache, the loss is evaluated for each receiver and transmission");
+
+  std::vector<double> cachedStaticPower;
+  std::vector<double> cachedMovingPower;
+  count = RunOne (true, cachedStaticPower, cachedMovingPower);
+  // the static receiver before and after its course change, and the
+  // moving receiver at each transmission
+  NS_TEST_ASSERT_MSG_EQ (count, 6, "With cache, the loss of the static pair is evaluated once per course");
+
+  NS_TEST_ASSERT_MSG_EQ (cachedStaticPower.size (), 4, "The static receiver missed a signal");
+  NS_TEST_ASSERT_MSG_EQ (cachedMovingPower.size (), 4, "The moving receiver missed a signal");
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (cachedStaticPower[i], staticPower[i], staticPower[i] * 1e-12,
+                                 "Cached power differs for the static receiver");
+      NS_TEST_ASSERT_MSG_EQ_TOL (cachedMovingPower[i], movingPower[i], movingPower[i] * 1e-12,
+                                 "Cached power differs for the moving receiver");
+    }
+  NS_TEST_ASSERT_MSG_GT (cachedStaticPower[3], cachedStaticPower[2], "The course change was not taken into account");
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test suite of the propagation cache of the spectrum channels.
+ */
+class SpectrumChannelCacheTestSuite : public TestSuite
+{
+public:
+  SpectrumChannelCacheTestSuite ();
+};
+
+SpectrumChannelCacheTestSuite::SpectrumChannelCacheTestSuite ()
+  : TestSuite ("spectrum-channel-cache", UNIT)
+{
+  AddTestCase (new SpectrumChannelCacheTestCase, TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static SpectrumChannelCacheTestSuite g_spectrumChannelCacheTestSuite;
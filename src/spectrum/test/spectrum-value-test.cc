@@ -223,6 +223,38 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   AddTestCase (new SpectrumValueTestCase (tv9b, v9, "tv9b =  doubleValue * v1"), TestCase::QUICK);
   AddTestCase (new SpectrumValueTestCase (tv10b, v10, "tv10b = doubleValue div v1"), TestCase::QUICK);
 
+  // operators on temporaries, which reuse the storage of the temporary
+  tv3 = SpectrumValue (v1) + v2;
+  tv4 = SpectrumValue (v1) - v2;
+  tv5 = SpectrumValue (v1) * v2;
+  tv6 = SpectrumValue (v1) / v2;
+  AddTestCase (new SpectrumValueTestCase (tv3, v3, "tv3 = temporary v1 + v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv4, v4, "tv4 = temporary v1 - v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv5, v5, "tv5 = temporary v1 * v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv6, v6, "tv6 = temporary v1 div v2"), TestCase::QUICK);
+
+  tv3 = v1 + SpectrumValue (v2);
+  tv5 = v1 * SpectrumValue (v2);
+  AddTestCase (new SpectrumValueTestCase (tv3, v3, "tv3 = v1 + temporary v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv5, v5, "tv5 = v1 * temporary v2"), TestCase::QUICK);
+
+  tv7a = SpectrumValue (v1) + doubleValue;
+  tv8a = SpectrumValue (v1) - doubleValue;
+  tv9a = doubleValue * SpectrumValue (v1);
+  tv10a = SpectrumValue (v1) / doubleValue;
+  AddTestCase (new SpectrumValueTestCase (tv7a, v7, "tv7a = temporary v1 + doubleValue"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv8a, v8, "tv8a = temporary v1 - doubleValue"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv9a, v9, "tv9a = doubleValue * temporary v1"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv10a, v10, "tv10a = temporary v1 div doubleValue"), TestCase::QUICK);
+
+  SpectrumValue tv11 (f);
+  tv11 = (v1 * v2) + (v1 - v2);
+  AddTestCase (new SpectrumValueTestCase (tv11, v5 + v4, "tv11 = (v1 * v2) + (v1 - v2)"), TestCase::QUICK);
+
+  tv11 = v3;
+  tv11.AddScaled (v1, doubleValue);
+  AddTestCase (new SpectrumValueTestCase (tv11, v3 + v9, "tv11 = v3, tv11 += v1 * doubleValue"), TestCase::QUICK);
+
 
 
 
@@ -22,6 +22,7 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/propagation-loss-model.h"
@@ -30,6 +31,7 @@
 #include "yans-wifi-channel.h"
 #include "yans-wifi-phy.h"
 #include "wifi-utils.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -37,6 +39,32 @@ NS_LOG_COMPONENT_DEFINE ("YansWifiChannel");
 
 NS_OBJECT_ENSURE_REGISTERED (YansWifiChannel);
 
+/**
+ * \param mobility a mobility model
+ * \return true if the mobility model does not move
+ */
+static bool
+IsStatic (Ptr<const MobilityModel> mobility)
+{
+  Vector velocity = mobility->GetVelocity ();
+  return velocity.x == 0 && velocity.y == 0 && velocity.z == 0;
+}
+
+/**
+ * \param phy the receiving PHY
+ * \param rxPowerDbm the received power before the RX gain
+ * \return true if the PHY drops the signal without processing it
+ *
+ * Such a signal never reaches WifiPhy::StartReceivePreamble, so it is
+ * not added to the InterferenceHelper of the PHY either: it neither
+ * lowers the SINR of other frames nor triggers CCA energy detection.
+ */
+static bool
+IsBelowRxSensitivity (Ptr<YansWifiPhy> phy, double rxPowerDbm)
+{
+  return (rxPowerDbm + phy->GetRxGain ()) < phy->GetRxSensitivity ();
+}
+
 TypeId
 YansWifiChannel::GetTypeId (void)
 {
@@ -52,11 +80,26 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("PropagationCache",
+                   "Cache the delay and the received power of the pairs of PHYs which do not move. "
+                   "Only valid with deterministic propagation loss models.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_cacheEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("RxSensitivityCutoff",
+                   "Do not schedule the reception of signals below the RX sensitivity of the receiver. "
+                   "The receiver drops these signals on arrival without adding them to its interference, "
+                   "so the PHY results are the same as without the cutoff.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_rxSensitivityCutoff),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_cacheEnabled (false),
+    m_rxSensitivityCutoff (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -67,11 +110,21 @@ YansWifiChannel::~YansWifiChannel ()
   m_phyList.clear ();
 }
 
+void
+YansWifiChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_phyList.clear ();
+  ResetCache ();
+  Channel::DoDispose ();
+}
+
 void
 YansWifiChannel::SetPropagationLossModel (const Ptr<PropagationLossModel> loss)
 {
   NS_LOG_FUNCTION (this << loss);
   m_loss = loss;
+  ClearCache ();
 }
 
 void
@@ -79,6 +132,7 @@ YansWifiChannel::SetPropagationDelayModel (const Ptr<PropagationDelayModel> dela
 {
   NS_LOG_FUNCTION (this << delay);
   m_delay = delay;
+  ClearCache ();
 }
 
 void
@@ -87,6 +141,19 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
   NS_LOG_FUNCTION (this << sender << packet << txPowerDbm << duration.GetSeconds ());
   Ptr<MobilityModel> senderMobility = sender->GetMobility ();
   NS_ASSERT (senderMobility != 0);
+  std::size_t senderIndex = 0;
+  bool senderStatic = false;
+  if (m_cacheEnabled)
+    {
+      if (m_cache.size () != m_phyList.size () * m_phyList.size ())
+        {
+          const_cast<YansWifiChannel *> (this)->ResetCache ();
+        }
+      senderIndex = std::find (m_phyList.begin (), m_phyList.end (), sender) - m_phyList.begin ();
+      NS_ASSERT (senderIndex < m_phyList.size ());
+      WatchMobility (senderIndex, senderMobility);
+      senderStatic = IsStatic (senderMobility);
+    }
   for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
     {
       if (sender != (*i))
@@ -98,10 +165,38 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
             }
 
           Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+          Time delay;
+          double rxPowerDbm;
+          if (m_cacheEnabled)
+            {
+              std::size_t receiverIndex = i - m_phyList.begin ();
+              WatchMobility (receiverIndex, receiverMobility);
+              PathEntry &entry = m_cache[senderIndex * m_phyList.size () + receiverIndex];
+              if (!entry.valid || entry.txPowerDbm != txPowerDbm)
+                {
+                  entry.delay = m_delay->GetDelay (senderMobility, receiverMobility);
+                  entry.rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+                  entry.txPowerDbm = txPowerDbm;
+                  // a moving PHY does not always notify a CourseChange
+                  entry.valid = senderStatic && IsStatic (receiverMobility);
+                }
+              delay = entry.delay;
+              rxPowerDbm = entry.rxPowerDbm;
+            }
+          else
+            {
+              delay = m_delay->GetDelay (senderMobility, receiverMobility);
+              rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+            }
           NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
                         "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+          // the same test as in Receive: signals above the RX sensitivity,
+          // decodable or not, are still scheduled and add to the interference
+          if (m_rxSensitivityCutoff && IsBelowRxSensitivity (*i, rxPowerDbm))
+            {
+              NS_LOG_LOGIC ("Signal below the RX sensitivity, not scheduled: " << rxPowerDbm << " dBm");
+              continue;
+            }
           Ptr<Packet> copy = packet->Copy ();
           Ptr<NetDevice> dstNetDevice = (*i)->GetDevice ();
           uint32_t dstNode;
@@ -127,7 +222,7 @@ YansWifiChannel::Receive (Ptr<YansWifiPhy> phy, Ptr<Packet> packet, double rxPow
   NS_LOG_FUNCTION (phy << packet << rxPowerDbm << duration.GetSeconds ());
   // Do no further processing if signal is too weak
   // Current implementation assumes constant rx power over the packet duration
-  if ((rxPowerDbm + phy->GetRxGain ()) < phy->GetRxSensitivity ())
+  if (IsBelowRxSensitivity (phy, rxPowerDbm))
     {
       NS_LOG_INFO ("Received signal too weak to process: " << rxPowerDbm << " dBm");
       return;
@@ -152,6 +247,64 @@ YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
   NS_LOG_FUNCTION (this << phy);
   m_phyList.push_back (phy);
+  ResetCache ();
+}
+
+void
+YansWifiChannel::ClearCache (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<PathEntry>::iterator i = m_cache.begin (); i != m_cache.end (); ++i)
+    {
+      i->valid = false;
+    }
+}
+
+void
+YansWifiChannel::ResetCache (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::size_t i = 0; i < m_watched.size (); ++i)
+    {
+      if (m_watched[i] != 0)
+        {
+          m_watched[i]->TraceDisconnectWithoutContext ("CourseChange", m_courseChange[i]);
+        }
+    }
+  m_watched.assign (m_phyList.size (), 0);
+  m_courseChange.assign (m_phyList.size (), Callback<void, Ptr<const MobilityModel> > ());
+  PathEntry invalid = {false, 0.0, 0.0, Time ()};
+  m_cache.assign (m_cacheEnabled ? m_phyList.size () * m_phyList.size () : 0, invalid);
+}
+
+void
+YansWifiChannel::WatchMobility (uint32_t index, Ptr<MobilityModel> mobility) const
+{
+  if (m_watched[index] == mobility)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << index << mobility);
+  if (m_watched[index] != 0)
+    {
+      m_watched[index]->TraceDisconnectWithoutContext ("CourseChange", m_courseChange[index]);
+    }
+  m_courseChange[index] = MakeCallback (&YansWifiChannel::CourseChanged, this).Bind (index);
+  mobility->TraceConnectWithoutContext ("CourseChange", m_courseChange[index]);
+  m_watched[index] = mobility;
+  CourseChanged (index, mobility);
+}
+
+void
+YansWifiChannel::CourseChanged (uint32_t index, Ptr<const MobilityModel> mobility) const
+{
+  NS_LOG_FUNCTION (this << index << mobility);
+  std::size_t n = m_phyList.size ();
+  for (std::size_t j = 0; j < n; ++j)
+    {
+      m_cache[index * n + j].valid = false;
+      m_cache[j * n + index].valid = false;
+    }
 }
 
 int64_t
@@ -22,6 +22,8 @@
 #define YANS_WIFI_CHANNEL_H
 
 #include "ns3/channel.h"
+#include "ns3/nstime.h"
+#include "ns3/callback.h"
 
 namespace ns3 {
 
@@ -30,7 +32,7 @@ class PropagationLossModel;
 class PropagationDelayModel;
 class YansWifiPhy;
 class Packet;
-class Time;
+class MobilityModel;
 
 /**
  * \brief a channel to interconnect ns3::YansWifiPhy objects.
@@ -40,6 +42,22 @@ class Time;
  * class and supports an ns3::PropagationLossModel and an
  * ns3::PropagationDelayModel.  By default, no propagation models are set;
  * it is the caller's responsibility to set them before using the channel.
+ *
+ * With the PropagationCache attribute, the channel keeps the delay and
+ * the received power of every pair of PHYs which are not moving, and
+ * only evaluates the propagation models again after a CourseChange of
+ * one of the two mobility models.  This is only valid with
+ * deterministic loss models: do not enable it with models which draw
+ * random variables or depend on time (e.g. Nakagami, Jakes), and call
+ * ClearCache after changing the parameters of a loss model.
+ *
+ * With the RxSensitivityCutoff attribute, the channel does not schedule
+ * the reception of a signal which arrives below the RX sensitivity of
+ * the receiver.  Receive drops such a signal before
+ * WifiPhy::StartReceivePreamble, which is where a signal is added to the
+ * interference of the PHY, so the cutoff only saves the packet copy and
+ * the event.  It must be kept consistent with Receive: any signal the
+ * PHY accounts as interference has to be scheduled.
  */
 class YansWifiChannel : public Channel
 {
@@ -97,6 +115,14 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * Forget the propagation results cached for all the pairs of PHYs.
+   */
+  void ClearCache (void);
+
+
+protected:
+  virtual void DoDispose (void);
 
 private:
   /**
@@ -116,9 +142,45 @@ private:
    */
   static void Receive (Ptr<YansWifiPhy> receiver, Ptr<Packet> packet, double txPowerDbm, Time duration);
 
+  /**
+   * Make sure the cache is invalidated when a PHY moves.
+   *
+   * \param index the index of the PHY in m_phyList
+   * \param mobility the current mobility model of the PHY
+   */
+  void WatchMobility (uint32_t index, Ptr<MobilityModel> mobility) const;
+  /**
+   * Invalidate the cached paths from and to a PHY.  Connected to the
+   * CourseChange trace of the mobility model of the PHY.
+   *
+   * \param index the index of the PHY in m_phyList
+   * \param mobility the mobility model which changed
+   */
+  void CourseChanged (uint32_t index, Ptr<const MobilityModel> mobility) const;
+  /**
+   * Disconnect the CourseChange traces and resize the cache to the PHY list.
+   */
+  void ResetCache (void);
+
+  /**
+   * Propagation result of a pair of PHYs.
+   */
+  struct PathEntry
+  {
+    bool valid;          //!< Is the entry usable
+    double txPowerDbm;   //!< The tx power of the computation (dBm)
+    double rxPowerDbm;   //!< The resulting rx power (dBm)
+    Time delay;          //!< The propagation delay
+  };
+
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  bool m_cacheEnabled;                 //!< Cache the propagation of the static pairs
+  bool m_rxSensitivityCutoff;          //!< Do not schedule receptions below the RX sensitivity
+  mutable std::vector<PathEntry> m_cache;                //!< Cached paths, sender * m_phyList.size () + receiver
+  mutable std::vector<Ptr<MobilityModel> > m_watched;    //!< Mobility model connected for each PHY
+  mutable std::vector<Callback<void, Ptr<const MobilityModel> > > m_courseChange; //!< CourseChange callbacks of each PHY
 };
 
 } //namespace ns3
@@ -28,6 +28,9 @@
 #include "ns3/adhoc-wifi-mac.h"
 #include "ns3/ap-wifi-mac.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/boolean.h"
 #include "ns3/yans-error-rate-model.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/test.h"
@@ -46,6 +49,7 @@
 #include "ns3/mgt-headers.h"
 #include "ns3/ht-configuration.h"
 #include "ns3/wifi-phy-header.h"
+#include "ns3/wifi-mac-trailer.h"
 
 using namespace ns3;
 
@@ -2174,6 +2178,336 @@ Bug2470TestCase::DoRun (void)
   // but before it does not enter RESET state. More tests should be written to verify all possible scenarios.
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Log distance loss model counting its evaluations
+ */
+class CountingLossModel : public PropagationLossModel
+{
+public:
+  CountingLossModel ()
+    : m_count (0),
+      m_model (CreateObject<LogDistancePropagationLossModel> ())
+  {
+  }
+  mutable uint32_t m_count; ///< number of evaluations
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const
+  {
+    m_count++;
+    return m_model->CalcRxPower (txPowerDbm, a, b);
+  }
+  virtual int64_t DoAssignStreams (int64_t stream)
+  {
+    return 0;
+  }
+
+  Ptr<LogDistancePropagationLossModel> m_model; ///< the actual loss model
+};
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Make sure that the propagation cache of the YansWifiChannel only
+ * evaluates the loss model once per static pair of PHYs, and again after
+ * a PHY moved, without changing the receptions.
+ */
+class YansWifiChannelCacheTest : public TestCase
+{
+public:
+  YansWifiChannelCacheTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  /**
+   * Run one configuration
+   * \param cache enable the propagation cache and the RX sensitivity cutoff
+   */
+  void RunOne (bool cache);
+  /**
+   * Create one node
+   * \param pos the position
+   * \param channel the wifi channel
+   * \returns the node
+   */
+  Ptr<Node> CreateOne (Vector pos, Ptr<YansWifiChannel> channel);
+  /**
+   * Send one packet function
+   * \param dev the device
+   */
+  void SendOnePacket (Ptr<WifiNetDevice> dev);
+  /**
+   * Move a node
+   * \param node the node
+   * \param pos the new position
+   */
+  void Move (Ptr<Node> node, Vector pos);
+  /**
+   * Notify the end of a reception
+   * \param packet the received packet
+   */
+  void RxEnd (Ptr<const Packet> packet);
+
+  ObjectFactory m_manager; ///< manager
+  ObjectFactory m_mac; ///< MAC
+  uint32_t m_received; ///< number of packets received
+};
+
+YansWifiChannelCacheTest::YansWifiChannelCacheTest ()
+  : TestCase ("Propagation cache of the YansWifiChannel"),
+    m_received (0)
+{
+}
+
+void
+YansWifiChannelCacheTest::SendOnePacket (Ptr<WifiNetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+YansWifiChannelCacheTest::Move (Ptr<Node> node, Vector pos)
+{
+  node->GetObject<MobilityModel> ()->SetPosition (pos);
+}
+
+void
+YansWifiChannelCacheTest::RxEnd (Ptr<const Packet> packet)
+{
+  m_received++;
+}
+
+Ptr<Node>
+YansWifiChannelCacheTest::CreateOne (Vector pos, Ptr<YansWifiChannel> channel)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+
+  Ptr<WifiMac> mac = m_mac.Create<WifiMac> ();
+  mac->SetDevice (dev);
+  mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  phy->SetErrorRateModel (error);
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->SetMobility (mobility);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<WifiRemoteStationManager> manager = m_manager.Create<WifiRemoteStationManager> ();
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  mac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (manager);
+  node->AddDevice (dev);
+
+  return node;
+}
+
+void
+YansWifiChannelCacheTest::RunOne (bool cache)
+{
+  m_received = 0;
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetAttribute ("PropagationCache", BooleanValue (cache));
+  channel->SetAttribute ("RxSensitivityCutoff", BooleanValue (cache));
+  Ptr<CountingLossModel> loss = CreateObject<CountingLossModel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (loss);
+
+  Ptr<Node> sender = CreateOne (Vector (0.0, 0.0, 0.0), channel);
+  Ptr<Node> receiver = CreateOne (Vector (5.0, 0.0, 0.0), channel);
+  CreateOne (Vector (5000.0, 0.0, 0.0), channel); // out of range
+  DynamicCast<WifiNetDevice> (receiver->GetDevice (0))->GetPhy ()
+    ->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&YansWifiChannelCacheTest::RxEnd, this));
+
+  Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice> (sender->GetDevice (0));
+  for (uint32_t i = 1; i <= 3; i++)
+    {
+      Simulator::Schedule (Seconds (i), &YansWifiChannelCacheTest::SendOnePacket, this, dev);
+    }
+  Simulator::Schedule (Seconds (3.5), &YansWifiChannelCacheTest::Move, this, receiver, Vector (10.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (4.0), &YansWifiChannelCacheTest::SendOnePacket, this, dev);
+
+  Simulator::Stop (Seconds (5.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received, 4, "The receiver did not get all the packets");
+  // two receivers for each of the 4 packets, or the two first evaluations
+  // and the moved receiver
+  NS_TEST_ASSERT_MSG_EQ (loss->m_count, cache ? 3 : 8, "Unexpected number of loss model evaluations");
+}
+
+void
+YansWifiChannelCacheTest::DoRun (void)
+{
+  m_mac.SetTypeId ("ns3::AdhocWifiMac");
+  m_manager.SetTypeId ("ns3::ConstantRateWifiManager");
+
+  RunOne (false);
+  RunOne (true);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Make sure that the RX sensitivity cutoff of the YansWifiChannel
+ * keeps the interference: a signal above the RX sensitivity of the
+ * receiver still corrupts the frame it overlaps, and a signal below it
+ * has no effect, with and without the cutoff.
+ */
+class YansWifiChannelCutoffTest : public TestCase
+{
+public:
+  YansWifiChannelCutoffTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  /**
+   * Send a frame and an overlapping interfering frame
+   * \param cutoff enable the RX sensitivity cutoff
+   * \param interferenceDbm the power of the interfering frame at the receiver
+   */
+  void RunOne (bool cutoff, double interferenceDbm);
+  /**
+   * Create one PHY
+   * \param channel the wifi channel
+   * \returns the PHY
+   */
+  Ptr<YansWifiPhy> CreateOne (Ptr<YansWifiChannel> channel);
+  /**
+   * Send one packet function
+   * \param phy the transmitting PHY
+   */
+  void SendOnePacket (Ptr<YansWifiPhy> phy);
+  /**
+   * Notify a successful reception
+   * \param p the packet
+   * \param snr the SNR
+   * \param txVector the transmit vector
+   * \param statusPerMpdu reception status per MPDU
+   */
+  void RxSuccess (Ptr<Packet> p, double snr, WifiTxVector txVector, std::vector<bool> statusPerMpdu);
+  /**
+   * Notify a failed reception
+   * \param p the packet
+   */
+  void RxFailure (Ptr<Packet> p);
+
+  uint32_t m_countRxSuccess; ///< count RX success
+  uint32_t m_countRxFailure; ///< count RX failure
+};
+
+YansWifiChannelCutoffTest::YansWifiChannelCutoffTest ()
+  : TestCase ("RX sensitivity cutoff of the YansWifiChannel keeps the interference"),
+    m_countRxSuccess (0),
+    m_countRxFailure (0)
+{
+}
+
+void
+YansWifiChannelCutoffTest::SendOnePacket (Ptr<YansWifiPhy> phy)
+{
+  WifiTxVector txVector = WifiTxVector (WifiPhy::GetOfdmRate6Mbps (), 0, WIFI_PREAMBLE_LONG, 800, 1, 1, 0, 20, false, false);
+  Ptr<Packet> pkt = Create<Packet> (1000);
+  WifiMacHeader hdr;
+  WifiMacTrailer trailer;
+  hdr.SetType (WIFI_MAC_DATA);
+  pkt->AddHeader (hdr);
+  pkt->AddTrailer (trailer);
+  phy->SendPacket (pkt, txVector);
+}
+
+void
+YansWifiChannelCutoffTest::RxSuccess (Ptr<Packet> p, double snr, WifiTxVector txVector, std::vector<bool> statusPerMpdu)
+{
+  m_countRxSuccess++;
+}
+
+void
+YansWifiChannelCutoffTest::RxFailure (Ptr<Packet> p)
+{
+  m_countRxFailure++;
+}
+
+Ptr<YansWifiPhy>
+YansWifiChannelCutoffTest::CreateOne (Ptr<YansWifiChannel> channel)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+  phy->SetChannel (channel);
+  phy->SetMobility (CreateObject<ConstantPositionMobilityModel> ());
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  return phy;
+}
+
+void
+YansWifiChannelCutoffTest::RunOne (bool cutoff, double interferenceDbm)
+{
+  m_countRxSuccess = 0;
+  m_countRxFailure = 0;
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetAttribute ("RxSensitivityCutoff", BooleanValue (cutoff));
+  Ptr<MatrixPropagationLossModel> loss = CreateObject<MatrixPropagationLossModel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (loss);
+
+  Ptr<YansWifiPhy> sender = CreateOne (channel);
+  Ptr<YansWifiPhy> interferer = CreateOne (channel);
+  Ptr<YansWifiPhy> receiver = CreateOne (channel);
+  receiver->SetRxSensitivity (-70.0);
+  receiver->SetReceiveOkCallback (MakeCallback (&YansWifiChannelCutoffTest::RxSuccess, this));
+  receiver->SetReceiveErrorCallback (MakeCallback (&YansWifiChannelCutoffTest::RxFailure, this));
+
+  double txPowerDbm = sender->GetTxPowerStart ();
+  loss->SetLoss (sender->GetMobility (), receiver->GetMobility (), txPowerDbm + 60.0);
+  loss->SetLoss (interferer->GetMobility (), receiver->GetMobility (), txPowerDbm - interferenceDbm);
+  loss->SetLoss (sender->GetMobility (), interferer->GetMobility (), txPowerDbm + 200.0);
+
+  // the interfering frame starts while the receiver is decoding the first one
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelCutoffTest::SendOnePacket, this, sender);
+  Simulator::Schedule (Seconds (1.0) + MicroSeconds (100), &YansWifiChannelCutoffTest::SendOnePacket, this, interferer);
+
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+YansWifiChannelCutoffTest::DoRun (void)
+{
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      bool cutoff = (i == 1);
+      // above the RX sensitivity of -70 dBm and stronger than the -60 dBm frame
+      RunOne (cutoff, -57.0);
+      NS_TEST_ASSERT_MSG_EQ (m_countRxSuccess, 0, "The interference was lost, cutoff=" << cutoff);
+      NS_TEST_ASSERT_MSG_EQ (m_countRxFailure, 1, "The frame was not corrupted, cutoff=" << cutoff);
+      // below the RX sensitivity: dropped by the channel in both cases
+      RunOne (cutoff, -80.0);
+      NS_TEST_ASSERT_MSG_EQ (m_countRxSuccess, 1, "The frame was not received, cutoff=" << cutoff);
+      NS_TEST_ASSERT_MSG_EQ (m_countRxFailure, 0, "Unexpected reception failure, cutoff=" << cutoff);
+    }
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -2204,3 +2538,24 @@ WifiTestSuite::WifiTestSuite ()
 }
 
 static WifiTestSuite g_wifiTestSuite; ///< the test suite
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief YansWifiChannel Test Suite
+ */
+class YansWifiChannelTestSuite : public TestSuite
+{
+public:
+  YansWifiChannelTestSuite ();
+};
+
+YansWifiChannelTestSuite::YansWifiChannelTestSuite ()
+  : TestSuite ("wifi-yans-channel", UNIT)
+{
+  AddTestCase (new YansWifiChannelCacheTest, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelCutoffTest, TestCase::QUICK);
+}
+
+static YansWifiChannelTestSuite g_yansWifiChannelTestSuite; ///< the test suite
@@ -145,6 +145,147 @@ Bench::Cb (void)
 }
 
 
+/**
+ * Timer mix of DASH clients: while a segment downloads, the client hops
+ * every millisecond; it polls its buffer every second, and re-arms a
+ * segment timer (cancelling the previous one) for every segment.
+ * Once the total is reached the clients stop, and the run ends when the
+ * event list drains.
+ */
+class DashBench
+{
+public:
+  /**
+   * constructor
+   * \param clients the number of clients
+   * \param total the total
+   */
+  DashBench (const uint32_t clients, const uint32_t total)
+    : m_clients (clients),
+      m_total (total),
+      m_count (0)
+  {
+    m_hops = CreateObject<UniformRandomVariable> ();
+    m_hops->SetAttribute ("Min", DoubleValue (20));
+    m_hops->SetAttribute ("Max", DoubleValue (200));
+  }
+
+  /// Run function
+  void RunBench (void);
+private:
+  /**
+   * One millisecond hop of a segment download
+   * \param client the client
+   * \param left the hops left before the segment is complete
+   */
+  void Hop (uint32_t client, uint32_t left);
+  /**
+   * Buffer poll of a client
+   * \param client the client
+   */
+  void Poll (uint32_t client);
+  /**
+   * Segment timeout of a client, only runs if a segment stalls
+   * \param client the client
+   */
+  void Timeout (uint32_t client);
+  /**
+   * Start the download of the next segment
+   * \param client the client
+   */
+  void StartSegment (uint32_t client);
+
+  Ptr<UniformRandomVariable> m_hops; ///< hops per segment
+  std::vector<EventId> m_timeouts; ///< segment timer of each client
+  uint32_t m_clients; ///< number of clients
+  uint32_t m_total; ///< total
+  uint32_t m_count; ///< count
+};
+
+void
+DashBench::RunBench (void)
+{
+  SystemWallClockMs time;
+  double init, simu;
+
+  m_count = 0;
+  m_timeouts.assign (m_clients, EventId ());
+
+  time.Start ();
+  for (uint32_t i = 0; i < m_clients; ++i)
+    {
+      Simulator::Schedule (MicroSeconds (i), &DashBench::StartSegment, this, i);
+      Simulator::Schedule (Seconds (1) + MicroSeconds (i), &DashBench::Poll, this, i);
+    }
+  init = time.End ();
+  init /= 1000;
+
+  time.Start ();
+  Simulator::Run ();
+  simu = time.End ();
+  simu /= 1000;
+
+  LOG (std::setw (g_fwidth) << init <<
+       std::setw (g_fwidth) << (2 * m_clients / init) <<
+       std::setw (g_fwidth) << (init / (2 * m_clients)) <<
+       std::setw (g_fwidth) << simu <<
+       std::setw (g_fwidth) << (m_count / simu) <<
+       std::setw (g_fwidth) << (simu / m_count));
+}
+
+void
+DashBench::StartSegment (uint32_t client)
+{
+  if (m_count >= m_total)
+    {
+      return;
+    }
+  ++m_count;
+  m_timeouts[client].Cancel ();
+  m_timeouts[client] = Simulator::Schedule (Seconds (4), &DashBench::Timeout, this, client);
+  Simulator::Schedule (MilliSeconds (1), &DashBench::Hop, this, client, m_hops->GetInteger ());
+}
+
+void
+DashBench::Hop (uint32_t client, uint32_t left)
+{
+  if (m_count >= m_total)
+    {
+      return;
+    }
+  ++m_count;
+  if (left > 0)
+    {
+      Simulator::Schedule (MilliSeconds (1), &DashBench::Hop, this, client, left - 1);
+    }
+  else
+    {
+      StartSegment (client);
+    }
+}
+
+void
+DashBench::Poll (uint32_t client)
+{
+  if (m_count >= m_total)
+    {
+      return;
+    }
+  ++m_count;
+  Simulator::Schedule (Seconds (1), &DashBench::Poll, this, client);
+}
+
+void
+DashBench::Timeout (uint32_t client)
+{
+  if (m_count >= m_total)
+    {
+      return;
+    }
+  ++m_count;
+}
+
+
 Ptr<RandomVariableStream>
 GetRandomStream (std::string filename)
 {
@@ -207,10 +348,12 @@ int main (int argc, char *argv[])
   bool schedHeap = false;
   bool schedList = false;
   bool schedMap  = true;
+  bool schedFour = false;
 
   uint32_t pop   =  100000;
   uint32_t total = 1000000;
   uint32_t runs  =       1;
+  uint32_t dash  =       0;
   std::string filename = "";
 
   CommandLine cmd;
@@ -221,11 +364,17 @@ int main (int argc, char *argv[])
              "  an ascii file, given by the --file=\"<filename>\" argument,\n"
              "  or standard input, by the argument --file=\"-\"\n"
              "In the case of either --file form, the input is expected\n"
-             "to be ascii, giving the relative event times in ns.");
+             "to be ascii, giving the relative event times in ns.\n"
+             "\n"
+             "With --dash=<clients>, the events are instead the timers of\n"
+             "DASH clients: 1 ms download hops, 1 s buffer polls and a\n"
+             "segment timer re-armed for every segment.");
   cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
   cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
+  cmd.AddValue ("fourary", "use FourAryHeapScheduler",    schedFour);
+  cmd.AddValue ("dash",  "number of DASH clients of the timer mix (default 0: off)", dash);
   cmd.AddValue ("debug", "enable debugging output",       g_debug);
   cmd.AddValue ("pop",   "event population size (default 1E5)",         pop);
   cmd.AddValue ("total", "total number of events to run (default 1E6)", total);
@@ -249,6 +398,10 @@ int main (int argc, char *argv[])
     {
       factory.SetTypeId ("ns3::ListScheduler");
     }
+  if (schedFour)
+    {
+      factory.SetTypeId ("ns3::FourAryHeapScheduler");
+    }
   Simulator::SetScheduler (factory);
 
   LOGME (std::setprecision (g_fwidth - 6));
@@ -260,7 +413,16 @@ int main (int argc, char *argv[])
   LOGME ("runs: " << runs);
 
   Bench *bench = new Bench (pop, total);
-  bench->SetRandomStream (GetRandomStream (filename));
+  DashBench *dashBench = 0;
+  if (dash > 0)
+    {
+      LOGME ("DASH clients: " << dash);
+      dashBench = new DashBench (dash, total);
+    }
+  else
+    {
+      bench->SetRandomStream (GetRandomStream (filename));
+    }
 
   // table header
   LOG ("");
@@ -288,7 +450,14 @@ int main (int argc, char *argv[])
   // prime
   DEB ("priming");
   std::cout << std::left << std::setw (g_fwidth) << "(prime)";
-  bench->RunBench ();
+  if (dashBench)
+    {
+      dashBench->RunBench ();
+    }
+  else
+    {
+      bench->RunBench ();
+    }
 
   bench->SetPopulation (pop);
   bench->SetTotal (total);
@@ -296,11 +465,19 @@ int main (int argc, char *argv[])
     {
       std::cout << std::setw (g_fwidth) << i;
 
-      bench->RunBench ();
+      if (dashBench)
+        {
+          dashBench->RunBench ();
+        }
+      else
+        {
+          bench->RunBench ();
+        }
     }
 
   LOG ("");
   Simulator::Destroy ();
   delete bench;
+  delete dashBench;
   return 0;
 }
@@ -0,0 +1,196 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the SpectrumValue arithmetic of
+// the LTE PHY: the SINR of an interference chunk, its accumulation by a
+// chunk processor, and the copy and scaling of a PSD by the channel.
+// Sample usage:  ./waf --run 'bench-spectrum-value --n=100000 --bands=100'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/spectrum-value.h"
+#include <iostream>
+#include <vector>
+#include <stdlib.h> // for exit ()
+#include <limits>
+#include <algorithm>
+
+using namespace ns3;
+
+/// The operands of the benchmarks
+struct BenchValues
+{
+  /**
+   * Constructor
+   * \param bands number of bands of the spectrum model
+   */
+  BenchValues (uint32_t bands);
+
+  Ptr<SpectrumModel> model;     //!< 180 kHz resource blocks
+  SpectrumValue rxSignal;       //!< Signal being received
+  SpectrumValue allSignals;     //!< Sum of all the signals
+  SpectrumValue noise;          //!< Noise
+  SpectrumValue interf;         //!< In place interference plus noise
+  SpectrumValue sinr;           //!< In place SINR
+  SpectrumValue sum;            //!< Accumulated SINR
+  double check;                 //!< Keeps the results alive
+};
+
+BenchValues::BenchValues (uint32_t bands)
+  : check (0)
+{
+  Bands rbs;
+  for (uint32_t i = 0; i < bands; ++i)
+    {
+      BandInfo rb;
+      rb.fl = 2.1e9 + i * 180e3;
+      rb.fc = rb.fl + 90e3;
+      rb.fh = rb.fl + 180e3;
+      rbs.push_back (rb);
+    }
+  model = Create<SpectrumModel> (rbs);
+  rxSignal = SpectrumValue (model);
+  allSignals = SpectrumValue (model);
+  noise = SpectrumValue (model);
+  interf = SpectrumValue (model);
+  sinr = SpectrumValue (model);
+  sum = SpectrumValue (model);
+  for (uint32_t i = 0; i < bands; ++i)
+    {
+      rxSignal[i] = 1e-16 * (1 + i % 7);
+      allSignals[i] = rxSignal[i] + 1e-17 * (1 + i % 5);
+      noise[i] = 4e-21;
+    }
+}
+
+/// The benchmark being run
+static BenchValues *g_values = 0;
+
+static void
+benchChunkOperators (uint32_t n)
+{
+  BenchValues &v = *g_values;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      SpectrumValue interf = v.allSignals - v.rxSignal + v.noise;
+      SpectrumValue sinr = v.rxSignal / interf;
+      v.sum += sinr * 1e-3;
+    }
+  v.check += Sum (v.sum);
+}
+
+static void
+benchChunkInPlace (uint32_t n)
+{
+  BenchValues &v = *g_values;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      v.interf = v.allSignals;
+      v.interf -= v.rxSignal;
+      v.interf += v.noise;
+      v.sinr = v.rxSignal;
+      v.sinr /= v.interf;
+      v.sum.AddScaled (v.sinr, 1e-3);
+    }
+  v.check += Sum (v.sum);
+}
+
+static void
+benchScaledCopy (uint32_t n)
+{
+  BenchValues &v = *g_values;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<SpectrumValue> psd = v.rxSignal.Copy ();
+      *psd *= 1e-9;
+      v.check += (*psd)[0];
+    }
+}
+
+static void
+benchIntegral (uint32_t n)
+{
+  BenchValues &v = *g_values;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      v.check += Integral (v.rxSignal);
+    }
+}
+
+static uint64_t
+runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  (*bench) (n);
+  uint64_t deltaMs = time.End ();
+  return deltaMs;
+}
+
+
+static void
+runBench (void (*bench) (uint32_t), uint32_t n, uint32_t minIterations, char const *name)
+{
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      uint64_t delay = runBenchOneIteration(bench, n);
+      minDelay = std::min(minDelay, delay);
+    }
+  double ps = n;
+  ps *= 1000;
+  ps /= std::max (minDelay, (uint64_t) 1);
+  std::cout << ps << " ops/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << name
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t bands = 100;
+  uint32_t minIterations = 1;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark SpectrumValue arithmetic");
+  cmd.AddValue ("n", "number of iterations", n);
+  cmd.AddValue ("bands", "number of bands of the spectrum model (100 for a 20 MHz LTE carrier)", bands);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || bands == 0)
+    {
+      std::cerr << "Error-- number of iterations must be specified " <<
+        "by command-line argument --n=(number of iterations)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-spectrum-value with n=" << n
+            << " and " << bands << " bands" << std::endl;
+
+  BenchValues values (bands);
+  g_values = &values;
+
+  runBench (&benchChunkOperators, n, minIterations, "SINR chunk with binary operators");
+  runBench (&benchChunkInPlace, n, minIterations, "SINR chunk in place");
+  runBench (&benchScaledCopy, n, minIterations, "Copy and scale a PSD");
+  runBench (&benchIntegral, n, minIterations, "Integral");
+
+  g_values = 0;
+  // print the results so that the compiler keeps the computations
+  std::cout << "checksum " << values.check << std::endl;
+  return 0;
+}
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+## -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+
+"""Merge the binary records of AnimationInterface::EnableBinaryOutput back
+into the XML trace file, for NetAnim.
+
+    utils/netanim-bin2xml.py topology.netanim [merged.netanim]
+
+The records are read from <trace file>.bin and interleaved in time order
+with the timed elements of the XML trace file.  The output defaults to
+<trace file>.xml.
+"""
+
+import re
+import struct
+import sys
+
+MAGIC = b'NS3ANIMB'
+VERSION = 2
+P2P_PACKET = 1
+LINK_SAMPLE = 2
+NODE_SAMPLE = 3
+
+TIME_RE = re.compile(r'\s(?:t|fbTx)="([^"]*)"')
+
+
+def xml_escape(s):
+    return s.replace('&', '&amp;').replace('"', '&quot;').replace("'", '&apos;') \
+            .replace('<', '&lt;').replace('>', '&gt;')
+
+
+def fmt(value):
+    # as AnimXmlElement::AddAttribute
+    return '%.10g' % value
+
+
+def read_records(filename):
+    """! Read the records of a binary trace file
+    @param filename the binary trace file
+    @return (time, XML element) of each record
+    """
+    with open(filename, 'rb') as f:
+        data = f.read()
+    if data[:8] != MAGIC:
+        sys.exit('%s is not a binary NetAnim trace' % filename)
+    version, = struct.unpack_from('=I', data, 8)
+    if version != VERSION:
+        sys.exit('%s: unsupported version %d' % (filename, version))
+    offset = 12
+    records = []
+    while offset < len(data):
+        kind, = struct.unpack_from('=B', data, offset)
+        offset += 1
+        if kind == P2P_PACKET:
+            fid, tid, fbtx, lbtx, fbrx, lbrx = struct.unpack_from('=IIdddd', data, offset)
+            offset += struct.calcsize('=IIdddd')
+            records.append((fbtx, '<p fId="%d" fbTx="%s" lbTx="%s" tId="%d" fbRx="%s" lbRx="%s" />\n'
+                            % (fid, fmt(fbtx), fmt(lbtx), tid, fmt(fbrx), fmt(lbrx))))
+        elif kind == LINK_SAMPLE:
+            t, fromid, toid, interval, bytes0, busy0, bytes1, busy1 = \
+                struct.unpack_from('=dIIdQdQd', data, offset)
+            offset += struct.calcsize('=dIIdQdQd')
+            # as AnimationInterface::WriteLinkSample
+            desc = []
+            for (a, b, nbytes, busy) in ((fromid, toid, bytes0, busy0), (toid, fromid, bytes1, busy1)):
+                desc.append('%d->%d: %.2f Mb/s %.2f%%'
+                            % (a, b, nbytes * 8 / interval / 1e6, min(1.0, busy / interval) * 100))
+            records.append((t, '<linkupdate t="%s" fromId="%d" toId="%d" ld="%s" />\n'
+                            % (fmt(t), fromid, toid, xml_escape(' '.join(desc)))))
+        elif kind == NODE_SAMPLE:
+            t, nodeid, interval, txid, txbytes, rxid, rxbytes = \
+                struct.unpack_from('=dIdIQIQ', data, offset)
+            offset += struct.calcsize('=dIdIQIQ')
+            # as AnimationInterface::WriteNodeSample
+            for (counterid, nbytes) in ((txid, txbytes), (rxid, rxbytes)):
+                records.append((t, '<nc c="%d" i="%d" t="%s" v="%s" />\n'
+                                % (counterid, nodeid, fmt(t), fmt(nbytes * 8 / interval / 1e6))))
+        else:
+            sys.exit('%s: unknown record type %d at byte %d' % (filename, kind, offset - 1))
+    records.sort(key=lambda r: r[0])
+    return records
+
+
+def main(argv):
+    if len(argv) < 2:
+        sys.exit(__doc__)
+    xml = argv[1]
+    output = argv[2] if len(argv) > 2 else xml + '.xml'
+    records = read_records(xml + '.bin')
+    next_record = 0
+    with open(xml) as src, open(output, 'w') as dst:
+        for line in src:
+            m = TIME_RE.search(line)
+            if m:
+                t = float(m.group(1))
+            elif line.lstrip().startswith('</anim>'):
+                t = float('inf')
+            else:
+                dst.write(line)
+                continue
+            while next_record < len(records) and records[next_record][0] <= t:
+                dst.write(records[next_record][1])
+                next_record += 1
+            dst.write(line)
+        for record in records[next_record:]:
+            dst.write(record[1])
+    print('%d records merged into %s' % (len(records), output))
+
+
+if __name__ == '__main__':
+    main(sys.argv)